@@ -0,0 +1,510 @@
+/*****************************************************************************
+
+    plik  : banded.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : przetwarzanie obrazu pasmami wierszy czytanymi wprost z pliku (--max-mem)
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "banded.h"
+#include "bmp_reader.h"
+#include "utils.h"
+#include "bmp_indexed.h"
+#include "display_layout.h"
+
+/**
+ * @brief Oblicza wysokość pasma mieszczącą się w budżecie pamięci
+ * 
+ * @details Bufor spakowanych danych jest alokowany w całości (korzystają
+ * z niego wszystkie zapisywacze), więc na pasma zostaje max_memory minus
+ * packed_size. Każdy wiersz pasma kosztuje wiersz pliku BMP i wiersz skali
+ * szarości; jeden dodatkowy wiersz obu buforów to wiersz wyprzedzający
+ * Floyd-Steinberga.
+ * 
+ * @param max_memory Budżet pamięci w bajtach
+ * @param packed_size Rozmiar spakowanych danych całego obrazu
+ * @param row_size Rozmiar wiersza w pliku BMP (z dopełnieniem)
+ * @param width Szerokość skali szarości w pikselach (szerokość obrazu, także nieparzysta dla 4bpp)
+ * @param height Wysokość obrazu w pikselach
+ * 
+ * @return Liczba wierszy pasma (wielokrotność BAND_ROW_ALIGN, najwyżej
+ *         wysokość obrazu zaokrąglona w górę) lub 0 gdy budżet jest za mały
+ * 
+ * @example
+ * ```c
+ * int band_rows = calculate_band_rows(64 * 1024 * 1024, packed_size, row_size, width, height);
+ * if (band_rows == 0) {
+ *     // Budżet nie mieści nawet 8 wierszy
+ * }
+ * ```
+ */
+int calculate_band_rows(size_t max_memory, size_t packed_size, size_t row_size, int width, int height) {
+    size_t bytes_per_row = row_size + (size_t)width;
+    if (max_memory < packed_size + bytes_per_row) {
+        return 0;
+    }
+    
+    size_t rows = (max_memory - packed_size) / bytes_per_row - 1;
+    size_t max_rows = ((size_t)height + BAND_ROW_ALIGN - 1) / BAND_ROW_ALIGN * BAND_ROW_ALIGN;
+    if (rows > max_rows) {
+        rows = max_rows;
+    }
+    rows -= rows % BAND_ROW_ALIGN;
+    return (int)rows;
+}
+
+/**
+ * @brief Konwertuje wiersze pliku BMP do skali szarości pasma
+ * 
+ * @details Widok wierszy ukrywa kolejność wierszy w pliku (od dołu lub od
+ * góry), więc każdy kernel zapisuje wynik od góry do dołu z odstępem width
+ * równym szerokości obrazu - nieparzystą szerokość 4bpp obsługują kernele
+ * pakujące, zerując ostatni półbajt linii.
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int convert_band_rows(ImageRowView* view, uchar* grayscale_rows, int width, int bits_per_pixel, const uchar* gray_lut) {
+    if (gray_lut) {
+        // Obraz z paletą - tablica zwraca od razu skalę głębi (BPP_GRAYSCALE_SHIFT())
+        return convert_indexed_to_grayscale(view, grayscale_rows, width, gray_lut);
+    }
+    return convert_to_grayscale_bpp(view, grayscale_rows, width, bits_per_pixel);
+}
+
+/**
+ * @brief Przygotowuje odbiornik pasm wierszy skali szarości
+ * 
+ * @details Odbiornik przyjmuje kolejne wiersze obrazu od góry, niezależnie
+ * od źródła (wiersze pliku BMP, dekoder PNG lub PNM). Gdy pasmo jest pełne,
+ * wykonuje regulację jasności i kontrastu oraz dithering (1bpp, 2bpp, 4bpp) i pakuje
+ * je bezpośrednio do docelowego miejsca w packed_data.
+ * 
+ * Floyd-Steinberg przenosi błąd do następnego wiersza, dlatego bufor pasma
+ * ma jeden wiersz więcej: ostatni wiersz (już z rozproszonym błędem) jest
+ * przenoszony na początek następnego pasma. Ordered dithering dostaje numer
+ * wiersza w obrazie. Wynik jest identyczny jak przy przetwarzaniu całości.
+ * 
+ * @param sink Odbiornik do zainicjalizowania
+ * @param context Kontekst konwersji
+ * @param width Szerokość skali szarości (szerokość obrazu, także nieparzysta dla 4bpp)
+ * @param height Wysokość obrazu
+ * @param band_rows Wysokość pasma (wynik calculate_band_rows())
+ * @param packed_data Bufor spakowanych danych całego obrazu (wyjściowy)
+ * @param stats Statystyki etapów (NULL = bez pomiaru)
+ * 
+ * @return 1 w przypadku sukcesu, 0 gdy brak pamięci (komunikat wypisany)
+ * 
+ * @example
+ * ```c
+ * BandSink sink;
+ * band_sink_init(&sink, &context, width, height, band_rows, packed_data, &stats);
+ * while (...) {
+ *     int free_rows;
+ *     uchar* rows = band_sink_next_rows(&sink, &free_rows);
+ *     // zapisz do rows od 1 do free_rows wierszy skali szarości
+ *     band_sink_commit(&sink, written_rows);
+ * }
+ * band_sink_free(&sink);
+ * ```
+ */
+int band_sink_init(BandSink* sink, ConversionContext* context, int width, int height, int band_rows, uchar* packed_data, ConversionStats* stats) {
+    int is_dithered = BPP_IS_DITHERED(context->bits_per_pixel);
+    
+    sink->context = context;
+    sink->width = width;
+    sink->height = height;
+    sink->band_rows = band_rows;
+    sink->lookahead = (is_dithered && context->dithering_method == DITHERING_FLOYD) ? 1 : 0;
+    sink->band_y = 0;
+    sink->buffered_rows = 0;
+    sink->adjusted_rows = 0;
+    sink->packed_data = packed_data;
+    sink->stats = stats;
+    sink->grayscale_data = (uchar*)stats_malloc((size_t)(band_rows + 1) * width);
+    if (!sink->grayscale_data) {
+        printf("Error: Cannot allocate memory for image band\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Liczba wierszy potrzebnych do przetworzenia bieżącego pasma (z wierszem wyprzedzającym)
+static int band_sink_needed_rows(BandSink* sink) {
+    int rows_to_process = sink->height - sink->band_y;
+    if (rows_to_process > sink->band_rows) {
+        rows_to_process = sink->band_rows;
+    }
+    int needed = rows_to_process + sink->lookahead;
+    if (needed > sink->height - sink->band_y) {
+        needed = sink->height - sink->band_y;
+    }
+    return needed;
+}
+
+/**
+ * @brief Zwraca miejsce na kolejne wiersze skali szarości
+ * 
+ * @param sink Odbiornik pasm
+ * @param free_rows Liczba wierszy, które można zapisać przed band_sink_commit() (wyjściowy)
+ * 
+ * @return Wskaźnik do pierwszego wolnego wiersza (odstęp wierszy = width)
+ */
+uchar* band_sink_next_rows(BandSink* sink, int* free_rows) {
+    *free_rows = band_sink_needed_rows(sink) - sink->buffered_rows;
+    return sink->grayscale_data + (size_t)sink->buffered_rows * sink->width;
+}
+
+// Przetwarza pełne pasmo z bufora i przenosi wiersz wyprzedzający na początek
+static int process_band(BandSink* sink) {
+    ConversionContext* context = sink->context;
+    int width = sink->width;
+    uchar* grayscale_data = sink->grayscale_data;
+    
+    int band_y = sink->band_y;
+    int rows_to_process = (sink->height - band_y < sink->band_rows) ? sink->height - band_y : sink->band_rows;
+    int result = 1;
+    if (BPP_IS_DITHERED(context->bits_per_pixel)) {
+        // Wiersz przeniesiony z poprzedniego pasma ma już regulację jasności
+        double stage_start = stats_stage_begin();
+        result = adjust_brightness_contrast(grayscale_data + (size_t)sink->adjusted_rows * width, width,
+                                            sink->buffered_rows - sink->adjusted_rows, context->brightness, context->contrast);
+        stats_stage_end(sink->stats, STATS_STAGE_BRIGHTNESS, stage_start);
+        
+        stage_start = stats_stage_begin();
+        result = result &&
+                 apply_dithering_band(grayscale_data, width, sink->buffered_rows, rows_to_process, band_y, context->dithering_method, BPP_LEVELS(context->bits_per_pixel)) &&
+                 quantize_to_bpp(grayscale_data, width, rows_to_process, context->bits_per_pixel);
+        stats_stage_end(sink->stats, STATS_STAGE_DITHERING, stage_start);
+    }
+    if (!result) {
+        printf("Error: Failed to convert image band at row %d\n", band_y);
+        return 0;
+    }
+    
+    double stage_start = stats_stage_begin();
+    int orientation = image_orientation(context->rotation, context->flip);
+    if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+        result = pack_layout_band(grayscale_data, sink->packed_data, width, sink->height, band_y, rows_to_process,
+                                  context->display_layout, context->page_commands, orientation);
+    } else {
+        result = pack_pixels_band(grayscale_data, sink->packed_data, width, sink->height, band_y, rows_to_process,
+                                  context->bits_per_pixel, context->scan_direction, context->pixel_order, orientation);
+    }
+    stats_stage_end(sink->stats, STATS_STAGE_PACKING, stage_start);
+    if (!result) {
+        printf("Error: Failed to pack pixels\n");
+        return 0;
+    }
+    
+    // Wiersz wyprzedzający (z błędem Floyd-Steinberga) staje się pierwszym wierszem następnego pasma
+    int carried_rows = sink->buffered_rows - rows_to_process;
+    if (carried_rows > 0) {
+        memmove(grayscale_data, grayscale_data + (size_t)rows_to_process * width, (size_t)carried_rows * width);
+    }
+    sink->band_y += rows_to_process;
+    sink->buffered_rows = carried_rows;
+    sink->adjusted_rows = carried_rows;
+    return 1;
+}
+
+/**
+ * @brief Przyjmuje zapisane wiersze i przetwarza pełne pasmo
+ * 
+ * @param sink Odbiornik pasm
+ * @param row_count Liczba wierszy zapisanych od band_sink_next_rows()
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+int band_sink_commit(BandSink* sink, int row_count) {
+    sink->buffered_rows += row_count;
+    // Wiersz wyprzedzający może sam wypełnić ostatnie pasmo, stąd pętla
+    while (sink->band_y < sink->height && sink->buffered_rows >= band_sink_needed_rows(sink)) {
+        if (!process_band(sink)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Zwalnia bufor odbiornika pasm
+ * 
+ * @param sink Odbiornik pasm
+ */
+void band_sink_free(BandSink* sink) {
+    stats_free(sink->grayscale_data);
+    sink->grayscale_data = NULL;
+}
+
+/**
+ * @brief Konwertuje obraz BMP pasmami wierszy czytanymi wprost z pliku
+ * 
+ * @details Zamiast wczytywać cały obraz (który może przekraczać dostępną
+ * pamięć), odczytuje z pliku tyle wierszy, ile brakuje do pełnego pasma,
+ * konwertuje je do skali szarości i przekazuje do odbiornika pasm
+ * (band_sink_commit()), który wykonuje pozostałe etapy.
+ * 
+ * @param file Otwarty plik BMP (nagłówek już odczytany)
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny BMP (wysokość po normalize_bmp_height())
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * @param context Kontekst konwersji
+ * @param width Szerokość skali szarości (szerokość obrazu, także nieparzysta dla 4bpp)
+ * @param band_rows Wysokość pasma (wynik calculate_band_rows())
+ * @param gray_lut Tablica palety z read_bmp_gray_lut() lub NULL dla 24/32 bpp
+ * @param packed_data Bufor spakowanych danych całego obrazu (wyjściowy)
+ * @param stats Statystyki etapów (NULL = bez pomiaru)
+ * @param position Bieżąca pozycja w pliku (aktualizowana)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ * 
+ * @note BMP od dołu wymaga pliku z przewijaniem; BMP od góry może przyjść z potoku
+ * @note Tylko dane bez kompresji - wiersze RLE nie mają stałego położenia w pliku
+ * @note Szczytowe zużycie pamięci: (band_rows + 1) * (row_size + width)
+ *       bajtów ponad packed_data
+ */
+int convert_bmp_banded(FILE* file, BMPHeader* header, BMPInfoHeader* info, int top_down, ConversionContext* context, int width, int band_rows, const uchar* gray_lut, uchar* packed_data, ConversionStats* stats, unsigned long long* position) {
+    int height = (int)info->height;
+    size_t row_size = calculate_bmp_row_size(info->width, info->bits_per_pixel);
+    
+    BandSink sink;
+    if (!band_sink_init(&sink, context, width, height, band_rows, packed_data, stats)) {
+        return 0;
+    }
+    uchar* file_rows = (uchar*)stats_malloc((size_t)(band_rows + 1) * row_size);
+    if (!file_rows) {
+        printf("Error: Cannot allocate memory for image band\n");
+        band_sink_free(&sink);
+        return 0;
+    }
+    
+    int result = 1;
+    int loaded_rows = 0; // Wiersze obrazu już przekazane do odbiornika
+    while (loaded_rows < height && result) {
+        int new_rows;
+        uchar* new_grayscale = band_sink_next_rows(&sink, &new_rows);
+        
+        // Wiersze obrazu loaded_rows..loaded_rows+new_rows-1 leżą w pliku w jednym ciągłym bloku
+        // (dla BMP od góry pasma są czytane po kolei od początku pliku)
+        size_t first_file_row = top_down ? (size_t)loaded_rows : (size_t)(height - loaded_rows - new_rows);
+        double stage_start = stats_stage_begin();
+        if (!read_bmp_rows(file, file_rows, row_size, header->data_offset, first_file_row, (size_t)new_rows, position)) {
+            printf("Error: Cannot read image data\n");
+            result = 0;
+            break;
+        }
+        stats_stage_end(stats, STATS_STAGE_PIXEL_READ, stage_start);
+        
+        stage_start = stats_stage_begin();
+        ImageRowView view;
+        make_bmp_row_view(&view, file_rows, info->width, new_rows, info->bits_per_pixel, top_down);
+        result = convert_band_rows(&view, new_grayscale, width, context->bits_per_pixel, gray_lut);
+        stats_stage_end(stats, STATS_STAGE_GRAYSCALE, stage_start);
+        if (!result) {
+            printf("Error: Failed to convert image band at row %d\n", loaded_rows);
+            break;
+        }
+        
+        result = band_sink_commit(&sink, new_rows);
+        loaded_rows += new_rows;
+    }
+    
+    stats_free(file_rows);
+    band_sink_free(&sink);
+    return result;
+}
+
+// Fragment wierszy pliku BMP pokrywający kolumny wycinka
+typedef struct {
+    int x;                 // Wycinek w pikselach obrazu
+    int y;
+    int width;
+    int height;
+    size_t first_byte;     // Pierwszy bajt wycinka w wierszu pliku
+    size_t byte_count;     // Bajty wycinka w wierszu pliku
+    int lead;              // Piksele przed x w pierwszym bajcie (1 i 4 bpp)
+    int full_rows;         // 1 = wycinek na całą szerokość (ciągłe wiersze pliku)
+} BmpRowSpan;
+
+static void make_bmp_row_span(BmpRowSpan* span, BMPInfoHeader* info, const CropRect* crop) {
+    int bits_per_pixel = info->bits_per_pixel;
+    span->x = crop ? crop->x : 0;
+    span->y = crop ? crop->y : 0;
+    span->width = crop ? crop->width : (int)info->width;
+    span->height = crop ? crop->height : (int)info->height;
+    span->first_byte = (size_t)span->x * bits_per_pixel / 8;
+    span->byte_count = ((size_t)(span->x + span->width) * bits_per_pixel + 7) / 8 - span->first_byte;
+    span->lead = (bits_per_pixel < 8) ? span->x % (8 / bits_per_pixel) : 0;
+    span->full_rows = (span->x == 0 && span->width == (int)info->width);
+}
+
+/**
+ * @brief Oblicza pamięć dekodowania BMP wiersz po wierszu (decode_bmp_rows())
+ * 
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny BMP (wysokość po normalize_bmp_height())
+ * @param crop Wycinek (NULL = cały obraz)
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * @param seekable 1 jeśli plik pozwala na skoki wstecz (input_is_seekable())
+ * 
+ * @return Rozmiar buforów w bajtach lub 0 gdy rozmiaru nie da się ustalić
+ */
+size_t calculate_bmp_decoder_memory(BMPHeader* header, BMPInfoHeader* info, const CropRect* crop, int top_down, int seekable) {
+    size_t row_size = calculate_bmp_row_size(info->width, info->bits_per_pixel);
+    size_t data_size, pixel_count;
+    BmpRowSpan span;
+    make_bmp_row_span(&span, info, crop);
+
+    if (info->compression != BMP_COMPRESSION_NONE) {
+        data_size = calculate_rle_data_size(header, info);
+        if (data_size == 0 || !size_multiply((size_t)info->width, info->height, &pixel_count) || data_size > (size_t)-1 - pixel_count) {
+            return 0;
+        }
+        return data_size + pixel_count;
+    }
+    if (!top_down && !seekable) {
+        if (!size_multiply(row_size, (size_t)span.height, &data_size)) {
+            return 0;
+        }
+    } else {
+        data_size = BMP_STREAM_ROWS * (span.full_rows ? row_size : span.byte_count);
+    }
+    return data_size + BMP_STREAM_ROWS * (size_t)(span.lead + span.width);
+}
+
+/**
+ * @brief Dekoduje obraz BMP (lub jego wycinek) wiersz po wierszu do skali szarości 0-255
+ * 
+ * @details Odpowiednik decode_png_rows() dla BMP: wiersze pliku są czytane
+ * porcjami po BMP_STREAM_ROWS, konwertowane do skali szarości i przekazywane
+ * odbiorcy od góry obrazu. Bufory mają stały rozmiar, więc odbiorca (np.
+ * skalowanie --resize) nie wymaga klatki skali szarości w pełnej
+ * rozdzielczości.
+ * 
+ * Dla wycinka (--crop) położenie każdego potrzebnego wiersza jest liczone
+ * z data_offset i rozmiaru wiersza, a z wiersza czytane są tylko bajty
+ * kolumn wycinka - reszta pliku jest przeskakiwana. Wiersze odbiorcy są
+ * numerowane od górnego wiersza wycinka.
+ * 
+ * @param file Otwarty plik BMP (nagłówek i paleta już odczytane)
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny BMP (wysokość po normalize_bmp_height())
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * @param gray_lut Tablica palety 0-255 z read_bmp_gray_lut() lub NULL dla 24/32 bpp
+ * @param crop Wycinek mieszczący się w obrazie (NULL = cały obraz)
+ * @param row_callback Odbiorca wierszy
+ * @param callback_arg Argument odbiorcy
+ * @param position Bieżąca pozycja w pliku (aktualizowana)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu lub przerwania przez odbiorcę
+ * 
+ * @note RLE nie ma stałego położenia wierszy - strumień jest dekodowany
+ *       w całości do skali szarości źródła, a z BMP od dołu z potoku jest
+ *       wczytywany jednym blokiem cały zakres wierszy wycinka (skoki wstecz
+ *       są niemożliwe)
+ */
+int decode_bmp_rows(FILE* file, BMPHeader* header, BMPInfoHeader* info, int top_down, const uchar* gray_lut, const CropRect* crop,
+                    ImageRowCallback row_callback, void* callback_arg, unsigned long long* position) {
+    int image_width = (int)info->width;
+    int image_height = (int)info->height;
+    size_t row_size = calculate_bmp_row_size(info->width, info->bits_per_pixel);
+    BmpRowSpan span;
+    make_bmp_row_span(&span, info, crop);
+    int result = 1;
+
+    if (info->compression != BMP_COMPRESSION_NONE) {
+        size_t data_size = calculate_rle_data_size(header, info);
+        uchar* data = (uchar*)stats_malloc(data_size);
+        uchar* grayscale_data = (uchar*)stats_malloc((size_t)image_width * image_height);
+        if (!data || !grayscale_data) {
+            printf("Error: Cannot allocate memory for image data\n");
+            result = 0;
+        } else if (!read_bmp_image_data(file, data, data_size, header->data_offset, position) ||
+                   !decode_bmp_rle(data, data_size, grayscale_data, image_width, image_height, image_width, info->compression, gray_lut)) {
+            printf("Error: Cannot read image data\n");
+            result = 0;
+        }
+        stats_free(data);
+        for (int y = 0; y < span.height && result; y++) {
+            result = row_callback(callback_arg, y, grayscale_data + (size_t)(span.y + y) * image_width + span.x);
+        }
+        stats_free(grayscale_data);
+        return result;
+    }
+
+    // BMP od dołu z potoku: jeden blok wierszy wycinka, dalej porcje są tylko widokami na niego
+    int whole = !top_down && !input_is_seekable(file);
+    size_t file_rows_size = whole ? row_size * span.height : BMP_STREAM_ROWS * (span.full_rows ? row_size : span.byte_count);
+    int view_width = span.lead + span.width;
+    uchar* file_rows = (uchar*)stats_malloc(file_rows_size);
+    uchar* grayscale_rows = (uchar*)stats_malloc((size_t)BMP_STREAM_ROWS * view_width);
+    if (!file_rows || !grayscale_rows) {
+        printf("Error: Cannot allocate memory for image data\n");
+        stats_free(file_rows);
+        stats_free(grayscale_rows);
+        return 0;
+    }
+    if (whole && !read_bmp_rows(file, file_rows, row_size, header->data_offset, (size_t)(image_height - span.y - span.height), (size_t)span.height, position)) {
+        printf("Error: Cannot read image data\n");
+        result = 0;
+    }
+
+    for (int y = 0; y < span.height && result; y += BMP_STREAM_ROWS) {
+        int rows = (span.height - y < BMP_STREAM_ROWS) ? span.height - y : BMP_STREAM_ROWS;
+        int image_y = span.y + y;
+        size_t first_file_row = top_down ? (size_t)image_y : (size_t)(image_height - image_y - rows);
+        ImageRowView view;
+
+        if (whole || span.full_rows) {
+            // Ciągłe wiersze pliku - widok przesunięty do pierwszego bajtu wycinka
+            uchar* chunk = whole ? file_rows + (size_t)(span.height - y - rows) * row_size : file_rows;
+            if (!whole && !read_bmp_rows(file, file_rows, row_size, header->data_offset, first_file_row, (size_t)rows, position)) {
+                printf("Error: Cannot read image data\n");
+                result = 0;
+                break;
+            }
+            make_bmp_row_view(&view, chunk, info->width, rows, info->bits_per_pixel, top_down);
+            view.first_row += span.first_byte;
+            view.width = view_width;
+        } else {
+            // Tylko bajty kolumn wycinka, w kolejności pliku; w buforze wiersze idą od góry
+            for (int r = 0; r < rows; r++) {
+                size_t file_row = first_file_row + r;
+                int buffer_row = top_down ? r : rows - 1 - r;
+                if (!read_bmp_row_bytes(file, file_rows + (size_t)buffer_row * span.byte_count, row_size, header->data_offset,
+                                        file_row, span.first_byte, span.byte_count, position)) {
+                    printf("Error: Cannot read image data\n");
+                    result = 0;
+                    break;
+                }
+            }
+            view.first_row = file_rows;
+            view.stride = (ptrdiff_t)span.byte_count;
+            view.width = view_width;
+            view.height = rows;
+            view.bits_per_pixel = info->bits_per_pixel;
+        }
+        if (!result) {
+            break;
+        }
+
+        if (!convert_band_rows(&view, grayscale_rows, view_width, BITS_PER_PIXEL_8BPP, gray_lut)) {
+            printf("Error: Failed to convert image rows at row %d\n", image_y);
+            result = 0;
+            break;
+        }
+        for (int r = 0; r < rows && result; r++) {
+            result = row_callback(callback_arg, y + r, grayscale_rows + (size_t)r * view_width + span.lead);
+        }
+    }
+
+    stats_free(file_rows);
+    stats_free(grayscale_rows);
+    return result;
+}
@@ -0,0 +1,54 @@
+/*****************************************************************************
+
+    plik  : banded.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla przetwarzania obrazu pasmami wierszy (--max-mem)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef BANDED_H
+#define BANDED_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "defs.h"
+#include "bmp_defs.h"
+#include "stats.h"
+
+// Wysokość pasma jest wielokrotnością 8 - pasuje do bajtów skanowania pionowego 1bpp i 4bpp
+#define BAND_ROW_ALIGN 8
+
+// Porcja wierszy pliku czytana naraz przez decode_bmp_rows()
+#define BMP_STREAM_ROWS 16
+
+// Odbiornik wierszy skali szarości (od góry obrazu) przetwarzający je pasmami
+typedef struct {
+    ConversionContext* context;
+    int width;             // Szerokość skali szarości (odstęp wierszy bufora)
+    int height;            // Wysokość obrazu
+    int band_rows;         // Wysokość pasma
+    int lookahead;         // 1 = wiersz wyprzedzający Floyd-Steinberga
+    int band_y;            // Wiersz obrazu odpowiadający pierwszemu wierszowi bufora
+    int buffered_rows;     // Wiersze w buforze (z przeniesionym z poprzedniego pasma)
+    int adjusted_rows;     // Wiersze z wykonaną już regulacją jasności i kontrastu
+    uchar* grayscale_data; // Bufor pasma: (band_rows + 1) * width bajtów
+    uchar* packed_data;    // Spakowane dane całego obrazu
+    ConversionStats* stats;
+} BandSink;
+
+// Prototypy funkcji przetwarzania pasmami
+int band_sink_init(BandSink* sink, ConversionContext* context, int width, int height, int band_rows, uchar* packed_data, ConversionStats* stats);
+uchar* band_sink_next_rows(BandSink* sink, int* free_rows);
+int band_sink_commit(BandSink* sink, int row_count);
+void band_sink_free(BandSink* sink);
+int calculate_band_rows(size_t max_memory, size_t packed_size, size_t row_size, int width, int height);
+int convert_bmp_banded(FILE* file, BMPHeader* header, BMPInfoHeader* info, int top_down, ConversionContext* context, int width, int band_rows, const uchar* gray_lut, uchar* packed_data, ConversionStats* stats, unsigned long long* position);
+size_t calculate_bmp_decoder_memory(BMPHeader* header, BMPInfoHeader* info, const CropRect* crop, int top_down, int seekable);
+int decode_bmp_rows(FILE* file, BMPHeader* header, BMPInfoHeader* info, int top_down, const uchar* gray_lut, const CropRect* crop,
+                    ImageRowCallback row_callback, void* callback_arg, unsigned long long* position);
+
+#endif
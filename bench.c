@@ -0,0 +1,556 @@
+/*****************************************************************************
+
+    plik  : bench.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : mikrobenchmarki wszystkich etapów konwersji (skala szarości,
+            jasność/kontrast, dithering, pakowanie, zapis, podgląd BMP)
+
+    licencja : MIT
+*****************************************************************************/
+
+#define _CRT_SECURE_NO_DEPRECATE
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "utils.h"
+#include "bmp_reader.h"
+#include "bmp_writer.h"
+#include "bmp_palette.h"
+#include "color.h"
+#include "display_layout.h"
+#include "resize.h"
+#include "timing.h"
+
+#define BENCH_PREVIEW_PATH "bench_preview.tmp.bmp"
+#define BENCH_MAX_REPETITIONS 1000
+
+// Dane wspólne dla wszystkich kerneli przy danym rozmiarze obrazu
+typedef struct {
+    int width;                 // Szerokość obrazu
+    int height;                // Wysokość obrazu
+    int row_size;              // Rozmiar wiersza BMP (z dopełnieniem)
+    uchar* image_data;         // Syntetyczny obraz BGR 24-bit (od dołu do góry)
+    ImageRowView view;         // Widok wierszy image_data
+    uchar* gray_source;        // Wzorcowa skala szarości 0-255 (nie modyfikowana)
+    uchar* gray_work;          // Bufor roboczy kerneli modyfikujących dane w miejscu
+    uchar* gray_4bpp;          // Piksele 0-15 dla pakowania 4bpp
+    uchar* gray_1bpp;          // Piksele 0/1 dla pakowania 1bpp
+    uchar* packed_1bpp;        // Spakowane dane 1bpp (wejście zapisywaczy 1bpp)
+    uchar* packed_4bpp;        // Spakowane dane 4bpp (wejście zapisywaczy 4bpp)
+    uchar* packed_work;        // Bufor wyjściowy kerneli pakujących
+    uchar* packed_color;       // Bufor wyjściowy pakowania kolorowego (2 bajty na piksel)
+    int packed_1bpp_size;      // Rozmiar danych 1bpp (poziomo)
+    int packed_4bpp_size;      // Rozmiar danych 4bpp (poziomo)
+    FILE* sink;                // Plik tymczasowy dla zapisywaczy formatów
+} BenchData;
+
+// Opis pojedynczego kernela
+typedef struct {
+    const char* name;                    // Nazwa kernela (stała w wynikach)
+    void (*prepare)(BenchData* data);    // Przygotowanie danych (poza pomiarem czasu)
+    int (*run)(BenchData* data);         // Mierzony kernel
+    double (*bytes)(BenchData* data);    // Liczba przetwarzanych bajtów wejściowych
+} BenchKernel;
+
+// Wynik pomiaru jednego kernela dla jednego rozmiaru
+typedef struct {
+    double min_ns;
+    double median_ns;
+    double ns_per_pixel;
+    double mb_per_s;
+} BenchResult;
+
+// ============================================================================
+// Przygotowanie danych
+// ============================================================================
+
+static void reset_gray_work(BenchData* data) {
+    memcpy(data->gray_work, data->gray_source, (size_t)data->width * data->height);
+}
+
+static void rewind_sink(BenchData* data) {
+    rewind(data->sink);
+}
+
+static double bytes_bgr(BenchData* data) {
+    return (double)data->row_size * data->height;
+}
+
+static double bytes_gray(BenchData* data) {
+    return (double)data->width * data->height;
+}
+
+static double bytes_packed_1bpp(BenchData* data) {
+    return (double)data->packed_1bpp_size;
+}
+
+static double bytes_packed_4bpp(BenchData* data) {
+    return (double)data->packed_4bpp_size;
+}
+
+/**
+ * @brief Generuje syntetyczny obraz testowy w formacie BMP 24-bit
+ *
+ * @details Obraz zawiera gradienty w trzech kanałach i deterministyczny szum
+ * (generator LCG), dzięki czemu dithering i progowanie pracują na realistycznych
+ * danych, a wyniki są powtarzalne między uruchomieniami.
+ *
+ * @param data Struktura BenchData z ustawionymi wymiarami i zaalokowanym image_data
+ */
+static void generate_synthetic_image(BenchData* data) {
+    unsigned int seed = 0x12345678u;
+    for (int y = 0; y < data->height; y++) {
+        uchar* row = data->image_data + (size_t)y * data->row_size;
+        for (int x = 0; x < data->width; x++) {
+            seed = seed * 1103515245u + 12345u;
+            int noise = (int)((seed >> 16) & 0x3F) - 32;
+            int base = (x * 255) / (data->width > 1 ? data->width - 1 : 1);
+            int value = base + noise;
+            row[x * 3 + 0] = (uchar)((value < 0) ? 0 : (value > 255) ? 255 : value);
+            row[x * 3 + 1] = (uchar)((y * 255) / (data->height > 1 ? data->height - 1 : 1));
+            row[x * 3 + 2] = (uchar)((x ^ y) & 0xFF);
+        }
+        memset(row + data->width * 3, 0, data->row_size - data->width * 3);
+    }
+}
+
+static void free_bench_data(BenchData* data) {
+    free(data->image_data);
+    free(data->gray_source);
+    free(data->gray_work);
+    free(data->gray_4bpp);
+    free(data->gray_1bpp);
+    free(data->packed_1bpp);
+    free(data->packed_4bpp);
+    free(data->packed_work);
+    free(data->packed_color);
+    if (data->sink) {
+        fclose(data->sink);
+    }
+    memset(data, 0, sizeof(*data));
+}
+
+/**
+ * @brief Alokuje i wypełnia wszystkie bufory dla danego rozmiaru obrazu
+ *
+ * @param data Struktura BenchData (wyjściowa)
+ * @param width Szerokość obrazu (parzysta)
+ * @param height Wysokość obrazu
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu alokacji
+ */
+static int init_bench_data(BenchData* data, int width, int height) {
+    size_t pixels = (size_t)width * height;
+
+    memset(data, 0, sizeof(*data));
+    data->width = width;
+    data->height = height;
+    data->row_size = calculate_bmp_row_size(width, 24);
+    data->image_data = (uchar*)malloc((size_t)data->row_size * height);
+    data->gray_source = (uchar*)malloc(pixels);
+    data->gray_work = (uchar*)malloc(pixels);
+    data->gray_4bpp = (uchar*)malloc(pixels);
+    data->gray_1bpp = (uchar*)malloc(pixels);
+    // Bufory spakowane z zapasem - pakowanie pionowe zaokrągla wysokość kolumny
+    data->packed_1bpp = (uchar*)malloc(pixels / 2 + width + height);
+    data->packed_4bpp = (uchar*)malloc(pixels / 2 + width + height);
+    data->packed_work = (uchar*)malloc(pixels / 2 + width + height);
+    data->packed_color = (uchar*)malloc(pixels * 2);
+    data->sink = tmpfile();
+
+    if (!data->image_data || !data->gray_source || !data->gray_work || !data->gray_4bpp ||
+        !data->gray_1bpp || !data->packed_1bpp || !data->packed_4bpp || !data->packed_work || !data->packed_color || !data->sink) {
+        free_bench_data(data);
+        return 0;
+    }
+
+    generate_synthetic_image(data);
+
+    // Dane wejściowe kolejnych etapów liczone raz, poza pomiarem
+    for (int y = 0; y < height; y++) {
+        const uchar* row = data->image_data + (size_t)(height - 1 - y) * data->row_size;
+        for (int x = 0; x < width; x++) {
+            data->gray_source[(size_t)y * width + x] = (uchar)convert_rgb_to_grayscale(row[x * 3 + 2], row[x * 3 + 1], row[x * 3]);
+        }
+    }
+    make_bmp_row_view(&data->view, data->image_data, width, height, 24, 0);
+    convert_to_grayscale_1bpp(&data->view, data->gray_1bpp, DITHERING_NONE, 50, 50);
+    convert_to_grayscale_4bpp(&data->view, data->gray_4bpp, width);
+    pack_pixels_1bpp(data->gray_1bpp, data->packed_1bpp, width, height, 1, 1);
+    pack_pixels_4bpp(data->gray_4bpp, data->packed_4bpp, width, height, 1, 1);
+    data->packed_1bpp_size = ((width + 7) / 8) * height;
+    data->packed_4bpp_size = ((width + 1) / 2) * height;
+
+    return 1;
+}
+
+// ============================================================================
+// Kernele
+// ============================================================================
+
+static int run_grayscale_4bpp(BenchData* d) {
+    return convert_to_grayscale_4bpp(&d->view, d->gray_work, d->width);
+}
+
+static int run_grayscale_1bpp(BenchData* d) {
+    return convert_to_grayscale_1bpp(&d->view, d->gray_work, DITHERING_NONE, 50, 50);
+}
+
+static int run_brightness_contrast(BenchData* d) {
+    return adjust_brightness_contrast(d->gray_work, d->width, d->height, 60, 70);
+}
+
+static int run_floyd(BenchData* d) {
+    return apply_floyd_steinberg_dithering(d->gray_work, d->width, d->height);
+}
+
+static int run_ordered(BenchData* d) {
+    return apply_ordered_dithering(d->gray_work, d->width, d->height);
+}
+
+static int run_ordered_4bpp(BenchData* d) {
+    return apply_ordered_dithering_band(d->gray_work, d->width, d->height, 0, DITHERING_ORDERED, BPP_LEVELS(BITS_PER_PIXEL_4BPP)) &&
+           quantize_to_bpp(d->gray_work, d->width, d->height, BITS_PER_PIXEL_4BPP);
+}
+
+static int run_blue_noise(BenchData* d) {
+    return apply_blue_noise_dithering_band(d->gray_work, d->width, d->height, 0, 2);
+}
+
+// Odbiorca wierszy skalowania - zapis do gray_work z odstępem szerokości celu
+static int store_resized_row(void* arg, int y, const uchar* gray_row) {
+    BenchData* d = (BenchData*)arg;
+    int resized_width = (d->width + 3) / 4;
+    memcpy(d->gray_work + (size_t)y * resized_width, gray_row, resized_width);
+    return 1;
+}
+
+static int run_resize_lanczos(BenchData* d) {
+    Resampler resampler;
+    if (!resampler_init(&resampler, d->width, d->height, (d->width + 3) / 4, (d->height + 3) / 4, RESIZE_FILTER_LANCZOS, store_resized_row, d)) {
+        return 0;
+    }
+    int result = 1;
+    for (int y = 0; y < d->height && result; y++) {
+        result = resampler_push_row(&resampler, y, d->gray_source + (size_t)y * d->width);
+    }
+    resampler_free(&resampler);
+    return result;
+}
+
+static int run_pack_1bpp_h(BenchData* d) {
+    return pack_pixels_1bpp(d->gray_1bpp, d->packed_work, d->width, d->height, 1, 1);
+}
+
+static int run_pack_1bpp_v(BenchData* d) {
+    return pack_pixels_1bpp(d->gray_1bpp, d->packed_work, d->width, d->height, 0, 1);
+}
+
+static int run_pack_4bpp_h(BenchData* d) {
+    return pack_pixels_4bpp(d->gray_4bpp, d->packed_work, d->width, d->height, 1, 1);
+}
+
+static int run_pack_4bpp_v(BenchData* d) {
+    return pack_pixels_4bpp(d->gray_4bpp, d->packed_work, d->width, d->height, 0, 1);
+}
+
+static int run_pack_layout_ssd1306(BenchData* d) {
+    return pack_layout(d->gray_1bpp, d->packed_work, d->width, d->height, DISPLAY_LAYOUT_SSD1306, PAGE_COMMANDS_NONE, ORIENTATION_IDENTITY);
+}
+
+static int run_pack_rgb565_h(BenchData* d) {
+    return pack_color_pixels(&d->view, d->packed_color, COLOR_FORMAT_RGB565_BE, DITHERING_NONE, 1);
+}
+
+static int run_pack_rgb332_h(BenchData* d) {
+    return pack_color_pixels(&d->view, d->packed_color, COLOR_FORMAT_RGB332, DITHERING_NONE, 1);
+}
+
+static int run_format_c_array(BenchData* d) {
+    return format_c_array_write(d->packed_4bpp, d->packed_4bpp_size, d->width, d->height, "bench", d->sink, 0, 4, COLOR_FORMAT_NONE, DITHERING_NONE, 50, 50, 0, 0);
+}
+
+static int run_format_raw_data(BenchData* d) {
+    return format_raw_data_write(d->packed_4bpp, d->packed_4bpp_size, d->sink, 4, COLOR_FORMAT_NONE, DITHERING_NONE, 50, 50, 0);
+}
+
+static int run_format_assembler(BenchData* d) {
+    return format_assembler_write(d->packed_4bpp, d->packed_4bpp_size, d->width, d->height, "bench", d->sink, 4, COLOR_FORMAT_NONE, DITHERING_NONE, 50, 50, 0);
+}
+
+static int run_format_masm_array(BenchData* d) {
+    return format_masm_array_write(d->packed_4bpp, d->packed_4bpp_size, d->width, d->height, "bench", d->sink, 4, COLOR_FORMAT_NONE, DITHERING_NONE, 50, 50, 0);
+}
+
+static uchar bench_color_first[3] = {0, 0, 0};
+static uchar bench_color_last[3] = {255, 255, 255};
+
+static int run_preview_1bpp_h(BenchData* d) {
+    PreviewContext ctx = {d->width, d->height, BENCH_PREVIEW_PATH, PALETTE_BW, bench_color_first, bench_color_last, 1, 1};
+    return generate_1bpp_bmp(d->packed_1bpp, &ctx);
+}
+
+static int run_preview_4bpp_h(BenchData* d) {
+    PreviewContext ctx = {d->width, d->height, BENCH_PREVIEW_PATH, PALETTE_BW, bench_color_first, bench_color_last, 1, 1};
+    return generate_4bpp_bmp(d->packed_4bpp, &ctx);
+}
+
+// Pakowanie pionowe do podglądu jest wykonywane w prepare, poza pomiarem
+static void prepare_preview_1bpp_v(BenchData* d) { pack_pixels_1bpp(d->gray_1bpp, d->packed_work, d->width, d->height, 0, 1); }
+static void prepare_preview_4bpp_v(BenchData* d) { pack_pixels_4bpp(d->gray_4bpp, d->packed_work, d->width, d->height, 0, 1); }
+
+static int run_preview_1bpp_v(BenchData* d) {
+    PreviewContext ctx = {d->width, d->height, BENCH_PREVIEW_PATH, PALETTE_BW, bench_color_first, bench_color_last, 0, 1};
+    return generate_1bpp_bmp(d->packed_work, &ctx);
+}
+
+static int run_preview_4bpp_v(BenchData* d) {
+    PreviewContext ctx = {d->width, d->height, BENCH_PREVIEW_PATH, PALETTE_BW, bench_color_first, bench_color_last, 0, 1};
+    return generate_4bpp_bmp(d->packed_work, &ctx);
+}
+
+static const BenchKernel bench_kernels[] = {
+    {"convert_to_grayscale_4bpp",  NULL,                   run_grayscale_4bpp,       bytes_bgr},
+    {"convert_to_grayscale_1bpp",  NULL,                   run_grayscale_1bpp,       bytes_bgr},
+    {"adjust_brightness_contrast", reset_gray_work,        run_brightness_contrast,  bytes_gray},
+    {"dither_floyd_steinberg",     reset_gray_work,        run_floyd,                bytes_gray},
+    {"dither_ordered",             reset_gray_work,        run_ordered,              bytes_gray},
+    {"dither_ordered_4bpp",        reset_gray_work,        run_ordered_4bpp,         bytes_gray},
+    {"dither_blue_noise",          reset_gray_work,        run_blue_noise,           bytes_gray},
+    {"resize_lanczos_quarter",     NULL,                   run_resize_lanczos,       bytes_gray},
+    {"pack_pixels_1bpp_h",         NULL,                   run_pack_1bpp_h,          bytes_gray},
+    {"pack_pixels_1bpp_v",         NULL,                   run_pack_1bpp_v,          bytes_gray},
+    {"pack_pixels_4bpp_h",         NULL,                   run_pack_4bpp_h,          bytes_gray},
+    {"pack_pixels_4bpp_v",         NULL,                   run_pack_4bpp_v,          bytes_gray},
+    {"pack_layout_ssd1306",        NULL,                   run_pack_layout_ssd1306,  bytes_gray},
+    {"pack_color_rgb565_h",        NULL,                   run_pack_rgb565_h,        bytes_bgr},
+    {"pack_color_rgb332_h",        NULL,                   run_pack_rgb332_h,        bytes_bgr},
+    {"format_c_array_write",       rewind_sink,            run_format_c_array,       bytes_packed_4bpp},
+    {"format_raw_data_write",      rewind_sink,            run_format_raw_data,      bytes_packed_4bpp},
+    {"format_assembler_write",     rewind_sink,            run_format_assembler,     bytes_packed_4bpp},
+    {"format_masm_array_write",    rewind_sink,            run_format_masm_array,    bytes_packed_4bpp},
+    {"generate_1bpp_bmp_h",        NULL,                   run_preview_1bpp_h,       bytes_packed_1bpp},
+    {"generate_1bpp_bmp_v",        prepare_preview_1bpp_v, run_preview_1bpp_v,       bytes_packed_1bpp},
+    {"generate_4bpp_bmp_h",        NULL,                   run_preview_4bpp_h,       bytes_packed_4bpp},
+    {"generate_4bpp_bmp_v",        prepare_preview_4bpp_v, run_preview_4bpp_v,       bytes_packed_4bpp},
+};
+
+#define BENCH_KERNEL_COUNT ((int)(sizeof(bench_kernels) / sizeof(bench_kernels[0])))
+
+// Domyślne rozmiary: od małych wyświetlaczy OLED do 16k x 16k
+static const int bench_sizes[][2] = {
+    {128, 64},
+    {256, 64},
+    {1024, 768},
+    {4096, 4096},
+    {16384, 16384},
+};
+
+#define BENCH_SIZE_COUNT ((int)(sizeof(bench_sizes) / sizeof(bench_sizes[0])))
+
+// ============================================================================
+// Pomiar
+// ============================================================================
+
+static int compare_double(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+/**
+ * @brief Mierzy czas wykonania kernela z rozgrzewką i powtórzeniami
+ *
+ * @details Każde powtórzenie wywołuje najpierw prepare() (poza pomiarem),
+ * a następnie mierzy pojedyncze wywołanie run(). Wynikiem jest minimum
+ * i mediana czasów powtórzeń oraz przeliczenia na ns/piksel i MB/s (wg mediany).
+ *
+ * @param kernel Opis kernela
+ * @param data Dane wejściowe dla bieżącego rozmiaru
+ * @param warmup Liczba przebiegów rozgrzewających (nie mierzonych)
+ * @param repetitions Liczba mierzonych powtórzeń
+ * @param result Wynik pomiaru (wyjściowy)
+ *
+ * @return 1 w przypadku sukcesu, 0 jeśli kernel zwrócił błąd
+ */
+static int measure_kernel(const BenchKernel* kernel, BenchData* data, int warmup, int repetitions, BenchResult* result) {
+    double samples[BENCH_MAX_REPETITIONS];
+
+    for (int i = 0; i < warmup; i++) {
+        if (kernel->prepare) kernel->prepare(data);
+        if (!kernel->run(data)) return 0;
+    }
+
+    for (int i = 0; i < repetitions; i++) {
+        if (kernel->prepare) kernel->prepare(data);
+        double start = timing_now_ns();
+        if (!kernel->run(data)) return 0;
+        samples[i] = timing_now_ns() - start;
+    }
+
+    qsort(samples, repetitions, sizeof(double), compare_double);
+    result->min_ns = samples[0];
+    result->median_ns = (repetitions % 2) ? samples[repetitions / 2]
+                                          : (samples[repetitions / 2 - 1] + samples[repetitions / 2]) / 2.0;
+    result->ns_per_pixel = result->median_ns / ((double)data->width * data->height);
+    result->mb_per_s = (result->median_ns > 0) ? kernel->bytes(data) / (result->median_ns / 1e9) / 1e6 : 0.0;
+    return 1;
+}
+
+static void print_bench_usage(const char* program_name) {
+    printf("Usage: %s [OPTIONS]\n", program_name);
+    printf("\n");
+    printf("Benchmarks every conversion kernel on synthetic images (128x64 .. 16384x16384).\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  -w, --warmup N       Warmup runs per kernel (default: 1)\n");
+    printf("  -r, --repetitions N  Measured runs per kernel (default: 5, max: %d)\n", BENCH_MAX_REPETITIONS);
+    printf("  -k, --kernel NAME    Run only kernels whose name contains NAME\n");
+    printf("  --max-pixels N       Skip image sizes with more than N pixels\n");
+    printf("  --quick              Same as --max-pixels 1048576\n");
+    printf("  --csv FILE           Write results as CSV\n");
+    printf("  --json FILE          Write results as JSON\n");
+    printf("  --help               Show this help message\n");
+}
+
+/**
+ * @brief Główna funkcja programu benchmarkującego
+ *
+ * @details Dla każdego rozmiaru z listy bench_sizes generuje syntetyczny obraz,
+ * mierzy wszystkie kernele i wypisuje tabelę wyników. Opcjonalnie zapisuje
+ * wyniki w formacie CSV i/lub JSON do śledzenia regresji wydajności.
+ *
+ * @example
+ * ```bash
+ * make bench
+ * ./bench_xbpp --quick --json bench.json
+ * ./bench_xbpp -k pack -r 20 --csv pack.csv
+ * ```
+ */
+int main(int argc, char* argv[]) {
+    int warmup = 1;
+    int repetitions = 5;
+    double max_pixels = 0;
+    const char* kernel_filter = NULL;
+    const char* csv_path = NULL;
+    const char* json_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--warmup") == 0) && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--repetitions") == 0) && i + 1 < argc) {
+            repetitions = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "-k") == 0 || strcmp(argv[i], "--kernel") == 0) && i + 1 < argc) {
+            kernel_filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-pixels") == 0 && i + 1 < argc) {
+            max_pixels = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            max_pixels = 1024.0 * 1024.0;
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            print_bench_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (warmup < 0 || repetitions < 1 || repetitions > BENCH_MAX_REPETITIONS) {
+        printf("Error: Invalid warmup/repetitions value\n");
+        return 1;
+    }
+
+    FILE* csv = NULL;
+    FILE* json = NULL;
+    if (csv_path && !(csv = fopen(csv_path, "w"))) {
+        printf("Error: Cannot open %s\n", csv_path);
+        return 1;
+    }
+    if (json_path && !(json = fopen(json_path, "w"))) {
+        printf("Error: Cannot open %s\n", json_path);
+        if (csv) fclose(csv);
+        return 1;
+    }
+
+    printf("BMP to xbpp kernel benchmark %s (warmup: %d, repetitions: %d)\n\n", VERSION_STRING, warmup, repetitions);
+    printf("%-28s %13s %14s %14s %12s %10s\n", "kernel", "size", "min [ms]", "median [ms]", "ns/pixel", "MB/s");
+
+    if (csv) {
+        fprintf(csv, "kernel,width,height,pixels,warmup,repetitions,min_ns,median_ns,ns_per_pixel,mb_per_s\n");
+    }
+    if (json) {
+        fprintf(json, "{\n  \"version\": \"%s\",\n  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"results\": [", VERSION_STRING, warmup, repetitions);
+    }
+
+    int first_json_entry = 1;
+    int exit_code = 0;
+
+    for (int s = 0; s < BENCH_SIZE_COUNT; s++) {
+        int width = bench_sizes[s][0];
+        int height = bench_sizes[s][1];
+        if (max_pixels > 0 && (double)width * height > max_pixels) {
+            continue;
+        }
+
+        BenchData data;
+        if (!init_bench_data(&data, width, height)) {
+            printf("Warning: Cannot allocate buffers for %dx%d, skipping\n", width, height);
+            continue;
+        }
+
+        char size_label[32];
+        snprintf(size_label, sizeof(size_label), "%dx%d", width, height);
+
+        for (int k = 0; k < BENCH_KERNEL_COUNT; k++) {
+            const BenchKernel* kernel = &bench_kernels[k];
+            if (kernel_filter && !strstr(kernel->name, kernel_filter)) {
+                continue;
+            }
+
+            BenchResult result;
+            if (!measure_kernel(kernel, &data, warmup, repetitions, &result)) {
+                printf("Error: Kernel %s failed for %s\n", kernel->name, size_label);
+                exit_code = 1;
+                continue;
+            }
+
+            printf("%-28s %13s %14.3f %14.3f %12.3f %10.1f\n", kernel->name, size_label,
+                   result.min_ns / 1e6, result.median_ns / 1e6, result.ns_per_pixel, result.mb_per_s);
+            fflush(stdout);
+
+            if (csv) {
+                fprintf(csv, "%s,%d,%d,%.0f,%d,%d,%.0f,%.0f,%.4f,%.2f\n", kernel->name, width, height,
+                        (double)width * height, warmup, repetitions,
+                        result.min_ns, result.median_ns, result.ns_per_pixel, result.mb_per_s);
+            }
+            if (json) {
+                fprintf(json, "%s\n    {\"kernel\": \"%s\", \"width\": %d, \"height\": %d, \"min_ns\": %.0f, "
+                        "\"median_ns\": %.0f, \"ns_per_pixel\": %.4f, \"mb_per_s\": %.2f}",
+                        first_json_entry ? "" : ",", kernel->name, width, height,
+                        result.min_ns, result.median_ns, result.ns_per_pixel, result.mb_per_s);
+                first_json_entry = 0;
+            }
+        }
+
+        free_bench_data(&data);
+    }
+
+    remove(BENCH_PREVIEW_PATH);
+
+    if (csv) {
+        fclose(csv);
+    }
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    return exit_code;
+}
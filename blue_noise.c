@@ -0,0 +1,82 @@
+/*****************************************************************************
+
+    plik  : blue_noise.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : tekstura progów blue noise 64x64 dla ditheringu -d blue
+            (wygenerowana przez scripts/generate_blue_noise.py - nie edytować)
+
+    licencja : MIT
+*****************************************************************************/
+
+#include "blue_noise.h"
+
+// Void-and-cluster, filtr Gaussa sigma 1.5 na torusie; próg = ranga * 255 / 4096 (0-254)
+const uchar blue_noise_texture[BLUE_NOISE_SIZE][BLUE_NOISE_SIZE] = {
+    { 36, 132, 112, 170, 248,   2,  48, 133, 204, 161, 219,  13, 251,  36, 158, 206,   5,  70, 228,  52, 182, 218, 125,  67, 226,   6, 212,  86,  26, 145, 193, 112, 233,  42, 209,  76, 250, 122, 228, 182,  27, 235, 167, 123, 240,  13, 200, 250,  22, 219, 194,  86, 178, 208,  16, 242,  97,  42,  69, 232, 170,  10, 124,  69},
+    {227,   6, 217,  73, 102, 224, 192,  77,  18,  96,  56, 192, 141,  99, 220,  54, 248, 104,  21, 131, 161, 100,  42, 173, 111, 148,  57, 184, 238, 102,  47,  83, 182,  66, 126, 156,  46, 201,  65, 142, 197,  73,  36, 100,  66, 138, 173,  73, 102, 170,  60, 149, 105,  53, 137, 193, 170, 224, 121,  28, 101, 254, 191, 157},
+    {175,  52, 149, 184,  38, 140, 113, 168, 216, 125, 237,  80,  46, 182,  16, 124, 146, 168, 189, 240,  63,   1, 249, 193,  83, 243,  31, 127, 161,   1, 205, 140,  29, 222,   7, 188, 104,  23, 164,   2,  95, 128, 225, 180, 213,  28, 116,  49, 233, 133,  37, 245,  11, 223,  83,  34,  75,  14, 200, 155, 216,  59,  24,  82},
+    {105, 243,  86,  18, 210,  63,  25, 252,  43, 151,   5, 171, 116, 243,  89, 194,  28,  76,  41,  92, 214, 153, 130,  20,  50, 138, 197,  78, 225,  62, 116, 247, 162,  97, 147, 231,  79, 239, 116, 214, 254,  52, 151,   9,  88, 246, 191, 147,   7, 205,  81, 124, 201, 158, 112, 234, 144, 106, 179,  47,  85, 146, 119, 211},
+    { 16, 133, 201, 118, 232, 154, 180,  94,  70, 194, 104, 209,  26, 154,  64, 226, 110, 235, 205, 120,  26,  79, 232, 103, 208, 168,  15, 101,  37, 212, 177,  19,  74, 198,  35,  57, 136, 178,  41,  68, 137,  25, 203, 110, 162,  43,  79, 218,  98, 164,  25, 184,  66,  39, 181,   6, 207,  59, 247, 133,   3, 239, 165,  41},
+    {183,  63, 166,  43,  77, 106,   9, 228, 139,  30, 235,  68, 135, 218,   2, 171,  49, 153,   8, 141, 172, 189,  38, 159,  66, 230, 121, 241, 156, 135,  92,  52, 131, 240, 113, 217,  12, 208,  96, 156, 189,  84, 236,  60, 195, 134,  18, 175,  56, 249, 115, 231, 142,  96, 253, 129, 166,  92,  28, 212, 107, 196,  68, 230},
+    {114, 250,   0, 143, 240, 197,  56, 206, 119, 165,  51, 184,  95,  40, 200, 130,  87, 185,  69, 254,  97,  59, 213, 117,   4,  87,  46, 181,  71,   9, 196, 229, 167,   3, 183,  87, 160, 124,  29, 244,   7, 169, 122,  35, 220, 100, 234, 125,  31, 145,  89,   0,  54, 214,  20,  72,  46, 233, 151,  76, 176,  35, 137,  89},
+    { 29, 204, 100, 186,  26, 127, 157,  24,  75, 246,   8, 148, 229, 118,  70, 244,  17, 211, 113,  42, 197,  16, 139, 244, 175, 201, 146, 218,  32, 249, 118,  38, 104,  67, 141,  48, 235,  72, 196,  55, 103, 210,  71, 144,   2, 159,  67, 188, 212,  74, 224, 197, 157, 109, 174, 205, 120, 186,  10, 126,  56, 223,  12, 159},
+    { 54, 139,  75, 219,  51,  90, 178, 223, 103, 190, 115,  80,  17, 192, 164, 102, 143,  34, 227, 158, 125, 233,  78,  33,  97,  60,  18, 111,  89, 171, 145,  81, 219, 190, 252,  17, 177, 109, 144, 226, 131,  21, 239, 178,  89, 252,  48, 111,  15, 165,  45, 129,  29, 244,  84, 146,  34,  98, 214, 163, 245, 101, 187, 211},
+    {228, 177,  38, 163, 115, 248,   4, 137,  38,  58, 212, 173, 253,  53,  26, 220,  59, 168,  90,   1,  67, 170, 109, 187, 150, 211, 130, 238, 192,  48, 212,  14, 155,  31, 125,  95, 220,  38,  12, 183,  88, 159,  39, 111, 206,  25, 195, 151,  87, 245, 183,  97, 192,  58,  10, 223,  65, 249,  26,  82,  42, 143,  69, 122},
+    { 88, 112,  11, 231, 147,  66, 192,  84, 238, 151,  20, 133,  93, 157, 127, 195,  81, 248, 183, 135, 205,  49, 220,   8, 250,  43, 167,  75,   5, 133,  66, 234, 112,  55, 208, 163,  63, 152, 247,  70,  47, 219, 189,  60, 136,  78, 126, 219,  37, 122,   8,  71, 221, 116, 171, 130, 194, 158, 115, 203, 179,   4, 240,  22},
+    { 46, 252, 197,  85,  20, 210,  34, 166, 111, 198,  73, 218,  31,  66, 232,   6, 117,  45,  22, 105, 241,  29, 143,  68, 121,  87,  26, 222, 107, 158, 195,  91, 170, 244,  84,  23, 198, 120,  99, 207, 136, 106,  11, 245, 169, 226,   7, 176,  62, 160, 229, 132, 153,  40, 240,  90,  47,   6, 139,  61, 222, 106, 172, 151},
+    {188, 138,  60, 121, 182,  98, 126, 225,  11,  47, 172, 109, 240, 184, 100, 165, 215, 149, 224, 189,  79, 163,  96, 201, 172, 228, 138, 184,  46, 254,  19,  41, 131,   0, 186, 140,  47, 229,   5, 160,  27, 234, 151,  94,  33,  53, 106, 248,  91, 200,  53,  27, 210,  78,  17, 206, 109, 182, 239,  94,  33, 132,  78, 214},
+    {100,   1, 168, 223,  45, 242,  58, 147,  77, 249, 131,   1, 150,  43, 134,  20,  64,  92, 130,  58,  12, 124, 235,  52,  18, 105,  61, 206,  82, 120, 175, 202, 223,  72, 116, 217,  91, 174,  77, 194,  61, 180,  73, 124, 196, 156, 210, 141,  22, 111, 241, 175, 105, 188, 136, 164,  68, 213,  19, 161, 198, 232,  57,  29},
+    {123, 206,  79,  28, 157, 134,  16, 213, 186,  91, 209,  61, 194,  80, 210, 245, 172, 201,  36, 252, 174, 212,  33, 190, 150, 247,   4, 161,  30, 144,  64,  99, 151,  50, 166,  15, 243,  33, 134, 252, 119,  40, 217,   0, 232,  86,  16,  70, 193,  41, 146,  85,   0, 233,  56, 254,  33, 126,  81,  52, 112,   8, 156, 245},
+    { 66, 142, 239, 110, 198,  85, 178, 108,  32, 160,  18, 102, 227,  25,  96,  46, 113,   7, 155,  85, 104, 141,  70, 116,  83, 213, 126,  94, 237, 211,   9, 246,  29, 231, 105, 200,  64, 155, 101,  16, 202,  88, 168, 137,  62, 181, 120, 228, 171, 124, 214,  64, 158, 121,  20,  88, 152, 226, 178, 247, 138, 188,  93, 177},
+    { 18,  39, 172,  56,   7, 251,  68, 224,  51, 136, 238, 174, 126, 158, 190, 143, 234,  76, 221, 186,  46,   0, 244, 180,  22,  47, 193, 171,  44, 107, 184, 128,  85, 188, 141,  42, 119, 213, 185,  51, 145, 238,  24, 106, 249,  28, 149,  50,  83,  10, 251,  33, 194, 224, 171, 111, 195,   4, 101,  38, 216,  73,  44, 219},
+    {152, 227,  92, 209, 118, 142,  26, 168, 117, 200,  72,  36,  55, 253,  13,  62, 178, 132,  21, 116, 227, 198, 155,  97, 220, 147,  67,  11, 230,  72, 155,  53, 206,   7,  75, 173, 233,   3,  78, 227, 113,  65, 192, 157,  46, 208,  96, 239, 199, 161, 105, 135,  91,  43,  74, 216,  51, 143,  70, 170,  23, 127, 195, 109},
+    { 76, 124, 187,  30, 158, 216,  96, 234,   6,  88, 154, 220, 116,  84, 212, 106,  33, 207,  55, 167,  69, 128,  18,  58, 120, 241,  89, 137, 199, 120,  32, 239, 165, 102, 251,  23,  93, 134, 162,  36, 175,  10, 219,  80, 126, 188,   4, 114,  35,  67, 184,  17, 231, 147, 181,  29, 124, 233, 202, 114, 239, 155,  14, 253},
+    {169,   6,  61, 245,  78,  46, 189,  62, 140, 249,  27, 193,   3, 182, 129, 156, 242,  94, 147, 248,  31,  90, 235, 166,  27, 179, 208,  21, 160,  95, 217,  19, 136,  61, 214, 151, 198,  58, 246,  91, 209, 132, 101,  33, 229,  71, 170, 139, 217, 150, 237,  53, 204, 108,  12, 241,  81, 158,  11,  57,  83, 209,  98,  51},
+    {229, 206, 147, 100, 174,  14, 127, 206,  38, 176, 101, 131,  68, 237,  45,  18,  79, 196,   7, 107, 174, 214, 140, 194,  78,  42, 108,  62, 253,  50, 176,  79, 117, 185,  42, 109,  26, 181, 120,  15, 155,  52, 251, 177, 147,  20, 244,  51,  81,  24, 121,  87, 163,  64, 131, 197,  99,  37, 183, 225, 141,  40, 185, 135},
+    { 32, 112,  21, 222, 137, 240, 107, 162,  81, 221,  50, 205, 148,  96, 168, 218, 183,  49, 127, 223,  75,  45,   4, 103, 246, 152, 223, 127, 189,   1, 145, 234, 201,  14, 144, 241,  80, 219,  40, 234,  74, 199,   7, 113,  56,  89, 206, 108, 192, 224, 178,   2, 244,  33, 221, 168,  54, 251, 128, 104, 167,   2, 243,  69},
+    {157, 195,  82,  50, 200,  68,  31, 229,  10, 121, 158,  17, 226,  31, 119,  65, 138, 236, 160,  23, 186, 122, 207,  55, 132,  11, 174,  32,  84, 215, 105,  34,  57,  95, 222,  65, 161, 130,  99, 177, 139,  94, 159, 215, 187, 125, 163,   8, 135,  39,  97, 145, 199, 115,  77,   6, 148, 192,  16,  49,  77, 202, 119,  95},
+    { 57, 249, 168, 122,   3, 182,  90, 146, 188,  70, 245,  91,  60, 180, 241,   9, 104,  34,  90,  60, 253, 150,  86, 163, 218,  72,  97, 237, 156,  65, 132, 167, 249, 183, 127,   3, 200,  21, 210,  61,  27, 227,  42,  72,  25, 228,  43, 253,  68, 159, 232,  71,  47, 185, 141, 236, 111,  86, 218, 173, 236, 148,  23, 179},
+    {  8, 132,  38, 234, 152, 114, 252,  49, 216,  37, 172, 113, 198, 134,  82, 195, 149, 205, 170, 215, 108,  14, 235,  30, 179,  43, 199, 119,  15, 196, 229,  10,  78, 152,  47, 112, 175,  52, 146, 242, 113, 191, 129, 245, 100, 149,  80, 179, 103, 211,  12, 126, 250,  19,  98,  41, 203,  59, 138,  27, 107,  62, 224, 208},
+    { 74, 105, 217,  88,  60, 210,  16, 126,  97, 139,   0, 212,  46,  15, 161,  50, 247,  72,   0, 133,  42, 182,  67, 129, 109, 250, 146,  57, 170,  40,  92, 122, 213,  26, 206, 246,  92, 226,  79,  14, 165,  85,   4, 171, 203,  18, 219, 129,  29,  55, 174, 201,  83, 166, 218, 181,  18, 158, 242,  83, 185, 127,  39, 141},
+    {236, 184,  17, 194,  32, 167,  77, 202, 176, 238,  84, 150, 253, 102, 220, 125,  22, 112, 230, 192,  97, 145, 221, 202,   3,  89,  24, 213, 103, 244, 183,  61, 164, 103, 143,  69,  30, 160, 116, 194,  48, 216,  63, 142,  45, 115,  61, 187, 239, 142, 112,  27, 149,  54, 124,  73, 227, 117,  37, 210,   4, 254,  90, 170},
+    {118,  47, 155, 136, 101, 241, 146,  35,  63,  22, 119,  52, 174,  30, 191,  65, 183, 143,  83,  54, 246,  17,  82,  48, 158, 187, 231, 127,  72, 138,  22, 223,  43, 232,   9, 184, 135, 203,  23, 254, 134, 102, 236, 188,  89, 249, 165,   1,  87, 215,  70, 229, 102, 238,   1, 143,  91, 176,  63, 134, 160,  50, 200,  13},
+    {208,  95, 248,  65, 216,   6, 112, 231, 191, 160, 224, 197,  72, 140,  92, 238,  42, 215, 167,  31, 152, 112, 171, 234, 121,  63,  37, 174,   5, 203, 151,  82, 127, 193,  89,  49, 235, 101,  64, 176,  10, 155,  30, 125,  15, 147, 209, 107,  47, 157,  10, 181,  35, 169, 208,  44, 245,  11, 196,  95, 230, 108, 145,  68},
+    {164,  22, 177,  40, 128, 181,  87,  50, 133,  80, 104,  11, 123, 230,   4, 156, 105,  14, 123, 199, 223,  68, 195,  25,  98, 208, 150,  87, 248,  45, 102, 173,  17, 244, 153, 120, 214,  36, 129,  90, 223,  76, 210,  55, 233,  73,  32, 128, 191, 247, 134, 205,  82, 118,  65, 186, 159, 109, 221,  21,  74, 183,  30, 226},
+    { 55, 124, 219,  79, 203,  29, 159, 220,  15, 241,  43, 207, 165,  39, 199,  79, 176, 251,  62,  98,   4, 130,  42, 253, 137,  10, 223, 111, 184,  64, 230, 208,  71,  34, 179,  62,   1, 149, 240, 187,  44, 166, 107, 195, 174,  98, 227, 167,  63,  23,  97,  53, 155, 252,  22, 130,  80,  35, 142, 170,  44, 241, 126,  90},
+    {246, 153,  10,  99, 149, 254,  66, 188, 116, 150, 180,  62, 249, 109, 146,  50, 220, 136,  34, 179, 237, 161,  93, 181,  71, 167,  55,  29, 133, 158,  12, 119, 144, 107, 222,  86, 171, 199,  73,  16, 140, 247,   3, 132,  38, 149,  12, 201,  83, 234, 121, 222,  13, 194, 103, 231, 210,  59, 250, 115, 205, 149,   8, 195},
+    { 34, 107, 187, 235,  49, 113,   1,  93, 210,  24,  78, 131,  18,  88, 212,  24, 114,  73, 202, 147,  81,  55, 217,  16, 227, 115, 202, 238,  76, 196,  39, 253,  52, 201,  15, 246, 114,  48, 102, 215, 117,  58,  92, 222,  65, 252, 115,  44, 141, 183,  40, 171, 138,  75,  46, 145,   5, 192,  86,  14,  63,  98, 178,  77},
+    {137, 227,  67,  26, 134, 198, 173, 142,  47, 246, 102, 215, 154, 189,  60, 244, 157,   7, 228, 104,  18, 187, 119, 151,  35,  84, 142,   0, 105, 221,  89, 164, 187,  76, 159, 132,  31, 229, 160,  24, 172, 201, 146,  21, 189,  80, 162, 220, 105,  15, 208,  66, 110, 227, 166,  94, 177, 122, 154, 215, 131, 235,  51, 213},
+    {  3, 173,  91, 163, 217,  78,  34, 228,  69, 163, 184,  35, 237,   0, 122, 177,  93, 190,  45, 129, 248,  40, 205,  99, 243, 173,  49, 191, 152,  57, 128,   8, 100,  29, 216,  59, 188, 143,  87, 244,  43,  79, 239, 167, 123, 209,   6,  59, 242, 156,  92, 247,   1, 200,  32, 245,  24,  53, 233,  37, 171,  25, 156, 116},
+    { 41, 207,  51, 120,  12, 242, 103, 125, 202,   8, 116,  55,  96, 140,  77,  38, 231, 139,  63, 213, 169,  75, 138,  58,  12, 213, 126, 248,  19, 181, 236, 204, 139, 241, 112,  83,   6, 206,  63, 123, 183,   8, 106,  54,  35,  99, 136, 180,  77,  36, 130, 186,  51, 147, 126,  80, 216,  99, 186,  75, 108, 202,  89, 252},
+    {140, 103, 239, 180, 144,  57, 189,  21, 148,  84, 232, 159, 198, 224, 167, 207,  20,  82, 162,  26, 114,   2, 232, 196, 162,  71,  94,  37, 114,  84,  27,  63, 168,  46, 179, 149, 251, 107,  20, 221, 150, 209, 133, 225, 186, 236,  27, 215, 115, 199,  18, 163, 106, 223,  64, 195, 152, 118,   7, 147, 241,  16,  70, 187},
+    {167,  15,  77,  32, 208,  94, 162, 248,  46, 211, 132,  25,  72,  14,  51, 102, 125, 254, 195,  96, 241, 180,  85, 122,  31, 144, 228, 176, 209, 160, 223, 119,  90, 231,  19, 198,  42, 131, 171,  52,  98,  70,  24, 154,  63,  86, 146,  49, 166, 237,  63, 211,  84,  24, 175,  44,  19, 251, 200,  56, 180, 126, 225,  55},
+    {217, 129, 193, 113, 235,   9,  74, 114, 178,  64, 101, 251, 184, 120, 241, 147, 177,   9,  52, 141,  34, 153,  48, 215, 184, 110,   5,  54,  74, 135,  43, 193,   3, 129,  66,  98, 226,  75, 191, 233,  34, 249, 190, 114,   3, 174, 251, 101,   9,  81, 143,  37, 250, 121, 232,  90, 163,  67, 137,  95,  41, 162, 100,  29},
+    { 81, 249,  62, 155,  47, 140, 199,  35, 224,   3, 169,  39, 151,  83, 196,  35,  68, 218, 115, 208,  72, 224, 104,  20,  64, 250, 198, 151, 239,  13, 105, 253, 154, 214, 176, 142,  28, 158,   0, 113, 138, 167,  80, 204, 228, 123,  25, 196, 131, 230, 113, 194, 157,   5, 138, 209, 108, 229,  30, 207, 235,   4, 197, 152},
+    { 45, 175,   2, 220, 103, 170, 230, 131,  92, 144, 203, 111,  59, 216,   5,  96, 231, 152,  86, 173,  12, 190, 136, 234, 156,  82,  36, 124,  95, 187, 169,  71,  31,  85,  49, 246, 118, 212,  91, 198,  60,  13, 106,  33,  52, 162,  76, 220,  58, 178,  18,  51,  99,  72, 182,  54,  13, 179,  80, 115, 146,  73, 244, 111},
+    {206, 122,  92, 190,  22,  82,  59,  14, 191,  69, 240,  22, 230, 135, 170, 118, 185,  17,  41, 236, 123,  55,  87, 176,  14, 106, 173, 225,  23, 211,  47, 142, 221, 115, 204,  11,  64, 178,  41, 245, 153, 223, 177, 239, 142,  96, 185,  40, 149,  92, 211, 163, 236, 203,  35, 246, 123, 153, 221,  17, 191,  50, 135,  21},
+    {154, 233,  36, 132, 243, 203, 117, 250, 156,  40, 125,  89, 180,  37,  73, 242,  54, 137, 201, 101, 156, 252,  29, 199, 127, 212,  53, 143,  66,  87, 120, 243,  19, 180, 159, 101, 150, 235,  77, 123,  25,  88, 128,  68, 210,  19, 247, 119,   0, 239,  75, 127,  25, 110, 145,  88, 195,  61,  40, 169,  93, 229, 179,  88},
+    { 12,  58, 169,  70, 149,  44, 176,  27, 100, 221, 166,   9, 207, 106, 158,  24, 209,  82, 166,  64,   4, 210, 114,  44,  72, 243,   1, 193, 238, 162,   7, 191,  95,  69,  43, 227,  30, 135,   7, 168, 217,  44, 197,   5, 111, 155,  71, 202, 175, 137,  36, 190,  61, 227, 172,   2, 235, 103, 141, 253, 128,  32,  65, 215},
+    {250, 185, 105, 225,   8,  93, 218, 135,  75, 196,  54, 142, 252,  51, 194,  95, 128, 248,  22, 222, 138,  79, 164, 228, 136, 160,  94, 113,  34, 131, 217,  57, 139, 235, 125, 191,  87, 210, 184,  99,  61, 144, 253, 169,  51, 233,  31, 102,  54, 219, 108, 254,  17, 132,  76,  49, 165,  25, 207,  71,   5, 200, 145, 114},
+    { 79, 134,  23, 198, 123, 162,  60, 189,   3, 237, 110,  82,  28, 120, 233,   2, 174,  45, 106, 181,  35, 193,  99,  10, 185,  28,  61, 180, 226,  74, 103, 175,  30, 207,   2, 165,  59, 115,  36, 243, 194, 113,  26,  94, 188, 123, 217, 163,  85,  14, 169, 148,  94, 181, 201, 222, 121,  85, 181, 116, 222,  98, 175,  41},
+    {154, 206,  48,  76, 232,  30, 245, 114, 152,  36, 173, 222, 185, 155,  66, 139, 225,  76, 153, 237, 124,  55, 243,  67, 111, 204, 248, 148,  19, 200,  44, 247, 153,  80, 107, 254,  20, 220, 154,  82,  13, 164,  71, 225, 143,  80,   7, 133, 199, 232,  49,  70, 211,  39, 108,  16, 146, 245,  56,  19, 159,  49, 237,   9},
+    { 91, 242, 168, 107, 181, 139,  86,  48, 209,  91, 130,  63,  11, 207,  88,  32, 199, 117,   9,  65, 201,  19, 173, 149, 219,  81,  46, 122,  88, 168, 135,  10, 117, 186,  38, 141,  70, 178, 128,  53, 233, 134, 211,  45,  18, 246,  60, 179,  41, 105, 129, 243,   8, 157, 234,  69, 190,  33, 133, 231, 192,  74, 129, 216},
+    { 61,  32, 124,   1,  57, 204,  13, 224, 179,  21, 249, 148,  45, 109, 240, 181,  54, 161, 215,  91, 143, 227, 120,  39,  17, 134, 172,   6, 234,  58, 215,  93, 234,  54, 218, 196,  93, 239,   5, 205,  89,  32, 175, 121, 156, 202, 110, 237, 151,  24, 191,  85, 178, 118,  51,  97, 161, 216,  67,  95, 144,  28, 108, 185},
+    {145, 195, 220, 151, 254, 100, 160, 133,  58, 117, 197,  76, 226, 167, 128,  15, 101, 254,  30, 189,  45, 103,  74, 251, 188,  97, 224, 192, 109, 152,  27, 177,  74, 157,  13, 122, 166,  44, 112, 150, 186, 106, 249,  64,  93, 172,  32,  83, 207,  68, 226, 144,  33, 218, 137, 252,  11, 110, 173,   0, 202, 251, 164,  16},
+    {116,  73,  93,  22, 187,  72,  38, 236,  82, 164,   4, 103, 190,  27,  64, 209, 144,  79, 130, 171, 218,  13, 162, 204,  53, 155,  63,  31,  78, 252, 127, 204,  35, 133, 228,  65,  25, 212,  77, 230,  60,  22, 200,   2, 234,  50, 139,  14, 123, 171,   1, 111,  62, 193,  24,  80, 203,  48, 240, 126,  44,  84,  56, 230},
+    { 39, 244, 176,  53, 129, 216, 112, 189,  28, 213, 238,  41, 140,  85, 245, 159,  41, 230,   1, 110,  57, 238, 127,  87,   3, 117, 240, 136, 209,  50,   7, 104, 243,  86, 183, 108, 250, 142, 175,  36, 133, 164,  75, 146, 117, 212, 185, 223,  99, 251,  50, 164, 242,  95, 172, 148, 123, 182,  75, 152, 221, 180, 101, 206},
+    {159,   5, 141, 229,  31, 166,   6, 150,  95, 130,  69, 154, 207, 109,  10, 118, 187,  67, 204, 156,  85, 177,  34, 147, 213, 182,  23, 161,  96, 174, 197, 148,  56, 161,   0, 204,  49,  97,   8, 202, 236, 113, 222, 180,  28,  88,  68, 157,  34, 192,  83, 210, 130,  13, 227,  58,  31, 214,  15, 104,  30, 140,  12, 128},
+    { 60,  98, 208, 114,  86, 238,  57, 203, 250,  47, 177,  23, 232,  54, 169, 218,  96,  27, 122, 248,  17, 196,  67, 232, 104,  47,  82, 222,  15, 120,  73, 224,  22, 215, 123,  78, 153, 190, 124,  88,  53,  14,  97,  44, 254, 134,   9, 236,  57, 127,  20, 150,  38,  74, 205, 106, 247,  87, 161, 237, 200,  71, 247, 191},
+    {221, 169,  19,  66, 198, 145, 106,  77,  15, 114, 199,  93, 125, 186,  31,  76, 240, 175, 142,  40, 100, 221, 137,  20, 165, 250, 131, 195,  58, 246,  38, 137,  92, 176,  43, 242,  29, 221,  68, 248, 172, 148, 194,  65, 163, 201,  96, 145, 176, 219, 103, 238, 191, 119, 154,   3, 189, 138,  42,  62, 120, 164,  45,  85},
+    { 28, 125, 250, 180,  43,  17, 185, 226, 170, 141, 228,   2,  71, 252, 148, 131,   6,  53, 213,  75, 161, 116,  50,  90, 190,  69,  30, 107, 146, 185, 164, 110, 231,  64, 197, 136, 100, 163,  21, 132,  37, 219, 117, 230,  21, 112,  45, 207,  77,   5, 168,  60,  90, 231,  50, 170,  69, 110, 223, 178,   4, 228, 109, 147},
+    {203,  48,  81, 152, 117, 243, 132,  51,  29,  84,  55, 162, 214,  43,  98, 211, 162, 110, 188, 230,   8, 178, 244, 149,  11, 208, 158, 236,   2,  79,  28, 205,   9, 157, 113,  15, 235,  55, 204, 182,  94,  74,  11, 142,  81, 181, 242,  26, 117, 248, 140,  31, 179,  21, 131, 241,  35, 196,  24, 144,  94, 187,  20, 240},
+    {166, 104, 231,   0, 212,  70,  93, 159, 218, 192, 244, 135, 111, 182,  21,  62, 236,  86,  23, 128,  59, 205,  32, 109, 225, 122,  40,  92, 217, 130, 238,  52,  86, 254,  39, 174,  84, 148, 108,   5, 211, 161, 245,  41, 215, 153,  61, 136, 193,  53,  98, 205, 115, 219,  84, 204,  97, 125, 253,  75, 217,  40, 134,  69},
+    { 11, 189, 139,  56, 169,  33, 202,   7, 119,  99,  39,  15,  79, 153, 203, 122, 175,  39, 154, 253,  93, 140,  77, 186,  52,  83, 177, 200,  59, 101, 193, 171, 118, 140, 214,  67, 192, 220,  45, 242, 121,  56, 191, 129, 102,   0, 225,  91, 165,  13, 229, 153,  72,   6, 165,  56, 150,   9, 169,  52, 118, 159, 199,  90},
+    {130,  36, 205,  95, 228, 111, 176, 254, 143,  67, 166, 188, 225,  34, 247,  11,  76, 217, 107, 190,  42, 166, 239,   4, 156, 233, 139,  17, 162,  37, 144,  69,  23, 182,  99,   1, 124,  25, 138,  71, 153,  24,  85, 173,  53, 197, 121,  37, 214,  80, 182,  41, 251, 138, 190,  28, 237, 209,  88, 193,  12, 246,  57, 226},
+    {110, 251,  73, 157,  19, 137,  81,  56,  25, 204, 240, 126, 104,  59,  94, 143, 193, 127,   2,  70, 211,  20, 121, 214, 105,  27,  65, 242, 108, 225,   5, 243, 201,  44, 225, 160, 246,  92, 177, 226, 100, 198, 230,  16, 253, 159,  74, 239, 145, 109,  23, 125,  59,  99, 224, 117,  73, 135,  37, 229, 145,  98,  26, 174},
+    { 48, 165,   8, 121, 238,  40, 187, 222, 154,  91,  48,   3, 148, 197, 169,  44, 241,  58, 225, 173, 133,  96,  57, 179,  76, 203, 128, 186,  81, 199, 123,  95, 152,  81, 129,  62,  37, 202,  59,   9, 168,  39, 118, 143,  93,  30, 179,  10,  60, 206, 242, 167, 197,  12, 155,  46, 185, 104, 165,  65, 115, 184,  78, 214},
+    {141,  87, 221, 183,  67, 207, 107,  13, 118, 183, 231,  78, 212,  20, 233, 111,  26, 160,  90,  36, 247, 151, 232,  38, 136, 252,  48,  13, 154,  39, 172,  58, 213,  10, 237, 191, 110, 148, 216, 132, 247,  78, 207,  62, 216, 110, 226, 130, 189,  91,  49, 140,  74, 236,  89, 213,  23, 249,   0, 211,  33, 237, 154,  16},
+    {242, 194,  56,  28, 144,  90, 164, 243,  66,  33, 135, 108, 172,  66, 129,  83, 186, 139, 203, 114,  12,  79, 196,  21, 160,  94, 175, 119, 222,  71, 250,  19, 134, 165, 100,  27, 172,  14,  86,  48, 108, 150,   6, 188,  47, 153,  84,  42, 157, 118,   2, 229,  32, 119, 163,  61, 128, 150, 190,  89, 136,  54, 204, 102}
+};
@@ -0,0 +1,25 @@
+/*****************************************************************************
+
+    plik  : blue_noise.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy tekstury progów blue noise (-d blue)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef BLUE_NOISE_H
+#define BLUE_NOISE_H
+
+#include "defs.h"
+
+// Bok kafelkowanej tekstury progów (potęga dwójki - indeksowanie przez maskę)
+#define BLUE_NOISE_SIZE 64
+#define BLUE_NOISE_MASK (BLUE_NOISE_SIZE - 1)
+
+// Tekstura progów 0-254 (blue_noise.c, generowana przez scripts/generate_blue_noise.py)
+extern const uchar blue_noise_texture[BLUE_NOISE_SIZE][BLUE_NOISE_SIZE];
+
+#endif
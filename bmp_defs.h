@@ -52,6 +52,9 @@ typedef struct {
 #define BMP_HEADER_SIZE 14
 #define BMP_INFO_HEADER_SIZE 40
 #define BMP_COMPRESSION_NONE 0
+#define BMP_COMPRESSION_RLE8 1
+#define BMP_COMPRESSION_RLE4 2
+#define BMP_MAX_PALETTE_COLORS 256
 
 // Stałe BMP 1bpp
 #define BMP_1BPP_PALETTE_SIZE 8
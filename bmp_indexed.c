@@ -0,0 +1,247 @@
+/*****************************************************************************
+
+    plik  : bmp_indexed.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : dekodowanie BMP z paletą (1/4/8bpp, RLE4, RLE8) do skali szarości
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "bmp_indexed.h"
+#include "bmp_reader.h"
+#include "utils.h"
+
+/**
+ * @brief Sprawdza, czy BMP przechowuje indeksy palety zamiast kolorów
+ * 
+ * @param info Wskaźnik do nagłówka informacyjnego BMP
+ * 
+ * @return 1 dla 1/4/8bpp (także RLE4/RLE8), 0 dla 24/32bpp
+ */
+int bmp_is_indexed(BMPInfoHeader* info) {
+    return info->bits_per_pixel == 1 || info->bits_per_pixel == 4 || info->bits_per_pixel == 8;
+}
+
+/**
+ * @brief Odczytuje paletę BMP i buduje tablicę indeks → skala szarości
+ * 
+ * @details Paleta leży bezpośrednio za nagłówkiem informacyjnym (jego
+ * rozmiar podaje header_size, więc obsługiwane są też nagłówki V4/V5).
+ * Każdy kolor jest konwertowany do skali szarości raz - dekodowanie
+ * piksela sprowadza się potem do jednego odczytu z tablicy. Dla trybu
+ * 4bpp wartości są od razu skalowane do 0-15.
+ * 
+ * @param file Otwarty plik BMP
+ * @param header Nagłówek pliku BMP (granica palety: data_offset)
+ * @param info Nagłówek informacyjny BMP
+ * @param bits_per_pixel Głębia wyjściowa (skala wg BPP_GRAYSCALE_SHIFT())
+ * @param lut Tablica BMP_MAX_PALETTE_COLORS wpisów (wyjściowa)
+ * @param position Bieżąca pozycja w pliku (wejściowa i wyjściowa)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Indeksy spoza palety są mapowane na 0 (czarny)
+ * 
+ * @example
+ * ```c
+ * uchar lut[BMP_MAX_PALETTE_COLORS];
+ * if (read_bmp_gray_lut(file, &header, &info, BITS_PER_PIXEL_1BPP, lut, &position)) {
+ *     // lut[indeks] = jasność 0-255
+ * }
+ * ```
+ */
+int read_bmp_gray_lut(FILE* file, BMPHeader* header, BMPInfoHeader* info, int bits_per_pixel, uchar* lut, unsigned long long* position) {
+    // biClrUsed przycinane jako liczba bez znaku - wartość >= 2^31 nie może stać się ujemnym rozmiarem odczytu
+    dword max_colors = (info->bits_per_pixel >= 1 && info->bits_per_pixel <= 8) ? (1u << info->bits_per_pixel) : BMP_MAX_PALETTE_COLORS;
+    dword color_count = (info->colors_used == 0 || info->colors_used > max_colors) ? max_colors : info->colors_used;
+
+    // Paleta kończy się przed danymi obrazu: jawne biClrUsed poza tę granicę to uszkodzony nagłówek,
+    // domyślna pełna paleta jest przycinana do miejsca przed danymi
+    unsigned long long palette_start = BMP_HEADER_SIZE + (unsigned long long)info->header_size;
+    unsigned long long palette_space = (header->data_offset > palette_start) ? (header->data_offset - palette_start) / sizeof(BMPColorEntry) : 0;
+    if (color_count > palette_space) {
+        if (info->colors_used != 0) {
+            printf("Error: BMP palette (%u colors) overlaps the pixel data\n", (unsigned)color_count);
+            return 0;
+        }
+        color_count = (dword)palette_space;
+    }
+    
+    BMPColorEntry palette[BMP_MAX_PALETTE_COLORS];
+    // Nagłówek V4/V5 jest dłuższy niż BMPInfoHeader - reszta jest pomijana odczytem (stdin)
+    if (!skip_input_to(file, position, BMP_HEADER_SIZE + (unsigned long long)info->header_size) ||
+        fread(palette, sizeof(BMPColorEntry), color_count, file) != color_count) {
+        return 0;
+    }
+    *position += (unsigned long long)color_count * sizeof(BMPColorEntry);
+    
+    memset(lut, 0, BMP_MAX_PALETTE_COLORS);
+    for (dword i = 0; i < color_count; i++) {
+        int gray = convert_rgb_to_grayscale(palette[i].red, palette[i].green, palette[i].blue);
+        lut[i] = (uchar)(gray >> BPP_GRAYSCALE_SHIFT(bits_per_pixel));
+    }
+    return 1;
+}
+
+/**
+ * @brief Zwraca rozmiar skompresowanych danych obrazu RLE
+ * 
+ * @details Pole image_size jest dla RLE obowiązkowe, ale część programów
+ * zapisuje 0 - wtedy rozmiar wynika z rozmiaru pliku.
+ * 
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny BMP
+ * 
+ * @return Rozmiar danych w bajtach lub 0, gdy nie da się go ustalić
+ */
+size_t calculate_rle_data_size(BMPHeader* header, BMPInfoHeader* info) {
+    if (info->image_size) {
+        return info->image_size;
+    }
+    if (header->file_size > header->data_offset) {
+        return header->file_size - header->data_offset;
+    }
+    return 0;
+}
+
+/**
+ * @brief Dekoduje wiersz nieskompresowanego BMP z paletą do skali szarości
+ * 
+ * @param source_row Wiersz pliku BMP (indeksy 1, 4 lub 8 bitów, MSB pierwszy)
+ * @param grayscale_row Wiersz wyjściowy (width bajtów)
+ * @param width Szerokość obrazu w pikselach
+ * @param source_bpp Głębia pliku BMP (1, 4 lub 8)
+ * @param lut Tablica indeks → skala szarości z read_bmp_gray_lut()
+ */
+void convert_indexed_row(uchar* source_row, uchar* grayscale_row, int width, int source_bpp, const uchar* lut) {
+    switch (source_bpp) {
+        case 8:
+            for (int x = 0; x < width; x++) {
+                grayscale_row[x] = lut[source_row[x]];
+            }
+            break;
+        case 4:
+            for (int x = 0; x < width; x++) {
+                uchar packed = source_row[x >> 1];
+                grayscale_row[x] = lut[(x & 1) ? (packed & 0x0F) : (packed >> 4)];
+            }
+            break;
+        default:
+            for (int x = 0; x < width; x++) {
+                grayscale_row[x] = lut[(source_row[x >> 3] >> (7 - (x & 7))) & 1];
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Dekoduje dane BI_RLE8/BI_RLE4 bezpośrednio do wierszy skali szarości
+ * 
+ * @details Obsługuje serie powtórzeń, tryb absolutny (z wyrównaniem do
+ * słowa), koniec wiersza, koniec obrazu i przesunięcie (delta). Piksele
+ * pominięte przez deltę lub koniec wiersza przyjmują kolor indeksu 0.
+ * Wiersze RLE są zapisane od dołu, wynik jest od góry do dołu.
+ * 
+ * @param data Skompresowane dane obrazu
+ * @param data_size Rozmiar skompresowanych danych
+ * @param grayscale_data Bufor wyjściowy (grayscale_stride * height bajtów)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym (>= width)
+ * @param compression BMP_COMPRESSION_RLE8 lub BMP_COMPRESSION_RLE4
+ * @param lut Tablica indeks → skala szarości
+ * 
+ * @return 1 w przypadku sukcesu, 0 dla uszkodzonych danych
+ */
+int decode_bmp_rle(uchar* data, size_t data_size, uchar* grayscale_data, int width, int height, int grayscale_stride, dword compression, const uchar* lut) {
+    int is_rle4 = (compression == BMP_COMPRESSION_RLE4);
+    size_t pos = 0;
+    int x = 0;
+    int row = 0; // Wiersz w kolejności pliku (0 = dolny)
+    
+    for (int y = 0; y < height; y++) {
+        memset(grayscale_data + (size_t)y * grayscale_stride, lut[0], width);
+    }
+    
+    while (pos + 1 < data_size) {
+        int count = data[pos];
+        int value = data[pos + 1];
+        pos += 2;
+        
+        if (count > 0) {
+            // Seria powtórzeń: RLE4 naprzemiennie starsza i młodsza połówka bajtu
+            if (row >= height || x + count > width) {
+                return 0;
+            }
+            uchar* dst = grayscale_data + (size_t)(height - 1 - row) * grayscale_stride + x;
+            for (int i = 0; i < count; i++) {
+                dst[i] = lut[is_rle4 ? ((i & 1) ? (value & 0x0F) : (value >> 4)) : value];
+            }
+            x += count;
+        } else if (value == 0) {
+            x = 0;
+            row++;
+        } else if (value == 1) {
+            return 1;
+        } else if (value == 2) {
+            if (pos + 1 >= data_size) {
+                return 0;
+            }
+            x += data[pos];
+            row += data[pos + 1];
+            pos += 2;
+        } else {
+            // Tryb absolutny: value indeksów, dane wyrównane do 2 bajtów
+            size_t byte_count = is_rle4 ? ((size_t)value + 1) / 2 : (size_t)value;
+            if (row >= height || x + value > width || pos + byte_count > data_size) {
+                return 0;
+            }
+            uchar* dst = grayscale_data + (size_t)(height - 1 - row) * grayscale_stride + x;
+            for (int i = 0; i < value; i++) {
+                dst[i] = lut[is_rle4 ? ((i & 1) ? (data[pos + i / 2] & 0x0F) : (data[pos + i / 2] >> 4)) : data[pos + i]];
+            }
+            x += value;
+            pos += (byte_count + 1) & ~(size_t)1;
+        }
+    }
+    
+    // Brak znacznika końca obrazu - pozostałe piksele mają kolor indeksu 0
+    return 1;
+}
+
+/**
+ * @brief Konwertuje nieskompresowane dane BMP z paletą do skali szarości
+ * 
+ * @details Wynik ma układ od góry do dołu niezależnie od orientacji pliku
+ * (obsługuje ją widok wierszy), a wartości pochodzą z tablicy lut, więc są
+ * w skali 0-255 (1bpp) lub 0-15 (4bpp) zależnie od jej budowy. Dane RLE
+ * dekoduje decode_bmp_rle().
+ * 
+ * @param view Widok wierszy obrazu (1, 4 lub 8 bpp)
+ * @param grayscale_data Bufor wyjściowy (grayscale_stride * wysokość bajtów)
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym (>= szerokość)
+ * @param lut Tablica indeks → skala szarości z read_bmp_gray_lut()
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @example
+ * ```c
+ * uchar lut[BMP_MAX_PALETTE_COLORS];
+ * read_bmp_gray_lut(file, &header, &info, BITS_PER_PIXEL_1BPP, lut, &position);
+ * make_bmp_row_view(&view, image_data, info.width, info.height, info.bits_per_pixel, top_down);
+ * convert_indexed_to_grayscale(&view, gray, width, lut);
+ * ```
+ */
+int convert_indexed_to_grayscale(ImageRowView* view, uchar* grayscale_data, int grayscale_stride, const uchar* lut) {
+    // Wiersze w kolejności pliku - dla BMP od dołu od ostatniego wiersza obrazu
+    for (int i = 0; i < view->height; i++) {
+        int y = (view->stride < 0) ? view->height - 1 - i : i;
+        convert_indexed_row(IMAGE_VIEW_ROW(view, y), grayscale_data + (size_t)y * grayscale_stride, view->width, view->bits_per_pixel, lut);
+    }
+    return 1;
+}
@@ -0,0 +1,29 @@
+/*****************************************************************************
+
+    plik  : bmp_indexed.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla dekodowania BMP z paletą (1/4/8bpp, RLE4, RLE8)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef BMP_INDEXED_H
+#define BMP_INDEXED_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "defs.h"
+#include "bmp_defs.h"
+
+// Prototypy funkcji dekodowania BMP z paletą
+int bmp_is_indexed(BMPInfoHeader* info);
+int read_bmp_gray_lut(FILE* file, BMPHeader* header, BMPInfoHeader* info, int bits_per_pixel, uchar* lut, unsigned long long* position);
+size_t calculate_rle_data_size(BMPHeader* header, BMPInfoHeader* info);
+void convert_indexed_row(uchar* source_row, uchar* grayscale_row, int width, int source_bpp, const uchar* lut);
+int decode_bmp_rle(uchar* data, size_t data_size, uchar* grayscale_data, int width, int height, int grayscale_stride, dword compression, const uchar* lut);
+int convert_indexed_to_grayscale(ImageRowView* view, uchar* grayscale_data, int grayscale_stride, const uchar* lut);
+
+#endif
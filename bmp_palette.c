@@ -16,16 +16,16 @@
  * @brief Generuje paletę kolorów BMP dla różnych wariantów i głębi
  * 
  * @details Funkcja generuje paletę kolorów BMP na podstawie wybranego wariantu
- * i liczby kolorów. Obsługuje palety 1bpp (2 kolory) i 4bpp (16 kolorów) z
- * różnymi wariantami: BW, GRAY, GREEN, PORTFOLIO, OLED_YELLOW i CUSTOM.
- * Dla palet 4bpp wykonuje interpolację liniową między kolorem początkowym
- * a końcowym.
+ * i liczby kolorów. Obsługuje palety 1bpp (2 kolory), 2bpp (4), 4bpp (16)
+ * i 8bpp (256) z różnymi wariantami: BW, GRAY, GREEN, PORTFOLIO, OLED_YELLOW
+ * i CUSTOM. Kolory pośrednie są interpolowane liniowo między kolorem
+ * początkowym a końcowym.
  * 
  * @param palette Wskaźnik do tablicy BMPColorEntry (wyjściowa)
  * @param context Wskaźnik do struktury PaletteContext z parametrami
  * 
  * @note Dla 1bpp: generuje dokładnie 2 kolory (0 i 1)
- * @note Dla 4bpp: generuje 16 kolorów z interpolacją liniową
+ * @note Dla n kolorów: kolor i = color0 + (colorN - color0) * i / (n - 1)
  * @note Wszystkie kolory mają alpha = 0x00 (przezroczystość)
  * @note Obsługuje palety niestandardowe z custom_first i custom_last
  * 
@@ -87,15 +87,11 @@ void generate_palette(BMPColorEntry* palette, PaletteContext* context) {
             break;
     }
     
-    // Generuj paletę w zależności od liczby kolorów
-    if (context->color_count == 2) {
-        // Paleta 1bpp - tylko 2 kolory
-        palette[0] = color0;
-        palette[1] = color15;
-    } else if (context->color_count == 16) {
-        // Paleta 4bpp - interpolacja liniowa między color0 a color15
-        for (int i = 0; i < 16; i++) {
-            float factor = (float)i / 15.0f;  // 0.0 dla i=0, 1.0 dla i=15
+    // Interpolacja liniowa między color0 a ostatnim kolorem (2, 4, 16 lub 256 kolorów)
+    if (context->color_count >= 2) {
+        int last = context->color_count - 1;
+        for (int i = 0; i <= last; i++) {
+            float factor = (float)i / (float)last;  // 0.0 dla pierwszego, 1.0 dla ostatniego
             
             palette[i].blue = (uchar)(color0.blue + (color15.blue - color0.blue) * factor);
             palette[i].green = (uchar)(color0.green + (color15.green - color0.green) * factor);
@@ -103,4 +99,18 @@ void generate_palette(BMPColorEntry* palette, PaletteContext* context) {
             palette[i].alpha = 0x00;
         }
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief Zwraca nazwę wariantu palety używaną w opcjach i nazwach plików
+ * 
+ * @param variant Wariant palety (PALETTE_BW..PALETTE_ALL)
+ * 
+ * @return Nazwa wariantu (np. "oled_yellow") lub "unknown"
+ */
+const char* palette_variant_name(int variant) {
+    static const char* names[] = {"bw", "gray", "green", "portfolio", "oled_yellow", "custom", "all"};
+    if (variant < 0 || variant > PALETTE_ALL) {
+        return "unknown";
+    }
+    return names[variant];
+}
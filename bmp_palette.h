@@ -23,16 +23,21 @@
 #define PALETTE_PORTFOLIO 3  // Portfolio
 #define PALETTE_OLED_YELLOW 4  // OLED żółty
 #define PALETTE_CUSTOM    5  // Niestandardowa
+#define PALETTE_ALL       6  // Wszystkie predefiniowane warianty (tylko podgląd --palette all)
+
+// Liczba predefiniowanych wariantów (PALETTE_BW..PALETTE_OLED_YELLOW)
+#define PALETTE_PRESET_COUNT 5
 
 // Struktura kontekstu palety
 typedef struct {
     int variant;              // Wariant palety (0-5)
-    int color_count;          // Liczba kolorów do wygenerowania (2 dla 1bpp, 16 dla 4bpp)
+    int color_count;          // Liczba kolorów do wygenerowania (2^bpp: 2, 4, 16 lub 256)
     uchar custom_first[3];    // Pierwszy kolor w rampie niestandardowej (R,G,B)
     uchar custom_last[3];     // Ostatni kolor w rampie niestandardowej (R,G,B)
 } PaletteContext;
 
 // Prototyp funkcji generowania palety
 void generate_palette(BMPColorEntry* palette, PaletteContext* context);
+const char* palette_variant_name(int variant);
 
 #endif
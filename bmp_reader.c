@@ -10,10 +10,186 @@
     licencja : MIT
 *****************************************************************************/
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64   // fseeko() z 64-bitowym off_t także na systemach 32-bitowych
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/types.h>
 #include "bmp_reader.h"
 
+// Krótsze skoki w przód są wykonywane odczytem, dłuższe przez przewinięcie pliku
+#define INPUT_SKIP_READ_LIMIT 65536
+
+/**
+ * @brief Ustawia pozycję w pliku z 64-bitowym przesunięciem
+ * 
+ * @details fseek() przyjmuje long, który na Windows (także x64) ma 32 bity,
+ * więc dane obrazu powyżej 2 GB byłyby nieosiągalne.
+ * 
+ * @param file Wskaźnik do otwartego pliku
+ * @param offset Przesunięcie od początku pliku w bajtach
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int seek_file_64(FILE* file, unsigned long long offset) {
+#ifdef _WIN32
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    if ((unsigned long long)(off_t)offset != offset) {
+        return 0;
+    }
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * @brief Sprawdza czy plik wejściowy pozwala na przewijanie
+ * 
+ * @param file Wskaźnik do otwartego pliku
+ * 
+ * @return 1 dla zwykłego pliku, 0 dla potoku lub terminala (np. stdin)
+ */
+int input_is_seekable(FILE* file) {
+#ifdef _WIN32
+    return _ftelli64(file) >= 0;
+#else
+    return ftello(file) >= 0;
+#endif
+}
+
+/**
+ * @brief Sprawdza czy zadeklarowane dane nieskompresowanego BMP mieszczą się w pliku
+ * 
+ * @details Nagłówek może deklarować wymiary, których plik nie zawiera.
+ * Etapy alokujące bufory zależne od wymiarów przed odczytem pierwszego
+ * wiersza (np. tablice wag skalowania) sprawdzają rozmiar wcześniej,
+ * zamiast dowiadywać się o krótkim pliku dopiero przy odczycie danych.
+ * 
+ * @param file Wskaźnik do otwartego pliku (pozycja nie jest zmieniana)
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny (wysokość po normalize_bmp_height())
+ * 
+ * @return 0 gdy dane wykraczają poza koniec pliku, 1 w pozostałych
+ *         przypadkach (także dla potoku i kompresji RLE - bez sprawdzenia)
+ */
+int bmp_data_within_file(FILE* file, BMPHeader* header, BMPInfoHeader* info) {
+    if (info->compression != BMP_COMPRESSION_NONE || !input_is_seekable(file)) {
+        return 1;
+    }
+#ifdef _WIN32
+    __int64 position = _ftelli64(file);
+    int measured = _fseeki64(file, 0, SEEK_END) == 0;
+    unsigned long long file_length = measured ? (unsigned long long)_ftelli64(file) : 0;
+    _fseeki64(file, position, SEEK_SET);
+#else
+    off_t position = ftello(file);
+    int measured = fseeko(file, 0, SEEK_END) == 0;
+    unsigned long long file_length = measured ? (unsigned long long)ftello(file) : 0;
+    fseeko(file, position, SEEK_SET);
+#endif
+    if (!measured) {
+        return 1;
+    }
+    unsigned long long row_size = calculate_bmp_row_size(info->width, info->bits_per_pixel);
+    unsigned long long available = (file_length > header->data_offset) ? file_length - header->data_offset : 0;
+    return row_size == 0 || info->height <= available / row_size;
+}
+
+/**
+ * @brief Przesuwa pozycję odczytu do podanego offsetu, także w potoku
+ * 
+ * @details Wejście może być potokiem (stdin), w którym fseek() nie działa,
+ * dlatego pozycję śledzi wywołujący. Skok w przód jest wykonywany
+ * odczytem i pominięciem bajtów - krótki zawsze, dłuższy tylko gdy
+ * pliku nie można przewijać. Skok wstecz wymaga pliku, który można
+ * przewijać.
+ * 
+ * @param file Wskaźnik do otwartego pliku
+ * @param position Bieżąca pozycja w pliku (wejściowa i wyjściowa)
+ * @param offset Docelowy offset od początku pliku
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @example
+ * ```c
+ * unsigned long long position = sizeof(BMPHeader) + sizeof(BMPInfoHeader);
+ * if (skip_input_to(file, &position, header.data_offset)) {
+ *     // Następny odczyt zwróci pierwszy bajt danych obrazu
+ * }
+ * ```
+ */
+int skip_input_to(FILE* file, unsigned long long* position, unsigned long long offset) {
+    if (offset == *position) {
+        return 1;
+    }
+    if (offset < *position || offset - *position > INPUT_SKIP_READ_LIMIT) {
+        if (input_is_seekable(file)) {
+            if (!seek_file_64(file, offset)) {
+                return 0;
+            }
+            *position = offset;
+            return 1;
+        }
+        if (offset < *position) {
+            return 0;
+        }
+    }
+    
+    uchar scratch[4096];
+    while (*position < offset) {
+        size_t part = (offset - *position < sizeof(scratch)) ? (size_t)(offset - *position) : sizeof(scratch);
+        if (fread(scratch, 1, part, file) != part) {
+            return 0;
+        }
+        *position += part;
+    }
+    return 1;
+}
+
+/**
+ * @brief Rozpoznaje format pliku wejściowego po sygnaturze
+ * 
+ * @details Podgląda pierwszy bajt pliku bez przewijania (działa także dla
+ * stdin), więc po rozpoznaniu formatu nagłówek od początku czyta właściwy
+ * dekoder (read_bmp_header(), read_png_header() lub read_pnm_header()),
+ * który sprawdza pełną sygnaturę.
+ * 
+ * @param file Wskaźnik do otwartego pliku (pozycja na początku)
+ * 
+ * @return IMAGE_FORMAT_BMP, IMAGE_FORMAT_PNM, IMAGE_FORMAT_PNG lub
+ *         IMAGE_FORMAT_UNKNOWN
+ * 
+ * @example
+ * ```c
+ * if (detect_image_format(file) == IMAGE_FORMAT_PNG) {
+ *     read_png_header(file, &png_info);
+ * }
+ * ```
+ */
+int detect_image_format(FILE* file) {
+    // Jeden bajt wystarcza do rozróżnienia formatów, a ungetc() gwarantuje
+    // zwrot jednego bajtu także w potoku
+    int first = getc(file);
+    if (first == EOF || ungetc(first, file) == EOF) {
+        return IMAGE_FORMAT_UNKNOWN;
+    }
+    switch (first) {
+        case 'B':
+            return IMAGE_FORMAT_BMP;
+        case 'P':
+            return IMAGE_FORMAT_PNM;
+        case 0x89:
+            return IMAGE_FORMAT_PNG;
+        default:
+            return IMAGE_FORMAT_UNKNOWN;
+    }
+}
+
 /**
  * @brief Odczytuje nagłówki pliku BMP z pliku
  * 
@@ -62,7 +238,8 @@ int read_bmp_header(FILE* file, BMPHeader* header, BMPInfoHeader* info) {
 /**
  * @brief Odczytuje dane obrazu BMP z pliku
  * 
- * @details Funkcja pozycjonuje plik na określonym offsetcie danych obrazu
+ * @details Funkcja przesuwa odczyt do offsetu danych obrazu (bez
+ * przewijania, jeśli dane leżą dalej w pliku - działa także dla stdin)
  * i odczytuje surowe dane pikseli do bufora. Sprawdza czy odczytano
  * oczekiwaną liczbę bajtów i zwraca status operacji.
  * 
@@ -70,26 +247,98 @@ int read_bmp_header(FILE* file, BMPHeader* header, BMPInfoHeader* info) {
  * @param image_data Wskaźnik do bufora na dane obrazu (wyjściowy)
  * @param data_size Rozmiar danych do odczytania w bajtach
  * @param data_offset Offset początku danych obrazu w pliku
+ * @param position Bieżąca pozycja w pliku (wejściowa i wyjściowa)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
  * 
- * @note Pozycjonuje plik na data_offset przed odczytem
+ * @note Pozycjonuje plik na data_offset przed odczytem (skip_input_to())
  * @note Sprawdza czy odczytano dokładnie data_size bajtów
  * @note Dane są odczytywane w formacie BGR (Blue-Green-Red)
  * 
  * @example
  * ```c
  * uchar* image_data = malloc(data_size);
- * if (read_bmp_image_data(file, image_data, data_size, data_offset)) {
+ * if (read_bmp_image_data(file, image_data, data_size, data_offset, &position)) {
  *     // Dane obrazu zostały odczytane pomyślnie
  * }
  * ```
  */
-int read_bmp_image_data(FILE* file, uchar* image_data, int data_size, dword data_offset) {
-    fseek(file, data_offset, SEEK_SET);
+int read_bmp_image_data(FILE* file, uchar* image_data, size_t data_size, dword data_offset, unsigned long long* position) {
+    if (!skip_input_to(file, position, data_offset)) {
+        return 0;
+    }
     if (fread(image_data, 1, data_size, file) != data_size) {
         return 0;
     }
+    *position += data_size;
+    return 1;
+}
+
+/**
+ * @brief Odczytuje ciągły zakres wierszy danych obrazu BMP
+ * 
+ * @details Wiersze są numerowane w kolejności zapisu w pliku (dla BMP
+ * od dołu do góry). Przesunięcie jest liczone w 64 bitach, dzięki czemu
+ * funkcja działa dla plików większych niż 4 GB. Używana przy
+ * przetwarzaniu obrazu pasmami (--max-mem). Kolejne pasma BMP zapisanego
+ * od góry leżą w pliku po kolei, więc są czytane bez przewijania.
+ * 
+ * @param file Wskaźnik do otwartego pliku BMP
+ * @param image_data Bufor na row_count * row_size bajtów (wyjściowy)
+ * @param row_size Rozmiar wiersza w pliku (z dopełnieniem)
+ * @param data_offset Offset początku danych obrazu w pliku
+ * @param first_row Numer pierwszego wiersza w pliku
+ * @param row_count Liczba wierszy do odczytania
+ * @param position Bieżąca pozycja w pliku (wejściowa i wyjściowa)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @example
+ * ```c
+ * // Wiersze pliku 100..163 (64 wiersze)
+ * read_bmp_rows(file, band, row_size, header.data_offset, 100, 64, &position);
+ * ```
+ */
+int read_bmp_rows(FILE* file, uchar* image_data, size_t row_size, dword data_offset, size_t first_row, size_t row_count, unsigned long long* position) {
+    unsigned long long offset = (unsigned long long)data_offset + (unsigned long long)first_row * row_size;
+    if (!skip_input_to(file, position, offset)) {
+        return 0;
+    }
+    size_t data_size = row_count * row_size;
+    if (fread(image_data, 1, data_size, file) != data_size) {
+        return 0;
+    }
+    *position += data_size;
+    return 1;
+}
+
+/**
+ * @brief Odczytuje fragment jednego wiersza danych obrazu BMP
+ * 
+ * @details Używana przy wycinaniu (--crop): z wiersza czytane są tylko
+ * bajty pokrywające kolumny wycinka, a przesunięcie jest liczone wprost
+ * z data_offset i rozmiaru wiersza, więc reszta pliku nie jest czytana.
+ * 
+ * @param file Wskaźnik do otwartego pliku BMP
+ * @param data Bufor na byte_count bajtów (wyjściowy)
+ * @param row_size Rozmiar wiersza w pliku (z dopełnieniem)
+ * @param data_offset Offset początku danych obrazu w pliku
+ * @param row Numer wiersza w pliku (dla BMP od dołu do góry)
+ * @param first_byte Pierwszy bajt fragmentu w wierszu
+ * @param byte_count Liczba bajtów fragmentu
+ * @param position Bieżąca pozycja w pliku (wejściowa i wyjściowa)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int read_bmp_row_bytes(FILE* file, uchar* data, size_t row_size, dword data_offset, size_t row, size_t first_byte, size_t byte_count, unsigned long long* position) {
+    unsigned long long offset = (unsigned long long)data_offset + (unsigned long long)row * row_size + first_byte;
+    if (!skip_input_to(file, position, offset)) {
+        return 0;
+    }
+    if (fread(data, 1, byte_count, file) != byte_count) {
+        return 0;
+    }
+    *position += byte_count;
     return 1;
 }
 
@@ -97,16 +346,17 @@ int read_bmp_image_data(FILE* file, uchar* image_data, int data_size, dword data
  * @brief Sprawdza czy format BMP jest obsługiwany przez program
  * 
  * @details Funkcja waliduje czy plik BMP ma format obsługiwany przez program.
- * Sprawdza głębię kolorów (musi być 24 lub 32 bpp) oraz kompresję
- * (musi być brak kompresji). Zwraca status zgodności z wymaganiami.
+ * Obsługiwane są obrazy 24/32 bpp bez kompresji, obrazy z paletą 1/4/8 bpp
+ * bez kompresji oraz skompresowane BI_RLE8 (8 bpp) i BI_RLE4 (4 bpp).
  * 
  * @param header Wskaźnik do nagłówka BMP (nieużywany w obecnej implementacji)
  * @param info Wskaźnik do nagłówka informacyjnego BMP
  * 
  * @return 1 jeśli format jest obsługiwany, 0 jeśli nie
  * 
- * @note Sprawdza głębię kolorów: 24 lub 32 bpp
- * @note Sprawdza kompresję: musi być 0 (brak kompresji)
+ * @note Sprawdza głębię kolorów: 1, 4, 8, 24 lub 32 bpp
+ * @note Sprawdza kompresję: brak, RLE8 tylko dla 8 bpp, RLE4 tylko dla 4 bpp
+ * @note Obrazy RLE muszą być zapisane od dołu (dodatnia wysokość)
  * @note Można rozszerzyć o dodatkowe walidacje w przyszłości
  * 
  * @example
@@ -121,17 +371,21 @@ int read_bmp_image_data(FILE* file, uchar* image_data, int data_size, dword data
  * ```
  */
 int validate_bmp_format(BMPHeader* header, BMPInfoHeader* info) {
-    // Sprawdź czy to 24-bitowy lub 32-bitowy BMP
-    if (info->bits_per_pixel != 24 && info->bits_per_pixel != 32) {
-        return 0;
-    }
+    // Wysokość ujemna = obraz zapisany od góry; RLE dopuszcza tylko zapis od dołu
+    int top_down = ((int)info->height < 0);
     
-    // Sprawdź czy kompresja jest obsługiwana (0 = brak kompresji)
-    if (info->compression != 0) {
-        return 0;
+    switch (info->compression) {
+        case BMP_COMPRESSION_NONE:
+            // Obrazy z paletą (1/4/8 bpp) i pełnokolorowe (24/32 bpp)
+            return info->bits_per_pixel == 1 || info->bits_per_pixel == 4 || info->bits_per_pixel == 8 ||
+                   info->bits_per_pixel == 24 || info->bits_per_pixel == 32;
+        case BMP_COMPRESSION_RLE8:
+            return info->bits_per_pixel == 8 && !top_down;
+        case BMP_COMPRESSION_RLE4:
+            return info->bits_per_pixel == 4 && !top_down;
+        default:
+            return 0;
     }
-    
-    return 1;
 }
 
 /**
@@ -145,20 +399,82 @@ int validate_bmp_format(BMPHeader* header, BMPInfoHeader* info) {
  * @param width Szerokość obrazu w pikselach
  * @param bits_per_pixel Głębia kolorów w bitach na piksel
  * 
- * @return Rozmiar wiersza w bajtach (z wyrównaniem)
+ * @return Rozmiar wiersza w bajtach (z wyrównaniem, 64-bitowo na systemach 64-bitowych)
  * 
  * @note Wyrównanie do granicy 4-bajtowej jest wymagane przez format BMP
- * @note Wzór: ((width * bytes_per_pixel + 3) / 4) * 4
+ * @note Wzór: ((width * bits_per_pixel + 31) / 32) * 4 - działa także dla 1/4 bpp
  * @note Padding jest dodawany automatycznie przez wzór
  * 
  * @example
  * ```c
- * int row_size = calculate_bmp_row_size(100, 24);  // 100 * 3 = 300, wyrównane do 300
- * int row_size2 = calculate_bmp_row_size(99, 24);  // 99 * 3 = 297, wyrównane do 300
- * int row_size3 = calculate_bmp_row_size(50, 32);  // 50 * 4 = 200, wyrównane do 200
+ * size_t row_size = calculate_bmp_row_size(100, 24);  // 100 * 3 = 300, wyrównane do 300
+ * size_t row_size2 = calculate_bmp_row_size(99, 24);  // 99 * 3 = 297, wyrównane do 300
+ * size_t row_size3 = calculate_bmp_row_size(50, 32);  // 50 * 4 = 200, wyrównane do 200
+ * size_t row_size4 = calculate_bmp_row_size(37, 4);   // 37 / 2 = 19, wyrównane do 20
  * ```
  */
-int calculate_bmp_row_size(dword width, int bits_per_pixel) {
-    int bytes_per_pixel = bits_per_pixel / 8;
-    return ((width * bytes_per_pixel + 3) / 4) * 4; // Wyrównaj do granicy 4-bajtowej
+size_t calculate_bmp_row_size(dword width, int bits_per_pixel) {
+    return (((size_t)width * bits_per_pixel + 31) / 32) * 4; // Wyrównaj do granicy 4-bajtowej
+}
+
+/**
+ * @brief Zamienia ujemną wysokość (BMP zapisany od góry) na dodatnią
+ * 
+ * @details Pole height nagłówka jest dword, więc ujemna wysokość obrazu
+ * zapisanego od góry wyglądałaby jak ogromna liczba. Po normalizacji
+ * height jest zawsze dodatnie, a orientację zwraca funkcja.
+ * 
+ * @param info Wskaźnik do nagłówka informacyjnego BMP (modyfikowany)
+ * 
+ * @return 1 jeśli obraz jest zapisany od góry, 0 jeśli od dołu
+ * 
+ * @example
+ * ```c
+ * int top_down = normalize_bmp_height(&info);
+ * printf("%ux%u %s\n", info.width, info.height, top_down ? "top-down" : "bottom-up");
+ * ```
+ */
+int normalize_bmp_height(BMPInfoHeader* info) {
+    int height = (int)info->height;
+    if (height < 0) {
+        info->height = (dword)(-(long long)height);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Tworzy widok wierszy na danych BMP bez kopiowania
+ * 
+ * @details Dla BMP zapisanego od dołu (domyślnie) górny wiersz obrazu jest
+ * ostatnim wierszem danych, a odstęp jest ujemny. Dla BMP zapisanego od góry
+ * widok jest zwykłą tablicą wierszy. Kernele konwersji używają tylko
+ * IMAGE_VIEW_ROW(), więc obie orientacje obsługuje ta sama pętla.
+ * 
+ * @param view Widok do wypełnienia
+ * @param data Dane wierszy w kolejności pliku
+ * @param width Szerokość obrazu w pikselach
+ * @param row_count Liczba wierszy w data
+ * @param bits_per_pixel Głębia kolorów danych
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * 
+ * @example
+ * ```c
+ * ImageRowView view;
+ * make_bmp_row_view(&view, image_data, info.width, info.height, info.bits_per_pixel, top_down);
+ * convert_to_grayscale_8bpp(&view, gray, info.width);
+ * ```
+ */
+void make_bmp_row_view(ImageRowView* view, uchar* data, dword width, int row_count, int bits_per_pixel, int top_down) {
+    size_t row_size = calculate_bmp_row_size(width, bits_per_pixel);
+    view->width = (int)width;
+    view->height = row_count;
+    view->bits_per_pixel = bits_per_pixel;
+    if (top_down) {
+        view->first_row = data;
+        view->stride = (ptrdiff_t)row_size;
+    } else {
+        view->first_row = data + (size_t)(row_count > 0 ? row_count - 1 : 0) * row_size;
+        view->stride = -(ptrdiff_t)row_size;
+    }
 }
@@ -12,13 +12,23 @@
 #ifndef __BMP_READER_H__
 #define __BMP_READER_H__
 
+#include <stdio.h>
+#include <stddef.h>
 #include "defs.h"
 #include "bmp_defs.h"
 
 // Prototypy funkcji
+int detect_image_format(FILE* file);
 int read_bmp_header(FILE* file, BMPHeader* header, BMPInfoHeader* info);
-int read_bmp_image_data(FILE* file, uchar* image_data, int data_size, dword data_offset);
+int input_is_seekable(FILE* file);
+int bmp_data_within_file(FILE* file, BMPHeader* header, BMPInfoHeader* info);
+int skip_input_to(FILE* file, unsigned long long* position, unsigned long long offset);
+int read_bmp_image_data(FILE* file, uchar* image_data, size_t data_size, dword data_offset, unsigned long long* position);
+int read_bmp_rows(FILE* file, uchar* image_data, size_t row_size, dword data_offset, size_t first_row, size_t row_count, unsigned long long* position);
+int read_bmp_row_bytes(FILE* file, uchar* data, size_t row_size, dword data_offset, size_t row, size_t first_byte, size_t byte_count, unsigned long long* position);
 int validate_bmp_format(BMPHeader* header, BMPInfoHeader* info);
-int calculate_bmp_row_size(dword width, int bits_per_pixel);
+size_t calculate_bmp_row_size(dword width, int bits_per_pixel);
+int normalize_bmp_height(BMPInfoHeader* info);
+void make_bmp_row_view(ImageRowView* view, uchar* data, dword width, int row_count, int bits_per_pixel, int top_down);
 
 #endif
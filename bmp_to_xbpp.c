@@ -15,276 +15,1848 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
+#include <limits.h>
 #include "defs.h"
 #include "bmp_reader.h"
 #include "utils.h"
 #include "options.h"
 #include "bmp_writer.h"
 #include "bmp_palette.h"
+#include "stats.h"
+#include "timing.h"
+#include "threads.h"
+#include "banded.h"
+#include "bmp_indexed.h"
+#include "png_reader.h"
+#include "pnm_reader.h"
+#include "stream_io.h"
+#include "color.h"
+#include "color_quantize.h"
+#include "display_layout.h"
+#include "resize.h"
+#include "manifest.h"
+
+// Zadanie zapisu jednego celu wyjściowego (wykonywane równolegle)
+typedef struct {
+    ConversionContext* context;
+    OutputTarget* target;
+    uchar* packed_data;
+    size_t packed_size;
+    int width;
+    int height;
+    int result;            // 1 = zapisano, 0 = błąd
+    double elapsed_ms;     // Czas zapisu tego celu
+    const char* alias_of;  // Tablica o tych samych danych (NULL = zapis danych)
+} OutputJob;
+
+// 1 = bez komunikatów postępu (--manifest: zasoby konwertowane równolegle
+// przeplatałyby swoje wiersze, podsumowanie wypisuje convert_manifest())
+static int progress_quiet = 0;
+
+// Komunikat postępu konwersji ("- ..."); błędy i ostrzeżenia idą wprost przez printf
+static void print_progress(const char* format, ...) {
+    if (progress_quiet) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+// Obrót i odbicie wyjścia (--rotate / --flip) w osiach obrazu źródłowego
+static int conversion_orientation(ConversionContext* context) {
+    return image_orientation(context->rotation, context->flip);
+}
 
 /**
- * @brief Główna funkcja programu konwertującego BMP na tablice bajtów
+ * @brief Oblicza rozmiar spakowanych danych dla trybu konwersji
+ * 
+ * @param context Kontekst konwersji (--layout wybiera układ sterownika)
+ * @param width Szerokość skali szarości (przed obrotem --rotate)
+ * @param height Wysokość obrazu (przed obrotem --rotate)
+ * 
+ * @return Rozmiar w bajtach lub 0 przy przepełnieniu
+ */
+static size_t calculate_conversion_packed_size(ConversionContext* context, int width, int height) {
+    oriented_size(conversion_orientation(context), width, height, &width, &height);
+    if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+        return calculate_layout_packed_size(width, height, context->display_layout, context->page_commands);
+    }
+    return calculate_packed_size(width, height, context->bits_per_pixel, context->scan_direction);
+}
+
+// Sprawdza czy obraz po obrocie mieści się w RAM sterownika (--layout z --page-cmds)
+static int check_conversion_layout_size(ConversionContext* context, int width, int height) {
+    oriented_size(conversion_orientation(context), width, height, &width, &height);
+    return check_display_layout_size(width, height, context->display_layout, context->page_commands);
+}
+
+// Pakuje piksele kernelem -h/-v albo w układzie sterownika (--layout), z obrotem i odbiciem
+static int pack_conversion_pixels(ConversionContext* context, uchar* grayscale_data, uchar* packed_data, int width, int height) {
+    int orientation = conversion_orientation(context);
+    if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+        return pack_layout(grayscale_data, packed_data, width, height, context->display_layout, context->page_commands, orientation);
+    }
+    return pack_pixels_band(grayscale_data, packed_data, width, height, 0, height, context->bits_per_pixel,
+                            context->scan_direction, context->pixel_order, orientation);
+}
+
+// Odwraca bity danych - komendy adresu strony (--page-cmds) pozostają bez zmian (wymiary po obrocie)
+static void invert_conversion_data(ConversionContext* context, uchar* packed_data, size_t packed_size, int width, int height) {
+    if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+        invert_layout_data(packed_data, width, height, context->display_layout, context->page_commands);
+    } else {
+        // Wyjście kolorowe jest odwracane bajt po bajcie, tak jak 8bpp
+        invert_packed_data(packed_data, packed_size, (context->color_format != COLOR_FORMAT_NONE) ? BITS_PER_PIXEL_8BPP : context->bits_per_pixel);
+    }
+}
+
+/**
+ * @brief Zapisuje podgląd BMP danych w układzie sterownika (--layout)
+ * 
+ * @details Dane są najpierw zamieniane na wiersze 1bpp (bit 7 = lewy
+ * piksel), a podgląd powstaje zwykłym kodem 1bpp z wybraną paletą.
+ * 
+ * @param packed_data Dane z pack_layout()
+ * @param preview_ctx Kontekst podglądu (kierunek i kolejność są nadpisywane)
+ * @param context Kontekst konwersji
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int generate_layout_preview(uchar* packed_data, PreviewContext* preview_ctx, ConversionContext* context) {
+    uchar* packed_rows = (uchar*)stats_malloc(calculate_packed_size(preview_ctx->width, preview_ctx->height, BITS_PER_PIXEL_1BPP, 1));
+    if (!packed_rows) {
+        return 0;
+    }
+    unpack_layout_rows(packed_data, packed_rows, preview_ctx->width, preview_ctx->height, context->display_layout, context->page_commands);
+    preview_ctx->scan_direction = 1;
+    preview_ctx->pixel_order = 1;
+    int result = (preview_ctx->palette_variant == PALETTE_ALL)
+                 ? (generate_bmp_all_palettes(packed_rows, preview_ctx, BITS_PER_PIXEL_1BPP) == PALETTE_PRESET_COUNT)
+                 : generate_bmp_preview(packed_rows, preview_ctx, BITS_PER_PIXEL_1BPP);
+    stats_free(packed_rows);
+    return result;
+}
+
+/**
+ * @brief Zapisuje jeden cel wyjściowy z gotowych spakowanych danych
+ * 
+ * @details Funkcja jest wywoływana przez run_parallel() dla każdego celu
+ * podanego opcją --out (oraz dla pliku wyjściowego i podglądu w trybie
+ * klasycznym). Wszystkie zadania czytają te same packed_data, więc dane
+ * nie są modyfikowane. Komunikaty są wypisywane po zakończeniu wszystkich
+ * zadań, aby nie przeplatały się na konsoli.
+ * 
+ * @param arg Tablica struktur OutputJob
+ * @param index Indeks zadania w tablicy
+ */
+static void write_output_job(void* arg, int index) {
+    OutputJob* job = &((OutputJob*)arg)[index];
+    ConversionContext* context = job->context;
+    double start = stats_stage_begin();
+    
+    if (job->target->format == FORMAT_BMP_PREVIEW && context->color_format == COLOR_FORMAT_INDEXED) {
+        // Podgląd indeksów 4bpp z paletą wyznaczoną z obrazu
+        PreviewContext preview_ctx = {job->width, job->height, job->target->path, 0, context->custom_color_first, context->custom_color_last, context->scan_direction, context->pixel_order, &context->image_palette[0][0]};
+        job->result = generate_bmp_preview(job->packed_data, &preview_ctx, BITS_PER_PIXEL_4BPP);
+    } else if (job->target->format == FORMAT_BMP_PREVIEW && context->color_format != COLOR_FORMAT_NONE) {
+        // Podgląd wyjścia kolorowego - BMP 24-bitowy bez palety
+        PreviewContext preview_ctx = {job->width, job->height, job->target->path, 0, context->custom_color_first, context->custom_color_last, context->scan_direction, context->pixel_order};
+        job->result = generate_color_preview(job->packed_data, &preview_ctx, context->color_format);
+    } else if (job->target->format == FORMAT_BMP_PREVIEW) {
+        // Podgląd BMP (bez inwersji - paleta zawsze standardowa)
+        int palette = (context->bits_per_pixel == BITS_PER_PIXEL_1BPP) ? context->palette_variant : context->palette_4bpp_variant;
+        PreviewContext preview_ctx = {job->width, job->height, job->target->path, palette, context->custom_color_first, context->custom_color_last, context->scan_direction, context->pixel_order};
+        if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+            job->result = generate_layout_preview(job->packed_data, &preview_ctx, context);
+        } else if (palette == PALETTE_ALL) {
+            // Jeden obraz, pięć plików - podmieniany jest tylko blok palety
+            job->result = (generate_bmp_all_palettes(job->packed_data, &preview_ctx, context->bits_per_pixel) == PALETTE_PRESET_COUNT);
+        } else {
+            job->result = generate_bmp_preview(job->packed_data, &preview_ctx, context->bits_per_pixel);
+        }
+    } else if (job->alias_of && FORMAT_HAS_ARRAY_NAME(job->target->format)) {
+        // Dane identyczne z wcześniejszym wycinkiem - tylko nazwa tablicy wskazuje oryginał
+        job->result = write_array_alias(job->alias_of, job->packed_size, job->width, job->height, context->array_name, job->target->path, job->target->format, context->use_progmem, context->bits_per_pixel, context->color_format, context->dithering_method, context->brightness, context->contrast, context->invert);
+    } else {
+        job->result = write_array(job->packed_data, job->packed_size, job->width, job->height, context->array_name, job->target->path, job->target->format, context->use_progmem, context->bits_per_pixel, context->color_format, context->dithering_method, context->brightness, context->contrast, context->invert, context->written_arrays != NULL);
+        if (job->result && context->color_format == COLOR_FORMAT_INDEXED && job->target->format != FORMAT_BINARY) {
+            // Paleta za danymi obrazu - plik binarny zawiera tylko indeksy
+            job->result = append_palette_array(job->target->path, job->target->format, context->array_name, context->use_progmem, &context->image_palette[0][0], INDEXED_PALETTE_COLORS);
+        }
+    }
+    
+    job->elapsed_ms = timing_elapsed_ms(start);
+}
+
+/**
+ * @brief Buduje listę celów wyjściowych konwersji
+ * 
+ * @details Bez opcji --out celem jest plik wyjściowy w formacie wybranym
+ * opcjami -c/-r/-a/-aa. Z --out celami są podane specyfikacje. Opcja --bmp
+ * dodaje podgląd BMP obok pierwszego celu. Cele są zapisywane równolegle,
+ * więc dwa cele o tej samej ścieżce (po dodaniu rozszerzenia podglądu
+ * i przyrostków wycinka) są odrzucane.
+ * 
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka pliku wyjściowego (tryb klasyczny)
+ * @param targets Tablica co najmniej MAX_OUTPUT_TARGETS + 1 elementów
+ * 
+ * @return Liczba celów w tablicy targets lub 0, gdy dwa cele mają tę samą ścieżkę
+ */
+static int collect_output_targets(ConversionContext* context, const char* output_path, OutputTarget* targets) {
+    int target_count = 0;
+    if (context->output_count == 0) {
+        // Tryb klasyczny: plik wyjściowy i opcjonalny podgląd obok niego
+        targets[target_count].format = context->output_format;
+        strncpy(targets[target_count].path, output_path, sizeof(targets[target_count].path) - 1);
+        targets[target_count].path[sizeof(targets[target_count].path) - 1] = '\0';
+        target_count++;
+    } else {
+        for (int i = 0; i < context->output_count; i++) {
+            targets[target_count++] = context->outputs[i];
+        }
+    }
+    if (context->generate_bmp) {
+        // Podgląd --bmp obok pierwszego celu wyjściowego
+        targets[target_count].format = FORMAT_BMP_PREVIEW;
+        strcpy(targets[target_count].path, targets[0].path);
+        set_default_extension(targets[target_count].path, sizeof(targets[target_count].path), FORMAT_BMP_PREVIEW);
+        target_count++;
+    }
+    for (int i = 1; i < target_count; i++) {
+        for (int j = 0; j < i; j++) {
+            if (strcmp(targets[i].path, targets[j].path) == 0) {
+                printf("Error: Several output targets write to the same file %s\n", targets[i].path);
+                return 0;
+            }
+        }
+    }
+    return target_count;
+}
+
+/**
+ * @brief Wypisuje statystyki konwersji, jeśli włączono --stats/--stats-json
+ * 
+ * @param context Kontekst konwersji
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
+ */
+static void print_conversion_stats(ConversionContext* context, ConversionStats* stats, double conversion_start) {
+    if (context->stats_output != STATS_OUTPUT_NONE) {
+        stats->total_ms = timing_elapsed_ms(conversion_start);
+        stats->peak_bytes = stats_peak_bytes();
+        stats_print(stdout, stats, context->stats_output);
+    }
+}
+
+// ============================================================================
+// Przegląd jasności i kontrastu (--sweep-br / --sweep-ct)
+// ============================================================================
+
+// Zadanie jednej kombinacji jasności i kontrastu
+typedef struct {
+    ConversionContext context;     // Kopia kontekstu z jasnością i kontrastem kombinacji
+    const uchar* grayscale_data;   // Wspólna skala szarości 8bpp (tylko do odczytu)
+    int width;
+    int height;
+    OutputTarget targets[MAX_OUTPUT_TARGETS + 1];
+    int target_count;
+    int result;                    // 1 = wszystkie cele zapisane, 0 = błąd
+    ConversionStats stats;         // Czasy etapów tej kombinacji
+} SweepJob;
+
+/**
+ * @brief Dopisuje do nazwy pliku przyrostek
+ * 
+ * @details Przyrostek jest wstawiany przed rozszerzeniem. Jeżeli ścieżka
+ * wskazuje katalog (kończy się separatorem), nazwą pliku staje się sam
+ * przyrostek bez podkreślenia, np. "preview/" -> "preview/br60_ct70".
+ * 
+ * @param path Ścieżka modyfikowana w miejscu (bufor 256 bajtów)
+ * @param suffix Przyrostek (np. "br60_ct70", "crop2")
+ */
+static void append_path_suffix(char* path, const char* suffix) {
+    char extension[256] = "";
+    char* name = path;
+    for (char* p = path; *p; p++) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
+        }
+    }
+    char* dot = strrchr(name, '.');
+    if (dot) {
+        strcpy(extension, dot);
+        *dot = '\0';
+    }
+    
+    char suffixed[256];
+    snprintf(suffixed, sizeof(suffixed), "%s%s%s%s", path, *name ? "_" : "", suffix, extension);
+    strcpy(path, suffixed);
+}
+
+// Przyrostek _brJASNOŚĆ_ctKONTRAST plików jednej kombinacji przeglądu
+static void make_sweep_path(char* path, int brightness, int contrast) {
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "br%d_ct%d", brightness, contrast);
+    append_path_suffix(path, suffix);
+}
+
+/**
+ * @brief Wykonuje konwersję 1bpp/2bpp/4bpp dla jednej kombinacji przeglądu
+ * 
+ * @details Kopiuje wspólną skalę szarości, a następnie wykonuje regulację
+ * jasności i kontrastu, dithering, pakowanie, inwersję i zapis wszystkich
+ * celów. Wywoływana równolegle przez run_parallel() - każde zadanie
+ * korzysta wyłącznie z własnych buforów.
+ * 
+ * @param arg Tablica struktur SweepJob
+ * @param index Indeks zadania w tablicy
+ */
+static void run_sweep_job(void* arg, int index) {
+    SweepJob* job = &((SweepJob*)arg)[index];
+    ConversionContext* context = &job->context;
+    size_t pixel_count = (size_t)job->width * job->height;
+    size_t packed_size = calculate_conversion_packed_size(context, job->width, job->height);
+    int output_width, output_height;
+    oriented_size(conversion_orientation(context), job->width, job->height, &output_width, &output_height);
+    
+    job->result = 0;
+    uchar* grayscale_data = (uchar*)stats_malloc(pixel_count);
+    uchar* packed_data = (uchar*)stats_malloc(packed_size);
+    if (!grayscale_data || !packed_data) {
+        stats_free(grayscale_data);
+        stats_free(packed_data);
+        return;
+    }
+    memcpy(grayscale_data, job->grayscale_data, pixel_count);
+    
+    double stage_start = stats_stage_begin();
+    int converted = adjust_brightness_contrast(grayscale_data, job->width, job->height, context->brightness, context->contrast);
+    stats_stage_end(&job->stats, STATS_STAGE_BRIGHTNESS, stage_start);
+    
+    if (converted) {
+        stage_start = stats_stage_begin();
+        converted = apply_dithering(grayscale_data, job->width, job->height, context->dithering_method, BPP_LEVELS(context->bits_per_pixel)) &&
+                    quantize_to_bpp(grayscale_data, job->width, job->height, context->bits_per_pixel);
+        stats_stage_end(&job->stats, STATS_STAGE_DITHERING, stage_start);
+    }
+    if (converted) {
+        stage_start = stats_stage_begin();
+        converted = pack_conversion_pixels(context, grayscale_data, packed_data, job->width, job->height);
+        stats_stage_end(&job->stats, STATS_STAGE_PACKING, stage_start);
+    }
+    if (converted && context->invert) {
+        stage_start = stats_stage_begin();
+        invert_conversion_data(context, packed_data, packed_size, output_width, output_height);
+        stats_stage_end(&job->stats, STATS_STAGE_INVERSION, stage_start);
+    }
+    
+    if (converted) {
+        // Cele jednej kombinacji zapisywane kolejno - równoległość jest na poziomie kombinacji
+        job->result = 1;
+        for (int i = 0; i < job->target_count; i++) {
+            OutputJob output = {context, &job->targets[i], packed_data, packed_size, output_width, output_height, 0, 0.0};
+            write_output_job(&output, 0);
+            int stage = (job->targets[i].format == FORMAT_BMP_PREVIEW) ? STATS_STAGE_PREVIEW_WRITE : STATS_STAGE_OUTPUT_WRITE;
+            job->stats.stage_ms[stage] += output.elapsed_ms;
+            if (!output.result) {
+                job->result = 0;
+            }
+        }
+    }
+    
+    stats_free(grayscale_data);
+    stats_free(packed_data);
+}
+
+/**
+ * @brief Przegląd kombinacji jasności i kontrastu z jednej skali szarości
+ * 
+ * @details Obraz jest odczytywany i konwertowany do skali szarości tylko raz.
+ * Każda kombinacja z zakresów --sweep-br i --sweep-ct (brak zakresu = jedna
+ * wartość z -br/-ct) jest zadaniem puli wątków, które zapisuje własny
+ * zestaw plików wyjściowych z przyrostkiem _brJASNOŚĆ_ctKONTRAST.
+ * 
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka pliku wyjściowego (podstawa nazw)
+ * @param grayscale_data Skala szarości 8bpp przed regulacją
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param stats Statystyki, do których doliczane są czasy wszystkich kombinacji
+ * 
+ * @return 1 jeśli wszystkie kombinacje zapisano, 0 w przypadku błędu
+ * 
+ * @example
+ * ```bash
+ * # 121 podglądów preview/br0_ct0.bmp ... preview/br100_ct100.bmp
+ * ./bmp_to_xbpp -1 -d floyd --sweep-br 0:100:10 --sweep-ct 0:100:10 --bmp image.bmp preview/
+ * ```
+ */
+static int run_brightness_contrast_sweep(ConversionContext* context, const char* output_path, uchar* grayscale_data, int width, int height, ConversionStats* stats) {
+    SweepRange brightness = context->sweep_brightness;
+    SweepRange contrast = context->sweep_contrast;
+    if (!brightness.step) {
+        SweepRange single = {context->brightness, context->brightness, 1};
+        brightness = single;
+    }
+    if (!contrast.step) {
+        SweepRange single = {context->contrast, context->contrast, 1};
+        contrast = single;
+    }
+    
+    int brightness_count = (brightness.last - brightness.first) / brightness.step + 1;
+    int contrast_count = (contrast.last - contrast.first) / contrast.step + 1;
+    int job_count = brightness_count * contrast_count;
+    
+    SweepJob* jobs = (SweepJob*)malloc(job_count * sizeof(SweepJob));
+    if (!jobs) {
+        printf("Error: Cannot allocate memory for sweep jobs\n");
+        return 0;
+    }
+    
+    OutputTarget targets[MAX_OUTPUT_TARGETS + 1];
+    int target_count = collect_output_targets(context, output_path, targets);
+    if (target_count == 0) {
+        free(jobs);
+        return 0;
+    }
+    
+    for (int b = 0; b < brightness_count; b++) {
+        for (int c = 0; c < contrast_count; c++) {
+            SweepJob* job = &jobs[b * contrast_count + c];
+            job->context = *context;
+            job->context.brightness = brightness.first + b * brightness.step;
+            job->context.contrast = contrast.first + c * contrast.step;
+            job->grayscale_data = grayscale_data;
+            job->width = width;
+            job->height = height;
+            job->target_count = target_count;
+            for (int i = 0; i < target_count; i++) {
+                job->targets[i] = targets[i];
+                make_sweep_path(job->targets[i].path, job->context.brightness, job->context.contrast);
+            }
+            stats_reset(&job->stats);
+        }
+    }
+    
+    print_progress("- sweep: %d brightness x %d contrast = %d combinations\n", brightness_count, contrast_count, job_count);
+    int thread_count = run_parallel(job_count, run_sweep_job, jobs, 0);
+    print_progress("- sweep threads: %d\n", thread_count);
+    
+    int success = 1;
+    for (int i = 0; i < job_count; i++) {
+        for (int stage = 0; stage < STATS_STAGE_COUNT; stage++) {
+            stats->stage_ms[stage] += jobs[i].stats.stage_ms[stage];
+        }
+        if (jobs[i].result) {
+            print_progress("- br %3d%% ct %3d%%: %s\n", jobs[i].context.brightness, jobs[i].context.contrast, jobs[i].targets[0].path);
+        } else {
+            printf("Error: Failed to write outputs for brightness %d%%, contrast %d%%\n", jobs[i].context.brightness, jobs[i].context.contrast);
+            success = 0;
+        }
+    }
+    
+    free(jobs);
+    return success;
+}
+
+/**
+ * @brief Konwertuje dane obrazu wejściowego do skali szarości
+ * 
+ * @details Wybiera dekoder zależnie od formatu: RLE, obraz z paletą albo
+ * 24/32 bpp. Dane nieskompresowane są czytane przez widok wierszy, więc
+ * obie orientacje BMP obsługuje ten sam kod bez kopiowania.
+ * 
+ * @param image_data Dane obrazu z pliku
+ * @param image_data_size Rozmiar danych obrazu
+ * @param info Nagłówek informacyjny (wysokość po normalize_bmp_height())
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * @param gray_lut Tablica palety lub NULL dla 24/32 bpp
+ * @param bits_per_pixel Głębia wyjściowa (skala wg BPP_GRAYSCALE_SHIFT())
+ * @param grayscale_data Bufor wyjściowy
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int convert_input_to_grayscale(uchar* image_data, size_t image_data_size, BMPInfoHeader* info, int top_down, const uchar* gray_lut,
+                                      int bits_per_pixel, uchar* grayscale_data, int grayscale_stride) {
+    if (info->compression != BMP_COMPRESSION_NONE) {
+        return decode_bmp_rle(image_data, image_data_size, grayscale_data, (int)info->width, (int)info->height, grayscale_stride, info->compression, gray_lut);
+    }
+    
+    ImageRowView view;
+    make_bmp_row_view(&view, image_data, info->width, (int)info->height, info->bits_per_pixel, top_down);
+    if (gray_lut) {
+        return convert_indexed_to_grayscale(&view, grayscale_data, grayscale_stride, gray_lut);
+    }
+    return convert_to_grayscale_bpp(&view, grayscale_data, grayscale_stride, bits_per_pixel);
+}
+
+/**
+ * @brief Wyszukuje tablicę wcześniejszego wycinka o tych samych danych
+ * 
+ * @param written Tablice zapisane w tym przebiegu (NULL = bez deduplikacji)
+ * @param packed_data Spakowane dane bieżącego wycinka
+ * @param packed_size Rozmiar danych w bajtach
+ * @param hash Skrót content_hash() danych
+ * 
+ * @return Tablica z identycznymi danymi lub NULL
+ */
+static const WrittenArray* find_written_array(const WrittenArrays* written, const uchar* packed_data, size_t packed_size, unsigned long long hash) {
+    for (int i = 0; written && i < written->count; i++) {
+        const WrittenArray* array = &written->arrays[i];
+        if (array->hash == hash && array->size == packed_size && memcmp(array->data, packed_data, packed_size) == 0) {
+            return array;
+        }
+    }
+    return NULL;
+}
+
+// Zapamiętuje tablicę z pełnymi danymi; bez pamięci na kopię kolejne wycinki po prostu jej nie aliasują
+static void add_written_array(WrittenArrays* written, const uchar* packed_data, size_t packed_size, unsigned long long hash, const char* array_name) {
+    if (written->count >= MAX_CROP_REGIONS) {
+        return;
+    }
+    WrittenArray* array = &written->arrays[written->count];
+    array->data = (uchar*)stats_malloc(packed_size);
+    if (!array->data) {
+        return;
+    }
+    memcpy(array->data, packed_data, packed_size);
+    array->size = packed_size;
+    array->hash = hash;
+    strcpy(array->array_name, array_name);
+    written->count++;
+}
+
+/**
+ * @brief Kończy konwersję: inwersja i zapis wszystkich celów wyjściowych
+ * 
+ * @details Wspólna część ścieżki całej klatki i przetwarzania pasmami
+ * (--max-mem) - obie kończą się tym samym buforem packed_data.
+ * 
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param packed_data Spakowane dane całego obrazu
+ * @param packed_size Rozmiar spakowanych danych w bajtach
+ * @param width Szerokość skali szarości (przed obrotem --rotate)
+ * @param height Wysokość obrazu (przed obrotem --rotate)
+ * @param stats Statystyki etapów
+ * 
+ * @return 1 w przypadku sukcesu, 0 gdy zapis pliku wyjściowego się nie powiódł
+ */
+static int finish_conversion(ConversionContext* context, const char* output_path, uchar* packed_data, size_t packed_size, int width, int height, ConversionStats* stats) {
+    // Nagłówki, podgląd i układ sterownika opisują obraz po obrocie i odbiciu
+    oriented_size(conversion_orientation(context), width, height, &width, &height);
+
+    // Zastosuj inwersję przed zapisem pliku i podglądu (--color indexed odwraca kolory palety, nie indeksy)
+    if (context->invert && context->color_format != COLOR_FORMAT_INDEXED) {
+        double stage_start = stats_stage_begin();
+        invert_conversion_data(context, packed_data, packed_size, width, height);
+        stats_stage_end(stats, STATS_STAGE_INVERSION, stage_start);
+    }
+
+    // Zasób manifestu: zachowaj kopię danych do zbiorczego wyjścia zamiast zapisywać pliki
+    if (context->capture) {
+        context->capture->data = (uchar*)stats_malloc(packed_size);
+        if (!context->capture->data) {
+            printf("Error: Cannot allocate memory for packed data\n");
+            return 0;
+        }
+        memcpy(context->capture->data, packed_data, packed_size);
+        context->capture->size = packed_size;
+        context->capture->width = width;
+        context->capture->height = height;
+        return 1;
+    }
+
+    // Zbierz cele wyjściowe - wszystkie zapisywacze korzystają z tych samych packed_data
+    OutputTarget targets[MAX_OUTPUT_TARGETS + 1];
+    int target_count = collect_output_targets(context, output_path, targets);
+    if (target_count == 0) {
+        return 0;
+    }
+
+    // Kilka wycinków --crop: dane identyczne z wcześniejszym wycinkiem trafiają do tablic C i assemblera jako alias
+    int named_targets = 0;
+    for (int i = 0; i < target_count; i++) {
+        named_targets += FORMAT_HAS_ARRAY_NAME(targets[i].format);
+    }
+    unsigned long long hash = 0;
+    const WrittenArray* original = NULL;
+    if (context->written_arrays && named_targets > 0) {
+        hash = content_hash(CONTENT_HASH_SEED, packed_data, packed_size);
+        original = find_written_array(context->written_arrays, packed_data, packed_size, hash);
+    }
+
+    OutputJob jobs[MAX_OUTPUT_TARGETS + 1];
+    for (int i = 0; i < target_count; i++) {
+        OutputJob job = {context, &targets[i], packed_data, packed_size, width, height, 0, 0.0, original ? original->array_name : NULL};
+        jobs[i] = job;
+    }
+    run_parallel(target_count, write_output_job, jobs, target_count);
+
+    int write_failed = 0;
+    for (int i = 0; i < target_count; i++) {
+        if (targets[i].format == FORMAT_BMP_PREVIEW) {
+            stats->stage_ms[STATS_STAGE_PREVIEW_WRITE] += jobs[i].elapsed_ms;
+            int palette = (context->bits_per_pixel == BITS_PER_PIXEL_1BPP) ? context->palette_variant : context->palette_4bpp_variant;
+            if (jobs[i].result && palette == PALETTE_ALL && context->color_format == COLOR_FORMAT_NONE) {
+                for (int variant = 0; variant < PALETTE_PRESET_COUNT; variant++) {
+                    char variant_path[256];
+                    make_palette_preview_path(variant_path, sizeof(variant_path), targets[i].path, variant);
+                    print_progress("- BMP preview saved: %s\n", variant_path);
+                }
+            } else if (jobs[i].result) {
+                print_progress("- BMP preview saved: %s\n", targets[i].path);
+            } else {
+                printf("Warning: Failed to generate BMP preview\n");
+            }
+        } else {
+            stats->stage_ms[STATS_STAGE_OUTPUT_WRITE] += jobs[i].elapsed_ms;
+            if (!jobs[i].result) {
+                printf("Error: Failed to write output file %s\n", targets[i].path);
+                write_failed = 1;
+            } else if (context->output_count > 0) {
+                print_progress("- output saved: %s\n", targets[i].path);
+            }
+        }
+    }
+    if (write_failed) {
+        return 0;
+    }
+
+    if (original) {
+        print_progress("- same data as %s, written as an alias\n", original->array_name);
+        context->written_arrays->duplicates++;
+        context->written_arrays->saved_size += packed_size * (size_t)named_targets;
+    } else if (context->written_arrays && named_targets > 0) {
+        add_written_array(context->written_arrays, packed_data, packed_size, hash, context->array_name);
+    }
+
+    print_progress("- conversion completed successfully\n");
+    print_progress("- packed data size: %lu bytes\n", (unsigned long)packed_size);
+    return 1;
+}
+
+/**
+ * @brief Wypisuje opcje konwersji
+ * 
+ * @param context Kontekst konwersji
+ */
+static void print_conversion_options(ConversionContext* context) {
+    print_progress("- opcje konwersji:\n");
+    if (context->color_format != COLOR_FORMAT_NONE) {
+        print_progress("  - format koloru: %s (%dbpp)\n", color_format_name(context->color_format), color_format_bits(context->color_format));
+        if (context->color_format == COLOR_FORMAT_INDEXED) {
+            print_progress("  - przebiegi k-means: %d\n", context->kmeans_iterations);
+        }
+    } else {
+        print_progress("  - głębia kolorów: %dbpp\n", context->bits_per_pixel);
+    }
+    if (context->display_layout != DISPLAY_LAYOUT_NONE) {
+        print_progress("  - układ sterownika: %s%s\n", display_layout_name(context->display_layout),
+               context->page_commands == PAGE_COMMANDS_I2C ? " z komendami stron (I2C)" :
+               context->page_commands == PAGE_COMMANDS_SPI ? " z komendami stron (SPI)" : "");
+    } else {
+        print_progress("  - kierunek skanowania: %s\n", context->scan_direction ? "poziomy" : "pionowy");
+        print_progress("  - kolejność pikseli: %s endian\n", context->pixel_order ? "little" : "big");
+    }
+    if (context->rotation || context->flip) {
+        print_progress("  - orientacja: obrót %d°%s%s\n", context->rotation,
+               (context->flip & FLIP_HORIZONTAL) ? ", odbicie poziome" : "",
+               (context->flip & FLIP_VERTICAL) ? ", odbicie pionowe" : "");
+    }
+    print_progress("  - format wyjściowy: %s\n", 
+           context->output_format == FORMAT_C_ARRAY ? "Tablica C (.h)" :
+           context->output_format == FORMAT_RAW_DATA ? "Surowe dane (.hex)" : "Assembler (.inc)");
+    print_progress("  - PROGMEM: %s\n", context->use_progmem ? "tak" : "nie");
+    print_progress("  - nazwa tablicy: %s\n", context->array_name);
+    if (BPP_IS_DITHERED(context->bits_per_pixel) || context->color_format != COLOR_FORMAT_NONE) {
+        print_progress("  - metoda ditheringu: %s\n",
+               context->dithering_method == DITHERING_NONE ? "Brak" : dithering_method_name(context->dithering_method));
+    }
+    if (context->color_format != COLOR_FORMAT_NONE) {
+        if (context->invert) {
+            print_progress("  - inwersja bitów: włączona\n");
+        }
+        return;
+    }
+    if (BPP_IS_DITHERED(context->bits_per_pixel)) {
+        print_progress("  - jasność: %d%%\n", context->brightness);
+        print_progress("  - kontrast: %d%%\n", context->contrast);
+    }
+    const char* palette_names[] = {"BW", "GRAY", "GREEN", "PORTFOLIO", "OLED_YELLOW", "CUSTOM", "ALL"};
+    int palette = (context->bits_per_pixel == BITS_PER_PIXEL_1BPP) ? context->palette_variant : context->palette_4bpp_variant;
+    print_progress("  - paleta: %s\n", palette_names[palette]);
+    if (palette == PALETTE_CUSTOM) {
+        print_progress("    - pierwszy kolor: (%d,%d,%d)\n", context->custom_color_first[2], context->custom_color_first[1], context->custom_color_first[0]);
+        print_progress("    - ostatni kolor: (%d,%d,%d)\n", context->custom_color_last[2], context->custom_color_last[1], context->custom_color_last[0]);
+    }
+    if (context->invert) {
+        print_progress("  - inwersja bitów: włączona\n");
+    }
+}
+
+/**
+ * @brief Wykonuje etapy po konwersji do skali szarości i zapisuje wyniki
+ * 
+ * @details Wspólna część ścieżki całej klatki dla wszystkich formatów
+ * wejściowych: dla głębi z ditheringiem (1bpp, 2bpp, 4bpp) przegląd jasności
+ * i kontrastu albo regulacja, dithering i kwantyzacja, następnie pakowanie
+ * i finish_conversion().
+ * 
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param grayscale_data Skala szarości całego obrazu (0-255)
+ * @param width Szerokość skali szarości
+ * @param height Wysokość obrazu
+ * @param packed_size Rozmiar spakowanych danych w bajtach
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
+ * 
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ */
+static int process_grayscale_frame(ConversionContext* context, const char* output_path, uchar* grayscale_data, int width, int height,
+                                   size_t packed_size, ConversionStats* stats, double conversion_start) {
+    double stage_start;
+    
+    if (!is_supported_bpp(context->bits_per_pixel)) {
+        printf("Error: Unsupported bits per pixel: %d\n", context->bits_per_pixel);
+        return 1;
+    }
+
+    if (BPP_IS_DITHERED(context->bits_per_pixel)) {
+        // Etapy 1bpp/2bpp/4bpp wywoływane osobno, aby --stats mógł zmierzyć każdy z nich
+        if (context->sweep_brightness.step || context->sweep_contrast.step) {
+            // Przegląd: skala szarości jest wspólna, pozostałe etapy wykonuje każda kombinacja
+            int swept = run_brightness_contrast_sweep(context, output_path, grayscale_data, width, height, stats);
+            print_conversion_stats(context, stats, conversion_start);
+            return swept ? 0 : 1;
+        }
+
+        stage_start = stats_stage_begin();
+        int converted = adjust_brightness_contrast(grayscale_data, width, height, context->brightness, context->contrast);
+        stats_stage_end(stats, STATS_STAGE_BRIGHTNESS, stage_start);
+        if (converted) {
+            stage_start = stats_stage_begin();
+            converted = apply_dithering(grayscale_data, width, height, context->dithering_method, BPP_LEVELS(context->bits_per_pixel)) &&
+                        quantize_to_bpp(grayscale_data, width, height, context->bits_per_pixel);
+            stats_stage_end(stats, STATS_STAGE_DITHERING, stage_start);
+        }
+        if (!converted) {
+            printf("Error: Failed to convert to grayscale with dithering\n");
+            return 1;
+        }
+    }
+
+    // Pakuj piksele w odpowiednim formacie
+    uchar* packed_data = (uchar*)stats_malloc(packed_size);
+    if (!packed_data) {
+        printf("Error: Cannot allocate memory for packed data\n");
+        return 1;
+    }
+
+    // Kernel pakowania wybierany według głębi lub układu sterownika (--layout)
+    stage_start = stats_stage_begin();
+    int pack_result = pack_conversion_pixels(context, grayscale_data, packed_data, width, height);
+    if (!pack_result) {
+        printf("Error: Failed to pack pixels\n");
+        stats_free(packed_data);
+        return 1;
+    }
+    stats_stage_end(stats, STATS_STAGE_PACKING, stage_start);
+
+    int written = finish_conversion(context, output_path, packed_data, packed_size, width, height, stats);
+    stats_free(packed_data);
+    if (!written) {
+        return 1;
+    }
+    print_conversion_stats(context, stats, conversion_start);
+    return 0;
+}
+
+// ============================================================================
+// Wyjście kolorowe RGB565/RGB332/RGB444 i indeksowane (--color)
+// ============================================================================
+
+/**
+ * @brief Kwantyzuje obraz do palety 16 kolorów i pakuje indeksy jako 4bpp
+ * 
+ * @details Paleta (median cut i opcjonalne przebiegi k-means) trafia do
+ * context->image_palette - zapisywacze dopisują ją za danymi obrazu,
+ * a podgląd BMP używa jej zamiast palety skali szarości. Z inwersją (-i)
+ * odwracane są kolory palety, więc indeksy pozostają bez zmian.
+ * 
+ * @param view Widok wierszy obrazu 24/32 bpp
+ * @param context Kontekst konwersji (wynik: image_palette)
+ * @param packed_data Bufor wyjściowy 4bpp
+ * @param width Szerokość obrazu (przy nieparzystej kernel zeruje nieużywaną połowę ostatniego bajtu linii)
+ * @param stats Statystyki etapów
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Wyznaczanie palety i mapowanie pikseli są mierzone jako etap ditheringu
+ */
+static int pack_indexed_color(ImageRowView* view, ConversionContext* context, uchar* packed_data, int width, ConversionStats* stats) {
+    uchar* indices = (uchar*)stats_malloc((size_t)width * (size_t)view->height);
+    if (!indices) {
+        printf("Error: Cannot allocate memory for palette indices\n");
+        return 0;
+    }
+
+    double stage_start = stats_stage_begin();
+    uchar palette[INDEXED_PALETTE_COLORS * 3];
+    int used = build_image_palette(view, INDEXED_PALETTE_COLORS, context->kmeans_iterations, palette);
+    int mapped = used > 0 && map_to_palette(view, palette, used, indices, width);
+    stats_stage_end(stats, STATS_STAGE_DITHERING, stage_start);
+    if (!mapped) {
+        printf("Error: Failed to quantize colors\n");
+        stats_free(indices);
+        return 0;
+    }
+    print_progress("- palette colors: %d of %d\n", used, INDEXED_PALETTE_COLORS);
+    for (int i = 0; i < INDEXED_PALETTE_COLORS; i++) {
+        for (int c = 0; c < 3; c++) {
+            uchar value = palette[i * 3 + c];
+            context->image_palette[i][c] = context->invert ? (uchar)(255 - value) : value;
+        }
+    }
+
+    stage_start = stats_stage_begin();
+    int packed = pack_pixels(indices, packed_data, width, view->height, BITS_PER_PIXEL_4BPP, context->scan_direction, context->pixel_order);
+    stats_stage_end(stats, STATS_STAGE_PACKING, stage_start);
+    stats_free(indices);
+    return packed;
+}
+
+/**
+ * @brief Konwertuje BMP 24/32-bitowy na wyjście kolorowe
+ * 
+ * @details Piksele BGR są pakowane wprost do formatu wyświetlacza
+ * (pack_color_pixels()) - bez etapu skali szarości. Format indexed
+ * wyznacza paletę z obrazu i pakuje indeksy jako 4bpp
+ * (pack_indexed_color()). Wynik trafia do tych samych zapisywaczy co dane
+ * w skali szarości (finish_conversion()).
+ * 
+ * @param file Plik wejściowy (pozycja za nagłówkami)
+ * @param header Nagłówek pliku BMP
+ * @param info Nagłówek informacyjny (wysokość po normalize_bmp_height())
+ * @param top_down 1 jeśli wiersze w pliku idą od góry obrazu
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param position Bieżąca pozycja w strumieniu wejściowym
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
+ * 
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ * 
+ * @note Obraz jest zawsze przetwarzany w całości - --max-mem jest pomijane
+ */
+static int convert_color_input(FILE* file, BMPHeader* header, BMPInfoHeader* info, int top_down, ConversionContext* context, const char* output_path,
+                               unsigned long long* position, ConversionStats* stats, double conversion_start) {
+    if (info->bits_per_pixel < 24 || info->compression != BMP_COMPRESSION_NONE) {
+        printf("Error: --color requires a 24-bit or 32-bit BMP input\n");
+        return 1;
+    }
+    if (context->max_memory > 0) {
+        printf("Warning: --max-mem is not supported with --color, converting the full frame\n");
+    }
+
+    int width = (int)info->width;
+    int height = (int)info->height;
+    int indexed = (context->color_format == COLOR_FORMAT_INDEXED);
+    size_t row_size = calculate_bmp_row_size(info->width, info->bits_per_pixel);
+    size_t image_data_size, index_count;
+    size_t packed_size = indexed ? calculate_packed_size(width, height, BITS_PER_PIXEL_4BPP, context->scan_direction)
+                                 : calculate_color_packed_size(width, height, context->color_format, context->scan_direction);
+    if (!size_multiply(row_size, info->height, &image_data_size) || !size_multiply((size_t)width, (size_t)height, &index_count) || packed_size == 0) {
+        printf("Error: Image too large for this platform (%dx%d)\n", width, height);
+        return 1;
+    }
+
+    double stage_start = stats_stage_begin();
+    uchar* image_data = (uchar*)stats_malloc(image_data_size);
+    if (!image_data) {
+        printf("Error: Cannot allocate memory for image data\n");
+        return 1;
+    }
+    if (!read_bmp_image_data(file, image_data, image_data_size, header->data_offset, position)) {
+        printf("Error: Cannot read image data\n");
+        stats_free(image_data);
+        return 1;
+    }
+    stats_stage_end(stats, STATS_STAGE_PIXEL_READ, stage_start);
+
+    uchar* packed_data = (uchar*)stats_malloc(packed_size);
+    if (!packed_data) {
+        printf("Error: Cannot allocate memory for packed data\n");
+        stats_free(image_data);
+        return 1;
+    }
+
+    ImageRowView view;
+    make_bmp_row_view(&view, image_data, info->width, height, info->bits_per_pixel, top_down);
+    int packed;
+    if (indexed) {
+        packed = pack_indexed_color(&view, context, packed_data, width, stats);
+    } else {
+        // Dithering kanałów i pakowanie to jeden etap - mierzony jako pakowanie
+        stage_start = stats_stage_begin();
+        packed = pack_color_pixels(&view, packed_data, context->color_format, context->dithering_method, context->scan_direction);
+        stats_stage_end(stats, STATS_STAGE_PACKING, stage_start);
+    }
+    stats_free(image_data);
+    if (!packed) {
+        printf("Error: Failed to pack color pixels\n");
+        stats_free(packed_data);
+        return 1;
+    }
+
+    int written = finish_conversion(context, output_path, packed_data, packed_size, width, height, stats);
+    stats_free(packed_data);
+    if (!written) {
+        return 1;
+    }
+    print_conversion_stats(context, stats, conversion_start);
+    return 0;
+}
+
+// ============================================================================
+// Wejście PNG i PGM/PPM oraz BMP ze skalowaniem (dekodowane wiersz po wierszu)
+// ============================================================================
+
+// Nagłówek obrazu dekodowanego wiersz po wierszu
+typedef struct {
+    int format;                // IMAGE_FORMAT_PNG, IMAGE_FORMAT_PNM lub IMAGE_FORMAT_BMP (--resize)
+    PngInfo png;
+    PnmInfo pnm;
+    BMPHeader* bmp_header;     // Pola BMP (decode_bmp_rows())
+    BMPInfoHeader* bmp_info;
+    int bmp_top_down;
+    const uchar* bmp_gray_lut;
+    unsigned long long* bmp_position;
+    const CropRect* crop;      // Wycinek --crop (NULL = cały obraz)
+} DecodedInput;
+
+// Filtr wierszy PNG/PGM/PPM przekazujący dalej tylko wiersze i kolumny wycinka
+typedef struct {
+    const CropRect* crop;
+    ImageRowCallback output;
+    void* output_arg;
+    int done;                  // 1 = ostatni wiersz wycinka przekazany, dekodowanie przerwane
+} CropRowFilter;
+
+// Odbiorca wierszy zapisujący je do skali szarości całej klatki
+typedef struct {
+    uchar* grayscale_data;
+    int stride;                // Odstęp wierszy
+    int width;                 // Szerokość obrazu
+    int bits_per_pixel;
+} FrameRowSink;
+
+// Odbiorca wierszy przekazujący je do przetwarzania pasmami (--max-mem)
+typedef struct {
+    BandSink band;
+    int width;                 // Szerokość obrazu
+} BandRowSink;
+
+// Zapisuje wiersz 0-255 z dekodera w skali trybu konwersji (BPP_GRAYSCALE_SHIFT())
+static void store_gray_row(uchar* dst, const uchar* gray_row, int width, int bits_per_pixel) {
+    int shift = BPP_GRAYSCALE_SHIFT(bits_per_pixel);
+    if (shift == 0) {
+        memcpy(dst, gray_row, width);
+        return;
+    }
+    for (int x = 0; x < width; x++) {
+        dst[x] = (uchar)(gray_row[x] >> shift);
+    }
+}
+
+static int store_frame_row(void* arg, int y, const uchar* gray_row) {
+    FrameRowSink* sink = (FrameRowSink*)arg;
+    store_gray_row(sink->grayscale_data + (size_t)y * sink->stride, gray_row, sink->width, sink->bits_per_pixel);
+    return 1;
+}
+
+static int store_band_row(void* arg, int y, const uchar* gray_row) {
+    BandRowSink* sink = (BandRowSink*)arg;
+    int free_rows;
+    uchar* dst = band_sink_next_rows(&sink->band, &free_rows);
+    (void)y;
+    store_gray_row(dst, gray_row, sink->width, sink->band.context->bits_per_pixel);
+    return band_sink_commit(&sink->band, 1);
+}
+
+static int crop_decoded_row(void* arg, int y, const uchar* gray_row) {
+    CropRowFilter* filter = (CropRowFilter*)arg;
+    const CropRect* crop = filter->crop;
+    if (y < crop->y) {
+        return 1;
+    }
+    if (!filter->output(filter->output_arg, y - crop->y, gray_row + crop->x)) {
+        return 0;
+    }
+    if (y + 1 == crop->y + crop->height) {
+        // Wiersze poniżej wycinka nie są potrzebne - przerwij dekodowanie
+        filter->done = 1;
+        return 0;
+    }
+    return 1;
+}
+
+static int decode_input_rows(FILE* file, DecodedInput* input, ImageRowCallback row_callback, void* callback_arg) {
+    if (input->format == IMAGE_FORMAT_BMP) {
+        // Wycinek BMP jest czytany wprost z położenia wierszy w pliku
+        return decode_bmp_rows(file, input->bmp_header, input->bmp_info, input->bmp_top_down, input->bmp_gray_lut, input->crop,
+                               row_callback, callback_arg, input->bmp_position);
+    }
+
+    CropRowFilter filter = {input->crop, row_callback, callback_arg, 0};
+    if (input->crop) {
+        row_callback = crop_decoded_row;
+        callback_arg = &filter;
+    }
+    int decoded = (input->format == IMAGE_FORMAT_PNG) ? decode_png_rows(file, &input->png, row_callback, callback_arg)
+                                                      : decode_pnm_rows(file, &input->pnm, row_callback, callback_arg);
+    return decoded || filter.done;
+}
+
+/**
+ * @brief Konwertuje obraz dekodowany wiersz po wierszu
+ * 
+ * @details Wiersze dekodera trafiają od razu do skali szarości całej
+ * klatki albo - gdy klatka nie mieści się w --max-mem - do przetwarzania
+ * pasmami. Przy --resize między dekoder a odbiorcę wchodzi skalowanie
+ * strumieniowe (resampler_push_row()), więc klatka i pasma mają już
+ * rozmiar docelowy, a skala szarości źródła nie jest nigdzie trzymana
+ * w całości.
+ * 
+ * @param file Plik wejściowy (pozycja za nagłówkiem)
+ * @param input Nagłówek obrazu
+ * @param image_width Szerokość źródła
+ * @param image_height Wysokość źródła
+ * @param decoder_memory Stała pamięć buforów dekodera
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
+ * 
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ * 
+ * @note Czas skalowania jest raportowany razem z dekodowaniem jako pixel_read
+ */
+static int convert_streamed_input(FILE* file, DecodedInput* input, int image_width, int image_height, size_t decoder_memory,
+                                  ConversionContext* context, const char* output_path, ConversionStats* stats, double conversion_start) {
+    double stage_start;
+    int is_resized = context->resize_width || context->resize_height;
+    if (input->crop) {
+        image_width = input->crop->width;
+        image_height = input->crop->height;
+    }
+    int input_width = image_width;
+    int input_height = image_height;
+    Resampler resampler;
+    ImageRowCallback row_callback;
+    void* row_sink;
+
+    if (is_resized) {
+        // Tablice wag skalowania rosną z szerokością źródła - nagłówek bez danych nie może ich zaalokować
+        if (input->format == IMAGE_FORMAT_BMP && !bmp_data_within_file(file, input->bmp_header, input->bmp_info)) {
+            printf("Error: Cannot read image data\n");
+            return 1;
+        }
+        int resize_width = context->resize_width;
+        int resize_height = context->resize_height;
+        resize_target_size(image_width, image_height, &resize_width, &resize_height);
+        print_progress("- resizing %dx%d to %dx%d (%s filter)\n", image_width, image_height, resize_width, resize_height,
+               resize_filter_name(context->resize_filter));
+        decoder_memory += calculate_resampler_memory(image_width, image_height, resize_width, resize_height, context->resize_filter);
+        image_width = resize_width;
+        image_height = resize_height;
+    }
+
+    // Szerokość skali szarości to szerokość obrazu - kernele zerują niepełny ostatni bajt linii 4bpp
+    int width = image_width;
+    int height = image_height;
+
+    if (!check_conversion_layout_size(context, width, height)) {
+        return 1;
+    }
+    size_t pixel_count;
+    size_t packed_size = calculate_conversion_packed_size(context, width, height);
+    if (!size_multiply((size_t)width, (size_t)height, &pixel_count) || packed_size == 0) {
+        printf("Error: Image too large for this platform (%dx%d)\n", image_width, image_height);
+        return 1;
+    }
+
+    int is_sweep = context->sweep_brightness.step || context->sweep_contrast.step;
+    size_t budget = context->max_memory;
+    int frame_fits = decoder_memory <= budget && pixel_count <= budget - decoder_memory &&
+                     packed_size <= budget - decoder_memory - pixel_count;
+    if (budget > 0 && !is_sweep && !frame_fits) {
+        // Bufory dekodera mają stały rozmiar - pasmo kosztuje tylko wiersze skali szarości
+        int band_rows = (budget > decoder_memory) ? calculate_band_rows(budget - decoder_memory, packed_size, 0, width, height) : 0;
+        if (band_rows == 0) {
+            printf("Error: --max-mem too small, need at least %lu bytes\n",
+                   (unsigned long)(decoder_memory + packed_size + (BAND_ROW_ALIGN + 1) * (size_t)width));
+            return 1;
+        }
+        print_progress("- processing in bands of %d rows (--max-mem %lu bytes)\n", band_rows, (unsigned long)context->max_memory);
+
+        uchar* packed_data = (uchar*)stats_malloc(packed_size);
+        if (!packed_data) {
+            printf("Error: Cannot allocate memory for packed data\n");
+            return 1;
+        }
+        BandRowSink sink;
+        sink.width = image_width;
+        if (!band_sink_init(&sink.band, context, width, height, band_rows, packed_data, stats)) {
+            stats_free(packed_data);
+            return 1;
+        }
+        row_callback = store_band_row;
+        row_sink = &sink;
+        if (is_resized && !resampler_init(&resampler, input_width, input_height, image_width, image_height, context->resize_filter, row_callback, row_sink)) {
+            band_sink_free(&sink.band);
+            stats_free(packed_data);
+            return 1;
+        }
+        if (is_resized) {
+            row_callback = resampler_push_row;
+            row_sink = &resampler;
+        }
+
+        // Etapy pasm są mierzone przez odbiornik - pixel_read to pozostały czas dekodowania
+        double band_ms = stats->stage_ms[STATS_STAGE_BRIGHTNESS] + stats->stage_ms[STATS_STAGE_DITHERING] + stats->stage_ms[STATS_STAGE_PACKING];
+        stage_start = stats_stage_begin();
+        int decoded = decode_input_rows(file, input, row_callback, row_sink);
+        band_ms = stats->stage_ms[STATS_STAGE_BRIGHTNESS] + stats->stage_ms[STATS_STAGE_DITHERING] + stats->stage_ms[STATS_STAGE_PACKING] - band_ms;
+        stats->stage_ms[STATS_STAGE_PIXEL_READ] += timing_elapsed_ms(stage_start) - band_ms;
+        if (is_resized) {
+            resampler_free(&resampler);
+        }
+        band_sink_free(&sink.band);
+        if (!decoded) {
+            printf("Error: Cannot decode image data\n");
+            stats_free(packed_data);
+            return 1;
+        }
+        int written = finish_conversion(context, output_path, packed_data, packed_size, width, height, stats);
+        stats_free(packed_data);
+        if (written) {
+            print_conversion_stats(context, stats, conversion_start);
+        }
+        return written ? 0 : 1;
+    }
+
+    uchar* grayscale_data = (uchar*)stats_malloc(pixel_count);
+    if (!grayscale_data) {
+        printf("Error: Cannot allocate memory for grayscale data\n");
+        return 1;
+    }
+
+    FrameRowSink sink = {grayscale_data, width, image_width, context->bits_per_pixel};
+    row_callback = store_frame_row;
+    row_sink = &sink;
+    if (is_resized) {
+        if (!resampler_init(&resampler, input_width, input_height, image_width, image_height, context->resize_filter, row_callback, row_sink)) {
+            stats_free(grayscale_data);
+            return 1;
+        }
+        row_callback = resampler_push_row;
+        row_sink = &resampler;
+    }
+    stage_start = stats_stage_begin();
+    int decoded = decode_input_rows(file, input, row_callback, row_sink);
+    stats_stage_end(stats, STATS_STAGE_PIXEL_READ, stage_start);
+    if (is_resized) {
+        resampler_free(&resampler);
+    }
+    if (!decoded) {
+        printf("Error: Cannot decode image data\n");
+        stats_free(grayscale_data);
+        return 1;
+    }
+
+    int exit_code = process_grayscale_frame(context, output_path, grayscale_data, width, height, packed_size, stats, conversion_start);
+    stats_free(grayscale_data);
+    return exit_code;
+}
+
+/**
+ * @brief Przygotowuje kontekst i ścieżkę wyjściową jednego z kilku wycinków
+ * 
+ * @details Przy kilku wycinkach każdy zapisuje własny zestaw plików:
+ * do ścieżki wyjściowej, ścieżek --out i nazwy tablicy dopisywany jest
+ * przyrostek - nazwa z --crop X,Y,SZER,WYS:NAZWA albo cropN. Pojedynczy
+ * wycinek zachowuje nazwy bez zmian.
+ */
+static void make_crop_context(ConversionContext* crop_context, char* crop_output_path, const char* output_path, int index) {
+    const CropRect* crop = &crop_context->crops[index];
+    char suffix[CROP_NAME_LENGTH + 16];
+
+    strncpy(crop_output_path, output_path, 255);
+    crop_output_path[255] = '\0';
+    if (crop_context->crop_count == 1) {
+        return;
+    }
+    if (crop->name[0]) {
+        snprintf(suffix, sizeof(suffix), "%s", crop->name);
+    } else {
+        snprintf(suffix, sizeof(suffix), "crop%d", index + 1);
+    }
+
+    if (!is_stdio_path(crop_output_path)) {
+        append_path_suffix(crop_output_path, suffix);
+    }
+    for (int i = 0; i < crop_context->output_count; i++) {
+        if (!is_stdio_path(crop_context->outputs[i].path)) {
+            append_path_suffix(crop_context->outputs[i].path, suffix);
+        }
+    }
+    size_t name_length = strlen(crop_context->array_name);
+    snprintf(crop_context->array_name + name_length, sizeof(crop_context->array_name) - name_length, "_%s", suffix);
+}
+
+/**
+ * @brief Konwertuje obraz dekodowany wiersz po wierszu w całości lub wycinkami (--crop)
  * 
- * @details Funkcja main implementuje główną logikę programu konwertującego
- * pliki BMP na tablice bajtów w różnych formatach (C array, raw data, assembler).
- * Obsługuje konwersję 1bpp i 4bpp z różnymi metodami ditheringu, paletami kolorów
- * i opcjami skanowania. Generuje pliki wyjściowe w wybranym formacie oraz
- * opcjonalne podglądy BMP.
+ * @details Każdy wycinek przechodzi osobno przez convert_streamed_input()
+ * jako samodzielny obraz (z --resize skalowany jest sam wycinek). Wycinek
+ * BMP jest czytany wprost z położenia swoich wierszy w pliku; PNG i PGM/PPM
+ * są dekodowane od początku pliku tylko do ostatniego wiersza wycinka.
  * 
- * @param argc Liczba argumentów wiersza poleceń
- * @param argv Tablica argumentów wiersza poleceń
+ * @param file Plik wejściowy (pozycja za nagłówkiem)
+ * @param input Nagłówek obrazu
+ * @param image_width Szerokość obrazu
+ * @param image_height Wysokość obrazu
+ * @param decoder_memory Stała pamięć buforów dekodera całego obrazu
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
  * 
- * @return 0 w przypadku sukcesu, 1 w przypadku błędu
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
  * 
- * @note Wyświetla informacje o wersji i autorze przy starcie
- * @note Parsuje argumenty wiersza poleceń
- * @note Obsługuje wszystkie formaty wyjściowe i opcje konwersji
- * @note Generuje podglądy BMP z różnymi paletami
- * @note Obsługuje inwersję bitów i różne kierunki skanowania
+ * @note Kilka wycinków wymaga pliku z przewijaniem (nie potoku)
+ */
+static int convert_streamed_regions(FILE* file, DecodedInput* input, int image_width, int image_height, size_t decoder_memory,
+                                    ConversionContext* context, const char* output_path, ConversionStats* stats, double conversion_start) {
+    if (context->crop_count == 0) {
+        input->crop = NULL;
+        return convert_streamed_input(file, input, image_width, image_height, decoder_memory, context, output_path, stats, conversion_start);
+    }
+
+    for (int i = 0; i < context->crop_count; i++) {
+        const CropRect* crop = &context->crops[i];
+        if (crop->x > image_width - crop->width || crop->y > image_height - crop->height) {
+            printf("Error: --crop region %d,%d,%d,%d is outside the %dx%d image\n", crop->x, crop->y, crop->width, crop->height,
+                   image_width, image_height);
+            return 1;
+        }
+    }
+    if (context->crop_count > 1 && !input_is_seekable(file)) {
+        printf("Error: Several --crop regions require a seekable input file (not a pipe)\n");
+        return 1;
+    }
+
+    ConversionContext* crop_context = (ConversionContext*)malloc(sizeof(ConversionContext));
+    // Z --dedup wycinki o identycznych danych (puste klatki, powtórzone ikony) zapisują dane raz
+    WrittenArrays* written = (context->crop_count > 1 && context->dedup_crops) ? (WrittenArrays*)calloc(1, sizeof(WrittenArrays)) : NULL;
+    if (!crop_context || (context->crop_count > 1 && context->dedup_crops && !written)) {
+        printf("Error: Cannot allocate memory for crop context\n");
+        free(crop_context);
+        return 1;
+    }
+    int exit_code = 0;
+    for (int i = 0; i < context->crop_count && exit_code == 0; i++) {
+        char crop_output_path[256];
+        *crop_context = *context;
+        crop_context->written_arrays = written;
+        make_crop_context(crop_context, crop_output_path, output_path, i);
+        input->crop = &crop_context->crops[i];
+        print_progress("- crop %d/%d: %dx%d at %d,%d -> %s\n", i + 1, context->crop_count, input->crop->width, input->crop->height,
+               input->crop->x, input->crop->y, crop_context->array_name);
+
+        size_t crop_decoder_memory = decoder_memory;
+        if (input->format == IMAGE_FORMAT_BMP) {
+            crop_decoder_memory = calculate_bmp_decoder_memory(input->bmp_header, input->bmp_info, input->crop, input->bmp_top_down, input_is_seekable(file));
+        } else if (i > 0) {
+            // PNG i PGM/PPM są dekodowane od początku - ponowny odczyt nagłówka
+            rewind(file);
+            int reread = (input->format == IMAGE_FORMAT_PNG) ? read_png_header(file, &input->png) : read_pnm_header(file, &input->pnm);
+            if (!reread) {
+                printf("Error: Cannot re-read image header for crop %d\n", i + 1);
+                exit_code = 1;
+                break;
+            }
+        }
+        exit_code = convert_streamed_input(file, input, image_width, image_height, crop_decoder_memory, crop_context, crop_output_path, stats, conversion_start);
+    }
+    input->crop = NULL;
+    free(crop_context);
+    if (written) {
+        if (exit_code == 0 && written->duplicates > 0) {
+            print_progress("- dedup: %d duplicate crops written as aliases, %lu bytes saved\n", written->duplicates,
+                           (unsigned long)written->saved_size);
+        }
+        for (int i = 0; i < written->count; i++) {
+            stats_free(written->arrays[i].data);
+        }
+        free(written);
+    }
+    return exit_code;
+}
+
+/**
+ * @brief Konwertuje obraz PNG lub PGM/PPM
  * 
- * @example
- * ```bash
- * # Konwersja 4bpp z domyślnymi ustawieniami
- * ./bmp_to_xbpp image.bmp
+ * @details Dekodery przekazują wiersze od góry obrazu już w skali szarości,
+ * więc nie ma bufora surowych danych pliku: wiersze trafiają od razu do
+ * skali szarości całej klatki albo - gdy klatka nie mieści się w --max-mem
+ * - do przetwarzania pasmami. Dalsze etapy są wspólne z wejściem BMP.
  * 
- * # Konwersja 1bpp z ditheringiem Floyd-Steinberg
- * ./bmp_to_xbpp -1 -d floyd image.bmp
+ * @param file Plik wejściowy (pozycja na początku)
+ * @param format IMAGE_FORMAT_PNG lub IMAGE_FORMAT_PNM
+ * @param context Kontekst konwersji
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param stats Statystyki etapów
+ * @param conversion_start Znacznik początku konwersji
  * 
- * # Konwersja z podglądem BMP i paletą zieloną
- * ./bmp_to_xbpp -1 --bmp --palette green image.bmp
- * ```
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ * 
+ * @note Czas dekodowania (dekompresja, filtry, konwersja koloru) jest
+ *       raportowany jako etap pixel_read
  */
-int main(int argc, char* argv[]) {
-    printf("\n");
-    printf("BMP to xbpp Array Converter %s (%s) (c) %s (https://ptodt.org.pl)\n", VERSION_STRING, BUILD_DATETIME, COPYRIGHT_STRING);
-    printf("\n");
-    printf("CODE BY                                      \n");
-    printf("    ----.-.---.---.---.                      \n");
-    printf("        |-.---.   |--.|#==---.. .  .  .      \n");
-    printf("     |  | |   | --.   |#==---. . .           \n");
-    printf("    -'--'-'---'---'---'               2025.09\n");
-    printf("\n");
+static int convert_decoded_input(FILE* file, int format, ConversionContext* context, const char* output_path, ConversionStats* stats, double conversion_start) {
+    double stage_start = stats_stage_begin();
+    DecodedInput input;
+    input.format = format;
+    int image_width, image_height;
+    size_t decoder_memory;
 
-    ConversionContext context = {1, 1, FORMAT_C_ARRAY, 0, "image_data", BITS_PER_PIXEL_4BPP, DITHERING_NONE, 50, 50, 0, 0, 0, 0, {0, 0, 0}, {255, 255, 255}}; // Domyślnie: poziomo, little endian, tablica C, bez PROGMEM, nazwa tablicy, 4bpp, None, jasność 50%, kontrast 50%, bez BMP, bez inwersji, paleta BW (0), paleta 4bpp BW (0), kolory niestandardowe (0,0,0) i (255,255,255)
-    char* input_path = NULL;
-    char* output_path = NULL;
-    char output_buffer[256]; // Bufor na ścieżkę wyjściową
+    if (format == IMAGE_FORMAT_PNG) {
+        if (!read_png_header(file, &input.png)) {
+            printf("Error: Invalid or unsupported PNG file\n");
+            return 1;
+        }
+        image_width = input.png.width;
+        image_height = input.png.height;
+        print_progress("- image size: %dx%d pixels\n", image_width, image_height);
+        print_progress("- input format: PNG, %d-bit %s\n", input.png.bit_depth, png_color_type_name(input.png.color_type));
+        if (input.png.interlace) {
+            printf("Error: Interlaced PNG (Adam7) is not supported\n");
+            return 1;
+        }
+        decoder_memory = calculate_png_decoder_memory(&input.png);
+    } else {
+        if (!read_pnm_header(file, &input.pnm)) {
+            printf("Error: Invalid PGM/PPM file (supported: binary P5 and P6)\n");
+            return 1;
+        }
+        image_width = input.pnm.width;
+        image_height = input.pnm.height;
+        print_progress("- image size: %dx%d pixels\n", image_width, image_height);
+        print_progress("- input format: %s, maxval %d\n", input.pnm.channels == 1 ? "PGM" : "PPM", input.pnm.maxval);
+        decoder_memory = calculate_pnm_row_size(&input.pnm) + (size_t)image_width;
+    }
 
-    if (!parse_arguments(argc, argv, &context, &input_path, &output_path)) {
-        print_usage(argv[0]);
+    if (image_width > INT_MAX - 8 || image_height > INT_MAX - 8) {
+        printf("Error: Image dimensions too large\n");
         return 1;
     }
-    
-    // Skopiuj ścieżkę wyjściową do bufora i ustaw domyślne rozszerzenie
-    strncpy(output_buffer, output_path, sizeof(output_buffer) - 1);
-    output_buffer[sizeof(output_buffer) - 1] = '\0';
-    
-    if (strcmp(output_path, "image_data.h") == 0) {
-        set_default_extension(output_buffer, context.output_format);
-        output_path = output_buffer;
+    stats_stage_end(stats, STATS_STAGE_HEADER_READ, stage_start);
+
+    print_conversion_options(context);
+
+    return convert_streamed_regions(file, &input, image_width, image_height, decoder_memory, context, output_path, stats, conversion_start);
+}
+
+/**
+ * @brief Konwertuje jeden obraz wejściowy do celów wyjściowych kontekstu
+ * 
+ * @details Pełna ścieżka konwersji pliku: rozpoznanie formatu, odczyt
+ * nagłówka i wybór trybu (kolor, wycinki i skalowanie, pasma --max-mem,
+ * cała klatka). Wywoływana z main() dla pojedynczego obrazu i równolegle
+ * dla każdego zasobu manifestu (--manifest) - wtedy context->capture
+ * przejmuje spakowane dane zamiast zapisu plików.
+ * 
+ * @param context Kontekst konwersji
+ * @param input_path Ścieżka pliku wejściowego lub "-" (stdin)
+ * @param output_path Ścieżka wyjściowa trybu klasycznego
+ * @param stats Statystyki etapów (zerowane na początku)
+ * 
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ */
+static int convert_image(ConversionContext* context, const char* input_path, const char* output_path, ConversionStats* stats) {
+    if (context->output_count > 0) {
+        print_progress("- converting %s to %d output targets\n", input_path, context->output_count);
+    } else {
+        print_progress("- converting %s to %s\n", input_path, output_path);
     }
 
-    printf("- converting %s to %s\n", input_path, output_path);
+    stats_reset(stats);
+    double conversion_start = stats_stage_begin();
+    double stage_start = stats_stage_begin();
 
-    FILE* file = fopen(input_path, "rb");
+    FILE* file = open_input_stream(input_path);
     if (!file) {
         printf("Error: Cannot open input file %s\n", input_path);
         return 1;
     }
 
+    // PNG i PGM/PPM mają własną ścieżkę dekodowania wiersz po wierszu
+    int input_format = detect_image_format(file);
+    if (input_format == IMAGE_FORMAT_UNKNOWN) {
+        printf("Error: Unrecognized input file format (supported: BMP, PNG, PGM, PPM)\n");
+        close_input_stream(file);
+        return 1;
+    }
+    if (input_format != IMAGE_FORMAT_BMP && context->color_format != COLOR_FORMAT_NONE) {
+        printf("Error: --color requires a 24-bit or 32-bit BMP input\n");
+        close_input_stream(file);
+        return 1;
+    }
+    if (input_format != IMAGE_FORMAT_BMP) {
+        int exit_code = convert_decoded_input(file, input_format, context, output_path, stats, conversion_start);
+        close_input_stream(file);
+        return exit_code;
+    }
+
     BMPHeader header;
     BMPInfoHeader info_header;
 
     if (!read_bmp_header(file, &header, &info_header)) {
         printf("Error: Invalid BMP file format\n");
-        fclose(file);
+        close_input_stream(file);
         return 1;
     }
 
-    printf("- image size: %dx%d pixels\n", (int)info_header.width, (int)info_header.height);
-    printf("- bits per pixel: %d\n", (int)info_header.bits_per_pixel);
-
     if (!validate_bmp_format(&header, &info_header)) {
-        printf("Error: Only uncompressed 24-bit and 32-bit BMP files are supported\n");
-        fclose(file);
-        return 1;
-    }
-
-    // Wyświetl opcje konwersji
-    printf("- opcje konwersji:\n");
-    printf("  - głębia kolorów: %dbpp\n", context.bits_per_pixel);
-    printf("  - kierunek skanowania: %s\n", context.scan_direction ? "poziomy" : "pionowy");
-    printf("  - kolejność pikseli: %s endian\n", context.pixel_order ? "little" : "big");
-    printf("  - format wyjściowy: %s\n", 
-           context.output_format == FORMAT_C_ARRAY ? "Tablica C (.h)" :
-           context.output_format == FORMAT_RAW_DATA ? "Surowe dane (.hex)" : "Assembler (.inc)");
-    printf("  - PROGMEM: %s\n", context.use_progmem ? "tak" : "nie");
-    printf("  - nazwa tablicy: %s\n", context.array_name);
-        if (context.bits_per_pixel == BITS_PER_PIXEL_1BPP) {
-            printf("  - metoda ditheringu: %s\n",
-                   context.dithering_method == DITHERING_FLOYD ? "Floyd-Steinberg" :
-                   context.dithering_method == DITHERING_ORDERED ? "Ordered 8x8" : "Brak");
-            printf("  - jasność: %d%%\n", context.brightness);
-            printf("  - kontrast: %d%%\n", context.contrast);
-            const char* palette_names[] = {"BW", "GRAY", "GREEN", "PORTFOLIO", "OLED_YELLOW", "CUSTOM"};
-            printf("  - paleta: %s\n", palette_names[context.palette_variant]);
-            if (context.palette_variant == PALETTE_CUSTOM) {
-                printf("    - pierwszy kolor: (%d,%d,%d)\n", context.custom_color_first[2], context.custom_color_first[1], context.custom_color_first[0]);
-                printf("    - ostatni kolor: (%d,%d,%d)\n", context.custom_color_last[2], context.custom_color_last[1], context.custom_color_last[0]);
-            }
-        } else if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-            const char* palette_4bpp_names[] = {"BW", "GRAY", "GREEN", "PORTFOLIO", "OLED_YELLOW", "CUSTOM"};
-            printf("  - paleta: %s\n", palette_4bpp_names[context.palette_4bpp_variant]);
-            if (context.palette_4bpp_variant == PALETTE_CUSTOM) {
-                printf("    - pierwszy kolor: (%d,%d,%d)\n", context.custom_color_first[2], context.custom_color_first[1], context.custom_color_first[0]);
-                printf("    - ostatni kolor: (%d,%d,%d)\n", context.custom_color_last[2], context.custom_color_last[1], context.custom_color_last[0]);
-            }
+        printf("Error: Unsupported BMP format (supported: 1/4/8-bit indexed, RLE4, RLE8, 24-bit and 32-bit)\n");
+        close_input_stream(file);
+        return 1;
+    }
+
+    // Pozycja w strumieniu wejściowym - dalsze odczyty nie przewijają pliku (stdin)
+    unsigned long long input_position = sizeof(BMPHeader) + sizeof(BMPInfoHeader);
+
+    // Ujemna wysokość = BMP zapisany od góry; dalej wysokość jest zawsze dodatnia
+    int top_down = normalize_bmp_height(&info_header);
+
+    print_progress("- image size: %dx%d pixels%s\n", (int)info_header.width, (int)info_header.height, top_down ? " (top-down)" : "");
+    print_progress("- bits per pixel: %d\n", (int)info_header.bits_per_pixel);
+    
+    // Zapas 8 pikseli na zaokrąglenia do pełnych bajtów w arytmetyce int
+    if (info_header.width == 0 || info_header.height == 0 || info_header.width > INT_MAX - 8 || info_header.height > INT_MAX - 8) {
+        printf("Error: Image dimensions too large\n");
+        close_input_stream(file);
+        return 1;
+    }
+    stats_stage_end(stats, STATS_STAGE_HEADER_READ, stage_start);
+
+    print_conversion_options(context);
+
+    if (context->color_format != COLOR_FORMAT_NONE) {
+        int exit_code = convert_color_input(file, &header, &info_header, top_down, context, output_path, &input_position, stats, conversion_start);
+        close_input_stream(file);
+        return exit_code;
+    }
+
+    // --resize i --crop: wiersze pliku są czytane i konwertowane porcjami (decode_bmp_rows())
+    if (context->resize_width || context->resize_height || context->crop_count > 0) {
+        uchar resize_gray_lut[BMP_MAX_PALETTE_COLORS];
+        int has_palette = bmp_is_indexed(&info_header);
+        if (has_palette && !read_bmp_gray_lut(file, &header, &info_header, BITS_PER_PIXEL_8BPP, resize_gray_lut, &input_position)) {
+            printf("Error: Cannot read BMP palette\n");
+            close_input_stream(file);
+            return 1;
+        }
+        size_t decoder_memory = calculate_bmp_decoder_memory(&header, &info_header, NULL, top_down, input_is_seekable(file));
+        if (decoder_memory == 0) {
+            printf("Error: Image too large for this platform (%ux%u)\n", (unsigned)info_header.width, (unsigned)info_header.height);
+            close_input_stream(file);
+            return 1;
+        }
+        DecodedInput input;
+        memset(&input, 0, sizeof(input));
+        input.format = IMAGE_FORMAT_BMP;
+        input.bmp_header = &header;
+        input.bmp_info = &info_header;
+        input.bmp_top_down = top_down;
+        input.bmp_gray_lut = has_palette ? resize_gray_lut : NULL;
+        input.bmp_position = &input_position;
+        int exit_code = convert_streamed_regions(file, &input, (int)info_header.width, (int)info_header.height, decoder_memory,
+                                                 context, output_path, stats, conversion_start);
+        close_input_stream(file);
+        return exit_code;
+    }
+
+    // Wymiary skali szarości - kernele zerują niepełny ostatni bajt linii 4bpp, bez kolumny dopełnienia
+    int width = (int)info_header.width;
+    int height = (int)info_header.height;
+    if (!check_conversion_layout_size(context, width, height)) {
+        close_input_stream(file);
+        return 1;
+    }
+
+    // Obrazy z paletą: kolor → skala szarości liczony raz dla każdego wpisu palety
+    int is_indexed = bmp_is_indexed(&info_header);
+    int is_rle = (info_header.compression != BMP_COMPRESSION_NONE);
+    uchar gray_lut[BMP_MAX_PALETTE_COLORS];
+    if (is_indexed && !read_bmp_gray_lut(file, &header, &info_header, context->bits_per_pixel, gray_lut, &input_position)) {
+        printf("Error: Cannot read BMP palette\n");
+        close_input_stream(file);
+        return 1;
+    }
+
+    // Wszystkie rozmiary liczone w size_t z kontrolą przepełnienia
+    size_t row_size = calculate_bmp_row_size(info_header.width, info_header.bits_per_pixel);
+    size_t image_data_size, pixel_count;
+    size_t packed_size = calculate_conversion_packed_size(context, width, height);
+    if (!size_multiply(row_size, info_header.height, &image_data_size) ||
+        !size_multiply((size_t)width, (size_t)height, &pixel_count) || packed_size == 0) {
+        printf("Error: Image too large for this platform (%ux%u)\n", (unsigned)info_header.width, (unsigned)info_header.height);
+        close_input_stream(file);
+        return 1;
+    }
+    if (is_rle) {
+        image_data_size = calculate_rle_data_size(&header, &info_header);
+        if (image_data_size == 0) {
+            printf("Error: Cannot determine RLE data size\n");
+            close_input_stream(file);
+            return 1;
+        }
+    }
+
+    int is_sweep = context->sweep_brightness.step || context->sweep_contrast.step;
+    size_t budget = context->max_memory;
+    int frame_fits = image_data_size <= budget && pixel_count <= budget - image_data_size &&
+                     packed_size <= budget - image_data_size - pixel_count;
+    if (budget > 0 && !is_sweep && !frame_fits && is_rle) {
+        // Strumień RLE nie ma stałego położenia wierszy - dekodowany jest zawsze w całości
+        printf("Warning: RLE-compressed BMP cannot be processed in bands, --max-mem ignored\n");
+        budget = 0;
+    }
+    if (budget > 0 && !is_sweep && !frame_fits && !top_down && !input_is_seekable(file)) {
+        // BMP od dołu z potoku: pasma wymagają skoków wstecz po wierszach
+        printf("Warning: Bottom-up BMP from a pipe cannot be processed in bands, --max-mem ignored\n");
+        budget = 0;
+    }
+    if (budget > 0 && !is_sweep && !frame_fits) {
+        // Cała klatka nie mieści się w budżecie - przetwarzanie pasmami wprost z pliku
+        int band_rows = calculate_band_rows(context->max_memory, packed_size, row_size, width, height);
+        if (band_rows == 0) {
+            printf("Error: --max-mem too small, need at least %lu bytes\n",
+                   (unsigned long)(packed_size + (BAND_ROW_ALIGN + 1) * (row_size + (size_t)width)));
+            close_input_stream(file);
+            return 1;
+        }
+        print_progress("- processing in bands of %d rows (--max-mem %lu bytes)\n", band_rows, (unsigned long)context->max_memory);
+        
+        uchar* packed_data = (uchar*)stats_malloc(packed_size);
+        if (!packed_data) {
+            printf("Error: Cannot allocate memory for packed data\n");
+            close_input_stream(file);
+            return 1;
+        }
+        int converted = convert_bmp_banded(file, &header, &info_header, top_down, context, width, band_rows, is_indexed ? gray_lut : NULL, packed_data, stats, &input_position);
+        close_input_stream(file);
+        if (!converted) {
+            stats_free(packed_data);
+            return 1;
         }
-        if (context.invert) {
-            printf("  - inwersja bitów: włączona\n");
+        int written = finish_conversion(context, output_path, packed_data, packed_size, width, height, stats);
+        stats_free(packed_data);
+        if (written) {
+            print_conversion_stats(context, stats, conversion_start);
         }
+        return written ? 0 : 1;
+    }
 
-    // Oblicz rozmiar wiersza z dopełnieniem
-    int row_size = calculate_bmp_row_size(info_header.width, info_header.bits_per_pixel);
-    int image_data_size = row_size * info_header.height;
+    stage_start = stats_stage_begin();
 
     // Alokuj pamięć na dane obrazu
-    uchar* image_data = (uchar*)malloc(image_data_size);
+    uchar* image_data = (uchar*)stats_malloc(image_data_size);
     if (!image_data) {
         printf("Error: Cannot allocate memory for image data\n");
-        fclose(file);
+        close_input_stream(file);
         return 1;
     }
 
     // Odczytaj dane obrazu
-    if (!read_bmp_image_data(file, image_data, image_data_size, header.data_offset)) {
+    if (!read_bmp_image_data(file, image_data, image_data_size, header.data_offset, &input_position)) {
         printf("Error: Cannot read image data\n");
-        free(image_data);
-        fclose(file);
+        stats_free(image_data);
+        close_input_stream(file);
         return 1;
     }
 
-    fclose(file);
+    close_input_stream(file);
+    stats_stage_end(stats, STATS_STAGE_PIXEL_READ, stage_start);
 
     // Konwertuj do skali szarości
-    int width = (int)info_header.width;
-    int height = (int)info_header.height;
-    
-    // Dla 4bpp upewnij się, że szerokość jest parzysta
-    if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP && width % 2 != 0) {
-        width++;
-    }
-
-    uchar* grayscale_data = (uchar*)malloc(width * height);
+    uchar* grayscale_data = (uchar*)stats_malloc(pixel_count);
     if (!grayscale_data) {
         printf("Error: Cannot allocate memory for grayscale data\n");
-        free(image_data);
+        stats_free(image_data);
         return 1;
     }
 
-    // Konwertuj do skali szarości w zależności od trybu
-    if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-        if (!convert_to_grayscale_4bpp(image_data, grayscale_data, (int)info_header.width, (int)info_header.height, row_size)) {
-            printf("Error: Failed to convert to grayscale\n");
-            free(image_data);
-            free(grayscale_data);
-            return 1;
-        }
-        } else if (context.bits_per_pixel == BITS_PER_PIXEL_1BPP) {
-            if (!convert_to_grayscale_1bpp(image_data, grayscale_data, (int)info_header.width, (int)info_header.height, row_size, context.dithering_method, context.brightness, context.contrast)) {
-            printf("Error: Failed to convert to grayscale with dithering\n");
-            free(image_data);
-            free(grayscale_data);
-            return 1;
-        }
-    } else {
-        printf("Error: Unsupported bits per pixel: %d\n", context.bits_per_pixel);
-        free(image_data);
-        free(grayscale_data);
+    stage_start = stats_stage_begin();
+    int converted = convert_input_to_grayscale(image_data, image_data_size, &info_header, top_down, is_indexed ? gray_lut : NULL,
+                                               context->bits_per_pixel, grayscale_data, width);
+    stats_stage_end(stats, STATS_STAGE_GRAYSCALE, stage_start);
+    stats_free(image_data);
+    if (!converted) {
+        printf("Error: Failed to convert to grayscale\n");
+        stats_free(grayscale_data);
         return 1;
     }
 
-    // Pakuj piksele w odpowiednim formacie
-    int packed_size;
-    if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-        packed_size = (width * height) / 2; // 2 piksele na bajt
-    } else {
-        packed_size = (width * height + 7) / 8; // 8 pikseli na bajt
+    int exit_code = process_grayscale_frame(context, output_path, grayscale_data, width, height, packed_size, stats, conversion_start);
+    stats_free(grayscale_data);
+    return exit_code;
+}
+
+// Zadanie konwersji zasobu manifestu: indeks zasobu i rozmiar jego pliku wejściowego
+typedef struct {
+    int index;
+    long input_size;
+} ManifestJob;
+
+// Zadania konwersji zasobów manifestu (wykonywane równolegle)
+typedef struct {
+    Manifest* manifest;
+    ManifestJob* jobs;     // Od największego pliku wejściowego
+} ManifestJobs;
+
+static void convert_manifest_job(void* arg, int index) {
+    ManifestJobs* jobs = (ManifestJobs*)arg;
+    ManifestAsset* asset = &jobs->manifest->assets[jobs->jobs[index].index];
+    double start = timing_now_ns();
+    asset->context.capture = &asset->image;
+    asset->result = (convert_image(&asset->context, asset->input_path, asset->name, &asset->stats) == 0);
+    asset->stats.total_ms = timing_elapsed_ms(start);
+}
+
+// Kolejność zadań: najpierw największe pliki, żeby długie konwersje nie zostały na koniec
+static int compare_manifest_jobs(const void* a, const void* b) {
+    const ManifestJob* job_a = (const ManifestJob*)a;
+    const ManifestJob* job_b = (const ManifestJob*)b;
+    if (job_a->input_size != job_b->input_size) {
+        return (job_a->input_size < job_b->input_size) ? 1 : -1;
     }
-    
-    uchar* packed_data = (uchar*)malloc(packed_size);
-    if (!packed_data) {
-        printf("Error: Cannot allocate memory for packed data\n");
-        free(image_data);
-        free(grayscale_data);
+    return job_a->index - job_b->index;
+}
+
+/**
+ * @brief Konwertuje wszystkie zasoby manifestu do jednego zbiorczego pliku
+ * 
+ * @details Zasoby są konwertowane równolegle (klucz jobs w [manifest]),
+ * od największego pliku wejściowego. Każdy przechodzi tę samą ścieżkę co
+ * pojedynczy obraz (convert_image()), ale spakowane dane trafiają do
+ * pamięci. Po konwersji wszystkich zasobów powstaje jeden plik z enum
+ * indeksu, tablicami i tablicą opisów (manifest_write_output()).
+ * 
+ * @param context Kontekst z opcji wiersza poleceń (podstawa każdego zasobu)
+ * @param manifest_path Ścieżka manifestu
+ * @param output_path Plik wyjściowy z wiersza poleceń ("image_data.h" = nie podano)
+ * 
+ * @return Kod wyjścia programu: 0 w przypadku sukcesu, 1 w przypadku błędu
+ */
+static int convert_manifest(ConversionContext* context, const char* manifest_path, const char* output_path) {
+    double conversion_start = timing_now_ns();
+    Manifest manifest;
+    if (!manifest_load(manifest_path, context, &manifest)) {
         return 1;
     }
 
-    // Wybierz odpowiednią funkcję pakowania
-    int pack_result;
-    if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-        pack_result = pack_pixels_4bpp(grayscale_data, packed_data, width, height, context.scan_direction, context.pixel_order);
-    } else {
-        pack_result = pack_pixels_1bpp(grayscale_data, packed_data, width, height, context.scan_direction, context.pixel_order);
+    // Plik wyjściowy: wiersz poleceń, potem klucz output, potem domyślna nazwa
+    char output_buffer[256];
+    if (strcmp(output_path, "image_data.h") == 0 && manifest.output_path[0]) {
+        output_path = manifest.output_path;
+        if (is_stdio_path(output_path) && !redirect_console_to_stderr()) {
+            printf("Error: Cannot redirect messages to stderr\n");
+            manifest_free(&manifest);
+            return 1;
+        }
+    } else if (strcmp(output_path, "image_data.h") == 0) {
+        strcpy(output_buffer, output_path);
+        set_default_extension(output_buffer, sizeof(output_buffer), manifest.output_format);
+        output_path = output_buffer;
     }
-    
-    if (!pack_result) {
-        printf("Error: Failed to pack pixels\n");
-        free(image_data);
-        free(grayscale_data);
-        free(packed_data);
+
+    ManifestJob* job_list = (ManifestJob*)malloc((size_t)manifest.asset_count * sizeof(ManifestJob));
+    if (!job_list) {
+        printf("Error: Cannot allocate memory for the manifest\n");
+        manifest_free(&manifest);
         return 1;
     }
+    for (int i = 0; i < manifest.asset_count; i++) {
+        job_list[i].index = i;
+        job_list[i].input_size = manifest.assets[i].input_size;
+    }
+    qsort(job_list, (size_t)manifest.asset_count, sizeof(ManifestJob), compare_manifest_jobs);
 
-    // Inwersja jest obsługiwana w write_array
+    printf("- manifest: %s, %d assets\n", manifest_path, manifest.asset_count);
+    ManifestJobs jobs = {&manifest, job_list};
+    progress_quiet = 1;
+    int thread_count = run_parallel(manifest.asset_count, convert_manifest_job, &jobs, manifest.jobs);
+    progress_quiet = 0;
+    // Zasoby są konwertowane równolegle we wspólnej puli pamięci - szczyt istnieje tylko dla całego przebiegu
+    size_t peak_bytes = stats_peak_bytes();
+    free(job_list);
+    printf("- manifest threads: %d\n", thread_count);
 
-    // Zapisz plik wyjściowy
-        if (!write_array(packed_data, packed_size, width, height, context.array_name, output_path, context.output_format, context.use_progmem, context.bits_per_pixel, context.dithering_method, context.brightness, context.contrast, context.invert)) {
-        printf("Error: Failed to write output file\n");
-        free(image_data);
-        free(grayscale_data);
-        free(packed_data);
+    int failed = 0;
+    for (int i = 0; i < manifest.asset_count; i++) {
+        if (!manifest.assets[i].result) {
+            printf("Error: Asset [%s] (%s) failed to convert\n", manifest.assets[i].name, manifest.assets[i].input_path);
+            failed++;
+        }
+    }
+    if (failed) {
+        printf("Error: %d of %d assets failed, combined output not written\n", failed, manifest.asset_count);
+        manifest_free(&manifest);
         return 1;
     }
-    
-    // Generuj BMP preview jeśli wymagane
-    if (context.generate_bmp) {
-        char bmp_path[256];
-        strcpy(bmp_path, output_path);
-        char* ext = strrchr(bmp_path, '.');
-        if (ext) {
-            strcpy(ext, ".bmp");
-        } else {
-            strcat(bmp_path, ".bmp");
-        }
-        
-        // Generuj BMP preview (bez inwersji - paleta zawsze standardowa)
-        int success = 0;
-        if (context.bits_per_pixel == BITS_PER_PIXEL_1BPP) {
-            PreviewContext preview_ctx = {width, height, bmp_path, context.palette_variant, context.custom_color_first, context.custom_color_last, context.scan_direction};
-            success = generate_1bpp_bmp(packed_data, &preview_ctx);
-        } else if (context.bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-            PreviewContext preview_ctx = {width, height, bmp_path, context.palette_4bpp_variant, context.custom_color_first, context.custom_color_last, context.scan_direction};
-            success = generate_4bpp_bmp(packed_data, &preview_ctx);
-        }
-        
-        if (success) {
-            printf("- BMP preview saved: %s\n", bmp_path);
-        } else {
-            printf("Warning: Failed to generate BMP preview\n");
+
+    // Identyczne dane zapisywane raz, pozostałe zasoby stają się aliasami
+    double dedup_start = timing_now_ns();
+    size_t saved_size = manifest.dedup ? manifest_deduplicate(&manifest) : 0;
+    double dedup_ms = timing_elapsed_ms(dedup_start);
+
+    int duplicate_count = 0;
+    for (int i = 0; i < manifest.asset_count; i++) {
+        ManifestAsset* asset = &manifest.assets[i];
+        printf("- [%d/%d] %s: %dx%d, %lu bytes (%.1f ms)", i + 1, manifest.asset_count, asset->name,
+               asset->image.width, asset->image.height, (unsigned long)asset->image.size, asset->stats.total_ms);
+        if (asset->duplicate_of >= 0) {
+            printf(", same data as %s", manifest.assets[asset->duplicate_of].name);
+            duplicate_count++;
         }
+        printf("\n");
+    }
+    if (manifest.dedup) {
+        printf("- dedup: %d duplicate assets, %lu bytes saved (%.2f ms)\n", duplicate_count, (unsigned long)saved_size, dedup_ms);
     }
 
-    printf("- conversion completed successfully\n");
-    printf("- packed data size: %d bytes\n", packed_size);
+    if (!manifest_write_output(&manifest, manifest_path, output_path)) {
+        printf("Error: Failed to write output file %s\n", output_path);
+        manifest_free(&manifest);
+        return 1;
+    }
+    printf("- combined output saved: %s (%lu bytes of data, %.1f ms)\n", output_path,
+           (unsigned long)manifest_data_size(&manifest), timing_elapsed_ms(conversion_start));
 
-    free(image_data);
-    free(grayscale_data);
-    free(packed_data);
+    if (context->stats_output != STATS_OUTPUT_NONE) {
+        StatsAggregate aggregate;
+        stats_aggregate_init(&aggregate);
+        for (int i = 0; i < manifest.asset_count; i++) {
+            stats_aggregate_add(&aggregate, &manifest.assets[i].stats);
+        }
+        aggregate.peak_bytes = peak_bytes;
+        stats_aggregate_print(stdout, &aggregate, context->stats_output);
+        stats_aggregate_free(&aggregate);
+    }
+    manifest_free(&manifest);
+    return 0;
+}
 
+// --help: pomoc jest jedynym wynikiem programu, więc idzie na stdout
+static int help_requested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            return 1;
+        }
+    }
     return 0;
 }
 
+/**
+ * @brief Główna funkcja programu konwertującego BMP na tablice bajtów
+ * 
+ * @details Funkcja main implementuje główną logikę programu konwertującego
+ * pliki BMP na tablice bajtów w różnych formatach (C array, raw data, assembler).
+ * Obsługuje konwersję 1bpp i 4bpp z różnymi metodami ditheringu, paletami kolorów
+ * i opcjami skanowania. Generuje pliki wyjściowe w wybranym formacie oraz
+ * opcjonalne podglądy BMP.
+ * 
+ * @param argc Liczba argumentów wiersza poleceń
+ * @param argv Tablica argumentów wiersza poleceń
+ * 
+ * @return 0 w przypadku sukcesu, 1 w przypadku błędu
+ * 
+ * @note Wyświetla informacje o wersji i autorze przy starcie
+ * @note Parsuje argumenty wiersza poleceń
+ * @note Obsługuje wszystkie formaty wyjściowe i opcje konwersji
+ * @note Generuje podglądy BMP z różnymi paletami
+ * @note Obsługuje inwersję bitów i różne kierunki skanowania
+ * 
+ * @example
+ * ```bash
+ * # Konwersja 4bpp z domyślnymi ustawieniami
+ * ./bmp_to_xbpp image.bmp
+ * 
+ * # Konwersja 1bpp z ditheringiem Floyd-Steinberg
+ * ./bmp_to_xbpp -1 -d floyd image.bmp
+ * 
+ * # Konwersja z podglądem BMP i paletą zieloną
+ * ./bmp_to_xbpp -1 --bmp --palette green image.bmp
+ * ```
+ */
+int main(int argc, char* argv[]) {
+    ConversionContext context = {1, 1, FORMAT_C_ARRAY, 0, "image_data", BITS_PER_PIXEL_4BPP, DITHERING_NONE, 50, 50, 0, 0, 0, 0, {0, 0, 0}, {255, 255, 255}, STATS_OUTPUT_NONE}; // Domyślnie: poziomo, little endian, tablica C, bez PROGMEM, nazwa tablicy, 4bpp, None, jasność 50%, kontrast 50%, bez BMP, bez inwersji, paleta BW (0), paleta 4bpp BW (0), kolory niestandardowe (0,0,0) i (255,255,255), bez statystyk
+    char* input_path = NULL;
+    char* output_path = NULL;
+    char output_buffer[256]; // Bufor na ścieżkę wyjściową
+
+    int parsed = parse_arguments(argc, argv, &context, &input_path, &output_path);
+
+    // Dane na stdout ("-") - wszystkie komunikaty, także baner, idą na stderr. Błąd parsowania
+    // (bez --help) też: cel danych nie jest wtedy znany, a stdout może być potokiem danych
+    int to_stderr = parsed ? count_stdout_targets(&context, output_path) > 0 : !help_requested(argc, argv);
+    if (to_stderr && !redirect_console_to_stderr()) {
+        fprintf(stderr, "Error: Cannot redirect messages to stderr\n");
+        return 1;
+    }
+
+    printf("\n");
+    printf("BMP to xbpp Array Converter %s (%s) (c) %s (https://ptodt.org.pl)\n", VERSION_STRING, BUILD_DATETIME, COPYRIGHT_STRING);
+    printf("\n");
+    printf("CODE BY                                      \n");
+    printf("    ----.-.---.---.---.                      \n");
+    printf("        |-.---.   |--.|#==---.. .  .  .      \n");
+    printf("     |  | |   | --.   |#==---. . .           \n");
+    printf("    -'--'-'---'---'---'               2025.09\n");
+    printf("\n");
+
+    if (!parsed) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (context.manifest) {
+        stats_reset_peak();
+        return convert_manifest(&context, input_path, output_path);
+    }
 
+    // Skopiuj ścieżkę wyjściową do bufora i ustaw domyślne rozszerzenie
+    strncpy(output_buffer, output_path, sizeof(output_buffer) - 1);
+    output_buffer[sizeof(output_buffer) - 1] = '\0';
+    
+    if (strcmp(output_path, "image_data.h") == 0) {
+        set_default_extension(output_buffer, sizeof(output_buffer), context.output_format);
+        output_path = output_buffer;
+    }
 
+    ConversionStats stats;
+    stats_reset_peak();
+    return convert_image(&context, input_path, output_path, &stats);
+}
@@ -16,21 +16,25 @@
 #include <time.h>
 #include "bmp_writer.h"
 #include "bmp_palette.h"
+#include "stats.h"
+#include "timing.h"
+#include "stream_io.h"
+#include "color.h"
 #include "version.h"
 
+// Szerokość paska kolumn przy blokowej transpozycji danych pionowych
+#define PREVIEW_STRIP_COLUMNS 64
+
 /**
- * @brief Zapisuje sekcję copyright do pliku BMP
+ * @brief Wypełnia sekcję copyright w buforze pliku BMP
  * 
- * @details Funkcja zapisuje niestandardową sekcję copyright po nagłówku BMP,
- * ale przed danymi obrazu. Sekcja zawiera informacje o wersji, dacie budowania
- * i prawach autorskich. Maksymalnie 256 bajtów.
+ * @details Funkcja tworzy niestandardową sekcję copyright umieszczaną po
+ * nagłówku BMP, ale przed danymi obrazu. Sekcja zawiera informacje o wersji,
+ * dacie budowania i prawach autorskich. Zawsze zajmuje 256 bajtów.
  * 
- * @param file Wskaźnik do otwartego pliku BMP
- * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * @param section Wskaźnik do BMP_COPYRIGHT_SECTION_SIZE bajtów bufora
  */
-static int write_bmp_copyright_section(FILE* file) {
-    if (!file) return 0;
-    
+static void fill_bmp_copyright_section(uchar* section) {
     // Nagłówek sekcji copyright (4 bajty)
     uchar section_header[4] = {0x43, 0x4F, 0x50, 0x59}; // "COPY"
     
@@ -39,10 +43,10 @@ static int write_bmp_copyright_section(FILE* file) {
     
     // Tworzenie tekstu copyright
     char copyright_text[256] = {0};
-    time_t now = time(NULL);
-    struct tm* tm_info = localtime(&now);
+    struct tm tm_info;
+    timing_local_time(&tm_info);
     char date_str[32];
-    strftime(date_str, sizeof(date_str), "%Y-%m-%d %H:%M:%S", tm_info);
+    strftime(date_str, sizeof(date_str), "%Y-%m-%d %H:%M:%S", &tm_info);
     
     snprintf(copyright_text, sizeof(copyright_text),
         "Generated by BMP to xbpp Array Converter %s (%s)\n"
@@ -59,23 +63,287 @@ static int write_bmp_copyright_section(FILE* file) {
     section_length = (dword)strlen(copyright_text);
     if (section_length > 248) section_length = 248; // Zostaw miejsce na nagłówek i długość
     
-    // Zapisz nagłówek sekcji
-    if (fwrite(section_header, 1, 4, file) != 4) return 0;
+    // Nagłówek, długość, tekst i dopełnienie zerami do 256 bajtów
+    memset(section, 0, BMP_COPYRIGHT_SECTION_SIZE);
+    memcpy(section, section_header, 4);
+    memcpy(section + 4, &section_length, 4);
+    memcpy(section + 8, copyright_text, section_length);
+}
+
+/**
+ * @brief Tworzy w pamięci kompletny plik BMP z wyzerowanymi danymi obrazu
+ * 
+ * @details Alokuje jeden bufor na cały plik i wypełnia nagłówki, paletę
+ * oraz sekcję copyright. Obszar danych jest wyzerowany, więc dopełnienie
+ * wierszy do 4 bajtów nie wymaga osobnego zapisu.
+ * 
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param bits_per_pixel Głębia kolorów (1, 4, 8 lub 24)
+ * @param palette Paleta kolorów
+ * @param color_count Liczba kolorów w palecie
+ * @param row_size Rozmiar wiersza z dopełnieniem w bajtach
+ * @param file_size Zwraca rozmiar całego pliku
+ * 
+ * @return Wskaźnik do bufora (zwalniany przez stats_free()) lub NULL
+ *         (także gdy plik przekroczyłby 4 GB)
+ */
+static uchar* create_bmp_buffer(int width, int height, int bits_per_pixel, BMPColorEntry* palette, int color_count, int row_size, size_t* file_size) {
+    size_t palette_size = (size_t)color_count * sizeof(BMPColorEntry);
+    size_t data_offset = BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + palette_size + BMP_COPYRIGHT_SECTION_SIZE;
+    size_t data_size = (size_t)row_size * height;
+    
+    // Pola rozmiaru w nagłówku BMP są 32-bitowe - większego podglądu nie da się zapisać
+    if (data_size > 0xFFFFFFFFUL - data_offset) {
+        return NULL;
+    }
     
-    // Zapisz długość sekcji
-    if (fwrite(&section_length, 1, 4, file) != 4) return 0;
+    uchar* buffer = (uchar*)stats_malloc(data_offset + data_size);
+    if (!buffer) {
+        return NULL;
+    }
     
-    // Zapisz tekst copyright
-    if (fwrite(copyright_text, 1, section_length, file) != section_length) return 0;
+    // Nagłówek BMP
+    BMPHeader bmp_header = {
+        .signature = {0x42, 0x4D}, // "BM"
+        .file_size = (dword)(data_offset + data_size),
+        .reserved = 0,
+        .data_offset = (dword)data_offset
+    };
     
-    // Wypełnij do 256 bajtów zerami
-    uchar padding[256] = {0};
-    int padding_size = 256 - 8 - section_length;
-    if (padding_size > 0) {
-        if (fwrite(padding, 1, padding_size, file) != padding_size) return 0;
+    // Nagłówek informacyjny BMP
+    BMPInfoHeader info_header = {
+        .header_size = BMP_INFO_HEADER_SIZE,
+        .width = width,
+        .height = height,
+        .planes = 1,
+        .bits_per_pixel = bits_per_pixel,
+        .compression = BMP_COMPRESSION_NONE,
+        .image_size = (dword)data_size,
+        .x_pixels_per_meter = 0,
+        .y_pixels_per_meter = 0,
+        .colors_used = color_count,
+        .colors_important = 0
+    };
+    
+    memcpy(buffer, &bmp_header, BMP_HEADER_SIZE);
+    memcpy(buffer + BMP_HEADER_SIZE, &info_header, BMP_INFO_HEADER_SIZE);
+    if (palette_size > 0) {
+        memcpy(buffer + BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE, palette, palette_size);
     }
+    fill_bmp_copyright_section(buffer + BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + palette_size);
+    memset(buffer + data_offset, 0, data_size);
     
-    return 1;
+    *file_size = data_offset + data_size;
+    return buffer;
+}
+
+/**
+ * @brief Zapisuje bufor pliku BMP na dysk jednym wywołaniem fwrite()
+ * 
+ * @param output_path Ścieżka do pliku wyjściowego
+ * @param buffer Bufor utworzony przez create_bmp_buffer()
+ * @param file_size Rozmiar bufora w bajtach
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int write_bmp_buffer(const char* output_path, uchar* buffer, size_t file_size) {
+    FILE* file = open_output_stream(output_path, "wb");
+    if (!file) {
+        return 0;
+    }
+    
+    int success = (fwrite(buffer, 1, file_size, file) == file_size);
+    if (!close_output_stream(file)) {
+        success = 0;
+    }
+    return success;
+}
+
+/**
+ * @brief Odwraca kolejność bitów w bajcie
+ * 
+ * @param value Bajt wejściowy
+ * 
+ * @return Bajt z bitem 0 zamienionym z bitem 7, 1 z 6 itd.
+ */
+static uchar reverse_bits(uchar value) {
+    value = (uchar)(((value & 0xF0) >> 4) | ((value & 0x0F) << 4));
+    value = (uchar)(((value & 0xCC) >> 2) | ((value & 0x33) << 2));
+    value = (uchar)(((value & 0xAA) >> 1) | ((value & 0x55) << 1));
+    return value;
+}
+
+/**
+ * @brief Transponuje blok 8x8 bitów
+ * 
+ * @details Wejście to 8 bajtów kolumn (bajt i = kolumna i, bit 7 = górny
+ * piksel), wyjście to 8 bajtów wierszy (bajt r = wiersz r, bit 7 = lewy
+ * piksel). Transpozycja odbywa się na jednym słowie 64-bitowym w trzech
+ * krokach zamiany bloków 1x1, 2x2 i 4x4 (Hacker's Delight, rozdz. 7-3).
+ * 
+ * @param columns 8 bajtów kolumn
+ * @param rows 8 bajtów wierszy (wynik)
+ */
+static void transpose_8x8(const uchar* columns, uchar* rows) {
+    unsigned long long x = 0;
+    unsigned long long t;
+    
+    for (int i = 0; i < 8; i++) {
+        x = (x << 8) | columns[i];
+    }
+    
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    
+    for (int i = 0; i < 8; i++) {
+        rows[i] = (uchar)(x >> (56 - 8 * i));
+    }
+}
+
+/**
+ * @brief Przepisuje dane pionowe 1bpp do wierszy BMP (od dołu do góry)
+ * 
+ * @details Obraz jest przetwarzany paskami po PREVIEW_STRIP_COLUMNS kolumn
+ * i pasmami po 8 wierszy. Każdy blok 8x8 jest składany z 8 bajtów kolumn
+ * i transponowany jednym przebiegiem transpose_8x8(), bez sprawdzania
+ * granic dla każdego piksela.
+ * 
+ * @param packed_data Dane pionowe (width * ((height + 7) / 8) bajtów)
+ * @param image_data Obszar danych bufora BMP (wyzerowany)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param row_size Rozmiar wiersza BMP z dopełnieniem
+ * @param pixel_order 1 = bit 0 to górny piksel, 0 = bit 7 to górny piksel
+ */
+static void transpose_1bpp_vertical(uchar* packed_data, uchar* image_data, int width, int height, int row_size, int pixel_order) {
+    int col_bytes = (height + 7) / 8;
+    uchar columns[8];
+    uchar rows[8];
+    
+    for (int x0 = 0; x0 < width; x0 += PREVIEW_STRIP_COLUMNS) {
+        int strip_end = (x0 + PREVIEW_STRIP_COLUMNS < width) ? x0 + PREVIEW_STRIP_COLUMNS : width;
+        
+        for (int yb = 0; yb < col_bytes; yb++) {
+            int rows_in_band = (height - yb * 8 < 8) ? height - yb * 8 : 8;
+            
+            for (int x = x0; x < strip_end; x += 8) {
+                for (int i = 0; i < 8; i++) {
+                    uchar value = (x + i < width) ? packed_data[(size_t)(x + i) * col_bytes + yb] : 0;
+                    columns[i] = pixel_order ? reverse_bits(value) : value;
+                }
+                transpose_8x8(columns, rows);
+                
+                for (int r = 0; r < rows_in_band; r++) {
+                    int y = yb * 8 + r;
+                    image_data[(size_t)(height - 1 - y) * row_size + x / 8] = rows[r];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Przepisuje dane pionowe 4bpp do wierszy BMP (od dołu do góry)
+ * 
+ * @details Każdy bajt danych pionowych zawiera 2 piksele z jednej kolumny,
+ * a bajt wiersza BMP 2 piksele z jednego wiersza. Bloki 2x2 pikseli (dwa
+ * bajty sąsiednich kolumn) dają dwa bajty kolejnych wierszy. Obraz jest
+ * przetwarzany paskami po PREVIEW_STRIP_COLUMNS kolumn, dzięki czemu odczyt
+ * kolejnych pasm trafia w te same linie cache.
+ * 
+ * @param packed_data Dane pionowe (width * ((height + 1) / 2) bajtów)
+ * @param image_data Obszar danych bufora BMP (wyzerowany)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param row_size Rozmiar wiersza BMP z dopełnieniem
+ * @param pixel_order 1 = górny piksel w starszej połówce, 0 = w młodszej
+ */
+static void transpose_4bpp_vertical(uchar* packed_data, uchar* image_data, int width, int height, int row_size, int pixel_order) {
+    int col_bytes = (height + 1) / 2;
+    
+    for (int x0 = 0; x0 < width; x0 += PREVIEW_STRIP_COLUMNS) {
+        int strip_end = (x0 + PREVIEW_STRIP_COLUMNS < width) ? x0 + PREVIEW_STRIP_COLUMNS : width;
+        
+        for (int yb = 0; yb < col_bytes; yb++) {
+            int y = yb * 2;
+            uchar* row_top = image_data + (size_t)(height - 1 - y) * row_size;
+            uchar* row_bottom = (y + 1 < height) ? row_top - row_size : NULL;
+            
+            for (int x = x0; x < strip_end; x += 2) {
+                uchar left = packed_data[(size_t)x * col_bytes + yb];
+                uchar right = (x + 1 < width) ? packed_data[(size_t)(x + 1) * col_bytes + yb] : 0;
+                
+                // Sprowadź do postaci: górny piksel w starszej połówce
+                if (!pixel_order) {
+                    left = (uchar)((left << 4) | (left >> 4));
+                    right = (uchar)((right << 4) | (right >> 4));
+                }
+                
+                row_top[x / 2] = (uchar)((left & 0xF0) | (right >> 4));
+                if (row_bottom) {
+                    row_bottom[x / 2] = (uchar)((left << 4) | (right & 0x0F));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Składa w pamięci kompletny plik podglądu BMP 1bpp
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych 1bpp
+ * @param preview_ctx Wskaźnik do struktury PreviewContext z parametrami
+ * @param file_size Zwraca rozmiar pliku w bajtach
+ * 
+ * @return Bufor pliku (zwalniany przez stats_free()) lub NULL
+ */
+static uchar* build_1bpp_preview(uchar* packed_data, PreviewContext* preview_ctx, size_t* file_size) {
+    int width = preview_ctx->width;
+    int height = preview_ctx->height;
+    uchar* custom_first = preview_ctx->custom_first;
+    uchar* custom_last = preview_ctx->custom_last;
+    int pixel_order = preview_ctx->pixel_order;
+    
+    // Oblicz rozmiar wiersza z dopełnieniem (musi być wielokrotnością 4)
+    int line_bytes = (width + 7) / 8;
+    int row_size = (line_bytes + 3) & ~3; // Zaokrąglij w górę do wielokrotności 4
+    
+    // Paleta kolorów - wybrana wariant
+    BMPColorEntry palette[2];
+    PaletteContext palette_context = {preview_ctx->palette_variant, 2, {custom_first[0], custom_first[1], custom_first[2]}, {custom_last[0], custom_last[1], custom_last[2]}};
+    generate_palette(palette, &palette_context);
+    
+    uchar* buffer = create_bmp_buffer(width, height, 1, palette, 2, row_size, file_size);
+    if (!buffer) {
+        return NULL;
+    }
+    uchar* image_data = buffer + BMP_1BPP_DATA_OFFSET;
+    
+    // Dane obrazu (od dołu do góry)
+    if (preview_ctx->scan_direction) {
+        // Skanowanie poziome - dane są w formacie wierszowym
+        for (int y = 0; y < height; y++) {
+            uchar* src = packed_data + (size_t)y * line_bytes;
+            uchar* dst = image_data + (size_t)(height - 1 - y) * row_size;
+            if (pixel_order) {
+                memcpy(dst, src, line_bytes);
+            } else {
+                for (int i = 0; i < line_bytes; i++) {
+                    dst[i] = reverse_bits(src[i]);
+                }
+            }
+        }
+    } else {
+        // Skanowanie pionowe - dane są w formacie kolumnowym, musimy je przekonwertować
+        transpose_1bpp_vertical(packed_data, image_data, width, height, row_size, pixel_order);
+    }
+    
+    return buffer;
 }
 
 /**
@@ -84,6 +352,7 @@ static int write_bmp_copyright_section(FILE* file) {
  * @details Funkcja tworzy plik BMP w formacie 1bpp (1 bit na piksel) z danych
  * spakowanych w bajtach. Obsługuje różne palety kolorów, skanowanie poziome/pionowe
  * i generuje pełny plik BMP z nagłówkami, paletą kolorów i danymi obrazu.
+ * Cały plik jest składany w jednym buforze i zapisywany jednym wywołaniem.
  * 
  * @param packed_data Wskaźnik do spakowanych danych 1bpp (8 pikseli na bajt)
  * @param preview_ctx Wskaźnik do struktury PreviewContext z parametrami
@@ -92,12 +361,13 @@ static int write_bmp_copyright_section(FILE* file) {
  * 
  * @note Generuje pełny plik BMP z nagłówkami i paletą
  * @note Obsługuje wyrównanie wierszy do granicy 4-bajtowej
- * @note Konwertuje dane kolumnowe na wierszowe dla podglądu
+ * @note Konwertuje dane kolumnowe na wierszowe blokową transpozycją 8x8
+ * @note Uwzględnia kolejność pikseli (pixel_order) użytą przy pakowaniu
  * @note Używa palety 2-kolorowej (0=czarny, 1=biały)
  * 
  * @example
  * ```c
- * PreviewContext ctx = {64, 32, "preview.bmp", PALETTE_BW, NULL, NULL, 1};
+ * PreviewContext ctx = {64, 32, "preview.bmp", PALETTE_BW, NULL, NULL, 1, 1};
  * uchar data[256];  // 64*32/8 = 256 bajtów
  * 
  * if (generate_1bpp_bmp(data, &ctx)) {
@@ -106,111 +376,76 @@ static int write_bmp_copyright_section(FILE* file) {
  * ```
  */
 int generate_1bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx) {
+    size_t file_size;
+    uchar* buffer = build_1bpp_preview(packed_data, preview_ctx, &file_size);
+    if (!buffer) {
+        return 0;
+    }
+    
+    int success = write_bmp_buffer(preview_ctx->output_path, buffer, file_size);
+    stats_free(buffer);
+    return success;
+}
+
+/**
+ * @brief Składa w pamięci kompletny plik podglądu BMP 4bpp
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych 4bpp
+ * @param preview_ctx Wskaźnik do struktury PreviewContext z parametrami
+ * @param file_size Zwraca rozmiar pliku w bajtach
+ * 
+ * @return Bufor pliku (zwalniany przez stats_free()) lub NULL
+ */
+static uchar* build_4bpp_preview(uchar* packed_data, PreviewContext* preview_ctx, size_t* file_size) {
     int width = preview_ctx->width;
     int height = preview_ctx->height;
-    const char* output_path = preview_ctx->output_path;
-    int palette_variant = preview_ctx->palette_variant;
     uchar* custom_first = preview_ctx->custom_first;
     uchar* custom_last = preview_ctx->custom_last;
-    int scan_direction = preview_ctx->scan_direction;
-    FILE* file = fopen(output_path, "wb");
-    if (!file) {
-        return 0;
-    }
+    int pixel_order = preview_ctx->pixel_order;
     
     // Oblicz rozmiar wiersza z dopełnieniem (musi być wielokrotnością 4)
-    int row_size = ((width + 7) / 8 + 3) & ~3; // Zaokrąglij w górę do wielokrotności 4
-    int data_size = row_size * height;
+    int line_bytes = (width + 1) / 2;
+    int row_size = (line_bytes + 3) & ~3; // Zaokrąglij w górę do wielokrotności 4
     
-    // Nagłówek BMP
-    BMPHeader bmp_header = {
-        .signature = {0x42, 0x4D}, // "BM"
-        .file_size = 0,            // Zostanie wypełnione
-        .reserved = 0,
-        .data_offset = BMP_1BPP_DATA_OFFSET
-    };
-    
-    // Oblicz rozmiar pliku (z sekcją copyright)
-    unsigned int file_size = BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + BMP_1BPP_PALETTE_SIZE + BMP_COPYRIGHT_SECTION_SIZE + data_size;
-    bmp_header.file_size = file_size;
-    
-    // Nagłówek informacyjny BMP
-    BMPInfoHeader info_header = {
-        .header_size = BMP_INFO_HEADER_SIZE,
-        .width = width,
-        .height = height,
-        .planes = 1,
-        .bits_per_pixel = 1,
-        .compression = BMP_COMPRESSION_NONE,
-        .image_size = data_size,
-        .x_pixels_per_meter = 0,
-        .y_pixels_per_meter = 0,
-        .colors_used = 2,
-        .colors_important = 0
-    };
-    
-    // Paleta kolorów - wybrana wariant
-    BMPColorEntry palette[2];
-    PaletteContext palette_context = {palette_variant, 2, {custom_first[0], custom_first[1], custom_first[2]}, {custom_last[0], custom_last[1], custom_last[2]}};
+    // Paleta kolorów (16 odcieni lub paleta wyznaczona z obrazu dla --color indexed)
+    BMPColorEntry palette[16];
+    PaletteContext palette_context = {preview_ctx->palette_variant, 16, {custom_first[0], custom_first[1], custom_first[2]}, {custom_last[0], custom_last[1], custom_last[2]}};
     generate_palette(palette, &palette_context);
+    if (preview_ctx->image_palette) {
+        for (int i = 0; i < 16; i++) {
+            palette[i].red = preview_ctx->image_palette[i * 3];
+            palette[i].green = preview_ctx->image_palette[i * 3 + 1];
+            palette[i].blue = preview_ctx->image_palette[i * 3 + 2];
+        }
+    }
     
-    // Zapisz nagłówek BMP
-    fwrite(&bmp_header, 1, sizeof(BMPHeader), file);
-    fwrite(&info_header, 1, sizeof(BMPInfoHeader), file);
-    fwrite(palette, 1, sizeof(palette), file);
-    
-    // Zapisz sekcję copyright
-    if (!write_bmp_copyright_section(file)) {
-        fclose(file);
-        return 0;
+    uchar* buffer = create_bmp_buffer(width, height, 4, palette, 16, row_size, file_size);
+    if (!buffer) {
+        return NULL;
     }
+    uchar* image_data = buffer + BMP_4BPP_DATA_OFFSET;
     
-    // Zapisz dane obrazu (od dołu do góry)
-    if (scan_direction) {
+    // Dane obrazu (od dołu do góry)
+    if (preview_ctx->scan_direction) {
         // Skanowanie poziome - dane są w formacie wierszowym
-        for (int y = height - 1; y >= 0; y--) {
-            fwrite(packed_data + (y * ((width + 7) / 8)), 1, (width + 7) / 8, file);
-            // Dodaj dopełnienie wiersza
-            int padding = row_size - ((width + 7) / 8);
-            for (int p = 0; p < padding; p++) {
-                fputc(0x00, file);
+        for (int y = 0; y < height; y++) {
+            uchar* src = packed_data + (size_t)y * line_bytes;
+            uchar* dst = image_data + (size_t)(height - 1 - y) * row_size;
+            if (pixel_order) {
+                memcpy(dst, src, line_bytes);
+            } else {
+                // Lewy piksel w młodszej połówce - zamień połówki
+                for (int i = 0; i < line_bytes; i++) {
+                    dst[i] = (uchar)((src[i] << 4) | (src[i] >> 4));
+                }
             }
         }
     } else {
         // Skanowanie pionowe - dane są w formacie kolumnowym, musimy je przekonwertować
-        uchar* row_data = malloc((width + 7) / 8);
-        for (int y = height - 1; y >= 0; y--) {
-            // Wyzeruj wiersz
-            memset(row_data, 0, (width + 7) / 8);
-            
-            // Skopiuj piksele z kolumn do wiersza
-            for (int x = 0; x < width; x++) {
-                int col_bytes = (height + 7) / 8;
-                int byte_index = x * col_bytes + (y / 8);
-                int bit_index = y % 8;
-                
-                if (byte_index < (width * col_bytes)) {
-                    uchar pixel_bit = (packed_data[byte_index] >> bit_index) & 1;
-                    if (pixel_bit) {
-                        int row_byte = x / 8;
-                        int row_bit = 7 - (x % 8);
-                        row_data[row_byte] |= (1 << row_bit);
-                    }
-                }
-            }
-            
-            fwrite(row_data, 1, (width + 7) / 8, file);
-            // Dodaj dopełnienie wiersza
-            int padding = row_size - ((width + 7) / 8);
-            for (int p = 0; p < padding; p++) {
-                fputc(0x00, file);
-            }
-        }
-        free(row_data);
+        transpose_4bpp_vertical(packed_data, image_data, width, height, row_size, pixel_order);
     }
     
-    fclose(file);
-    return 1;
+    return buffer;
 }
 
 /**
@@ -219,6 +454,7 @@ int generate_1bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx) {
  * @details Funkcja tworzy plik BMP w formacie 4bpp (4 bity na piksel) z danych
  * spakowanych w bajtach. Obsługuje różne palety kolorów, skanowanie poziome/pionowe
  * i generuje pełny plik BMP z nagłówkami, paletą kolorów i danymi obrazu.
+ * Cały plik jest składany w jednym buforze i zapisywany jednym wywołaniem.
  * 
  * @param packed_data Wskaźnik do spakowanych danych 4bpp (2 piksele na bajt)
  * @param preview_ctx Wskaźnik do struktury PreviewContext z parametrami
@@ -227,13 +463,14 @@ int generate_1bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx) {
  * 
  * @note Generuje pełny plik BMP z nagłówkami i paletą 16-kolorową
  * @note Obsługuje wyrównanie wierszy do granicy 4-bajtowej
- * @note Konwertuje dane kolumnowe na wierszowe dla podglądu
+ * @note Konwertuje dane kolumnowe na wierszowe blokami 2x2 pikseli
+ * @note Uwzględnia kolejność pikseli (pixel_order) użytą przy pakowaniu
  * @note Używa palety 16-kolorowej z interpolacją liniową
  * 
  * @example
  * ```c
- * PreviewContext ctx = {64, 32, "preview.bmp", PALETTE_BW, NULL, NULL, 1};
- * uchar data[512];  // 64*32/2 = 1024 bajtów
+ * PreviewContext ctx = {64, 32, "preview.bmp", PALETTE_BW, NULL, NULL, 1, 1};
+ * uchar data[1024];  // 64*32/2 = 1024 bajtów
  * 
  * if (generate_4bpp_bmp(data, &ctx)) {
  *     // Plik BMP został wygenerowany pomyślnie
@@ -241,122 +478,238 @@ int generate_1bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx) {
  * ```
  */
 int generate_4bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx) {
-    int width = preview_ctx->width;
-    int height = preview_ctx->height;
-    const char* output_path = preview_ctx->output_path;
-    int palette_variant = preview_ctx->palette_variant;
-    uchar* custom_first = preview_ctx->custom_first;
-    uchar* custom_last = preview_ctx->custom_last;
-    int scan_direction = preview_ctx->scan_direction;
-    FILE* file = fopen(output_path, "wb");
-    if (!file) {
+    size_t file_size;
+    uchar* buffer = build_4bpp_preview(packed_data, preview_ctx, &file_size);
+    if (!buffer) {
         return 0;
     }
     
-    // Oblicz rozmiar wiersza z dopełnieniem (musi być wielokrotnością 4)
-    int row_size = ((width + 1) / 2 + 3) & ~3; // Zaokrąglij w górę do wielokrotności 4
-    int data_size = row_size * height;
+    int success = write_bmp_buffer(preview_ctx->output_path, buffer, file_size);
+    stats_free(buffer);
+    return success;
+}
+
+/**
+ * @brief Odczytuje piksel (x, y) ze spakowanych danych N bpp
+ * 
+ * @details Odwrotność kerneli pack_pixels(): przy skanowaniu poziomym bajt
+ * leży w wierszu y, przy pionowym w kolumnie x. Przy pixel_order = 1
+ * pierwszy piksel bajtu zajmuje najstarsze bity.
+ */
+static uchar unpack_pixel(const uchar* packed_data, int x, int y, int width, int height, int bits_per_pixel, int scan_direction, int pixel_order) {
+    int pixels_per_byte = 8 / bits_per_pixel;
+    size_t byte_index;
+    int index;
+    if (scan_direction) {
+        byte_index = (size_t)y * ((width + pixels_per_byte - 1) / pixels_per_byte) + x / pixels_per_byte;
+        index = x % pixels_per_byte;
+    } else {
+        byte_index = (size_t)x * ((height + pixels_per_byte - 1) / pixels_per_byte) + y / pixels_per_byte;
+        index = y % pixels_per_byte;
+    }
+    int shift = pixel_order ? 8 - bits_per_pixel - index * bits_per_pixel : index * bits_per_pixel;
+    return (uchar)((packed_data[byte_index] >> shift) & (BPP_LEVELS(bits_per_pixel) - 1));
+}
+
+/**
+ * @brief Składa podgląd BMP dla głębi bez własnego formatu wierszy BMP
+ * 
+ * @details BMP nie ma trybu 2 bitów na piksel, więc podgląd 2bpp jest
+ * zapisywany jako BMP 4bpp z paletą 4 kolorów. Podgląd 8bpp to BMP 8bpp
+ * z paletą 256 kolorów. Piksele są rozpakowywane po jednym - podgląd
+ * jest pomocą wizualną, a nie ścieżką krytyczną.
+ * 
+ * @param packed_data Spakowane dane 2bpp lub 8bpp
+ * @param preview_ctx Kontekst podglądu
+ * @param bits_per_pixel Głębia danych (2 lub 8)
+ * @param file_size Rozmiar pliku BMP (wyjściowy)
+ * 
+ * @return Bufor pliku BMP (stats_free()) lub NULL w przypadku błędu
+ */
+static uchar* build_generic_preview(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel, size_t* file_size) {
+    int width = preview_ctx->width;
+    int height = preview_ctx->height;
+    int color_count = BPP_LEVELS(bits_per_pixel);
+    int bmp_bits = (bits_per_pixel == BITS_PER_PIXEL_2BPP) ? 4 : bits_per_pixel;
+    int row_size = (int)((((size_t)width * bmp_bits + 7) / 8 + 3) & ~(size_t)3);
     
-    // Nagłówek BMP
-    BMPHeader bmp_header = {
-        .signature = {0x42, 0x4D}, // "BM"
-        .file_size = 0,            // Zostanie wypełnione
-        .reserved = 0,
-        .data_offset = BMP_4BPP_DATA_OFFSET
-    };
+    BMPColorEntry palette[BMP_MAX_PALETTE_COLORS];
+    PaletteContext palette_context = {preview_ctx->palette_variant, color_count,
+                                      {preview_ctx->custom_first[0], preview_ctx->custom_first[1], preview_ctx->custom_first[2]},
+                                      {preview_ctx->custom_last[0], preview_ctx->custom_last[1], preview_ctx->custom_last[2]}};
+    generate_palette(palette, &palette_context);
     
-    // Oblicz rozmiar pliku (z sekcją copyright)
-    unsigned int file_size = BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + BMP_4BPP_PALETTE_SIZE + BMP_COPYRIGHT_SECTION_SIZE + data_size;
-    bmp_header.file_size = file_size;
+    uchar* buffer = create_bmp_buffer(width, height, bmp_bits, palette, color_count, row_size, file_size);
+    if (!buffer) {
+        return NULL;
+    }
+    uchar* image_data = buffer + BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + color_count * sizeof(BMPColorEntry) + BMP_COPYRIGHT_SECTION_SIZE;
     
-    // Nagłówek informacyjny BMP
-    BMPInfoHeader info_header = {
-        .header_size = BMP_INFO_HEADER_SIZE,
-        .width = width,
-        .height = height,
-        .planes = 1,
-        .bits_per_pixel = 4,
-        .compression = BMP_COMPRESSION_NONE,
-        .image_size = data_size,
-        .x_pixels_per_meter = 0,
-        .y_pixels_per_meter = 0,
-        .colors_used = 16,
-        .colors_important = 0
-    };
+    // Dane obrazu (od dołu do góry)
+    for (int y = 0; y < height; y++) {
+        uchar* dst = image_data + (size_t)(height - 1 - y) * row_size;
+        for (int x = 0; x < width; x++) {
+            uchar value = unpack_pixel(packed_data, x, y, width, height, bits_per_pixel, preview_ctx->scan_direction, preview_ctx->pixel_order);
+            if (bmp_bits == 8) {
+                dst[x] = value;
+            } else {
+                dst[x / 2] |= (x % 2) ? value : (uchar)(value << 4);
+            }
+        }
+    }
     
-    // Paleta kolorów (16 odcieni)
-    BMPColorEntry palette[16];
-    PaletteContext palette_context = {palette_variant, 16, {custom_first[0], custom_first[1], custom_first[2]}, {custom_last[0], custom_last[1], custom_last[2]}};
-    generate_palette(palette, &palette_context);
+    return buffer;
+}
+
+// Składa podgląd BMP dla dowolnej obsługiwanej głębi
+static uchar* build_preview(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel, size_t* file_size) {
+    switch (bits_per_pixel) {
+        case BITS_PER_PIXEL_1BPP:
+            return build_1bpp_preview(packed_data, preview_ctx, file_size);
+        case BITS_PER_PIXEL_4BPP:
+            return build_4bpp_preview(packed_data, preview_ctx, file_size);
+        case BITS_PER_PIXEL_2BPP:
+        case BITS_PER_PIXEL_8BPP:
+            return build_generic_preview(packed_data, preview_ctx, bits_per_pixel, file_size);
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Generuje podgląd BMP dla danych o dowolnej obsługiwanej głębi
+ * 
+ * @details 1bpp i 4bpp są zapisywane w natywnych formatach BMP, 2bpp jako
+ * BMP 4bpp z paletą 4 kolorów, 8bpp jako BMP 8bpp z paletą 256 kolorów.
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych
+ * @param preview_ctx Wskaźnik do struktury PreviewContext z parametrami
+ * @param bits_per_pixel Głębia danych (1, 2, 4 lub 8)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @example
+ * ```c
+ * PreviewContext ctx = {width, height, "preview.bmp", PALETTE_BW, first, last, 1, 1};
+ * generate_bmp_preview(packed, &ctx, BITS_PER_PIXEL_2BPP);
+ * ```
+ */
+int generate_bmp_preview(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel) {
+    size_t file_size;
+    uchar* buffer = build_preview(packed_data, preview_ctx, bits_per_pixel, &file_size);
+    if (!buffer) {
+        return 0;
+    }
     
-    // Zapisz nagłówek BMP
-    fwrite(&bmp_header, 1, sizeof(BMPHeader), file);
-    fwrite(&info_header, 1, sizeof(BMPInfoHeader), file);
-    fwrite(palette, 1, sizeof(palette), file);
+    int success = write_bmp_buffer(preview_ctx->output_path, buffer, file_size);
+    stats_free(buffer);
+    return success;
+}
+
+/**
+ * @brief Generuje podgląd BMP 24-bitowy dla wyjścia kolorowego
+ * 
+ * @details Piksele RGB565/RGB332/RGB444 są rozpakowywane z powrotem do
+ * BGR, więc podgląd pokazuje dokładnie kolory trafiające na wyświetlacz
+ * (razem z ditheringiem). Paleta nie jest używana.
+ * 
+ * @param packed_data Spakowane dane pack_color_pixels()
+ * @param preview_ctx Kontekst podglądu (wariant palety jest pomijany)
+ * @param color_format Format wyjścia kolorowego (COLOR_FORMAT_*)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int generate_color_preview(uchar* packed_data, PreviewContext* preview_ctx, int color_format) {
+    int width = preview_ctx->width;
+    int height = preview_ctx->height;
+    int row_size = (int)(((size_t)width * 3 + 3) & ~(size_t)3);
+    size_t file_size;
     
-    // Zapisz sekcję copyright
-    if (!write_bmp_copyright_section(file)) {
-        fclose(file);
+    uchar* buffer = create_bmp_buffer(width, height, 24, NULL, 0, row_size, &file_size);
+    if (!buffer) {
         return 0;
     }
+    uchar* image_data = buffer + BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + BMP_COPYRIGHT_SECTION_SIZE;
     
-    // Zapisz dane obrazu (od dołu do góry)
-    if (scan_direction) {
-        // Skanowanie poziome - dane są w formacie wierszowym
-        for (int y = height - 1; y >= 0; y--) {
-            fwrite(packed_data + (y * ((width + 1) / 2)), 1, (width + 1) / 2, file);
-            // Dodaj dopełnienie wiersza
-            int padding = row_size - ((width + 1) / 2);
-            for (int p = 0; p < padding; p++) {
-                fputc(0x00, file);
-            }
+    // Dane obrazu (od dołu do góry)
+    for (int y = 0; y < height; y++) {
+        uchar* dst = image_data + (size_t)(height - 1 - y) * row_size;
+        for (int x = 0; x < width; x++, dst += 3) {
+            unpack_color_pixel(packed_data, x, y, width, height, color_format, preview_ctx->scan_direction, dst);
         }
-    } else {
-        // Skanowanie pionowe - dane są w formacie kolumnowym, musimy je przekonwertować
-        uchar* row_data = malloc((width + 1) / 2);
-        for (int y = height - 1; y >= 0; y--) {
-            // Wyzeruj wiersz
-            memset(row_data, 0, (width + 1) / 2);
-            
-            // Skopiuj piksele z kolumn do wiersza
-            for (int x = 0; x < width; x += 2) {
-                int col_bytes = (height + 1) / 2;
-                int byte_index = (x / 2) * col_bytes + (y / 2);
-                
-                if (byte_index < ((width / 2) * col_bytes)) {
-                    uchar packed_byte = packed_data[byte_index];
-                    uchar pixel1, pixel2;
-                    
-                    // W formacie pionowym, każdy bajt zawiera 2 piksele z tej samej kolumny
-                    if (y % 2 == 0) {
-                        // Pierwszy piksel w parze
-                        pixel1 = (packed_byte >> 4) & 0x0F;
-                        pixel2 = packed_byte & 0x0F;
-                    } else {
-                        // Drugi piksel w parze
-                        pixel1 = packed_byte & 0x0F;
-                        pixel2 = (packed_byte >> 4) & 0x0F;
-                    }
-                    
-                    // Zapisz piksele w wierszu
-                    if (x + 1 < width) {
-                        row_data[x / 2] = (pixel1 << 4) | pixel2;
-                    } else {
-                        row_data[x / 2] = (pixel1 << 4);
-                    }
-                }
-            }
-            
-            fwrite(row_data, 1, (width + 1) / 2, file);
-            // Dodaj dopełnienie wiersza
-            int padding = row_size - ((width + 1) / 2);
-            for (int p = 0; p < padding; p++) {
-                fputc(0x00, file);
-            }
+    }
+    
+    int success = write_bmp_buffer(preview_ctx->output_path, buffer, file_size);
+    stats_free(buffer);
+    return success;
+}
+
+/**
+ * @brief Tworzy ścieżkę podglądu dla wariantu palety
+ * 
+ * @details Wstawia nazwę palety przed rozszerzeniem, np. dla "img.bmp"
+ * i PALETTE_GREEN zwraca "img_green.bmp".
+ * 
+ * @param dst Bufor wynikowy
+ * @param size Rozmiar bufora wynikowego
+ * @param path Ścieżka podglądu
+ * @param variant Wariant palety (PALETTE_BW..PALETTE_CUSTOM)
+ */
+void make_palette_preview_path(char* dst, size_t size, const char* path, int variant) {
+    const char* name = path;
+    for (const char* p = path; *p; p++) {
+        if (*p == '/' || *p == '\\') {
+            name = p + 1;
         }
-        free(row_data);
+    }
+    const char* dot = strrchr(name, '.');
+    int stem_length = dot ? (int)(dot - path) : (int)strlen(path);
+    snprintf(dst, size, "%.*s_%s%s", stem_length, path, palette_variant_name(variant), dot ? dot : "");
+}
+
+/**
+ * @brief Generuje podglądy BMP we wszystkich predefiniowanych paletach
+ * 
+ * @details Dane obrazu (transpozycja, wiersze BMP) są składane tylko raz.
+ * Dla każdego wariantu od PALETTE_BW do PALETTE_OLED_YELLOW w tym samym
+ * buforze podmieniany jest wyłącznie blok palety, a plik jest zapisywany
+ * pod nazwą z przyrostkiem wariantu (make_palette_preview_path()).
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych
+ * @param preview_ctx Wskaźnik do struktury PreviewContext (palette_variant jest ignorowany)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * 
+ * @return Liczba zapisanych plików (PALETTE_PRESET_COUNT w przypadku sukcesu)
+ * 
+ * @example
+ * ```c
+ * PreviewContext ctx = {64, 32, "preview.bmp", PALETTE_ALL, first, last, 1, 1};
+ * generate_bmp_all_palettes(data, &ctx, 1);
+ * // preview_bw.bmp, preview_gray.bmp, preview_green.bmp, ...
+ * ```
+ */
+int generate_bmp_all_palettes(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel) {
+    size_t file_size;
+    uchar* buffer = build_preview(packed_data, preview_ctx, bits_per_pixel, &file_size);
+    if (!buffer) {
+        return 0;
+    }
+    
+    int color_count = BPP_LEVELS(bits_per_pixel);
+    BMPColorEntry* palette_block = (BMPColorEntry*)(buffer + BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE);
+    int written = 0;
+    
+    for (int variant = 0; variant < PALETTE_PRESET_COUNT; variant++) {
+        BMPColorEntry palette[BMP_MAX_PALETTE_COLORS];
+        PaletteContext palette_context = {variant, color_count, {0, 0, 0}, {0, 0, 0}};
+        generate_palette(palette, &palette_context);
+        memcpy(palette_block, palette, color_count * sizeof(BMPColorEntry));
+        
+        char path[256];
+        make_palette_preview_path(path, sizeof(path), preview_ctx->output_path, variant);
+        written += write_bmp_buffer(path, buffer, file_size);
     }
     
-    fclose(file);
-    return 1;
+    stats_free(buffer);
+    return written;
 }
@@ -13,11 +13,16 @@
 #ifndef BMP_WRITER_H
 #define BMP_WRITER_H
 
+#include <stddef.h>
 #include "defs.h"
 #include "bmp_defs.h"
 
 // Prototypy funkcji zapisu BMP
 int generate_1bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx);
 int generate_4bpp_bmp(uchar* packed_data, PreviewContext* preview_ctx);
+int generate_bmp_preview(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel);
+int generate_color_preview(uchar* packed_data, PreviewContext* preview_ctx, int color_format);
+int generate_bmp_all_palettes(uchar* packed_data, PreviewContext* preview_ctx, int bits_per_pixel);
+void make_palette_preview_path(char* dst, size_t size, const char* path, int variant);
 
 #endif
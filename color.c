@@ -0,0 +1,464 @@
+/*****************************************************************************
+
+    plik  : color.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : wyjście kolorowe RGB565 (little/big endian), RGB332 i RGB444
+            pakowane wprost z danych BGR, z ditheringiem każdego kanału
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "defs.h"
+#include "color.h"
+#include "utils.h"
+#include "stats.h"
+#include "threads.h"
+
+// SSE2 jest dostępne na każdym procesorze x86-64 (i opcjonalnie na x86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLOR_USE_SSE2 1
+#endif
+
+// Opis formatu wyjścia kolorowego
+typedef struct {
+    int format;                // COLOR_FORMAT_*
+    const char* name;          // Nazwa opcji --color
+    const char* description;   // Nazwa w komunikatach i nagłówku pliku
+    int bits;                  // Bity na piksel
+    int channel_bits[3];       // Bity kanałów R, G, B
+} ColorFormatInfo;
+
+static const ColorFormatInfo color_formats[] = {
+    {COLOR_FORMAT_RGB565_LE, "rgb565le", "RGB565 little endian", 16, {5, 6, 5}},
+    {COLOR_FORMAT_RGB565_BE, "rgb565be", "RGB565 big endian", 16, {5, 6, 5}},
+    {COLOR_FORMAT_RGB332, "rgb332", "RGB332", 8, {3, 3, 2}},
+    {COLOR_FORMAT_RGB444, "rgb444", "RGB444", 12, {4, 4, 4}},
+    {COLOR_FORMAT_INDEXED, "indexed", "Indexed 16 colors", 4, {0, 0, 0}}  // Pakowany jak 4bpp (color_quantize.c)
+};
+
+static const ColorFormatInfo* find_color_format(int color_format) {
+    for (size_t i = 0; i < sizeof(color_formats) / sizeof(color_formats[0]); i++) {
+        if (color_formats[i].format == color_format) {
+            return &color_formats[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Zwraca format wyjścia kolorowego dla nazwy opcji --color
+ *
+ * @param name Nazwa formatu (rgb565, rgb565le, rgb565be, rgb332, rgb444, indexed)
+ *
+ * @return COLOR_FORMAT_* lub -1 dla nieznanej nazwy
+ *
+ * @note "rgb565" oznacza little endian - kolejność bajtów uint16_t na MCU
+ */
+int parse_color_format(const char* name) {
+    if (strcmp(name, "rgb565") == 0) {
+        return COLOR_FORMAT_RGB565_LE;
+    }
+    for (size_t i = 0; i < sizeof(color_formats) / sizeof(color_formats[0]); i++) {
+        if (strcmp(name, color_formats[i].name) == 0) {
+            return color_formats[i].format;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Zwraca nazwę formatu wyjścia kolorowego
+ *
+ * @param color_format COLOR_FORMAT_*
+ *
+ * @return Nazwa formatu (np. "RGB565 big endian") lub "none"
+ */
+const char* color_format_name(int color_format) {
+    const ColorFormatInfo* info = find_color_format(color_format);
+    return info ? info->description : "none";
+}
+
+/**
+ * @brief Zwraca liczbę bitów na piksel formatu wyjścia kolorowego
+ *
+ * @param color_format COLOR_FORMAT_*
+ *
+ * @return 16, 12, 8 lub 4 (indexed); 0 dla nieznanego formatu
+ */
+int color_format_bits(int color_format) {
+    const ColorFormatInfo* info = find_color_format(color_format);
+    return info ? info->bits : 0;
+}
+
+// Rozmiar linii (wiersza lub kolumny) o długości length pikseli - linie zaczynają się od pełnego bajtu
+static size_t color_line_size(size_t length, int bits) {
+    return (length * bits + 7) / 8;
+}
+
+/**
+ * @brief Oblicza rozmiar danych wyjścia kolorowego
+ *
+ * @details Przy skanowaniu poziomym linią jest wiersz, przy pionowym
+ * kolumna. Każda linia zaczyna się od pełnego bajtu - dla RGB444
+ * z nieparzystą długością linii ostatni półbajt jest dopełnieniem.
+ *
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param color_format COLOR_FORMAT_*
+ * @param scan_direction 1 = poziomo (wiersze), 0 = pionowo (kolumny)
+ *
+ * @return Rozmiar w bajtach lub 0 przy przepełnieniu / nieznanym formacie
+ *
+ * @note COLOR_FORMAT_INDEXED ma rozmiar danych 4bpp (calculate_packed_size())
+ */
+size_t calculate_color_packed_size(int width, int height, int color_format, int scan_direction) {
+    const ColorFormatInfo* info = find_color_format(color_format);
+    if (!info || info->format == COLOR_FORMAT_INDEXED) {
+        return 0;
+    }
+    size_t lines = (size_t)(scan_direction ? height : width);
+    size_t length = (size_t)(scan_direction ? width : height);
+    size_t packed_size;
+    if (length > ((size_t)-1 - 7) / 16 || !size_multiply(lines, color_line_size(length, info->bits), &packed_size)) {
+        return 0;
+    }
+    return packed_size;
+}
+
+// Składa wartość piksela z poziomów kanałów: R w najstarszych bitach, B w najmłodszych
+static dword encode_color(const ColorFormatInfo* info, int r, int g, int b) {
+    return ((dword)r << (info->channel_bits[1] + info->channel_bits[2])) | ((dword)g << info->channel_bits[2]) | (dword)b;
+}
+
+// Zapisuje wartość piksela index w linii
+static void put_color_value(uchar* line, size_t index, dword value, int color_format) {
+    switch (color_format) {
+        case COLOR_FORMAT_RGB565_LE:
+            line[2 * index] = (uchar)value;
+            line[2 * index + 1] = (uchar)(value >> 8);
+            break;
+        case COLOR_FORMAT_RGB565_BE:
+            line[2 * index] = (uchar)(value >> 8);
+            line[2 * index + 1] = (uchar)value;
+            break;
+        case COLOR_FORMAT_RGB332:
+            line[index] = (uchar)value;
+            break;
+        case COLOR_FORMAT_RGB444: {
+            // Strumień półbajtów R G B od najstarszego - 2 piksele w 3 bajtach
+            uchar* dst = line + index * 3 / 2;
+            if (index % 2 == 0) {
+                dst[0] = (uchar)(value >> 4);
+                dst[1] = (uchar)((dst[1] & 0x0F) | ((value & 0x0F) << 4));
+            } else {
+                dst[0] = (uchar)((dst[0] & 0xF0) | (value >> 8));
+                dst[1] = (uchar)value;
+            }
+            break;
+        }
+    }
+}
+
+// Odczytuje wartość piksela index z linii (odwrotność put_color_value())
+static dword get_color_value(const uchar* line, size_t index, int color_format) {
+    switch (color_format) {
+        case COLOR_FORMAT_RGB565_LE:
+            return (dword)line[2 * index] | ((dword)line[2 * index + 1] << 8);
+        case COLOR_FORMAT_RGB565_BE:
+            return ((dword)line[2 * index] << 8) | (dword)line[2 * index + 1];
+        case COLOR_FORMAT_RGB332:
+            return line[index];
+        case COLOR_FORMAT_RGB444: {
+            const uchar* src = line + index * 3 / 2;
+            if (index % 2 == 0) {
+                return ((dword)src[0] << 4) | (dword)(src[1] >> 4);
+            }
+            return ((dword)(src[0] & 0x0F) << 8) | (dword)src[1];
+        }
+        default:
+            return 0;
+    }
+}
+
+#ifdef COLOR_USE_SSE2
+// Ładuje 4 piksele BGR(A) jako 32-bitowe słowa 0x??RRGGBB
+static __m128i load_bgr4(const uchar* src, int bytes_per_pixel) {
+    if (bytes_per_pixel == 4) {
+        return _mm_loadu_si128((const __m128i*)src);
+    }
+    int pixels[4];
+    for (int i = 0; i < 4; i++) {
+        memcpy(&pixels[i], src + i * 3, 4);
+    }
+    return _mm_loadu_si128((const __m128i*)pixels);
+}
+
+// Piksele 0x??RRGGBB → RGB565 w 32-bitowych słowach
+static __m128i bgr4_to_rgb565(__m128i pixels) {
+    __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32(0xF800));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x07E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 3), _mm_set1_epi32(0x001F));
+    __m128i value = _mm_or_si128(_mm_or_si128(r, g), b);
+    // Rozszerzenie znaku bitu 15, aby _mm_packs_epi32 nie nasycało wartości >= 0x8000
+    return _mm_srai_epi32(_mm_slli_epi32(value, 16), 16);
+}
+
+// Piksele 0x??RRGGBB → RGB332 w 32-bitowych słowach
+static __m128i bgr4_to_rgb332(__m128i pixels) {
+    __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32(0xE0));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 11), _mm_set1_epi32(0x1C));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 6), _mm_set1_epi32(0x03));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+/**
+ * @brief Pakuje początek wiersza RGB565/RGB332 po 8 pikseli z SSE2
+ *
+ * @details Dla danych 24-bitowych każdy piksel jest ładowany jako 4 bajty,
+ * więc ostatni piksel wiersza zostaje dla pętli skalarnej - odczyt nie
+ * wychodzi poza dane obrazu.
+ *
+ * @return Liczba spakowanych pikseli (reszta wiersza w kodzie skalarnym)
+ */
+static int pack_color_row_sse2(const uchar* src, int bytes_per_pixel, int width, uchar* dst, int color_format) {
+    int vector_end = (bytes_per_pixel == 3) ? width - 1 : width;
+    int x = 0;
+    if (color_format == COLOR_FORMAT_RGB332) {
+        for (; x + 8 <= vector_end; x += 8) {
+            __m128i low = bgr4_to_rgb332(load_bgr4(src + (size_t)x * bytes_per_pixel, bytes_per_pixel));
+            __m128i high = bgr4_to_rgb332(load_bgr4(src + (size_t)(x + 4) * bytes_per_pixel, bytes_per_pixel));
+            __m128i words = _mm_packs_epi32(low, high);
+            _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(words, words));
+        }
+        return x;
+    }
+    for (; x + 8 <= vector_end; x += 8) {
+        __m128i low = bgr4_to_rgb565(load_bgr4(src + (size_t)x * bytes_per_pixel, bytes_per_pixel));
+        __m128i high = bgr4_to_rgb565(load_bgr4(src + (size_t)(x + 4) * bytes_per_pixel, bytes_per_pixel));
+        __m128i words = _mm_packs_epi32(low, high);
+        if (color_format == COLOR_FORMAT_RGB565_BE) {
+            words = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+        }
+        _mm_storeu_si128((__m128i*)(dst + 2 * (size_t)x), words);
+    }
+    return x;
+}
+#endif
+
+/**
+ * @brief Pakuje obraz bez ditheringu wprost z danych BGR
+ *
+ * @details Kanały są obcinane do starszych bitów (r >> 3 itd.). Wiersze
+ * RGB565 i RGB332 skanowane poziomo idą przez kernel SSE2, pozostałe
+ * przypadki (RGB444, skanowanie pionowe, końcówki wierszy) przez pętlę
+ * skalarną z identycznym wynikiem.
+ */
+static void pack_color_direct(ImageRowView* view, uchar* packed_data, const ColorFormatInfo* info, int scan_direction) {
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    size_t line_size = color_line_size((size_t)(scan_direction ? view->width : view->height), info->bits);
+    int shift_r = 8 - info->channel_bits[0];
+    int shift_g = 8 - info->channel_bits[1];
+    int shift_b = 8 - info->channel_bits[2];
+
+    // Wiersze w kolejności pliku - dla BMP od dołu od ostatniego wiersza obrazu
+    for (int i = 0; i < view->height; i++) {
+        int y = (view->stride < 0) ? view->height - 1 - i : i;
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        int x = 0;
+        if (scan_direction) {
+            uchar* line = packed_data + (size_t)y * line_size;
+#ifdef COLOR_USE_SSE2
+            if (info->bits != 12) {
+                x = pack_color_row_sse2(src, bytes_per_pixel, view->width, line, info->format);
+            }
+#endif
+            for (src += (size_t)x * bytes_per_pixel; x < view->width; x++, src += bytes_per_pixel) {
+                put_color_value(line, x, encode_color(info, src[2] >> shift_r, src[1] >> shift_g, src[0] >> shift_b), info->format);
+            }
+        } else {
+            for (; x < view->width; x++, src += bytes_per_pixel) {
+                put_color_value(packed_data + (size_t)x * line_size, y, encode_color(info, src[2] >> shift_r, src[1] >> shift_g, src[0] >> shift_b), info->format);
+            }
+        }
+    }
+}
+
+// Zadanie ditheringu jednego kanału (wykonywane równolegle)
+typedef struct {
+    uchar* plane;
+    int width;
+    int height;
+    int dithering_method;
+    int levels;
+    int result;
+} ChannelDitherJob;
+
+static void dither_channel_job(void* arg, int index) {
+    ChannelDitherJob* job = &((ChannelDitherJob*)arg)[index];
+    job->result = apply_dithering(job->plane, job->width, job->height, job->dithering_method, job->levels);
+}
+
+/**
+ * @brief Pakuje obraz z ditheringiem każdego kanału osobno
+ *
+ * @details Kanały R, G, B są rozdzielane na płaszczyzny 0-255, a każda
+ * płaszczyzna przechodzi przez ten sam dithering co skala szarości
+ * (apply_dithering() z liczbą poziomów kanału, np. 32/64/32 dla RGB565).
+ * Trzy płaszczyzny są niezależne, więc dithering biegnie równolegle.
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+static int pack_color_dithered(ImageRowView* view, uchar* packed_data, const ColorFormatInfo* info, int dithering_method, int scan_direction) {
+    int width = view->width;
+    int height = view->height;
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    size_t pixel_count = (size_t)width * height;
+    size_t line_size = color_line_size((size_t)(scan_direction ? width : height), info->bits);
+
+    uchar* planes = (uchar*)stats_malloc(3 * pixel_count);
+    if (!planes) {
+        printf("Error: Cannot allocate memory for color channels\n");
+        return 0;
+    }
+
+    // Rozdzielenie BGR na płaszczyzny R, G, B (od góry do dołu)
+    for (int i = 0; i < height; i++) {
+        int y = (view->stride < 0) ? height - 1 - i : i;
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        size_t offset = (size_t)y * width;
+        for (int x = 0; x < width; x++, src += bytes_per_pixel) {
+            planes[offset + x] = src[2];
+            planes[pixel_count + offset + x] = src[1];
+            planes[2 * pixel_count + offset + x] = src[0];
+        }
+    }
+
+    ChannelDitherJob jobs[3];
+    for (int c = 0; c < 3; c++) {
+        ChannelDitherJob job = {planes + c * pixel_count, width, height, dithering_method, 1 << info->channel_bits[c], 0};
+        jobs[c] = job;
+    }
+    run_parallel(3, dither_channel_job, jobs, 3);
+    if (!jobs[0].result || !jobs[1].result || !jobs[2].result) {
+        stats_free(planes);
+        return 0;
+    }
+
+    // Po ditheringu wartości leżą dokładnie na poziomach kanału - odwzorowanie na numer poziomu
+    uchar level_lut[3][256];
+    for (int c = 0; c < 3; c++) {
+        int steps = (1 << info->channel_bits[c]) - 1;
+        for (int value = 0; value < 256; value++) {
+            level_lut[c][value] = (uchar)((value * steps + 127) / 255);
+        }
+    }
+
+    const uchar* plane_r = planes;
+    const uchar* plane_g = planes + pixel_count;
+    const uchar* plane_b = planes + 2 * pixel_count;
+    for (int y = 0; y < height; y++) {
+        size_t offset = (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            dword value = encode_color(info, level_lut[0][plane_r[offset + x]], level_lut[1][plane_g[offset + x]], level_lut[2][plane_b[offset + x]]);
+            if (scan_direction) {
+                put_color_value(packed_data + (size_t)y * line_size, x, value, info->format);
+            } else {
+                put_color_value(packed_data + (size_t)x * line_size, y, value, info->format);
+            }
+        }
+    }
+
+    stats_free(planes);
+    return 1;
+}
+
+/**
+ * @brief Pakuje obraz BGR(A) do formatu wyjścia kolorowego
+ *
+ * @details Zamiast konwersji do skali szarości piksele są pakowane wprost
+ * z danych BMP 24/32-bitowych. Bez ditheringu kanały są obcinane do
+ * starszych bitów, z ditheringiem (floyd, o8x8, blue) każdy kanał jest
+ * ditherowany do własnej liczby poziomów.
+ *
+ * Układ danych:
+ * - RGB565 little endian: młodszy bajt pierwszy (uint16_t na MCU little endian)
+ * - RGB565 big endian: starszy bajt pierwszy - kolejność oczekiwana przez
+ *   sterowniki TFT po SPI, bufor można wysłać przez DMA bez zamiany bajtów
+ * - RGB332: jeden bajt RRRGGGBB na piksel
+ * - RGB444: 2 piksele w 3 bajtach (RRRRGGGG BBBBRRRR GGGGBBBB)
+ *
+ * @param view Widok wierszy obrazu wejściowego (24 lub 32 bpp, BGR/BGRA)
+ * @param packed_data Bufor wyjściowy (calculate_color_packed_size() bajtów)
+ * @param color_format COLOR_FORMAT_*
+ * @param dithering_method Metoda ditheringu (DITHERING_*)
+ * @param scan_direction 1 = poziomo (wiersze), 0 = pionowo (kolumny)
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ *
+ * @example
+ * ```c
+ * size_t size = calculate_color_packed_size(w, h, COLOR_FORMAT_RGB565_BE, 1);
+ * uchar* packed = stats_malloc(size);
+ * pack_color_pixels(&view, packed, COLOR_FORMAT_RGB565_BE, DITHERING_FLOYD, 1);
+ * ```
+ */
+int pack_color_pixels(ImageRowView* view, uchar* packed_data, int color_format, int dithering_method, int scan_direction) {
+    const ColorFormatInfo* info = find_color_format(color_format);
+    if (!info || info->format == COLOR_FORMAT_INDEXED || view->bits_per_pixel < 24) {
+        return 0;
+    }
+
+    size_t packed_size = calculate_color_packed_size(view->width, view->height, color_format, scan_direction);
+    if (info->bits == 12) {
+        // Półbajty dopełnienia linii nie są zapisywane przez put_color_value()
+        memset(packed_data, 0, packed_size);
+    }
+
+    if (dithering_method == DITHERING_NONE) {
+        pack_color_direct(view, packed_data, info, scan_direction);
+        return 1;
+    }
+    return pack_color_dithered(view, packed_data, info, dithering_method, scan_direction);
+}
+
+/**
+ * @brief Odczytuje piksel (x, y) z danych wyjścia kolorowego
+ *
+ * @details Odwrotność pack_color_pixels() dla podglądu BMP: poziomy
+ * kanałów są rozciągane z powrotem na pełną skalę 0-255.
+ *
+ * @param packed_data Spakowane dane
+ * @param x Kolumna piksela
+ * @param y Wiersz piksela
+ * @param width Szerokość obrazu
+ * @param height Wysokość obrazu
+ * @param color_format COLOR_FORMAT_*
+ * @param scan_direction 1 = poziomo (wiersze), 0 = pionowo (kolumny)
+ * @param bgr Wynik: 3 bajty w kolejności B, G, R
+ */
+void unpack_color_pixel(const uchar* packed_data, int x, int y, int width, int height, int color_format, int scan_direction, uchar* bgr) {
+    const ColorFormatInfo* info = find_color_format(color_format);
+    if (!info) {
+        bgr[0] = bgr[1] = bgr[2] = 0;
+        return;
+    }
+
+    size_t line_size = color_line_size((size_t)(scan_direction ? width : height), info->bits);
+    dword value = scan_direction ? get_color_value(packed_data + (size_t)y * line_size, x, color_format)
+                                 : get_color_value(packed_data + (size_t)x * line_size, y, color_format);
+
+    int shift = 0;
+    for (int c = 2; c >= 0; c--) {
+        // c: 0 = R, 1 = G, 2 = B - B w najmłodszych bitach
+        int steps = (1 << info->channel_bits[c]) - 1;
+        int level = (int)((value >> shift) & (dword)steps);
+        bgr[2 - c] = (uchar)(level * 255 / steps);
+        shift += info->channel_bits[c];
+    }
+}
@@ -0,0 +1,28 @@
+/*****************************************************************************
+
+    plik  : color.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla wyjścia kolorowego RGB565/RGB332/RGB444
+            dla wyświetlaczy TFT
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef COLOR_H
+#define COLOR_H
+
+#include <stddef.h>
+#include "defs.h"
+
+// Prototypy funkcji wyjścia kolorowego
+int parse_color_format(const char* name);
+const char* color_format_name(int color_format);
+int color_format_bits(int color_format);
+size_t calculate_color_packed_size(int width, int height, int color_format, int scan_direction);
+int pack_color_pixels(ImageRowView* view, uchar* packed_data, int color_format, int dithering_method, int scan_direction);
+void unpack_color_pixel(const uchar* packed_data, int x, int y, int width, int height, int color_format, int scan_direction, uchar* bgr);
+
+#endif
@@ -0,0 +1,416 @@
+/*****************************************************************************
+
+    plik  : color_quantize.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : kwantyzacja kolorów do palety wyznaczonej z obrazu (median cut
+            z opcjonalnym k-means) i mapowanie pikseli na indeksy palety
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "defs.h"
+#include "color_quantize.h"
+#include "stats.h"
+#include "threads.h"
+
+// Histogram: 5 bitów na kanał (RGB555) - 32768 komórek
+#define QUANTIZE_HISTOGRAM_BITS 5
+#define QUANTIZE_HISTOGRAM_SIZE (1 << (3 * QUANTIZE_HISTOGRAM_BITS))
+
+// Liczba wierszy obrazu w jednym zadaniu równoległym
+#define QUANTIZE_ROWS_PER_TASK 64
+
+// Pamięć podręczna najbliższego koloru: mapowanie bezpośrednie, 4096 wpisów
+#define QUANTIZE_CACHE_BITS 12
+#define QUANTIZE_CACHE_SIZE (1 << QUANTIZE_CACHE_BITS)
+#define QUANTIZE_CACHE_VALID 0x01000000u
+
+// Komórka histogramu: liczba pikseli i sumy kanałów (średni kolor komórki)
+typedef struct {
+    dword count;
+    unsigned long long sum[3];  // R, G, B
+} HistogramCell;
+
+// Niepusty kolor histogramu wejściowy dla median cut
+typedef struct {
+    uchar color[3];             // Średni kolor komórki (R, G, B)
+    dword count;
+    const HistogramCell* cell;
+} QuantizeEntry;
+
+// Pudełko median cut - zakres [first, last) tablicy wpisów
+typedef struct {
+    int first;
+    int last;
+    int widest_channel;         // Kanał o największym zakresie
+    int range;                  // Zakres tego kanału
+} QuantizeBox;
+
+// Pamięć podręczna najbliższego koloru (każde zadanie ma własną)
+typedef struct {
+    dword keys[QUANTIZE_CACHE_SIZE];     // Kolor 0xRRGGBB | QUANTIZE_CACHE_VALID
+    uchar indices[QUANTIZE_CACHE_SIZE];
+} NearestColorCache;
+
+// Zadanie równoległe przebiegu po pikselach (k-means lub mapowanie)
+typedef struct {
+    const ImageRowView* view;
+    const uchar* palette;       // Paleta RGB (3 bajty na kolor)
+    int color_count;
+    int first_row;
+    int row_count;
+    uchar* indices;             // Wynik mapowania lub NULL (przebieg k-means)
+    int indices_stride;
+    unsigned long long sums[QUANTIZE_MAX_COLORS][3];  // Sumy kanałów klastrów (k-means)
+    unsigned long long counts[QUANTIZE_MAX_COLORS];   // Liczności klastrów (k-means)
+} QuantizeTask;
+
+/**
+ * @brief Zwraca indeks najbliższego koloru palety (odległość euklidesowa w RGB)
+ */
+static int find_nearest_color(const uchar* palette, int color_count, int r, int g, int b) {
+    int best_index = 0;
+    int best_distance = 0x7FFFFFFF;
+    for (int i = 0; i < color_count; i++) {
+        int dr = r - palette[i * 3];
+        int dg = g - palette[i * 3 + 1];
+        int db = b - palette[i * 3 + 2];
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < best_distance) {
+            best_distance = distance;
+            best_index = i;
+        }
+    }
+    return best_index;
+}
+
+/**
+ * @brief Najbliższy kolor palety z pamięcią podręczną
+ *
+ * @details Obrazy mają zwykle dużo powtarzających się kolorów - pełne
+ * przeszukanie palety wykonywane jest tylko przy chybieniu. Klucz zawiera
+ * cały kolor 24-bitowy, więc wynik jest dokładny niezależnie od zawartości
+ * pamięci podręcznej.
+ */
+static int find_nearest_cached(NearestColorCache* cache, const uchar* palette, int color_count, int r, int g, int b) {
+    dword key = ((dword)r << 16) | ((dword)g << 8) | (dword)b;
+    dword slot = ((key * 2654435761u) >> (32 - QUANTIZE_CACHE_BITS)) & (QUANTIZE_CACHE_SIZE - 1);
+    if (cache->keys[slot] == (key | QUANTIZE_CACHE_VALID)) {
+        return cache->indices[slot];
+    }
+    int index = find_nearest_color(palette, color_count, r, g, b);
+    cache->keys[slot] = key | QUANTIZE_CACHE_VALID;
+    cache->indices[slot] = (uchar)index;
+    return index;
+}
+
+// Wyznacza kanał o największym zakresie w pudełku
+static void measure_box(const QuantizeEntry* entries, QuantizeBox* box) {
+    int low[3] = {255, 255, 255};
+    int high[3] = {0, 0, 0};
+    for (int i = box->first; i < box->last; i++) {
+        for (int c = 0; c < 3; c++) {
+            if (entries[i].color[c] < low[c]) low[c] = entries[i].color[c];
+            if (entries[i].color[c] > high[c]) high[c] = entries[i].color[c];
+        }
+    }
+    box->widest_channel = 0;
+    box->range = high[0] - low[0];
+    for (int c = 1; c < 3; c++) {
+        if (high[c] - low[c] > box->range) {
+            box->range = high[c] - low[c];
+            box->widest_channel = c;
+        }
+    }
+}
+
+// Porównanie wpisów po kanale channel; remisy rozstrzygają pozostałe kanały
+// i kolejność w histogramie, więc wynik qsort() nie zależy od implementacji
+static int compare_entries(const QuantizeEntry* a, const QuantizeEntry* b, int channel) {
+    for (int i = 0; i < 3; i++) {
+        int c = (channel + i) % 3;
+        if (a->color[c] != b->color[c]) {
+            return a->color[c] - b->color[c];
+        }
+    }
+    return (a->cell > b->cell) - (a->cell < b->cell);
+}
+
+static int compare_entries_r(const void* a, const void* b) {
+    return compare_entries((const QuantizeEntry*)a, (const QuantizeEntry*)b, 0);
+}
+
+static int compare_entries_g(const void* a, const void* b) {
+    return compare_entries((const QuantizeEntry*)a, (const QuantizeEntry*)b, 1);
+}
+
+static int compare_entries_b(const void* a, const void* b) {
+    return compare_entries((const QuantizeEntry*)a, (const QuantizeEntry*)b, 2);
+}
+
+/**
+ * @brief Median cut na niepustych komórkach histogramu
+ *
+ * @details Dzielone jest zawsze pudełko o największym zakresie kanału,
+ * wzdłuż tego kanału, w medianie liczby pikseli. Kolor palety to średnia
+ * ważona pikseli pudełka (z sum komórek histogramu, nie ze środków komórek).
+ *
+ * @return Liczba kolorów palety (mniejsza od color_count, gdy obraz ma
+ *         mniej różnych kolorów)
+ */
+static int median_cut(QuantizeEntry* entries, int entry_count, int color_count, uchar* palette) {
+    static int (*const comparators[3])(const void*, const void*) = {compare_entries_r, compare_entries_g, compare_entries_b};
+    QuantizeBox boxes[QUANTIZE_MAX_COLORS];
+    int box_count = 1;
+    boxes[0].first = 0;
+    boxes[0].last = entry_count;
+    measure_box(entries, &boxes[0]);
+
+    while (box_count < color_count) {
+        // Pudełko z największym zakresem, które da się podzielić
+        int split = -1;
+        for (int i = 0; i < box_count; i++) {
+            if (boxes[i].last - boxes[i].first >= 2 && (split < 0 || boxes[i].range > boxes[split].range)) {
+                split = i;
+            }
+        }
+        if (split < 0) {
+            break;
+        }
+
+        QuantizeBox* box = &boxes[split];
+        qsort(entries + box->first, (size_t)(box->last - box->first), sizeof(QuantizeEntry), comparators[box->widest_channel]);
+
+        unsigned long long total = 0;
+        for (int i = box->first; i < box->last; i++) {
+            total += entries[i].count;
+        }
+        // Mediana liczby pikseli; obie połowy muszą zawierać co najmniej jeden wpis
+        unsigned long long accumulated = 0;
+        int middle = box->first + 1;
+        for (int i = box->first; i < box->last - 1; i++) {
+            accumulated += entries[i].count;
+            middle = i + 1;
+            if (accumulated * 2 >= total) {
+                break;
+            }
+        }
+
+        boxes[box_count].first = middle;
+        boxes[box_count].last = box->last;
+        box->last = middle;
+        measure_box(entries, box);
+        measure_box(entries, &boxes[box_count]);
+        box_count++;
+    }
+
+    for (int i = 0; i < box_count; i++) {
+        unsigned long long sum[3] = {0, 0, 0};
+        unsigned long long count = 0;
+        for (int e = boxes[i].first; e < boxes[i].last; e++) {
+            for (int c = 0; c < 3; c++) {
+                sum[c] += entries[e].cell->sum[c];
+            }
+            count += entries[e].count;
+        }
+        for (int c = 0; c < 3; c++) {
+            palette[i * 3 + c] = (uchar)((sum[c] + count / 2) / count);
+        }
+    }
+    return box_count;
+}
+
+// Przebieg po wierszach zadania: mapowanie na indeksy lub sumy klastrów k-means
+static void quantize_task(void* arg, int index) {
+    QuantizeTask* task = &((QuantizeTask*)arg)[index];
+    const ImageRowView* view = task->view;
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    NearestColorCache* cache = (NearestColorCache*)stats_malloc(sizeof(NearestColorCache));
+    if (cache) {
+        memset(cache->keys, 0, sizeof(cache->keys));
+    }
+
+    memset(task->sums, 0, sizeof(task->sums));
+    memset(task->counts, 0, sizeof(task->counts));
+    for (int y = task->first_row; y < task->first_row + task->row_count; y++) {
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        uchar* dst = task->indices ? task->indices + (size_t)y * task->indices_stride : NULL;
+        for (int x = 0; x < view->width; x++, src += bytes_per_pixel) {
+            int nearest = cache ? find_nearest_cached(cache, task->palette, task->color_count, src[2], src[1], src[0])
+                                : find_nearest_color(task->palette, task->color_count, src[2], src[1], src[0]);
+            if (dst) {
+                dst[x] = (uchar)nearest;
+            } else {
+                task->sums[nearest][0] += src[2];
+                task->sums[nearest][1] += src[1];
+                task->sums[nearest][2] += src[0];
+                task->counts[nearest]++;
+            }
+        }
+    }
+    if (cache) {
+        stats_free(cache);
+    }
+}
+
+// Dzieli obraz na zadania po QUANTIZE_ROWS_PER_TASK wierszy i wykonuje je równolegle
+static QuantizeTask* run_quantize_tasks(const ImageRowView* view, const uchar* palette, int color_count, uchar* indices, int indices_stride, int* task_count) {
+    int count = (view->height + QUANTIZE_ROWS_PER_TASK - 1) / QUANTIZE_ROWS_PER_TASK;
+    QuantizeTask* tasks = (QuantizeTask*)stats_malloc((size_t)count * sizeof(QuantizeTask));
+    if (!tasks) {
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        tasks[i].view = view;
+        tasks[i].palette = palette;
+        tasks[i].color_count = color_count;
+        tasks[i].first_row = i * QUANTIZE_ROWS_PER_TASK;
+        tasks[i].row_count = (view->height - tasks[i].first_row < QUANTIZE_ROWS_PER_TASK) ? view->height - tasks[i].first_row : QUANTIZE_ROWS_PER_TASK;
+        tasks[i].indices = indices;
+        tasks[i].indices_stride = indices_stride;
+    }
+    run_parallel(count, quantize_task, tasks, 0);
+    *task_count = count;
+    return tasks;
+}
+
+/**
+ * @brief Wyznacza paletę color_count kolorów najlepiej oddającą obraz
+ *
+ * @details Najpierw histogram RGB555 z sumami kanałów, potem median cut
+ * na niepustych komórkach. Opcjonalne iteracje k-means (Lloyd) poprawiają
+ * paletę na pełnych kolorach pikseli: każdy piksel jest przypisywany do
+ * najbliższego koloru, a kolor zastępowany średnią przypisanych pikseli.
+ * Przebiegi k-means są równoległe - pasma wierszy liczą własne sumy,
+ * scalane po zakończeniu (wynik nie zależy od liczby wątków).
+ *
+ * @param view Widok wierszy obrazu (24 lub 32 bpp, BGR/BGRA)
+ * @param color_count Liczba kolorów palety (2..QUANTIZE_MAX_COLORS)
+ * @param kmeans_iterations Liczba iteracji k-means (0 = tylko median cut)
+ * @param palette Wynik: color_count kolorów RGB (3 bajty na kolor);
+ *                nieużyte wpisy są czarne
+ *
+ * @return Liczba wyznaczonych kolorów (1..color_count) lub 0 w przypadku błędu
+ *
+ * @example
+ * ```c
+ * uchar palette[16 * 3];
+ * int used = build_image_palette(&view, 16, 4, palette);
+ * map_to_palette(&view, palette, used, indices, width);
+ * ```
+ */
+int build_image_palette(ImageRowView* view, int color_count, int kmeans_iterations, uchar* palette) {
+    if (view->bits_per_pixel < 24 || color_count < 2 || color_count > QUANTIZE_MAX_COLORS) {
+        return 0;
+    }
+    memset(palette, 0, (size_t)color_count * 3);
+
+    HistogramCell* histogram = (HistogramCell*)stats_malloc(QUANTIZE_HISTOGRAM_SIZE * sizeof(HistogramCell));
+    if (!histogram) {
+        return 0;
+    }
+    memset(histogram, 0, QUANTIZE_HISTOGRAM_SIZE * sizeof(HistogramCell));
+
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    int shift = 8 - QUANTIZE_HISTOGRAM_BITS;
+    for (int y = 0; y < view->height; y++) {
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        for (int x = 0; x < view->width; x++, src += bytes_per_pixel) {
+            int cell_index = ((src[2] >> shift) << (2 * QUANTIZE_HISTOGRAM_BITS)) | ((src[1] >> shift) << QUANTIZE_HISTOGRAM_BITS) | (src[0] >> shift);
+            HistogramCell* cell = &histogram[cell_index];
+            cell->count++;
+            cell->sum[0] += src[2];
+            cell->sum[1] += src[1];
+            cell->sum[2] += src[0];
+        }
+    }
+
+    int entry_count = 0;
+    for (int i = 0; i < QUANTIZE_HISTOGRAM_SIZE; i++) {
+        entry_count += (histogram[i].count > 0);
+    }
+    QuantizeEntry* entries = (QuantizeEntry*)stats_malloc((size_t)entry_count * sizeof(QuantizeEntry));
+    if (!entries) {
+        stats_free(histogram);
+        return 0;
+    }
+    int entry = 0;
+    for (int i = 0; i < QUANTIZE_HISTOGRAM_SIZE; i++) {
+        const HistogramCell* cell = &histogram[i];
+        if (cell->count > 0) {
+            for (int c = 0; c < 3; c++) {
+                entries[entry].color[c] = (uchar)((cell->sum[c] + cell->count / 2) / cell->count);
+            }
+            entries[entry].count = cell->count;
+            entries[entry].cell = cell;
+            entry++;
+        }
+    }
+
+    int used = median_cut(entries, entry_count, color_count, palette);
+    stats_free(entries);
+    stats_free(histogram);
+
+    for (int iteration = 0; iteration < kmeans_iterations; iteration++) {
+        int task_count;
+        QuantizeTask* tasks = run_quantize_tasks(view, palette, used, NULL, 0, &task_count);
+        if (!tasks) {
+            return 0;
+        }
+        int changed = 0;
+        for (int i = 0; i < used; i++) {
+            unsigned long long sum[3] = {0, 0, 0};
+            unsigned long long count = 0;
+            for (int t = 0; t < task_count; t++) {
+                for (int c = 0; c < 3; c++) {
+                    sum[c] += tasks[t].sums[i][c];
+                }
+                count += tasks[t].counts[i];
+            }
+            // Kolor bez przypisanych pikseli zostaje bez zmian
+            for (int c = 0; count > 0 && c < 3; c++) {
+                uchar mean = (uchar)((sum[c] + count / 2) / count);
+                changed |= (mean != palette[i * 3 + c]);
+                palette[i * 3 + c] = mean;
+            }
+        }
+        stats_free(tasks);
+        if (!changed) {
+            break;
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief Zamienia piksele obrazu na indeksy najbliższych kolorów palety
+ *
+ * @details Pasma wierszy są mapowane równolegle, każde z własną pamięcią
+ * podręczną najbliższego koloru. Indeksy mają układ od góry do dołu.
+ *
+ * @param view Widok wierszy obrazu (24 lub 32 bpp, BGR/BGRA)
+ * @param palette Paleta RGB (3 bajty na kolor)
+ * @param color_count Liczba kolorów palety
+ * @param indices Wynik: indeks palety dla każdego piksela
+ * @param indices_stride Odstęp wierszy w buforze indeksów (>= szerokość)
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int map_to_palette(ImageRowView* view, const uchar* palette, int color_count, uchar* indices, int indices_stride) {
+    if (view->bits_per_pixel < 24 || color_count < 1 || color_count > QUANTIZE_MAX_COLORS) {
+        return 0;
+    }
+    int task_count;
+    QuantizeTask* tasks = run_quantize_tasks(view, palette, color_count, indices, indices_stride, &task_count);
+    if (!tasks) {
+        return 0;
+    }
+    stats_free(tasks);
+    return 1;
+}
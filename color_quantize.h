@@ -0,0 +1,26 @@
+/*****************************************************************************
+
+    plik  : color_quantize.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla kwantyzacji kolorów do palety wyznaczonej
+            z obrazu (median cut, k-means)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef COLOR_QUANTIZE_H
+#define COLOR_QUANTIZE_H
+
+#include "defs.h"
+
+// Maksymalna liczba kolorów palety wyznaczanej z obrazu
+#define QUANTIZE_MAX_COLORS INDEXED_PALETTE_COLORS
+
+// Prototypy funkcji kwantyzacji kolorów
+int build_image_palette(ImageRowView* view, int color_count, int kmeans_iterations, uchar* palette);
+int map_to_palette(ImageRowView* view, const uchar* palette, int color_count, uchar* indices, int indices_stride);
+
+#endif
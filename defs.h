@@ -13,6 +13,7 @@
 #ifndef __DEFS_H__
 #define __DEFS_H__
 
+#include <stddef.h>
 #include "version.h"
 
 typedef unsigned char uchar;
@@ -31,19 +32,137 @@ typedef char *string;
 #define FORMAT_RAW_DATA    1  // Surowe dane (.hex) - tylko dane bez deklaracji
 #define FORMAT_ASSEMBLER   2  // Format assemblera (.inc)
 #define FORMAT_MASM_ARRAY  3  // Format MASM z makrem .array (.inc)
+#define FORMAT_BINARY      4  // Surowe bajty binarne (.bin) - bez nagłówka
+
+// Formaty z nazwaną tablicą (C i assembler) - tylko do nich można zapisać alias tablicy
+#define FORMAT_HAS_ARRAY_NAME(format) ((format) == FORMAT_C_ARRAY || (format) == FORMAT_ASSEMBLER || (format) == FORMAT_MASM_ARRAY)
+#define FORMAT_BMP_PREVIEW 5  // Podgląd BMP (tylko jako cel --out preview:)
+
+// Maksymalna liczba celów wyjściowych --out w jednym uruchomieniu
+#define MAX_OUTPUT_TARGETS 16
 
 // Stałe dla głębi kolorów
+#define BITS_PER_PIXEL_8BPP  8  // 8 bits per pixel (256 odcieni szarości)
 #define BITS_PER_PIXEL_4BPP  4  // 4 bits per pixel (domyślne)
+#define BITS_PER_PIXEL_2BPP  2  // 2 bits per pixel (4 odcienie, np. e-papier)
 #define BITS_PER_PIXEL_1BPP  1  // 1 bit per pixel
 
-// Stałe dla metod ditheringu (tylko dla 1bpp)
+// Liczba odcieni głębi bpp
+#define BPP_LEVELS(bpp) (1 << (bpp))
+
+// Głębie z regulacją jasności/kontrastu i ditheringiem - skala szarości 0-255
+// jest kwantyzowana dopiero po ditheringu (quantize_to_bpp()); 8bpp ma pełną
+// skalę wejścia, więc dithering nie miałby czego rozpraszać
+#define BPP_IS_DITHERED(bpp) ((bpp) <= BITS_PER_PIXEL_4BPP)
+
+// Przesunięcie skali 0-255 przy konwersji do skali szarości: głębie z ditheringiem
+// dostają pełną skalę, pozostałe od razu poziomy 0..BPP_LEVELS(bpp)-1
+#define BPP_GRAYSCALE_SHIFT(bpp) (BPP_IS_DITHERED(bpp) ? 0 : 8 - (bpp))
+
+// Formaty wyjścia kolorowego --color (COLOR_FORMAT_NONE = skala szarości)
+#define COLOR_FORMAT_NONE      0
+#define COLOR_FORMAT_RGB565_LE 1  // RGB565, młodszy bajt pierwszy
+#define COLOR_FORMAT_RGB565_BE 2  // RGB565, starszy bajt pierwszy (kolejność SPI sterowników TFT)
+#define COLOR_FORMAT_RGB332    3  // RGB332, 1 bajt na piksel
+#define COLOR_FORMAT_RGB444    4  // RGB444, 2 piksele w 3 bajtach
+#define COLOR_FORMAT_INDEXED   5  // Indeksy 4bpp i paleta wyznaczona z obrazu
+
+// Liczba kolorów palety wyjścia indeksowanego (--color indexed)
+#define INDEXED_PALETTE_COLORS BPP_LEVELS(BITS_PER_PIXEL_4BPP)
+#define MAX_KMEANS_ITERATIONS  64 // Górna granica --kmeans
+
+// Układy pamięci sterowników wyświetlaczy --layout (tylko 1bpp, DISPLAY_LAYOUT_NONE = -h/-v)
+#define DISPLAY_LAYOUT_NONE    0
+#define DISPLAY_LAYOUT_SSD1306 1  // Strony po 8 wierszy, bajt = kolumna strony, bit 0 = górny piksel
+#define DISPLAY_LAYOUT_SH1106  2  // Jak SSD1306, RAM 132 kolumn - obraz od kolumny 2
+#define DISPLAY_LAYOUT_ST7565  3  // Jak SSD1306 (sterowniki LCD 128x64)
+#define DISPLAY_LAYOUT_UC8151  4  // E-paper: wiersze, bit 7 = lewy piksel
+
+// Komendy adresu strony przeplatane z danymi --page-cmds (tylko układy stronicowe)
+#define PAGE_COMMANDS_NONE 0
+#define PAGE_COMMANDS_I2C  1  // Bajt kontrolny 0x80 przed każdą komendą i 0x40 przed danymi strony
+#define PAGE_COMMANDS_SPI  2  // Same komendy i dane - linię D/C przełącza firmware
+
+// Filtry skalowania --resize-filter (wagi w resize.c)
+#define RESIZE_FILTER_BILINEAR 0  // Trójkąt, przy zmniejszaniu rozciągnięty o skalę (domyślny)
+#define RESIZE_FILTER_BOX      1  // Średnia pokrytego obszaru
+#define RESIZE_FILTER_LANCZOS  2  // Lanczos-3 (najostrzejszy, lekkie dzwonienie na krawędziach)
+
+// Odbicie wyjścia --flip (maska, wykonywane po obrocie --rotate)
+#define FLIP_NONE       0
+#define FLIP_HORIZONTAL 1  // Lewa i prawa strona zamienione
+#define FLIP_VERTICAL   2  // Góra i dół zamienione
+
+// Obrót i odbicie sprowadzone do osi obrazu źródłowego (image_orientation())
+#define ORIENTATION_IDENTITY  0
+#define ORIENTATION_TRANSPOSE 1  // Wiersze wyjścia to kolumny źródła (obrót o 90 lub 270 stopni)
+#define ORIENTATION_MIRROR_X  2  // Kolumny źródła od prawej
+#define ORIENTATION_MIRROR_Y  4  // Wiersze źródła od dołu
+
+// Stałe dla metod ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
 #define DITHERING_NONE        0  // Bez ditheringu - proste progowanie
 #define DITHERING_FLOYD       1  // Floyd-Steinberg dithering (domyślne)
-#define DITHERING_ORDERED     2  // Ordered 8x8 dithering
+#define DITHERING_ORDERED     2  // Ordered 8x8 dithering (Bayer)
+#define DITHERING_BLUE_NOISE  3  // Blue noise 64x64 (tekstura progów)
+#define DITHERING_ORDERED_2X2 4  // Ordered 2x2 (Bayer)
+#define DITHERING_ORDERED_4X4 5  // Ordered 4x4 (Bayer)
+#define DITHERING_ORDERED_16X16 6  // Ordered 16x16 (Bayer)
+#define DITHERING_CLUSTER_4X4 7  // Cluster-dot 4x4
+#define DITHERING_CLUSTER_8X8 8  // Cluster-dot 8x8
 
 // Typ formatu wyjściowego
 typedef int OutputFormat;
 
+// Cel wyjściowy podany opcją --out FORMAT:ŚCIEŻKA
+typedef struct {
+    OutputFormat format;       // Format zapisu (FORMAT_*)
+    char path[256];            // Ścieżka pliku wyjściowego
+} OutputTarget;
+
+// Zakres wartości przeglądu --sweep-br / --sweep-ct (step = 0 - przegląd wyłączony)
+typedef struct {
+    int first;                 // Pierwsza wartość
+    int last;                  // Ostatnia wartość (włącznie)
+    int step;                  // Krok
+} SweepRange;
+
+// Wycinki --crop (powtarzalna opcja)
+#define MAX_CROP_REGIONS 64
+#define CROP_NAME_LENGTH 32
+
+// Prostokąt --crop X,Y,SZER,WYS[:NAZWA] (współrzędne od lewego górnego rogu obrazu)
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+    char name[CROP_NAME_LENGTH]; // Przyrostek plików i tablicy przy kilku wycinkach ("" = cropN)
+} CropRect;
+
+// Spakowany obraz zasobu manifestu (--manifest) - przejmowany zamiast zapisu celów wyjściowych
+typedef struct {
+    uchar* data;               // Spakowane dane (stats_malloc(), po inwersji)
+    size_t size;               // Rozmiar danych w bajtach
+    int width;                 // Szerokość obrazu wyjściowego (po obrocie)
+    int height;                // Wysokość obrazu wyjściowego (po obrocie)
+} PackedImage;
+
+// Tablica zapisana z pełnymi danymi - kolejne wycinki o tych samych danych stają się jej aliasami
+typedef struct {
+    unsigned long long hash;   // Skrót content_hash() danych
+    uchar* data;               // Kopia danych do porównania bajt po bajcie
+    size_t size;               // Rozmiar danych w bajtach
+    char array_name[64];       // Nazwa tablicy z danymi
+} WrittenArray;
+
+// Tablice zapisane w jednym przebiegu kilku wycinków --crop
+typedef struct {
+    WrittenArray arrays[MAX_CROP_REGIONS];
+    int count;                 // Liczba tablic z pełnymi danymi
+    int duplicates;            // Liczba wycinków zapisanych jako aliasy
+    size_t saved_size;         // Bajty niezapisane dzięki aliasom
+} WrittenArrays;
+
 // Kontekst konwersji
 typedef struct {
     int scan_direction;        // 1 = poziomo (wiersze), 0 = pionowo (kolumny)
@@ -51,16 +170,39 @@ typedef struct {
     OutputFormat output_format; // Typ formatu wyjściowego
     int use_progmem;           // 1 = dodaj słowo kluczowe PROGMEM, 0 = bez PROGMEM
     char array_name[64];       // Nazwa tablicy wyjściowej
-    int bits_per_pixel;        // 4 = 4bpp (domyślne), 1 = 1bpp
-    int dithering_method;      // Metoda ditheringu (tylko dla 1bpp)
-    int brightness;            // Jasność 0-100% (tylko dla 1bpp)
-    int contrast;              // Kontrast 0-100% (tylko dla 1bpp)
+    int bits_per_pixel;        // 1, 2, 4 (domyślne) lub 8 bitów na piksel
+    int dithering_method;      // Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+    int brightness;            // Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+    int contrast;              // Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
     int generate_bmp;          // 1 = generuj BMP preview (tylko dla 1bpp)
     int invert;                // 1 = odwróć bity (zamień 0 na 1 i odwrotnie)
     int palette_variant;       // Wariant palety dla 1bpp (0=BW, 1=GRAY, 2=GREEN, 3=PORTFOLIO, 4=OLED_YELLOW, 5=CUSTOM)
-    int palette_4bpp_variant;  // Wariant palety dla 4bpp (0=BW, 1=GRAY, 2=GREEN, 3=PORTFOLIO, 4=OLED_YELLOW, 5=CUSTOM)
+    int palette_4bpp_variant;  // Wariant palety dla 2bpp, 4bpp i 8bpp (0=BW, 1=GRAY, 2=GREEN, 3=PORTFOLIO, 4=OLED_YELLOW, 5=CUSTOM)
     uchar custom_color_first[3];  // Pierwszy kolor w rampie niestandardowej (R,G,B)
     uchar custom_color_last[3];   // Ostatni kolor w rampie niestandardowej (R,G,B)
+    int stats_output;          // Statystyki etapów (0=brak, 1=tabela, 2=JSON - patrz STATS_OUTPUT_*)
+    OutputTarget outputs[MAX_OUTPUT_TARGETS]; // Cele wyjściowe --out (puste = tryb klasyczny)
+    int output_count;          // Liczba celów wyjściowych --out
+    SweepRange sweep_brightness; // Przegląd jasności --sweep-br (tylko dla 1bpp, 2bpp i 4bpp)
+    SweepRange sweep_contrast;   // Przegląd kontrastu --sweep-ct (tylko dla 1bpp, 2bpp i 4bpp)
+    size_t max_memory;         // Budżet pamięci --max-mem w bajtach (0 = bez limitu)
+    int color_format;          // Wyjście kolorowe --color (COLOR_FORMAT_*, 0 = skala szarości)
+    int kmeans_iterations;     // Iteracje k-means po median cut (tylko --color indexed)
+    uchar image_palette[INDEXED_PALETTE_COLORS][3]; // Paleta RGB wyznaczona z obrazu podczas konwersji (--color indexed)
+    int display_layout;        // Układ pamięci sterownika --layout (DISPLAY_LAYOUT_*, 0 = -h/-v)
+    int page_commands;         // Komendy adresu strony --page-cmds (PAGE_COMMANDS_*)
+    int resize_width;          // Szerokość docelowa --resize (0 = bez skalowania lub z proporcji)
+    int resize_height;         // Wysokość docelowa --resize (0 = bez skalowania lub z proporcji)
+    int resize_filter;         // Filtr skalowania --resize-filter (RESIZE_FILTER_*)
+    CropRect crops[MAX_CROP_REGIONS]; // Wycinki --crop (konwertowane kolejno)
+    int crop_count;            // Liczba wycinków --crop (0 = cały obraz)
+    int dedup_crops;           // 1 = --dedup: wycinki o identycznych danych zapisują aliasy tablic
+    int keep_duplicates;       // 1 = --no-dedup: zasoby manifestu o identycznych danych zapisują pełne tablice
+    int rotation;              // Obrót wyjścia --rotate w stopniach zgodnie z ruchem wskazówek zegara (0, 90, 180, 270)
+    int flip;                  // Odbicie wyjścia --flip (FLIP_*)
+    int manifest;              // 1 = plik wejściowy jest manifestem zasobów (--manifest)
+    PackedImage* capture;      // Cel spakowanych danych zamiast plików wyjściowych (NULL = zapis celów)
+    WrittenArrays* written_arrays; // Tablice wcześniejszych wycinków do aliasowania (NULL = bez deduplikacji)
 } ConversionContext;
 
 // Kontekst podglądu BMP
@@ -72,18 +214,43 @@ typedef struct {
     uchar* custom_first;       // Pierwszy kolor w rampie niestandardowej (R,G,B)
     uchar* custom_last;        // Ostatni kolor w rampie niestandardowej (R,G,B)
     int scan_direction;        // 1 = poziomo (wiersze), 0 = pionowo (kolumny)
+    int pixel_order;           // Kolejność pikseli użyta przy pakowaniu (1 = little, 0 = big endian)
+    const uchar* image_palette; // Paleta RGB wyznaczona z obrazu (NULL = palette_variant)
 } PreviewContext;
 
+// Widok wierszy obrazu wejściowego - dostęp do wiersza bez kopiowania i odwracania danych
+typedef struct {
+    uchar* first_row;          // Górny wiersz obrazu
+    ptrdiff_t stride;          // Odstęp do następnego wiersza w bajtach (ujemny dla BMP zapisanych od dołu)
+    int width;                 // Szerokość obrazu w pikselach
+    int height;                // Liczba wierszy w widoku
+    int bits_per_pixel;        // Głębia kolorów danych (1, 4, 8, 24 lub 32)
+} ImageRowView;
+
+// Wiersz y widoku (0 = górny)
+#define IMAGE_VIEW_ROW(view, y) ((view)->first_row + (ptrdiff_t)(y) * (view)->stride)
+
+// Formaty pliku wejściowego rozpoznawane po sygnaturze (detect_image_format())
+#define IMAGE_FORMAT_UNKNOWN 0
+#define IMAGE_FORMAT_BMP     1  // "BM"
+#define IMAGE_FORMAT_PNM     2  // "P5" (PGM) lub "P6" (PPM), binarne
+#define IMAGE_FORMAT_PNG     3  // "\x89PNG"
+
+// Odbiorca wierszy dekoderów PNG/PNM: wiersz y (od góry) w skali szarości 0-255,
+// zwraca 1 aby kontynuować, 0 aby przerwać dekodowanie
+typedef int (*ImageRowCallback)(void* arg, int y, const uchar* gray_row);
+
 // Kontekst nagłówka pliku
 typedef struct {
     int width;                 // Szerokość obrazu (0 = pomiń w nagłówku)
     int height;                // Wysokość obrazu (0 = pomiń w nagłówku)
-    int bits_per_pixel;        // Głębia kolorów (1 lub 4)
-    int dithering_method;      // Metoda ditheringu (tylko dla 1bpp)
-    int brightness;            // Jasność 0-100% (tylko dla 1bpp)
-    int contrast;              // Kontrast 0-100% (tylko dla 1bpp)
+    int bits_per_pixel;        // Głębia kolorów (1, 2, 4 lub 8)
+    int dithering_method;      // Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+    int brightness;            // Jasność 0-100%
+    int contrast;              // Kontrast 0-100%
     int invert;                // 1 = odwróć bity
     int is_assembler;          // 1 = użyj ";" jako prefiks, 0 = użyj "//"
+    int color_format;          // Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
 } HeaderContext;
 
 #endif
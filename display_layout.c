@@ -0,0 +1,324 @@
+/*****************************************************************************
+
+    plik  : display_layout.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : pakowanie 1bpp w natywnym układzie pamięci sterowników
+            wyświetlaczy (strony SSD1306/SH1106/ST7565, wiersze UC8151)
+            z opcjonalnymi komendami adresu strony
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "defs.h"
+#include "display_layout.h"
+#include "utils.h"
+
+// Komendy trybu adresowania stron (wspólne dla SSD1306, SH1106 i ST7565)
+#define PAGE_CMD_SET_PAGE        0xB0  // 0xB0 | numer strony
+#define PAGE_CMD_COLUMN_LOW      0x00  // 0x00 | młodsze 4 bity kolumny
+#define PAGE_CMD_COLUMN_HIGH     0x10  // 0x10 | starsze 4 bity kolumny
+#define I2C_CONTROL_COMMAND      0x80  // Bajt kontrolny Co=1: jedna komenda, po niej kolejny bajt kontrolny
+#define I2C_CONTROL_DATA         0x40  // Bajt kontrolny: dalej dane GDDRAM
+
+// Opis układu pamięci sterownika
+typedef struct {
+    int layout;                // DISPLAY_LAYOUT_*
+    const char* name;          // Nazwa opcji --layout
+    const char* description;   // Nazwa w komunikatach
+    int pages;                 // 1 = strony po 8 wierszy, 0 = wiersze (bit 7 = lewy piksel)
+    int column_offset;         // Pierwsza kolumna obrazu w RAM sterownika
+    int ram_columns;           // Kolumny RAM (limit dla --page-cmds)
+    int ram_pages;             // Strony RAM (limit dla --page-cmds)
+} DisplayLayoutInfo;
+
+static const DisplayLayoutInfo display_layouts[] = {
+    {DISPLAY_LAYOUT_SSD1306, "ssd1306", "SSD1306 pages", 1, 0, 128, 8},
+    {DISPLAY_LAYOUT_SH1106, "sh1106", "SH1106 pages", 1, 2, 132, 8},
+    {DISPLAY_LAYOUT_ST7565, "st7565", "ST7565 pages", 1, 0, 132, 9},
+    {DISPLAY_LAYOUT_UC8151, "uc8151", "UC8151 rows", 0, 0, 0, 0}
+};
+
+static const DisplayLayoutInfo* find_display_layout(int display_layout) {
+    for (size_t i = 0; i < sizeof(display_layouts) / sizeof(display_layouts[0]); i++) {
+        if (display_layouts[i].layout == display_layout) {
+            return &display_layouts[i];
+        }
+    }
+    return NULL;
+}
+
+// Bajty komend przed danymi strony i bajty kontrolne przed samymi danymi
+static int page_command_bytes(int page_commands) {
+    return (page_commands == PAGE_COMMANDS_I2C) ? 6 : (page_commands == PAGE_COMMANDS_SPI) ? 3 : 0;
+}
+
+static int page_data_prefix_bytes(int page_commands) {
+    return (page_commands == PAGE_COMMANDS_I2C) ? 1 : 0;
+}
+
+// Rozmiar jednej strony w strumieniu wyjściowym (komendy, prefiks danych, width bajtów)
+static size_t layout_page_size(int width, int page_commands) {
+    return (size_t)page_command_bytes(page_commands) + page_data_prefix_bytes(page_commands) + (size_t)width;
+}
+
+static int layout_page_count(int height) {
+    return (height + LAYOUT_PAGE_ROWS - 1) / LAYOUT_PAGE_ROWS;
+}
+
+/**
+ * @brief Zwraca układ pamięci dla nazwy opcji --layout
+ *
+ * @param name Nazwa sterownika (ssd1306, sh1106, st7565, uc8151)
+ *
+ * @return DISPLAY_LAYOUT_* lub -1 dla nieznanej nazwy
+ */
+int parse_display_layout(const char* name) {
+    for (size_t i = 0; i < sizeof(display_layouts) / sizeof(display_layouts[0]); i++) {
+        if (strcmp(name, display_layouts[i].name) == 0) {
+            return display_layouts[i].layout;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Zwraca nazwę układu pamięci sterownika
+ *
+ * @param display_layout DISPLAY_LAYOUT_*
+ *
+ * @return Nazwa układu (np. "SSD1306 pages") lub "none"
+ */
+const char* display_layout_name(int display_layout) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    return info ? info->description : "none";
+}
+
+/**
+ * @brief Sprawdza czy sterownik adresuje pamięć stronami po 8 wierszy
+ *
+ * @param display_layout DISPLAY_LAYOUT_*
+ *
+ * @return 1 dla SSD1306/SH1106/ST7565, 0 w przeciwnym razie
+ */
+int display_layout_has_pages(int display_layout) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    return info ? info->pages : 0;
+}
+
+/**
+ * @brief Sprawdza czy obraz mieści się w RAM sterownika przy --page-cmds
+ *
+ * @details Komendy adresu strony kodują numer strony na 4 bitach i kolumnę
+ * na 8 bitach, a sterownik ma stałą liczbę stron i kolumn. Bez komend
+ * rozmiar nie jest ograniczany - firmware sam adresuje kolejne bloki.
+ *
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_*
+ *
+ * @return 1 jeśli obraz się mieści, 0 w przeciwnym razie (z komunikatem błędu)
+ */
+int check_display_layout_size(int width, int height, int display_layout, int page_commands) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    if (!info || page_commands == PAGE_COMMANDS_NONE) {
+        return 1;
+    }
+    if (width + info->column_offset > info->ram_columns || layout_page_count(height) > info->ram_pages) {
+        printf("Error: Image %dx%d does not fit %s RAM (%dx%d from column %d) for --page-cmds\n", width, height,
+               info->name, info->ram_columns - info->column_offset, info->ram_pages * LAYOUT_PAGE_ROWS, info->column_offset);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Oblicza rozmiar danych w układzie pamięci sterownika
+ *
+ * @details Układy stronicowe mają ceil(height / 8) stron po width bajtów,
+ * a z --page-cmds każda strona jest poprzedzona komendami adresu (i2c:
+ * 3 komendy z bajtami kontrolnymi + bajt kontrolny danych, spi: 3 bajty). Układ wierszowy ma
+ * height wierszy po ceil(width / 8) bajtów.
+ *
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_*
+ *
+ * @return Rozmiar w bajtach lub 0 przy przepełnieniu / nieznanym układzie
+ */
+size_t calculate_layout_packed_size(int width, int height, int display_layout, int page_commands) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    if (!info) {
+        return 0;
+    }
+    if (!info->pages) {
+        return calculate_packed_size(width, height, BITS_PER_PIXEL_1BPP, 1);
+    }
+    size_t packed_size;
+    if (!size_multiply((size_t)layout_page_count(height), layout_page_size(width, page_commands), &packed_size)) {
+        return 0;
+    }
+    return packed_size;
+}
+
+// Zapisuje komendy adresu strony; zwraca miejsce na dane strony
+// (i2c: bajt kontrolny Co=1 przed każdą komendą, więc strona to jeden zapis I2C)
+static uchar* write_page_commands(uchar* dst, const DisplayLayoutInfo* info, int page, int page_commands) {
+    if (page_commands == PAGE_COMMANDS_NONE) {
+        return dst;
+    }
+    uchar commands[3] = {
+        (uchar)(PAGE_CMD_SET_PAGE | page),
+        (uchar)(PAGE_CMD_COLUMN_LOW | (info->column_offset & 0x0F)),
+        (uchar)(PAGE_CMD_COLUMN_HIGH | (info->column_offset >> 4))
+    };
+    for (int i = 0; i < 3; i++) {
+        if (page_commands == PAGE_COMMANDS_I2C) {
+            *dst++ = I2C_CONTROL_COMMAND;
+        }
+        *dst++ = commands[i];
+    }
+    if (page_commands == PAGE_COMMANDS_I2C) {
+        *dst++ = I2C_CONTROL_DATA;
+    }
+    return dst;
+}
+
+// Zapisuje komendy adresu wszystkich stron - dane stron wypełnia pack_band_lines()
+static void write_all_page_commands(uchar* packed_data, int width, int height, const DisplayLayoutInfo* info, int page_commands) {
+    size_t page_size = layout_page_size(width, page_commands);
+    for (int page = 0; page < layout_page_count(height); page++) {
+        write_page_commands(packed_data + (size_t)page * page_size, info, page, page_commands);
+    }
+}
+
+/**
+ * @brief Pakuje piksele 1bpp (0/1) w układzie pamięci sterownika
+ *
+ * @param pixels Piksele 0/1 (width * height, od góry do dołu)
+ * @param packed_data Bufor wyjściowy (calculate_layout_packed_size() bajtów)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_* (tylko układy stronicowe)
+ * @param orientation Obrót i odbicie (image_orientation())
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ *
+ * @example
+ * ```c
+ * size_t size = calculate_layout_packed_size(128, 64, DISPLAY_LAYOUT_SSD1306, PAGE_COMMANDS_I2C);
+ * pack_layout(pixels, packed, 128, 64, DISPLAY_LAYOUT_SSD1306, PAGE_COMMANDS_I2C, ORIENTATION_IDENTITY);
+ * // 8 x (80 B0+p 80 00 80 10, 40, 128 bajtów strony) = 1080 bajtów
+ * ```
+ */
+int pack_layout(uchar* pixels, uchar* packed_data, int width, int height, int display_layout, int page_commands, int orientation) {
+    return pack_layout_band(pixels, packed_data, width, height, 0, height, display_layout, page_commands, orientation);
+}
+
+/**
+ * @brief Pakuje pasmo wierszy w układzie pamięci sterownika (--max-mem)
+ *
+ * @details Strona to bajty kolejnych kolumn obrazu wyjściowego z górnym
+ * wierszem strony w bicie 0, czyli kernel kolumn 1bpp (-v -l) z odstępem
+ * linii 1 i odstępem bajtów linii równym rozmiarowi strony. Dzięki temu
+ * strony korzystają z tego samego obrotu i odbicia co -h/-v. Bajt strony
+ * dzielony przez dwa pasma jest dopełniany przez drugie z nich, więc pasma
+ * nie muszą zaczynać się na granicy strony, ale muszą przychodzić kolejno.
+ *
+ * @param pixels Piksele 0/1 pasma (width * band_height)
+ * @param packed_data Bufor wyjściowy całego obrazu
+ * @param width Szerokość źródła w pikselach
+ * @param height Wysokość całego źródła
+ * @param band_y Pierwszy wiersz pasma
+ * @param band_height Liczba wierszy pasma
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_*
+ * @param orientation Obrót i odbicie (image_orientation())
+ *
+ * @return 1 w przypadku sukcesu, 0 dla nieznanego układu
+ */
+int pack_layout_band(uchar* pixels, uchar* packed_data, int width, int height, int band_y, int band_height, int display_layout, int page_commands, int orientation) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    if (!info) {
+        return 0;
+    }
+    if (!info->pages) {
+        // UC8151: wiersze z bitem 7 jako lewym pikselem - to kernel -h -l
+        return pack_pixels_band(pixels, packed_data, width, height, band_y, band_height, BITS_PER_PIXEL_1BPP, 1, 1, orientation);
+    }
+    int out_width, out_height;
+    oriented_size(orientation, width, height, &out_width, &out_height);
+    if (band_y == 0) {
+        write_all_page_commands(packed_data, out_width, out_height, info, page_commands);
+    }
+    size_t data_offset = (size_t)page_command_bytes(page_commands) + page_data_prefix_bytes(page_commands);
+    return pack_band_lines(pixels, width, height, band_y, band_height, BITS_PER_PIXEL_1BPP, 0, 1, orientation,
+                           packed_data + data_offset, 1, (ptrdiff_t)layout_page_size(out_width, page_commands));
+}
+
+/**
+ * @brief Odwraca bity danych obrazu, pomijając komendy adresu strony
+ *
+ * @param packed_data Dane z pack_layout()
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_*
+ */
+void invert_layout_data(uchar* packed_data, int width, int height, int display_layout, int page_commands) {
+    size_t data_offset = (size_t)page_command_bytes(page_commands) + page_data_prefix_bytes(page_commands);
+    if (!display_layout_has_pages(display_layout) || data_offset == 0) {
+        invert_packed_data(packed_data, calculate_layout_packed_size(width, height, display_layout, page_commands), BITS_PER_PIXEL_1BPP);
+        return;
+    }
+    size_t page_size = layout_page_size(width, page_commands);
+    for (int page = 0; page < layout_page_count(height); page++) {
+        invert_packed_data(packed_data + (size_t)page * page_size + data_offset, (size_t)width, BITS_PER_PIXEL_1BPP);
+    }
+}
+
+/**
+ * @brief Zamienia dane w układzie sterownika na wiersze 1bpp (podgląd BMP)
+ *
+ * @details Wynik ma układ pack_pixels() dla -h -l (bit 7 = lewy piksel),
+ * więc podgląd korzysta ze zwykłego kodu 1bpp.
+ *
+ * @param packed_data Dane z pack_layout()
+ * @param packed_rows Bufor wyjściowy (calculate_packed_size(width, height, 1, 1) bajtów)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param display_layout DISPLAY_LAYOUT_*
+ * @param page_commands PAGE_COMMANDS_*
+ *
+ * @return 1 w przypadku sukcesu, 0 dla nieznanego układu
+ */
+int unpack_layout_rows(const uchar* packed_data, uchar* packed_rows, int width, int height, int display_layout, int page_commands) {
+    const DisplayLayoutInfo* info = find_display_layout(display_layout);
+    if (!info) {
+        return 0;
+    }
+    size_t line_bytes = ((size_t)width + 7) / 8;
+    if (!info->pages) {
+        memcpy(packed_rows, packed_data, line_bytes * (size_t)height);
+        return 1;
+    }
+    size_t page_size = layout_page_size(width, page_commands);
+    size_t data_offset = (size_t)page_command_bytes(page_commands) + page_data_prefix_bytes(page_commands);
+    memset(packed_rows, 0, line_bytes * (size_t)height);
+    for (int y = 0; y < height; y++) {
+        const uchar* page = packed_data + (size_t)(y / LAYOUT_PAGE_ROWS) * page_size + data_offset;
+        uchar* dst = packed_rows + (size_t)y * line_bytes;
+        int bit = y % LAYOUT_PAGE_ROWS;
+        for (int x = 0; x < width; x++) {
+            dst[x / 8] |= (uchar)(((page[x] >> bit) & 1) << (7 - x % 8));
+        }
+    }
+    return 1;
+}
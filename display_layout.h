@@ -0,0 +1,34 @@
+/*****************************************************************************
+
+    plik  : display_layout.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla układów pamięci sterowników wyświetlaczy
+            (SSD1306, SH1106, ST7565, UC8151)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef DISPLAY_LAYOUT_H
+#define DISPLAY_LAYOUT_H
+
+#include <stddef.h>
+#include "defs.h"
+
+// Wysokość strony sterowników stronicowych (jeden bajt danych = 8 wierszy kolumny)
+#define LAYOUT_PAGE_ROWS 8
+
+// Prototypy funkcji układów pamięci sterowników
+int parse_display_layout(const char* name);
+const char* display_layout_name(int display_layout);
+int display_layout_has_pages(int display_layout);
+int check_display_layout_size(int width, int height, int display_layout, int page_commands);
+size_t calculate_layout_packed_size(int width, int height, int display_layout, int page_commands);
+int pack_layout(uchar* pixels, uchar* packed_data, int width, int height, int display_layout, int page_commands, int orientation);
+int pack_layout_band(uchar* pixels, uchar* packed_data, int width, int height, int band_y, int band_height, int display_layout, int page_commands, int orientation);
+void invert_layout_data(uchar* packed_data, int width, int height, int display_layout, int page_commands);
+int unpack_layout_rows(const uchar* packed_data, uchar* packed_rows, int width, int height, int display_layout, int page_commands);
+
+#endif
@@ -0,0 +1,91 @@
+/*****************************************************************************
+
+    plik  : dither_matrices.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : matryce progów ordered ditheringu (Bayer, cluster-dot)
+            (wygenerowane przez scripts/generate_dither_matrices.py - nie edytować)
+
+    licencja : MIT
+*****************************************************************************/
+
+#include "dither_matrices.h"
+
+// Bayer 2x2 (rozproszone progi)
+static const uchar bayer_2x2[2 * 2] = {
+     31, 159,
+    223,  95
+};
+
+// Bayer 4x4 (rozproszone progi)
+static const uchar bayer_4x4[4 * 4] = {
+      7, 135,  39, 167,
+    199,  71, 231, 103,
+     55, 183,  23, 151,
+    247, 119, 215,  87
+};
+
+// Bayer 8x8 (rozproszone progi)
+static const uchar bayer_8x8[8 * 8] = {
+      1, 129,  33, 161,   9, 137,  41, 169,
+    193,  65, 225,  97, 201,  73, 233, 105,
+     49, 177,  17, 145,  57, 185,  25, 153,
+    241, 113, 209,  81, 249, 121, 217,  89,
+     13, 141,  45, 173,   5, 133,  37, 165,
+    205,  77, 237, 109, 197,  69, 229, 101,
+     61, 189,  29, 157,  53, 181,  21, 149,
+    253, 125, 221,  93, 245, 117, 213,  85
+};
+
+// Bayer 16x16 (rozproszone progi)
+static const uchar bayer_16x16[16 * 16] = {
+      0, 127,  32, 159,   8, 135,  40, 167,   2, 129,  34, 161,  10, 137,  42, 169,
+    191,  64, 223,  96, 199,  72, 231, 104, 193,  66, 225,  98, 201,  74, 233, 106,
+     48, 175,  16, 143,  56, 183,  24, 151,  50, 177,  18, 145,  58, 185,  26, 153,
+    239, 112, 207,  80, 247, 120, 215,  88, 241, 114, 209,  82, 249, 122, 217,  90,
+     12, 139,  44, 171,   4, 131,  36, 163,  14, 141,  46, 173,   6, 133,  38, 165,
+    203,  76, 235, 108, 195,  68, 227, 100, 205,  78, 237, 110, 197,  70, 229, 102,
+     60, 187,  28, 155,  52, 179,  20, 147,  62, 189,  30, 157,  54, 181,  22, 149,
+    251, 124, 219,  92, 243, 116, 211,  84, 253, 126, 221,  94, 245, 118, 213,  86,
+      3, 130,  35, 162,  11, 138,  43, 170,   1, 128,  33, 160,   9, 136,  41, 168,
+    194,  67, 226,  99, 202,  75, 234, 107, 192,  65, 224,  97, 200,  73, 232, 105,
+     51, 178,  19, 146,  59, 186,  27, 154,  49, 176,  17, 144,  57, 184,  25, 152,
+    242, 115, 210,  83, 250, 123, 218,  91, 240, 113, 208,  81, 248, 121, 216,  89,
+     15, 142,  47, 174,   7, 134,  39, 166,  13, 140,  45, 172,   5, 132,  37, 164,
+    206,  79, 238, 111, 198,  71, 230, 103, 204,  77, 236, 109, 196,  69, 228, 101,
+     63, 190,  31, 158,  55, 182,  23, 150,  61, 188,  29, 156,  53, 180,  21, 148,
+    254, 127, 222,  95, 246, 119, 214,  87, 252, 125, 220,  93, 244, 117, 212,  85
+};
+
+// Cluster-dot 4x4 (kropka rosnąca od środka)
+static const uchar cluster_4x4[4 * 4] = {
+    231, 151, 167, 247,
+    135,  39,  55, 183,
+    119,  23,   7,  71,
+    215, 103,  87, 199
+};
+
+// Cluster-dot 8x8 (kropka rosnąca od środka)
+static const uchar cluster_8x8[8 * 8] = {
+    249, 229, 197, 161, 165, 201, 233, 253,
+    225, 157, 117,  85,  89, 121, 169, 237,
+    193, 113,  57,  37,  41,  61, 125, 205,
+    153,  81,  33,   9,  13,  45,  93, 173,
+    149,  77,  29,   5,   1,  17,  65, 129,
+    189, 109,  53,  25,  21,  49,  97, 177,
+    221, 145, 105,  73,  69, 101, 133, 209,
+    245, 217, 185, 141, 137, 181, 213, 241
+};
+
+const DitherMatrix dither_matrices[] = {
+    {DITHERING_ORDERED_2X2, 2, bayer_2x2},
+    {DITHERING_ORDERED_4X4, 4, bayer_4x4},
+    {DITHERING_ORDERED, 8, bayer_8x8},
+    {DITHERING_ORDERED_16X16, 16, bayer_16x16},
+    {DITHERING_CLUSTER_4X4, 4, cluster_4x4},
+    {DITHERING_CLUSTER_8X8, 8, cluster_8x8},
+};
+
+const int dither_matrix_count = (int)(sizeof(dither_matrices) / sizeof(dither_matrices[0]));
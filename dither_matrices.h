@@ -0,0 +1,29 @@
+/*****************************************************************************
+
+    plik  : dither_matrices.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy matryc progów ordered ditheringu
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef DITHER_MATRICES_H
+#define DITHER_MATRICES_H
+
+#include "defs.h"
+
+// Matryca progów size x size (size - potęga dwójki), progi 0-254 zapisane wierszami
+typedef struct {
+    int dithering_method;       // Metoda ditheringu (DITHERING_ORDERED*, DITHERING_CLUSTER_*)
+    int size;                   // Bok matrycy w pikselach
+    const uchar* thresholds;    // Progi środków przedziałów (2r+1)*255/(2N)
+} DitherMatrix;
+
+// Tabela matryc (dither_matrices.c, generowana przez scripts/generate_dither_matrices.py)
+extern const DitherMatrix dither_matrices[];
+extern const int dither_matrix_count;
+
+#endif
@@ -0,0 +1,475 @@
+/*****************************************************************************
+
+    plik  : inflate.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : strumieniowa dekompresja zlib/deflate (RFC 1950/1951) bez
+            zewnętrznych bibliotek - używana przez dekoder PNG
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "inflate.h"
+#include "stats.h"
+
+#define INFLATE_INPUT_SIZE   16384  // Bufor odczytu skompresowanych danych
+#define INFLATE_MAX_BITS     15     // Najdłuższy kod Huffmana w deflate
+#define INFLATE_FAST_BITS    9      // Kody do tej długości dekodowane jedną tablicą
+#define INFLATE_LENGTH_CODES 288    // Literały, koniec bloku i długości
+#define INFLATE_DIST_CODES   32     // Odległości (30 używanych + 2 zarezerwowane)
+
+// Kanoniczny kod Huffmana: liczby kodów każdej długości i symbole w kolejności kodów
+typedef struct {
+    short count[INFLATE_MAX_BITS + 1];
+    short symbol[INFLATE_LENGTH_CODES];
+    unsigned short fast[1 << INFLATE_FAST_BITS]; // (długość << 9) | symbol, 0 = kod dłuższy
+} HuffmanTable;
+
+typedef struct {
+    InflateReadFunc read_func;
+    void* read_arg;
+    InflateWriteFunc write_func;
+    void* write_arg;
+
+    uchar input[INFLATE_INPUT_SIZE];
+    int input_pos;
+    int input_length;
+    int input_end;                   // 1 = read_func zwróciła koniec danych
+
+    unsigned long bit_buffer;        // Bity czytane od najmłodszego
+    int bit_count;
+
+    uchar window[INFLATE_WINDOW_SIZE];
+    unsigned long output_total;      // Liczba bajtów wyprodukowanych od początku strumienia
+    int pending;                     // Bajty okna jeszcze nie przekazane do write_func
+
+    HuffmanTable length_table;
+    HuffmanTable distance_table;
+} InflateState;
+
+// Podstawy i bity dodatkowe kodów długości 257..285 oraz odległości 0..29 (RFC 1951, 3.2.5)
+static const short length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uchar length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const unsigned short distance_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uchar distance_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Kolejność długości kodów długości kodów w nagłówku bloku dynamicznego
+static const uchar code_length_order[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// ============================================================================
+// Wejście bitowe i wyjście przez okno
+// ============================================================================
+
+// Uzupełnia bufor bitów do co najmniej need bitów; 0 gdy dane się skończyły
+static int fill_bits(InflateState* state, int need) {
+    while (state->bit_count < need) {
+        if (state->input_pos == state->input_length) {
+            int length = state->input_end ? 0 : state->read_func(state->read_arg, state->input, INFLATE_INPUT_SIZE);
+            if (length <= 0) {
+                state->input_end = 1;
+                return 0;
+            }
+            state->input_pos = 0;
+            state->input_length = length;
+        }
+        state->bit_buffer |= (unsigned long)state->input[state->input_pos++] << state->bit_count;
+        state->bit_count += 8;
+    }
+    return 1;
+}
+
+static int get_bits(InflateState* state, int count, int* value) {
+    if (!fill_bits(state, count)) {
+        return 0;
+    }
+    *value = (int)(state->bit_buffer & ((1UL << count) - 1));
+    state->bit_buffer >>= count;
+    state->bit_count -= count;
+    return 1;
+}
+
+// Przekazuje zaległe bajty okna do write_func (w dwóch częściach, jeśli okno się zawinęło)
+static int flush_output(InflateState* state) {
+    if (state->pending == 0) {
+        return 1;
+    }
+    int start = (int)((state->output_total - (unsigned long)state->pending) & (INFLATE_WINDOW_SIZE - 1));
+    int first = state->pending;
+    if (start + first > INFLATE_WINDOW_SIZE) {
+        first = INFLATE_WINDOW_SIZE - start;
+    }
+    if (!state->write_func(state->write_arg, state->window + start, first)) {
+        return 0;
+    }
+    if (first < state->pending && !state->write_func(state->write_arg, state->window, state->pending - first)) {
+        return 0;
+    }
+    state->pending = 0;
+    return 1;
+}
+
+static int put_byte(InflateState* state, uchar value) {
+    state->window[state->output_total & (INFLATE_WINDOW_SIZE - 1)] = value;
+    state->output_total++;
+    if (++state->pending == INFLATE_FLUSH_SIZE) {
+        return flush_output(state);
+    }
+    return 1;
+}
+
+// ============================================================================
+// Kody Huffmana
+// ============================================================================
+
+/**
+ * @brief Buduje kanoniczny kod Huffmana z długości kodów symboli
+ *
+ * @details Kody do INFLATE_FAST_BITS bitów trafiają dodatkowo do tablicy
+ * fast indeksowanej odwróconymi bitami (deflate zapisuje kody od
+ * najstarszego bitu), dłuższe są dekodowane bit po bicie.
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy długości opisują nadmiarowy kod
+ */
+static int build_huffman_table(HuffmanTable* table, const uchar* lengths, int symbol_count) {
+    short offsets[INFLATE_MAX_BITS + 1];
+    int next_code[INFLATE_MAX_BITS + 1];
+
+    memset(table->count, 0, sizeof(table->count));
+    memset(table->fast, 0, sizeof(table->fast));
+    for (int symbol = 0; symbol < symbol_count; symbol++) {
+        table->count[lengths[symbol]]++;
+    }
+    table->count[0] = 0;
+
+    // Kod niepełny jest dopuszczalny (np. jedna odległość), nadmiarowy nie
+    int left = 1;
+    for (int length = 1; length <= INFLATE_MAX_BITS; length++) {
+        left = (left << 1) - table->count[length];
+        if (left < 0) {
+            return 0;
+        }
+    }
+
+    offsets[1] = 0;
+    for (int length = 1; length < INFLATE_MAX_BITS; length++) {
+        offsets[length + 1] = offsets[length] + table->count[length];
+    }
+    for (int symbol = 0; symbol < symbol_count; symbol++) {
+        if (lengths[symbol]) {
+            table->symbol[offsets[lengths[symbol]]++] = (short)symbol;
+        }
+    }
+
+    int code = 0;
+    next_code[0] = 0;
+    for (int length = 1; length <= INFLATE_MAX_BITS; length++) {
+        code = (code + table->count[length - 1]) << 1;
+        next_code[length] = code;
+    }
+    for (int symbol = 0; symbol < symbol_count; symbol++) {
+        int length = lengths[symbol];
+        if (length == 0 || length > INFLATE_FAST_BITS) {
+            if (length) {
+                next_code[length]++;
+            }
+            continue;
+        }
+        int value = next_code[length]++;
+        int reversed = 0;
+        for (int bit = 0; bit < length; bit++) {
+            reversed = (reversed << 1) | ((value >> bit) & 1);
+        }
+        for (int index = reversed; index < (1 << INFLATE_FAST_BITS); index += 1 << length) {
+            table->fast[index] = (unsigned short)((length << 9) | symbol);
+        }
+    }
+    return 1;
+}
+
+// Dekoduje jeden symbol; -1 gdy kod jest niepoprawny lub dane się skończyły
+static int decode_symbol(InflateState* state, const HuffmanTable* table) {
+    // Na końcu strumienia w buforze może być mniej niż INFLATE_FAST_BITS bitów
+    fill_bits(state, INFLATE_FAST_BITS);
+    int entry = table->fast[state->bit_buffer & ((1 << INFLATE_FAST_BITS) - 1)];
+    if (entry && (entry >> 9) <= state->bit_count) {
+        state->bit_buffer >>= entry >> 9;
+        state->bit_count -= entry >> 9;
+        return entry & 0x1FF;
+    }
+
+    // Kod dłuższy niż tablica fast - dekodowanie kanoniczne bit po bicie
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length <= INFLATE_MAX_BITS; length++) {
+        int bit;
+        if (!get_bits(state, 1, &bit)) {
+            return -1;
+        }
+        code |= bit;
+        int count = table->count[length];
+        if (code - count < first) {
+            return table->symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+// ============================================================================
+// Bloki deflate
+// ============================================================================
+
+static int inflate_stored_block(InflateState* state) {
+    // Blok zaczyna się od granicy bajtu
+    state->bit_buffer >>= state->bit_count & 7;
+    state->bit_count -= state->bit_count & 7;
+
+    int length, inverted_length;
+    if (!get_bits(state, 16, &length) || !get_bits(state, 16, &inverted_length) || length != (~inverted_length & 0xFFFF)) {
+        return 0;
+    }
+    while (length-- > 0) {
+        int value;
+        if (!get_bits(state, 8, &value) || !put_byte(state, (uchar)value)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int inflate_codes(InflateState* state) {
+    for (;;) {
+        int symbol = decode_symbol(state, &state->length_table);
+        if (symbol < 0) {
+            return 0;
+        }
+        if (symbol < 256) {
+            if (!put_byte(state, (uchar)symbol)) {
+                return 0;
+            }
+            continue;
+        }
+        if (symbol == 256) {
+            return 1;
+        }
+
+        symbol -= 257;
+        int extra;
+        if (symbol >= 29 || !get_bits(state, length_extra[symbol], &extra)) {
+            return 0;
+        }
+        int length = length_base[symbol] + extra;
+
+        symbol = decode_symbol(state, &state->distance_table);
+        if (symbol < 0 || symbol >= 30 || !get_bits(state, distance_extra[symbol], &extra)) {
+            return 0;
+        }
+        unsigned long distance = distance_base[symbol] + (unsigned long)extra;
+        if (distance > state->output_total) {
+            return 0;
+        }
+        while (length-- > 0) {
+            if (!put_byte(state, state->window[(state->output_total - distance) & (INFLATE_WINDOW_SIZE - 1)])) {
+                return 0;
+            }
+        }
+    }
+}
+
+static int inflate_fixed_block(InflateState* state) {
+    uchar lengths[INFLATE_LENGTH_CODES];
+    int symbol = 0;
+    for (; symbol < 144; symbol++) lengths[symbol] = 8;
+    for (; symbol < 256; symbol++) lengths[symbol] = 9;
+    for (; symbol < 280; symbol++) lengths[symbol] = 7;
+    for (; symbol < INFLATE_LENGTH_CODES; symbol++) lengths[symbol] = 8;
+    build_huffman_table(&state->length_table, lengths, INFLATE_LENGTH_CODES);
+
+    memset(lengths, 5, 30);
+    build_huffman_table(&state->distance_table, lengths, 30);
+    return inflate_codes(state);
+}
+
+static int inflate_dynamic_block(InflateState* state) {
+    uchar lengths[INFLATE_LENGTH_CODES + INFLATE_DIST_CODES];
+    int length_count, distance_count, code_length_count;
+    if (!get_bits(state, 5, &length_count) || !get_bits(state, 5, &distance_count) || !get_bits(state, 4, &code_length_count)) {
+        return 0;
+    }
+    length_count += 257;
+    distance_count += 1;
+    code_length_count += 4;
+    if (length_count > 286 || distance_count > 30) {
+        return 0;
+    }
+
+    // Długości kodów są same zakodowane kodem Huffmana o 19 symbolach
+    memset(lengths, 0, 19);
+    for (int i = 0; i < code_length_count; i++) {
+        int value;
+        if (!get_bits(state, 3, &value)) {
+            return 0;
+        }
+        lengths[code_length_order[i]] = (uchar)value;
+    }
+    if (!build_huffman_table(&state->length_table, lengths, 19)) {
+        return 0;
+    }
+
+    int total = length_count + distance_count;
+    int index = 0;
+    while (index < total) {
+        int symbol = decode_symbol(state, &state->length_table);
+        if (symbol < 0) {
+            return 0;
+        }
+        if (symbol < 16) {
+            lengths[index++] = (uchar)symbol;
+            continue;
+        }
+
+        int value = 0;
+        int repeat;
+        if (symbol == 16) {
+            // Powtórzenie poprzedniej długości 3-6 razy
+            if (index == 0 || !get_bits(state, 2, &repeat)) {
+                return 0;
+            }
+            value = lengths[index - 1];
+            repeat += 3;
+        } else if (symbol == 17) {
+            if (!get_bits(state, 3, &repeat)) {
+                return 0;
+            }
+            repeat += 3;
+        } else {
+            if (!get_bits(state, 7, &repeat)) {
+                return 0;
+            }
+            repeat += 11;
+        }
+        if (index + repeat > total) {
+            return 0;
+        }
+        memset(lengths + index, value, repeat);
+        index += repeat;
+    }
+
+    // Blok bez kodu końca bloku nie mógłby się zakończyć
+    if (lengths[256] == 0) {
+        return 0;
+    }
+    if (!build_huffman_table(&state->length_table, lengths, length_count) ||
+        !build_huffman_table(&state->distance_table, lengths + length_count, distance_count)) {
+        return 0;
+    }
+    return inflate_codes(state);
+}
+
+/**
+ * @brief Zwraca ilość pamięci zajmowanej przez stan dekompresji
+ *
+ * @return Rozmiar stanu (okno, bufor wejściowy i tablice kodów) w bajtach
+ */
+size_t zlib_inflate_memory(void) {
+    return sizeof(InflateState);
+}
+
+/**
+ * @brief Dekompresuje strumień zlib porcjami, bez bufora na całe dane
+ *
+ * @details Skompresowane bajty są pobierane przez read_func, a wynik
+ * przekazywany do write_func porcjami co najwyżej INFLATE_FLUSH_SIZE bajtów.
+ * Pamięć dekompresji jest stała (okno 32 KB i bufor wejściowy), niezależnie
+ * od rozmiaru danych - dekoder PNG może dzięki temu przetwarzać obraz
+ * wiersz po wierszu.
+ *
+ * @param read_func Źródło skompresowanych danych
+ * @param read_arg Argument przekazywany do read_func
+ * @param write_func Odbiorca zdekompresowanych danych
+ * @param write_arg Argument przekazywany do write_func
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy dane są uszkodzone, urwane lub
+ *         write_func przerwała dekompresję
+ *
+ * @note Suma kontrolna Adler-32 na końcu strumienia nie jest sprawdzana
+ * @note Słowniki predefiniowane (FDICT) nie są obsługiwane - PNG ich nie używa
+ *
+ * @example
+ * ```c
+ * if (!zlib_inflate_stream(read_idat, &chunks, receive_scanlines, &rows)) {
+ *     printf("Error: Corrupted compressed data\n");
+ * }
+ * ```
+ */
+int zlib_inflate_stream(InflateReadFunc read_func, void* read_arg, InflateWriteFunc write_func, void* write_arg) {
+    InflateState* state = (InflateState*)stats_malloc(sizeof(InflateState));
+    if (!state) {
+        return 0;
+    }
+    state->read_func = read_func;
+    state->read_arg = read_arg;
+    state->write_func = write_func;
+    state->write_arg = write_arg;
+    state->input_pos = 0;
+    state->input_length = 0;
+    state->input_end = 0;
+    state->bit_buffer = 0;
+    state->bit_count = 0;
+    state->output_total = 0;
+    state->pending = 0;
+
+    // Nagłówek zlib: metoda 8 (deflate), okno do 32 KB, bez słownika
+    int method, flags;
+    int result = get_bits(state, 8, &method) && get_bits(state, 8, &flags) &&
+                 (method & 0x0F) == 8 && (method >> 4) <= 7 &&
+                 (method * 256 + flags) % 31 == 0 && !(flags & 0x20);
+
+    int last_block = 0;
+    while (result && !last_block) {
+        int type;
+        if (!get_bits(state, 1, &last_block) || !get_bits(state, 2, &type)) {
+            result = 0;
+            break;
+        }
+        switch (type) {
+            case 0:
+                result = inflate_stored_block(state);
+                break;
+            case 1:
+                result = inflate_fixed_block(state);
+                break;
+            case 2:
+                result = inflate_dynamic_block(state);
+                break;
+            default:
+                result = 0;
+                break;
+        }
+    }
+    result = result && flush_output(state);
+
+    stats_free(state);
+    return result;
+}
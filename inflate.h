@@ -0,0 +1,43 @@
+/*****************************************************************************
+
+    plik  : inflate.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla strumieniowej dekompresji zlib/deflate (RFC 1950/1951)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stddef.h>
+#include "defs.h"
+
+// Rozmiar okna deflate - największa odległość odwołania wstecz
+#define INFLATE_WINDOW_SIZE 32768
+
+// Dane wyjściowe są przekazywane porcjami co najwyżej tej wielkości
+#define INFLATE_FLUSH_SIZE 16384
+
+/**
+ * @brief Dostarcza kolejne bajty skompresowanego strumienia
+ *
+ * @return Liczba bajtów zapisanych do buffer (1..size), 0 na końcu danych
+ */
+typedef int (*InflateReadFunc)(void* arg, uchar* buffer, int size);
+
+/**
+ * @brief Odbiera kolejną porcję zdekompresowanych danych
+ *
+ * @return 1 aby kontynuować, 0 aby przerwać dekompresję z błędem
+ */
+typedef int (*InflateWriteFunc)(void* arg, const uchar* data, int size);
+
+// Prototypy funkcji dekompresji
+size_t zlib_inflate_memory(void);
+int zlib_inflate_stream(InflateReadFunc read_func, void* read_arg, InflateWriteFunc write_func, void* write_arg);
+
+#endif
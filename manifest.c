@@ -0,0 +1,1203 @@
+/*****************************************************************************
+
+    plik  : manifest.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : manifest zasobów (--manifest) - wczytywanie pliku INI z opcjami
+            każdego zasobu i zapis zbiorczego wyjścia z enum indeksu
+
+    licencja : MIT
+*****************************************************************************/
+
+#define _CRT_SECURE_NO_DEPRECATE
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "manifest.h"
+#include "options.h"
+#include "utils.h"
+#include "color.h"
+#include "stream_io.h"
+#include "display_layout.h"
+
+// Najdłuższy wiersz manifestu
+#define MANIFEST_LINE_LENGTH 1024
+
+// Najwięcej argumentów opcji jednego zasobu ([defaults] i sekcja razem)
+#define MANIFEST_MAX_ARGUMENTS 128
+
+// Nazwy sekcji zastrzeżone dla ustawień manifestu
+#define MANIFEST_SECTION_SETTINGS "manifest"
+#define MANIFEST_SECTION_DEFAULTS "defaults"
+
+// Rodzaj wpisu klucz = wartość sekcji zasobu
+#define ENTRY_INPUT   0  // input = plik wejściowy
+#define ENTRY_OPTIONS 1  // options = opcje wiersza poleceń rozdzielone spacjami
+#define ENTRY_SWITCH  2  // bpp = N -> opcja -N bez argumentu
+#define ENTRY_OPTION  3  // klucz = wartość -> --klucz wartość
+
+// Wpis klucz = wartość. Dla ENTRY_OPTIONS wartość jest już podzielona
+// na argument_count napisów oddzielonych zerami
+typedef struct {
+    int kind;                  // ENTRY_*
+    char key[32];              // Klucz (komunikaty błędów)
+    char option[36];           // Opcja wiersza poleceń (--klucz lub -N)
+    char value[512];           // Wartość bez cudzysłowów
+    int argument_count;        // Liczba argumentów w value (ENTRY_OPTIONS)
+    int line;                  // Wiersz w pliku manifestu
+} ManifestEntry;
+
+// Sekcja [nazwa] i zakres jej wpisów
+typedef struct {
+    char name[MANIFEST_NAME_LENGTH];
+    int line;
+    int first_entry;
+    int entry_count;
+} ManifestSection;
+
+// Zawartość pliku manifestu przed zbudowaniem kontekstów zasobów
+typedef struct {
+    ManifestSection* sections;
+    int section_count;
+    int section_capacity;
+    ManifestEntry* entries;
+    int entry_count;
+    int entry_capacity;
+} ManifestFile;
+
+// Powiększa tablicę dynamiczną dwukrotnie, gdy jest pełna
+static int reserve_element(void** array, int count, int* capacity, size_t element_size) {
+    if (count < *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity * 2 : 16;
+    void* grown = realloc(*array, (size_t)new_capacity * element_size);
+    if (!grown) {
+        printf("Error: Cannot allocate memory for the manifest\n");
+        return 0;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+// Usuwa białe znaki z początku i końca napisu (w miejscu)
+static char* trim(char* text) {
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    size_t length = strlen(text);
+    while (length > 0 && isspace((unsigned char)text[length - 1])) {
+        text[--length] = '\0';
+    }
+    return text;
+}
+
+// Identyfikator C: litery, cyfry i '_', bez cyfry na początku
+static int is_identifier(const char* name) {
+    if (!*name || isdigit((unsigned char)*name)) {
+        return 0;
+    }
+    for (; *name; name++) {
+        if (!isalnum((unsigned char)*name) && *name != '_') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Obcina komentarz na końcu wiersza: ';' lub '#' po białym znaku, poza cudzysłowem
+static void strip_inline_comment(char* text) {
+    int quoted = 0;
+    for (char* c = text; *c; c++) {
+        if (*c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (*c == ';' || *c == '#') && c > text && isspace((unsigned char)c[-1])) {
+            *c = '\0';
+            return;
+        }
+    }
+}
+
+// Dzieli wartość options na argumenty oddzielone zerami, zwraca ich liczbę
+static int split_arguments(char* value) {
+    int count = 0;
+    char* src = value;
+    char* dst = value;
+    while (*src) {
+        while (isspace((unsigned char)*src)) {
+            src++;
+        }
+        if (!*src) {
+            break;
+        }
+        while (*src && !isspace((unsigned char)*src)) {
+            *dst++ = *src++;
+        }
+        if (*src) {
+            src++;  // Separator zostanie nadpisany zerem kończącym argument
+        }
+        *dst++ = '\0';
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Zamienia wpis klucz = wartość sekcji zasobu na opcje wiersza poleceń
+ *
+ * @details Klucz jest długą nazwą opcji z argumentem (dither = floyd ->
+ * --dither floyd). Wyjątki: input (plik wejściowy), options (dowolne opcje,
+ * także przełączniki bez argumentu) i bpp (bpp = 1 -> -1).
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int classify_entry(ManifestEntry* entry, const char* path) {
+    if (strcmp(entry->key, "input") == 0) {
+        entry->kind = ENTRY_INPUT;
+    } else if (strcmp(entry->key, "options") == 0) {
+        entry->kind = ENTRY_OPTIONS;
+        entry->argument_count = split_arguments(entry->value);
+    } else if (strcmp(entry->key, "bpp") == 0) {
+        if (strcmp(entry->value, "1") != 0 && strcmp(entry->value, "2") != 0 &&
+            strcmp(entry->value, "4") != 0 && strcmp(entry->value, "8") != 0) {
+            printf("Error: %s:%d: Invalid bpp '%s'. Use: 1, 2, 4, 8\n", path, entry->line, entry->value);
+            return 0;
+        }
+        entry->kind = ENTRY_SWITCH;
+        snprintf(entry->option, sizeof(entry->option), "-%s", entry->value);
+    } else if (strcmp(entry->key, "format") == 0) {
+        printf("Error: %s:%d: 'format' applies to the combined output, set it in [%s]\n", path, entry->line, MANIFEST_SECTION_SETTINGS);
+        return 0;
+    } else {
+        entry->kind = ENTRY_OPTION;
+        snprintf(entry->option, sizeof(entry->option), "--%s", entry->key);
+    }
+    return 1;
+}
+
+/**
+ * @brief Wczytuje sekcje i wpisy pliku INI
+ *
+ * @details Wiersze puste i zaczynające się od ';' lub '#' są pomijane,
+ * a ';' lub '#' po spacji zaczyna komentarz do końca wiersza. Wartość
+ * w cudzysłowach zachowuje spacje na brzegach i znaki komentarza.
+ *
+ * @param file Otwarty plik manifestu
+ * @param path Ścieżka manifestu (komunikaty błędów)
+ * @param contents Wynik (zwalniany przez free_manifest_file())
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int read_manifest_file(FILE* file, const char* path, ManifestFile* contents) {
+    char buffer[MANIFEST_LINE_LENGTH];
+    int line = 0;
+    while (fgets(buffer, sizeof(buffer), file)) {
+        line++;
+        if (!strchr(buffer, '\n') && !feof(file)) {
+            printf("Error: %s:%d: Line too long (maximum %d characters)\n", path, line, MANIFEST_LINE_LENGTH - 2);
+            return 0;
+        }
+        char* text = trim(buffer);
+        if (*text == '\0' || *text == ';' || *text == '#') {
+            continue;
+        }
+        strip_inline_comment(text);
+        text = trim(text);
+
+        if (*text == '[') {
+            char* end = strchr(text, ']');
+            if (!end || end[1] != '\0') {
+                printf("Error: %s:%d: Invalid section header '%s'\n", path, line, text);
+                return 0;
+            }
+            *end = '\0';
+            char* name = trim(text + 1);
+            if (!is_identifier(name) || strlen(name) >= MANIFEST_NAME_LENGTH) {
+                printf("Error: %s:%d: Invalid asset name '%s' (letters, digits and '_', up to %d chars)\n", path, line, name, MANIFEST_NAME_LENGTH - 1);
+                return 0;
+            }
+            for (int i = 0; i < contents->section_count; i++) {
+                if (strcmp(contents->sections[i].name, name) == 0) {
+                    printf("Error: %s:%d: Duplicate section [%s] (first at line %d)\n", path, line, name, contents->sections[i].line);
+                    return 0;
+                }
+            }
+            if (!reserve_element((void**)&contents->sections, contents->section_count, &contents->section_capacity, sizeof(ManifestSection))) {
+                return 0;
+            }
+            ManifestSection* section = &contents->sections[contents->section_count++];
+            strcpy(section->name, name);
+            section->line = line;
+            section->first_entry = contents->entry_count;
+            section->entry_count = 0;
+            continue;
+        }
+
+        char* equals = strchr(text, '=');
+        if (!equals) {
+            printf("Error: %s:%d: Expected 'key = value' or '[section]'\n", path, line);
+            return 0;
+        }
+        if (contents->section_count == 0) {
+            printf("Error: %s:%d: Key outside of a section\n", path, line);
+            return 0;
+        }
+        *equals = '\0';
+        char* key = trim(text);
+        char* value = trim(equals + 1);
+        size_t value_length = strlen(value);
+        if (value_length >= 2 && value[0] == '"' && value[value_length - 1] == '"') {
+            value[value_length - 1] = '\0';
+            value++;
+        }
+        if (*key == '\0' || strlen(key) >= sizeof(((ManifestEntry*)0)->key) || strlen(value) >= sizeof(((ManifestEntry*)0)->value)) {
+            printf("Error: %s:%d: Invalid key or value too long\n", path, line);
+            return 0;
+        }
+
+        if (!reserve_element((void**)&contents->entries, contents->entry_count, &contents->entry_capacity, sizeof(ManifestEntry))) {
+            return 0;
+        }
+        ManifestEntry* entry = &contents->entries[contents->entry_count++];
+        memset(entry, 0, sizeof(*entry));
+        strcpy(entry->key, key);
+        strcpy(entry->value, value);
+        entry->line = line;
+        contents->sections[contents->section_count - 1].entry_count++;
+    }
+    return 1;
+}
+
+static void free_manifest_file(ManifestFile* contents) {
+    free(contents->sections);
+    free(contents->entries);
+    memset(contents, 0, sizeof(*contents));
+}
+
+static const ManifestSection* find_section(const ManifestFile* contents, const char* name) {
+    for (int i = 0; i < contents->section_count; i++) {
+        if (strcmp(contents->sections[i].name, name) == 0) {
+            return &contents->sections[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wczytuje ustawienia zbiorczego wyjścia z sekcji [manifest]
+ *
+ * @details Klucze: output (plik wyjściowy, gdy nie podano go w wierszu
+ * poleceń), format (c, asm, masm, bin), enum (przedrostek nazw indeksu)
+ * jobs (liczba wątków, 0 = liczba procesorów) i dedup (on/off, wspólne
+ * dane identycznych zasobów). Paczka binarna ma jeszcze align
+ * (wyrównanie slotów) i header (nagłówek C z indeksem).
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int read_manifest_settings(const ManifestFile* contents, const ManifestSection* section, const char* path, Manifest* manifest) {
+    for (int i = 0; section && i < section->entry_count; i++) {
+        const ManifestEntry* entry = &contents->entries[section->first_entry + i];
+        if (strcmp(entry->key, "output") == 0) {
+            if (strlen(entry->value) >= sizeof(manifest->output_path)) {
+                printf("Error: %s:%d: Output path too long\n", path, entry->line);
+                return 0;
+            }
+            strcpy(manifest->output_path, entry->value);
+        } else if (strcmp(entry->key, "format") == 0) {
+            if (strcmp(entry->value, "c") == 0) {
+                manifest->output_format = FORMAT_C_ARRAY;
+            } else if (strcmp(entry->value, "asm") == 0) {
+                manifest->output_format = FORMAT_ASSEMBLER;
+            } else if (strcmp(entry->value, "masm") == 0) {
+                manifest->output_format = FORMAT_MASM_ARRAY;
+            } else if (strcmp(entry->value, "bin") == 0) {
+                manifest->output_format = FORMAT_BINARY;
+            } else {
+                printf("Error: %s:%d: Unknown combined output format '%s'. Use: c, asm, masm, bin\n", path, entry->line, entry->value);
+                return 0;
+            }
+        } else if (strcmp(entry->key, "enum") == 0) {
+            if (!is_identifier(entry->value) || strlen(entry->value) >= sizeof(manifest->enum_name)) {
+                printf("Error: %s:%d: Invalid enum prefix '%s'\n", path, entry->line, entry->value);
+                return 0;
+            }
+            strcpy(manifest->enum_name, entry->value);
+        } else if (strcmp(entry->key, "jobs") == 0) {
+            char* end;
+            long jobs = strtol(entry->value, &end, 10);
+            if (*entry->value == '\0' || *end != '\0' || jobs < 0) {
+                printf("Error: %s:%d: Invalid jobs count '%s'\n", path, entry->line, entry->value);
+                return 0;
+            }
+            manifest->jobs = (int)jobs;
+        } else if (strcmp(entry->key, "align") == 0) {
+            char* end;
+            long alignment = strtol(entry->value, &end, 10);
+            if (*end == 'K' || *end == 'k') {
+                alignment *= 1024;
+                end++;
+            }
+            if (*entry->value == '\0' || *end != '\0' || alignment <= 0 || alignment > PACK_MAX_ALIGN || (alignment & (alignment - 1))) {
+                printf("Error: %s:%d: Invalid alignment '%s' (power of two up to 16M, e.g. 512 or 4K)\n", path, entry->line, entry->value);
+                return 0;
+            }
+            manifest->alignment = alignment;
+        } else if (strcmp(entry->key, "dedup") == 0) {
+            if (strcmp(entry->value, "on") != 0 && strcmp(entry->value, "off") != 0) {
+                printf("Error: %s:%d: Invalid dedup '%s'. Use: on, off\n", path, entry->line, entry->value);
+                return 0;
+            }
+            manifest->dedup = (strcmp(entry->value, "on") == 0);
+        } else if (strcmp(entry->key, "header") == 0) {
+            if (strlen(entry->value) >= sizeof(manifest->header_path)) {
+                printf("Error: %s:%d: Header path too long\n", path, entry->line);
+                return 0;
+            }
+            strcpy(manifest->header_path, entry->value);
+        } else {
+            printf("Error: %s:%d: Unknown key '%s' in [%s] (use: output, format, enum, jobs, dedup, align, header)\n", path, entry->line, entry->key, MANIFEST_SECTION_SETTINGS);
+            return 0;
+        }
+    }
+    if (manifest->output_format == FORMAT_RAW_DATA) {
+        printf("Error: The combined manifest output supports the c, asm, masm and bin formats\n");
+        return 0;
+    }
+    if (manifest->header_path[0] && manifest->output_format != FORMAT_BINARY) {
+        printf("Error: %s: 'header' applies to the binary pack (format = bin)\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+// Dopisuje argumenty wpisów sekcji do argv; input zapamiętuje osobno
+static int append_section_arguments(const ManifestFile* contents, const ManifestSection* section, char** argv, int* argc, const char** input) {
+    for (int i = 0; section && i < section->entry_count; i++) {
+        const ManifestEntry* entry = &contents->entries[section->first_entry + i];
+        int needed = (entry->kind == ENTRY_OPTIONS) ? entry->argument_count : (entry->kind == ENTRY_OPTION) ? 2 : 1;
+        if (*argc + needed > MANIFEST_MAX_ARGUMENTS) {
+            return 0;
+        }
+        if (entry->kind == ENTRY_INPUT) {
+            *input = entry->value;
+        } else if (entry->kind == ENTRY_OPTIONS) {
+            const char* argument = entry->value;
+            for (int a = 0; a < entry->argument_count; a++) {
+                argv[(*argc)++] = (char*)argument;
+                argument += strlen(argument) + 1;
+            }
+        } else {
+            argv[(*argc)++] = (char*)entry->option;
+            if (entry->kind == ENTRY_OPTION) {
+                argv[(*argc)++] = (char*)entry->value;
+            }
+        }
+    }
+    return 1;
+}
+
+// Ścieżka bezwzględna: "/", "\" albo litera dysku
+static int is_absolute_path(const char* path) {
+    return path[0] == '/' || path[0] == '\\' || (isalpha((unsigned char)path[0]) && path[1] == ':');
+}
+
+// Rozmiar pliku wejściowego (-1 gdy nie da się go ustalić)
+static long input_file_size(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+    long size = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    fclose(file);
+    return size;
+}
+
+/**
+ * @brief Buduje kontekst konwersji zasobu z wpisów [defaults] i sekcji
+ *
+ * @details Wpisy są zamieniane na argumenty wiersza poleceń i przechodzą
+ * przez parse_arguments(), więc manifest przyjmuje dokładnie te same opcje
+ * i reguły walidacji co program. Kontekst startuje od opcji wiersza
+ * poleceń, a nazwą tablicy jest domyślnie nazwa sekcji.
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int build_asset(const ManifestFile* contents, const ManifestSection* defaults, const ManifestSection* section,
+                       const char* path, const char* manifest_dir, const ConversionContext* base, ManifestAsset* asset) {
+    char* argv[MANIFEST_MAX_ARGUMENTS + 1];
+    int argc = 0;
+    const char* input = NULL;
+    memset(asset, 0, sizeof(*asset));
+    strcpy(asset->name, section->name);
+    asset->line = section->line;
+    asset->duplicate_of = -1;
+
+    argv[argc++] = (char*)"manifest";
+    argv[argc++] = (char*)"--name";
+    argv[argc++] = asset->name;
+    if (!append_section_arguments(contents, defaults, argv, &argc, &input) ||
+        !append_section_arguments(contents, section, argv, &argc, &input)) {
+        printf("Error: %s:%d: Too many options for asset [%s] (maximum %d arguments)\n", path, section->line, section->name, MANIFEST_MAX_ARGUMENTS);
+        return 0;
+    }
+    if (!input || !*input) {
+        printf("Error: %s:%d: Asset [%s] has no input file (input = PATH)\n", path, section->line, section->name);
+        return 0;
+    }
+    const char* dir = is_absolute_path(input) ? "" : manifest_dir;
+    if (strlen(dir) + strlen(input) >= sizeof(asset->input_path)) {
+        printf("Error: %s:%d: Input path of asset [%s] too long\n", path, section->line, section->name);
+        return 0;
+    }
+    sprintf(asset->input_path, "%s%s", dir, input);
+    argv[argc++] = asset->input_path;
+
+    char* parsed_input;
+    char* parsed_output;
+    asset->context = *base;
+    if (!parse_arguments(argc, argv, &asset->context, &parsed_input, &parsed_output)) {
+        printf("Error: %s:%d: Invalid options for asset [%s]\n", path, section->line, section->name);
+        return 0;
+    }
+    if (parsed_input != asset->input_path || strcmp(parsed_output, "image_data.h") != 0) {
+        printf("Error: %s:%d: Unexpected argument '%s' for asset [%s]\n", path, section->line,
+               (parsed_input != asset->input_path) ? parsed_input : asset->input_path, section->name);
+        return 0;
+    }
+
+    // Zasób nie zapisuje własnych plików ani statystyk - robi to zbiorcze wyjście
+    asset->context.manifest = 0;
+    asset->context.stats_output = STATS_OUTPUT_NONE;
+    asset->input_size = input_file_size(asset->input_path);
+    return 1;
+}
+
+// Nazwa stałej enum: PRZEDROSTEK_NAZWA wielkimi literami
+static void make_constant_name(char* dst, size_t size, const char* prefix, const char* name) {
+    snprintf(dst, size, "%s_%s", prefix, name);
+    for (; *dst; dst++) {
+        *dst = (char)toupper((unsigned char)*dst);
+    }
+}
+
+// Typy i tablice generowane przez zbiorcze wyjście (PRZEDROSTEK_nazwa) oraz jego stałe (PRZEDROSTEK_NAZWA)
+static const char* const reserved_type_names[] = {"id", "info", "table", "pack_header", "pack_entry"};
+static const char* const reserved_constants[] = {"COUNT", "PACK_MAGIC", "PACK_VERSION", "PACK_ALIGN", "PACK_SIZE",
+                                                 "PACK_INVERTED", "PACK_HORIZONTAL", "PACK_LITTLE_ENDIAN"};
+
+/**
+ * @brief Sprawdza, czy identyfikator jest zajęty przez zbiorcze wyjście manifestu
+ *
+ * @param manifest Manifest (przedrostek enum)
+ * @param identifier Nazwa tablicy lub stałej zasobu
+ *
+ * @return Zarezerwowana nazwa, z którą koliduje identyfikator, lub NULL
+ */
+static const char* reserved_identifier(const Manifest* manifest, const char* identifier) {
+    static char reserved[MANIFEST_NAME_LENGTH * 2 + 2];
+    for (size_t i = 0; i < sizeof(reserved_type_names) / sizeof(reserved_type_names[0]); i++) {
+        snprintf(reserved, sizeof(reserved), "%s_%s", manifest->enum_name, reserved_type_names[i]);
+        if (strcmp(identifier, reserved) == 0) {
+            return reserved;
+        }
+    }
+    for (size_t i = 0; i < sizeof(reserved_constants) / sizeof(reserved_constants[0]); i++) {
+        make_constant_name(reserved, sizeof(reserved), manifest->enum_name, reserved_constants[i]);
+        if (strcmp(identifier, reserved) == 0) {
+            return reserved;
+        }
+    }
+    return NULL;
+}
+
+// Nazwy tablic i stałych enum muszą być unikalne w zbiorczym wyjściu i nie mogą zająć jego własnych nazw
+static int check_unique_names(const Manifest* manifest, const char* path) {
+    for (int i = 0; i < manifest->asset_count; i++) {
+        const ManifestAsset* asset = &manifest->assets[i];
+        char constant[MANIFEST_NAME_LENGTH * 2 + 2];
+        make_constant_name(constant, sizeof(constant), manifest->enum_name, asset->name);
+        const char* reserved = reserved_identifier(manifest, asset->context.array_name);
+        if (reserved) {
+            printf("Error: %s:%d: Asset [%s] uses array name '%s' reserved by the manifest output\n", path, asset->line,
+                   asset->name, reserved);
+            return 0;
+        }
+        reserved = reserved_identifier(manifest, constant);
+        if (reserved) {
+            printf("Error: %s:%d: Asset [%s] maps to enum constant %s reserved by the manifest output, rename the asset\n",
+                   path, asset->line, asset->name, reserved);
+            return 0;
+        }
+        for (int j = 0; j < i; j++) {
+            const ManifestAsset* other = &manifest->assets[j];
+            char other_constant[MANIFEST_NAME_LENGTH * 2 + 2];
+            make_constant_name(other_constant, sizeof(other_constant), manifest->enum_name, other->name);
+            if (strcmp(asset->context.array_name, other->context.array_name) == 0) {
+                printf("Error: %s:%d: Asset [%s] uses array name '%s' already used by [%s]\n", path, asset->line, asset->name,
+                       asset->context.array_name, other->name);
+                return 0;
+            }
+            if (strcmp(constant, other_constant) == 0) {
+                printf("Error: %s:%d: Asset [%s] maps to enum constant %s already used by [%s]\n", path, asset->line, asset->name,
+                       constant, other->name);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Wczytuje manifest zasobów i buduje kontekst konwersji każdego zasobu
+ *
+ * @details Plik INI:
+ * ```ini
+ * [manifest]              ; ustawienia zbiorczego wyjścia (opcjonalnie)
+ * output = assets.h
+ * enum = asset
+ *
+ * [defaults]              ; opcje wspólne wszystkich zasobów (opcjonalnie)
+ * bpp = 1
+ * options = -p
+ *
+ * [logo]                  ; zasób: tablica logo, stała ASSET_LOGO
+ * input = gfx/logo.png
+ * dither = floyd
+ * ```
+ * Ścieżki input są liczone względem katalogu manifestu.
+ *
+ * @param path Ścieżka manifestu lub "-" (stdin)
+ * @param defaults Kontekst z opcji wiersza poleceń (podstawa każdego zasobu)
+ * @param manifest Wynik (zwalniany przez manifest_free())
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+int manifest_load(const char* path, const ConversionContext* defaults, Manifest* manifest) {
+    memset(manifest, 0, sizeof(*manifest));
+    manifest->output_format = defaults->output_format;
+    strcpy(manifest->enum_name, MANIFEST_DEFAULT_ENUM);
+    manifest->alignment = PACK_DEFAULT_ALIGN;
+    manifest->dedup = !defaults->keep_duplicates; // --no-dedup, klucz dedup ma pierwszeństwo
+
+    FILE* file = open_input_stream(path);
+    if (!file) {
+        printf("Error: Cannot open manifest %s\n", path);
+        return 0;
+    }
+    ManifestFile contents;
+    memset(&contents, 0, sizeof(contents));
+    int loaded = read_manifest_file(file, path, &contents);
+    close_input_stream(file);
+
+    // Katalog manifestu - podstawa względnych ścieżek input
+    char manifest_dir[256] = "";
+    const char* separator = strrchr(path, '/');
+    const char* backslash = strrchr(path, '\\');
+    if (backslash && (!separator || backslash > separator)) {
+        separator = backslash;
+    }
+    if (separator && (size_t)(separator - path + 1) < sizeof(manifest_dir)) {
+        memcpy(manifest_dir, path, (size_t)(separator - path + 1));
+        manifest_dir[separator - path + 1] = '\0';
+    }
+
+    const ManifestSection* settings = find_section(&contents, MANIFEST_SECTION_SETTINGS);
+    const ManifestSection* common = find_section(&contents, MANIFEST_SECTION_DEFAULTS);
+    loaded = loaded && read_manifest_settings(&contents, settings, path, manifest);
+    for (int i = 0; loaded && i < contents.entry_count; i++) {
+        int in_settings = settings && i >= settings->first_entry && i < settings->first_entry + settings->entry_count;
+        loaded = in_settings || classify_entry(&contents.entries[i], path);
+    }
+
+    int asset_capacity = 0;
+    for (int i = 0; loaded && i < contents.section_count; i++) {
+        const ManifestSection* section = &contents.sections[i];
+        if (section == settings || section == common) {
+            continue;
+        }
+        loaded = reserve_element((void**)&manifest->assets, manifest->asset_count, &asset_capacity, sizeof(ManifestAsset)) &&
+                 build_asset(&contents, common, section, path, manifest_dir, defaults, &manifest->assets[manifest->asset_count]);
+        if (loaded) {
+            manifest->asset_count++;
+        }
+    }
+    free_manifest_file(&contents);
+
+    if (loaded && manifest->asset_count == 0) {
+        printf("Error: Manifest %s defines no assets\n", path);
+        loaded = 0;
+    }
+    if (loaded) {
+        loaded = check_unique_names(manifest, path);
+    }
+    if (!loaded) {
+        manifest_free(manifest);
+    }
+    return loaded;
+}
+
+/**
+ * @brief Liczy łączny rozmiar spakowanych danych zapisywanych do wyjścia
+ *
+ * @param manifest Manifest po konwersji zasobów
+ *
+ * @return Suma rozmiarów danych w bajtach (duplikaty liczone raz)
+ */
+size_t manifest_data_size(const Manifest* manifest) {
+    size_t total = 0;
+    for (int i = 0; i < manifest->asset_count; i++) {
+        if (manifest->assets[i].duplicate_of < 0) {
+            total += manifest->assets[i].image.size;
+        }
+    }
+    return total;
+}
+
+// Skrót zawartości zasobu do deduplikacji
+typedef struct {
+    unsigned long long hash;
+    int index;
+} ContentHash;
+
+static int compare_content_hash(const void* a, const void* b) {
+    const ContentHash* hash_a = (const ContentHash*)a;
+    const ContentHash* hash_b = (const ContentHash*)b;
+    if (hash_a->hash != hash_b->hash) {
+        return (hash_a->hash < hash_b->hash) ? -1 : 1;
+    }
+    return hash_a->index - hash_b->index;
+}
+
+// Zasoby mogą dzielić tablicę: te same bajty, ta sama paleta i (w C) to samo PROGMEM
+static int same_content(const ManifestAsset* a, const ManifestAsset* b, int check_progmem) {
+    int indexed = (a->context.color_format == COLOR_FORMAT_INDEXED);
+    if (a->image.size != b->image.size || indexed != (b->context.color_format == COLOR_FORMAT_INDEXED) ||
+        (check_progmem && a->context.use_progmem != b->context.use_progmem)) {
+        return 0;
+    }
+    if (memcmp(a->image.data, b->image.data, a->image.size) != 0) {
+        return 0;
+    }
+    return !indexed || memcmp(a->context.image_palette, b->context.image_palette, sizeof(a->context.image_palette)) == 0;
+}
+
+/**
+ * @brief Wyszukuje zasoby o identycznych spakowanych danych
+ *
+ * @details Zasoby są grupowane po skrócie FNV-1a danych (i palety),
+ * a w grupie porównywane bajt po bajcie. Duplikat wskazuje pierwszy
+ * zasób (w kolejności manifestu) z tymi samymi danymi; zbiorcze
+ * wyjście zapisuje dane raz, a duplikat staje się aliasem (#define
+ * w C, etykieta w assemblerze, wspólny slot w paczce binarnej).
+ *
+ * @param manifest Manifest po konwersji zasobów
+ *
+ * @return Liczba bajtów zaoszczędzonych przez wspólne dane
+ */
+size_t manifest_deduplicate(Manifest* manifest) {
+    ContentHash* hashes = (ContentHash*)malloc((size_t)manifest->asset_count * sizeof(ContentHash));
+    if (!hashes) {
+        return 0; // Bez deduplikacji wyjście jest nadal poprawne
+    }
+    for (int i = 0; i < manifest->asset_count; i++) {
+        const ManifestAsset* asset = &manifest->assets[i];
+        unsigned long long hash = content_hash(CONTENT_HASH_SEED, asset->image.data, asset->image.size);
+        if (asset->context.color_format == COLOR_FORMAT_INDEXED) {
+            hash = content_hash(hash, &asset->context.image_palette[0][0], sizeof(asset->context.image_palette));
+        }
+        hashes[i].hash = hash;
+        hashes[i].index = i;
+    }
+    qsort(hashes, (size_t)manifest->asset_count, sizeof(ContentHash), compare_content_hash);
+
+    // W grupie o tym samym skrócie indeksy rosną, więc pierwszy pasujący zasób jest najwcześniejszy
+    size_t saved = 0;
+    int check_progmem = (manifest->output_format == FORMAT_C_ARRAY);
+    for (int first = 0, j = 0; j < manifest->asset_count; j++) {
+        if (hashes[j].hash != hashes[first].hash) {
+            first = j;
+        }
+        ManifestAsset* asset = &manifest->assets[hashes[j].index];
+        for (int k = first; k < j; k++) {
+            const ManifestAsset* candidate = &manifest->assets[hashes[k].index];
+            if (candidate->duplicate_of < 0 && same_content(asset, candidate, check_progmem)) {
+                asset->duplicate_of = hashes[k].index;
+                saved += asset->image.size;
+                break;
+            }
+        }
+    }
+    free(hashes);
+    return saved;
+}
+
+// Głębia danych zasobu w bitach na piksel (wyjście kolorowe: bity formatu koloru)
+static int asset_bits_per_pixel(const ManifestAsset* asset) {
+    if (asset->context.color_format != COLOR_FORMAT_NONE) {
+        return color_format_bits(asset->context.color_format);
+    }
+    return asset->context.bits_per_pixel;
+}
+
+// Strażnik nagłówka z nazwy pliku wyjściowego (stdout: z przedrostka enum)
+static void make_include_guard(char* guard, size_t size, const char* output_path, const char* enum_name) {
+    const char* name = output_path;
+    if (is_stdio_path(output_path)) {
+        snprintf(guard, size, "%s_DATA_H", enum_name);
+    } else {
+        for (const char* c = output_path; *c; c++) {
+            if (*c == '/' || *c == '\\') {
+                name = c + 1;
+            }
+        }
+        snprintf(guard, size, "%s%s", isdigit((unsigned char)*name) ? "_" : "", name);
+    }
+    for (; *guard; guard++) {
+        *guard = isalnum((unsigned char)*guard) ? (char)toupper((unsigned char)*guard) : '_';
+    }
+}
+
+// Enum (C) albo stałe (assembler) z indeksami zasobów; offsets = położenie w paczce binarnej (NULL = brak)
+static void write_asset_index(FILE* file, const Manifest* manifest, int is_assembler, const unsigned long* offsets) {
+    char constant[MANIFEST_NAME_LENGTH * 2 + 2];
+    if (!is_assembler) {
+        fprintf(file, "typedef enum {\n");
+        for (int i = 0; i < manifest->asset_count; i++) {
+            const ManifestAsset* asset = &manifest->assets[i];
+            make_constant_name(constant, sizeof(constant), manifest->enum_name, asset->name);
+            fprintf(file, "    %s,%*s// %dx%d, %lu bytes", constant, (int)(strlen(constant) < 31 ? 31 - strlen(constant) : 1), "",
+                    asset->image.width, asset->image.height, (unsigned long)asset->image.size);
+            if (offsets) {
+                fprintf(file, " at 0x%08lX", offsets[i]);
+            }
+            fprintf(file, "\n");
+        }
+        make_constant_name(constant, sizeof(constant), manifest->enum_name, "COUNT");
+        fprintf(file, "    %s\n", constant);
+        fprintf(file, "} %s_id;\n", manifest->enum_name);
+    } else {
+        for (int i = 0; i < manifest->asset_count; i++) {
+            make_constant_name(constant, sizeof(constant), manifest->enum_name, manifest->assets[i].name);
+            fprintf(file, "%s = %d\n", constant, i);
+        }
+        make_constant_name(constant, sizeof(constant), manifest->enum_name, "COUNT");
+        fprintf(file, "%s = %d\n", constant, manifest->asset_count);
+    }
+}
+
+// Tablica indeksu: dane, rozmiar, wymiary i głębia (C) albo adresy etykiet (assembler)
+static void write_asset_table(FILE* file, const Manifest* manifest) {
+    char count_constant[MANIFEST_NAME_LENGTH * 2 + 2];
+    make_constant_name(count_constant, sizeof(count_constant), manifest->enum_name, "COUNT");
+
+    if (manifest->output_format == FORMAT_ASSEMBLER) {
+        fprintf(file, "\n%s_table:\n", manifest->enum_name);
+        for (int i = 0; i < manifest->asset_count; i++) {
+            fprintf(file, "    .dw %s\n", manifest->assets[i].context.array_name);
+        }
+        return;
+    }
+    if (manifest->output_format == FORMAT_MASM_ARRAY) {
+        fprintf(file, "\n.array %s_table[%d].word\n", manifest->enum_name, manifest->asset_count);
+        for (int i = 0; i < manifest->asset_count; i++) {
+            fprintf(file, " %s\n", manifest->assets[i].context.array_name);
+        }
+        fprintf(file, ".enda\n");
+        return;
+    }
+
+    // Tablica w pamięci programu tylko gdy wszystkie dane zasobów mają PROGMEM
+    int all_progmem = 1;
+    for (int i = 0; i < manifest->asset_count; i++) {
+        all_progmem &= manifest->assets[i].context.use_progmem;
+    }
+    fprintf(file, "\nconst %s_info %s_table[%s]%s = {\n", manifest->enum_name, manifest->enum_name, count_constant, all_progmem ? " PROGMEM" : "");
+    for (int i = 0; i < manifest->asset_count; i++) {
+        const ManifestAsset* asset = &manifest->assets[i];
+        fprintf(file, "    {%s, %lu, %d, %d, %d}%s\n", asset->context.array_name, (unsigned long)asset->image.size,
+                asset->image.width, asset->image.height, asset_bits_per_pixel(asset), (i < manifest->asset_count - 1) ? "," : "");
+    }
+    fprintf(file, "};\n");
+}
+
+// Skrót FNV-1a (32 bity) nazwy zasobu - wyszukiwanie zasobu po nazwie na urządzeniu
+static unsigned long name_hash(const char* name) {
+    unsigned long hash = 2166136261UL;
+    for (; *name; name++) {
+        hash = ((hash ^ (uchar)*name) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+// Zapis liczby little-endian na bytes bajtach
+static void put_le(uchar* dst, unsigned long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        dst[i] = (uchar)(value >> (8 * i));
+    }
+}
+
+// Dopełnia plik bajtami PACK_PADDING do zadanej pozycji
+static int write_padding(FILE* file, unsigned long long position, unsigned long long target) {
+    uchar padding[512];
+    memset(padding, PACK_PADDING, sizeof(padding));
+    while (position < target) {
+        size_t chunk = (target - position < sizeof(padding)) ? (size_t)(target - position) : sizeof(padding);
+        if (fwrite(padding, 1, chunk, file) != chunk) {
+            return 0;
+        }
+        position += chunk;
+    }
+    return 1;
+}
+
+// Rozmiar danych slotu zasobu: spakowany obraz i paleta RGB (--color indexed)
+static unsigned long long asset_slot_data_size(const ManifestAsset* asset) {
+    unsigned long long size = asset->image.size;
+    if (asset->context.color_format == COLOR_FORMAT_INDEXED) {
+        size += INDEXED_PALETTE_COLORS * 3;
+    }
+    return size;
+}
+
+/**
+ * @brief Wyznacza położenie slotów zasobów w paczce binarnej
+ *
+ * @details Pierwszy slot zaczyna się za tabelą indeksu, każdy kolejny za
+ * poprzednim; początek i długość slotu są wielokrotnością wyrównania, więc
+ * zasób można podmienić nadpisując tylko jego slot (np. sektor flash).
+ * Duplikat (manifest_deduplicate()) dostaje slot zasobu, który powtarza.
+ *
+ * @param manifest Manifest po konwersji zasobów
+ * @param offsets Wynik: początki slotów (asset_count elementów)
+ * @param slot_sizes Wynik: rozmiary slotów (asset_count elementów)
+ * @param total_size Wynik: rozmiar całej paczki
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy paczka przekracza 4 GB lub wymiar 65535
+ */
+static int layout_asset_pack(const Manifest* manifest, unsigned long* offsets, unsigned long* slot_sizes, unsigned long* total_size) {
+    unsigned long long align = (unsigned long long)manifest->alignment;
+    unsigned long long position = PACK_HEADER_SIZE + (unsigned long long)PACK_ENTRY_SIZE * manifest->asset_count;
+    for (int i = 0; i < manifest->asset_count; i++) {
+        const ManifestAsset* asset = &manifest->assets[i];
+        if (asset->image.width > 0xFFFF || asset->image.height > 0xFFFF) {
+            printf("Error: Asset [%s] is too large for the pack index (%dx%d, maximum 65535)\n", asset->name, asset->image.width, asset->image.height);
+            return 0;
+        }
+        if (asset->duplicate_of >= 0) {
+            offsets[i] = offsets[asset->duplicate_of];
+            slot_sizes[i] = slot_sizes[asset->duplicate_of];
+            continue;
+        }
+        position = (position + align - 1) / align * align;
+        offsets[i] = (unsigned long)position;
+        slot_sizes[i] = (unsigned long)((asset_slot_data_size(asset) + align - 1) / align * align);
+        position += slot_sizes[i];
+        if (position > 0xFFFFFFFFULL) {
+            printf("Error: Binary pack exceeds 4 GB\n");
+            return 0;
+        }
+    }
+    *total_size = (unsigned long)((position + align - 1) / align * align);
+    return 1;
+}
+
+// Wpis indeksu paczki binarnej (układ opisany w manifest.h)
+static void make_pack_entry(uchar* entry, const ManifestAsset* asset, unsigned long offset, unsigned long slot_size) {
+    const ConversionContext* context = &asset->context;
+    memset(entry, 0, PACK_ENTRY_SIZE);
+    put_le(entry + 0, name_hash(asset->name), 4);
+    put_le(entry + 4, offset, 4);
+    put_le(entry + 8, (unsigned long)asset->image.size, 4);
+    put_le(entry + 12, slot_size, 4);
+    put_le(entry + 16, (unsigned long)asset->image.width, 2);
+    put_le(entry + 18, (unsigned long)asset->image.height, 2);
+    entry[20] = (uchar)asset_bits_per_pixel(asset);
+    entry[21] = (uchar)context->display_layout;
+    entry[22] = (uchar)context->color_format;
+    entry[23] = (uchar)((context->scan_direction ? PACK_FLAG_HORIZONTAL : 0) | (context->pixel_order ? PACK_FLAG_LITTLE_ENDIAN : 0) |
+                        (context->invert ? PACK_FLAG_INVERTED : 0));
+    if (context->color_format == COLOR_FORMAT_INDEXED) {
+        put_le(entry + 24, offset + (unsigned long)asset->image.size, 4);
+    }
+}
+
+/**
+ * @brief Zapisuje paczkę binarną: nagłówek, tabelę indeksu i wyrównane sloty zasobów
+ *
+ * @details Układ pól w manifest.h (PACK_*). Sloty są dopełniane bajtami
+ * PACK_PADDING do wielokrotności wyrównania, więc oprogramowanie urządzenia
+ * może mapować lub przesyłać DMA zasób po indeksie bez systemu plików.
+ *
+ * @param file Otwarty plik wyjściowy (tryb binarny)
+ * @param manifest Manifest po konwersji zasobów
+ * @param offsets Początki slotów z layout_asset_pack()
+ * @param slot_sizes Rozmiary slotów z layout_asset_pack()
+ * @param total_size Rozmiar paczki z layout_asset_pack()
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu zapisu
+ */
+static int write_asset_pack(FILE* file, const Manifest* manifest, const unsigned long* offsets, const unsigned long* slot_sizes,
+                            unsigned long total_size) {
+    uchar header[PACK_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, PACK_MAGIC, 4);
+    put_le(header + 4, PACK_VERSION, 2);
+    put_le(header + 6, PACK_ENTRY_SIZE, 2);
+    put_le(header + 8, (unsigned long)manifest->asset_count, 4);
+    put_le(header + 12, (unsigned long)manifest->alignment, 4);
+    put_le(header + 16, PACK_HEADER_SIZE, 4);
+    put_le(header + 20, total_size, 4);
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+        return 0;
+    }
+
+    for (int i = 0; i < manifest->asset_count; i++) {
+        uchar entry[PACK_ENTRY_SIZE];
+        make_pack_entry(entry, &manifest->assets[i], offsets[i], slot_sizes[i]);
+        if (fwrite(entry, 1, sizeof(entry), file) != sizeof(entry)) {
+            return 0;
+        }
+    }
+
+    unsigned long long position = PACK_HEADER_SIZE + (unsigned long long)PACK_ENTRY_SIZE * manifest->asset_count;
+    for (int i = 0; i < manifest->asset_count; i++) {
+        const ManifestAsset* asset = &manifest->assets[i];
+        if (asset->duplicate_of >= 0) {
+            continue;
+        }
+        if (!write_padding(file, position, offsets[i]) ||
+            fwrite(asset->image.data, 1, asset->image.size, file) != asset->image.size) {
+            return 0;
+        }
+        if (asset->context.color_format == COLOR_FORMAT_INDEXED &&
+            fwrite(&asset->context.image_palette[0][0], 1, INDEXED_PALETTE_COLORS * 3, file) != INDEXED_PALETTE_COLORS * 3) {
+            return 0;
+        }
+        position = offsets[i] + asset_slot_data_size(asset);
+    }
+    return write_padding(file, position, total_size);
+}
+
+// Nagłówek C paczki binarnej: enum indeksu i struktury nagłówka i wpisu
+static int write_pack_header(const Manifest* manifest, const char* manifest_path, const char* pack_path,
+                             const unsigned long* offsets, unsigned long total_size) {
+    FILE* file = open_output_stream(manifest->header_path, "w");
+    if (!file) {
+        printf("Error: Failed to write output file %s\n", manifest->header_path);
+        return 0;
+    }
+    char guard[300];
+    char prefix[MANIFEST_NAME_LENGTH * 2 + 2];
+    make_include_guard(guard, sizeof(guard), manifest->header_path, manifest->enum_name);
+    make_constant_name(prefix, sizeof(prefix), manifest->enum_name, "PACK");
+
+    write_generator_comment(file, 0);
+    fprintf(file, "// Manifest: %s (%d assets)\n", manifest_path, manifest->asset_count);
+    fprintf(file, "// Pack: %s (%lu bytes, slots aligned to %ld bytes, padding 0x%02X)\n", pack_path, total_size, manifest->alignment, PACK_PADDING);
+    fprintf(file, "\n#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n", guard, guard);
+    write_asset_index(file, manifest, 0, offsets);
+    fprintf(file, "\n#define %s_MAGIC \"%s\"\n", prefix, PACK_MAGIC);
+    fprintf(file, "#define %s_VERSION %d\n", prefix, PACK_VERSION);
+    fprintf(file, "#define %s_ALIGN %ld\n", prefix, manifest->alignment);
+    fprintf(file, "#define %s_SIZE %luUL\n", prefix, total_size);
+    fprintf(file, "#define %s_INVERTED 0x%02X\n", prefix, PACK_FLAG_INVERTED);
+    fprintf(file, "#define %s_HORIZONTAL 0x%02X\n", prefix, PACK_FLAG_HORIZONTAL);
+    fprintf(file, "#define %s_LITTLE_ENDIAN 0x%02X\n", prefix, PACK_FLAG_LITTLE_ENDIAN);
+
+    fprintf(file, "\n// Pack header at offset 0, all fields little-endian\n");
+    fprintf(file, "typedef struct {\n");
+    fprintf(file, "    char magic[4];             // \"%s\"\n", PACK_MAGIC);
+    fprintf(file, "    uint16_t version;\n");
+    fprintf(file, "    uint16_t entry_size;       // %d\n", PACK_ENTRY_SIZE);
+    fprintf(file, "    uint32_t asset_count;\n");
+    fprintf(file, "    uint32_t alignment;\n");
+    fprintf(file, "    uint32_t index_offset;     // Index table, asset_count entries in enum order\n");
+    fprintf(file, "    uint32_t size;\n");
+    fprintf(file, "    uint32_t reserved[2];\n");
+    fprintf(file, "} %s_pack_header;\n", manifest->enum_name);
+    fprintf(file, "\n// Pack index entry; name_hash is 32-bit FNV-1a of the asset name\n");
+    fprintf(file, "typedef struct {\n");
+    fprintf(file, "    uint32_t name_hash;\n");
+    fprintf(file, "    uint32_t offset;           // Slot start, multiple of the alignment\n");
+    fprintf(file, "    uint32_t size;             // Image data bytes\n");
+    fprintf(file, "    uint32_t slot_size;        // Bytes reserved for the asset, multiple of the alignment\n");
+    fprintf(file, "    uint16_t width;\n");
+    fprintf(file, "    uint16_t height;\n");
+    fprintf(file, "    uint8_t bits_per_pixel;\n");
+    fprintf(file, "    uint8_t layout;            // 0 = rows/columns (-h/-v)");
+    for (int layout = DISPLAY_LAYOUT_SSD1306; layout <= DISPLAY_LAYOUT_UC8151; layout++) {
+        fprintf(file, ", %d = %s", layout, display_layout_name(layout));
+    }
+    fprintf(file, "\n");
+    fprintf(file, "    uint8_t color_format;      // 0 = grayscale");
+    for (int format = COLOR_FORMAT_NONE + 1; format <= COLOR_FORMAT_INDEXED; format++) {
+        fprintf(file, ", %d = %s", format, color_format_name(format));
+    }
+    fprintf(file, "\n");
+    fprintf(file, "    uint8_t flags;             // %s_INVERTED, %s_HORIZONTAL, %s_LITTLE_ENDIAN\n", prefix, prefix, prefix);
+    fprintf(file, "    uint32_t palette_offset;   // %d RGB triplets after the data (indexed color), 0 = none\n", INDEXED_PALETTE_COLORS);
+    fprintf(file, "    uint32_t reserved;\n");
+    fprintf(file, "} %s_pack_entry;\n", manifest->enum_name);
+    fprintf(file, "\n#endif\n");
+    return close_output_stream(file);
+}
+
+// Rozmiar danych duplikatów, których zbiorcze wyjście nie zapisuje
+static size_t duplicate_data_size(const Manifest* manifest) {
+    size_t total = 0;
+    for (int i = 0; i < manifest->asset_count; i++) {
+        if (manifest->assets[i].duplicate_of >= 0) {
+            total += manifest->assets[i].image.size;
+        }
+    }
+    return total;
+}
+
+// Alias duplikatu do tablicy (i palety) zasobu o tych samych danych: #define w C, etykieta w assemblerze
+static void write_duplicate_alias(FILE* file, const Manifest* manifest, const ManifestAsset* asset) {
+    const ManifestAsset* original = &manifest->assets[asset->duplicate_of];
+    int indexed = (asset->context.color_format == COLOR_FORMAT_INDEXED);
+    if (manifest->output_format == FORMAT_C_ARRAY) {
+        fprintf(file, "\n// Asset: %s (%s) - same data as %s\n", asset->name, asset->input_path, original->name);
+        fprintf(file, "#define %s %s\n", asset->context.array_name, original->context.array_name);
+        if (indexed) {
+            fprintf(file, "#define %s_palette %s_palette\n", asset->context.array_name, original->context.array_name);
+        }
+    } else {
+        fprintf(file, "\n; Asset: %s (%s) - same data as %s\n", asset->name, asset->input_path, original->name);
+        fprintf(file, "%s = %s\n", asset->context.array_name, original->context.array_name);
+        if (indexed) {
+            fprintf(file, "%s_palette = %s_palette\n", asset->context.array_name, original->context.array_name);
+        }
+    }
+}
+
+/**
+ * @brief Zapisuje zbiorcze wyjście manifestu: indeks i tablice wszystkich zasobów
+ *
+ * @details Plik zaczyna się od nagłówka programu, potem idzie enum
+ * indeksu (w assemblerze stałe), tablice zasobów w kolejności manifestu,
+ * każda z komentarzem wymiarów i formatu, i na końcu tablica indeksu
+ * PRZEDROSTEK_table z adresem, rozmiarem, wymiarami i głębią danych.
+ *
+ * @param manifest Manifest po konwersji wszystkich zasobów
+ * @param manifest_path Ścieżka manifestu (komentarz w nagłówku)
+ * @param output_path Plik wyjściowy lub "-" (stdout)
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu zapisu
+ */
+int manifest_write_output(Manifest* manifest, const char* manifest_path, const char* output_path) {
+    if (manifest->output_format == FORMAT_BINARY) {
+        unsigned long* offsets = (unsigned long*)malloc((size_t)manifest->asset_count * 2 * sizeof(unsigned long));
+        unsigned long* slot_sizes = offsets + manifest->asset_count;
+        unsigned long total_size = 0;
+        if (!offsets) {
+            printf("Error: Cannot allocate memory for the manifest\n");
+            return 0;
+        }
+        int written = layout_asset_pack(manifest, offsets, slot_sizes, &total_size);
+        if (written) {
+            FILE* file = open_output_stream(output_path, "wb");
+            written = file && write_asset_pack(file, manifest, offsets, slot_sizes, total_size);
+            written = file ? close_output_stream(file) && written : 0;
+        }
+        if (written && manifest->header_path[0]) {
+            written = write_pack_header(manifest, manifest_path, output_path, offsets, total_size);
+        }
+        free(offsets);
+        return written;
+    }
+
+    FILE* file = open_output_stream(output_path, "w");
+    if (!file) {
+        return 0;
+    }
+
+    int is_assembler = (manifest->output_format != FORMAT_C_ARRAY);
+    const char* comment_prefix = is_assembler ? ";" : "//";
+    write_generator_comment(file, is_assembler);
+    fprintf(file, "%s Manifest: %s (%d assets, %lu bytes", comment_prefix, manifest_path, manifest->asset_count,
+            (unsigned long)manifest_data_size(manifest));
+    size_t shared_size = duplicate_data_size(manifest);
+    if (shared_size > 0) {
+        fprintf(file, ", %lu bytes saved by shared data", (unsigned long)shared_size);
+    }
+    fprintf(file, ")\n");
+
+    char guard[300];
+    if (!is_assembler) {
+        // Wymiary większe od 16 bitów wymagają szerszego typu
+        int max_dimension = 0;
+        for (int i = 0; i < manifest->asset_count; i++) {
+            if (manifest->assets[i].image.width > max_dimension) max_dimension = manifest->assets[i].image.width;
+            if (manifest->assets[i].image.height > max_dimension) max_dimension = manifest->assets[i].image.height;
+        }
+        const char* dimension_type = (max_dimension > 65535) ? "unsigned long" : "unsigned short";
+
+        make_include_guard(guard, sizeof(guard), output_path, manifest->enum_name);
+        fprintf(file, "\n#ifndef %s\n#define %s\n\n", guard, guard);
+        write_asset_index(file, manifest, is_assembler, NULL);
+        fprintf(file, "\ntypedef struct {\n");
+        fprintf(file, "    const unsigned char* data;\n");
+        fprintf(file, "    unsigned long size;\n");
+        fprintf(file, "    %s width;\n", dimension_type);
+        fprintf(file, "    %s height;\n", dimension_type);
+        fprintf(file, "    unsigned char bits_per_pixel;\n");
+        fprintf(file, "} %s_info;\n", manifest->enum_name);
+    } else {
+        fprintf(file, "\n");
+        write_asset_index(file, manifest, is_assembler, NULL);
+    }
+
+    for (int i = 0; i < manifest->asset_count; i++) {
+        ManifestAsset* asset = &manifest->assets[i];
+        ConversionContext* context = &asset->context;
+        HeaderContext header_ctx = {asset->image.width, asset->image.height, context->bits_per_pixel, context->dithering_method,
+                                    context->brightness, context->contrast, context->invert, is_assembler, context->color_format};
+        if (asset->duplicate_of >= 0) {
+            write_duplicate_alias(file, manifest, asset);
+            continue;
+        }
+        fprintf(file, "\n%s Asset: %s (%s)\n", comment_prefix, asset->name, asset->input_path);
+        write_format_comment(file, &header_ctx);
+        if (manifest->output_format == FORMAT_C_ARRAY) {
+            format_c_array_data(asset->image.data, asset->image.size, context->array_name, file, context->use_progmem, 0);
+        } else if (manifest->output_format == FORMAT_ASSEMBLER) {
+            format_assembler_data(asset->image.data, asset->image.size, context->array_name, file);
+        } else {
+            format_masm_array_data(asset->image.data, asset->image.size, context->array_name, file);
+        }
+        if (context->color_format == COLOR_FORMAT_INDEXED) {
+            format_palette_write(file, manifest->output_format, context->array_name, context->use_progmem,
+                                 &context->image_palette[0][0], INDEXED_PALETTE_COLORS);
+        }
+    }
+
+    write_asset_table(file, manifest);
+    if (!is_assembler) {
+        fprintf(file, "\n#endif\n");
+    }
+    return close_output_stream(file);
+}
+
+/**
+ * @brief Zwalnia zasoby manifestu i ich spakowane dane
+ *
+ * @param manifest Manifest z manifest_load()
+ */
+void manifest_free(Manifest* manifest) {
+    for (int i = 0; i < manifest->asset_count; i++) {
+        if (manifest->assets[i].image.data) {
+            stats_free(manifest->assets[i].image.data);
+        }
+    }
+    free(manifest->assets);
+    manifest->assets = NULL;
+    manifest->asset_count = 0;
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************
+
+    plik  : manifest.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy manifestu zasobów (--manifest) i zbiorczego wyjścia
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include "defs.h"
+#include "stats.h"
+
+// Długość nazwy zasobu (sekcji) i przedrostka enum - jak ConversionContext.array_name
+#define MANIFEST_NAME_LENGTH 64
+
+// Domyślny przedrostek enum i tablicy indeksu (klucz enum w [manifest])
+#define MANIFEST_DEFAULT_ENUM "asset"
+
+// Paczka binarna (format = bin): nagłówek, tabela indeksu i sloty zasobów wyrównane do align.
+// Wszystkie pola little-endian, przesunięcia liczone od początku paczki.
+//
+// Nagłówek (PACK_HEADER_SIZE bajtów):
+//   0  "XBPK"        4  u16 wersja     6  u16 rozmiar wpisu indeksu
+//   8  u32 liczba zasobów              12 u32 wyrównanie slotów
+//   16 u32 początek indeksu            20 u32 rozmiar paczki      24..31 zarezerwowane (0)
+//
+// Wpis indeksu (PACK_ENTRY_SIZE bajtów, w kolejności enum):
+//   0  u32 FNV-1a nazwy  4  u32 offset danych  8  u32 rozmiar danych  12 u32 rozmiar slotu
+//   16 u16 szerokość     18 u16 wysokość       20 u8 bity na piksel   21 u8 układ (DISPLAY_LAYOUT_*)
+//   22 u8 format koloru (COLOR_FORMAT_*)       23 u8 flagi (PACK_FLAG_*)
+//   24 u32 offset palety RGB (--color indexed, 0 = brak)               28 u32 zarezerwowane (0)
+#define PACK_MAGIC        "XBPK"
+#define PACK_VERSION      1
+#define PACK_HEADER_SIZE  32
+#define PACK_ENTRY_SIZE   32
+#define PACK_DEFAULT_ALIGN 4            // Domyślne wyrównanie slotów (klucz align)
+#define PACK_MAX_ALIGN    (16L << 20)   // Największe wyrównanie (16 MB)
+#define PACK_PADDING      0xFF          // Wypełnienie slotów (stan skasowanej pamięci flash)
+
+// Flagi wpisu indeksu paczki
+#define PACK_FLAG_HORIZONTAL    0x01    // Skanowanie poziome (-h)
+#define PACK_FLAG_LITTLE_ENDIAN 0x02    // Kolejność pikseli little endian (-l)
+#define PACK_FLAG_INVERTED      0x04    // Dane odwrócone (--invert)
+
+// Zasób manifestu: jedna sekcja [nazwa] = jedna tablica w zbiorczym wyjściu
+typedef struct {
+    char name[MANIFEST_NAME_LENGTH]; // Nazwa sekcji (identyfikator w enum)
+    char input_path[256];      // Plik wejściowy (względem katalogu manifestu)
+    int line;                  // Wiersz nagłówka sekcji (komunikaty błędów)
+    long input_size;           // Rozmiar pliku wejściowego (kolejność zadań, -1 = nieznany)
+    ConversionContext context; // Opcje: wiersz poleceń, potem [defaults], potem sekcja zasobu
+    PackedImage image;         // Wynik konwersji (context.capture)
+    ConversionStats stats;     // Czasy etapów konwersji zasobu
+    int result;                // 1 = skonwertowano
+    int duplicate_of;          // Indeks zasobu o identycznych danych (-1 = dane własne)
+} ManifestAsset;
+
+// Manifest wczytany przez manifest_load()
+typedef struct {
+    ManifestAsset* assets;     // Zasoby w kolejności sekcji
+    int asset_count;
+    char output_path[256];     // Klucz output z [manifest] ("" = z wiersza poleceń)
+    OutputFormat output_format; // Format zbiorczego wyjścia (FORMAT_C_ARRAY, FORMAT_ASSEMBLER, FORMAT_MASM_ARRAY, FORMAT_BINARY)
+    long alignment;            // Wyrównanie slotów paczki binarnej (klucz align)
+    char header_path[256];     // Nagłówek C z indeksem paczki binarnej ("" = bez nagłówka)
+    char enum_name[MANIFEST_NAME_LENGTH]; // Przedrostek enum i tablicy indeksu
+    int jobs;                  // Liczba wątków konwersji (0 = liczba procesorów)
+    int dedup;                 // 1 = identyczne dane zapisywane raz (klucz dedup, domyślnie on)
+} Manifest;
+
+// Prototypy funkcji manifestu
+int manifest_load(const char* path, const ConversionContext* defaults, Manifest* manifest);
+int manifest_write_output(Manifest* manifest, const char* manifest_path, const char* output_path);
+size_t manifest_data_size(const Manifest* manifest);
+size_t manifest_deduplicate(Manifest* manifest);
+void manifest_free(Manifest* manifest);
+
+#endif
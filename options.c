@@ -15,11 +15,178 @@
 #include <string.h>
 #include "defs.h"
 #include "options.h"
+#include "stream_io.h"
+#include "bmp_palette.h"
+#include "stats.h"
+#include "color.h"
+#include "display_layout.h"
+#include "utils.h"
+#include "resize.h"
 
 // ============================================================================
 // Funkcje obsługi argumentów
 // ============================================================================
 
+// Nazwy formatów akceptowane przez --out FORMAT:ŚCIEŻKA
+static const struct {
+    const char* name;
+    OutputFormat format;
+} output_format_names[] = {
+    {"c", FORMAT_C_ARRAY},
+    {"raw", FORMAT_RAW_DATA},
+    {"asm", FORMAT_ASSEMBLER},
+    {"masm", FORMAT_MASM_ARRAY},
+    {"bin", FORMAT_BINARY},
+    {"preview", FORMAT_BMP_PREVIEW}
+};
+
+/**
+ * @brief Parsuje specyfikację celu wyjściowego FORMAT:ŚCIEŻKA
+ * 
+ * @details Format jest oddzielony od ścieżki pierwszym dwukropkiem, więc
+ * ścieżki zawierające dwukropek (np. "c:C:\out\img.h") są obsługiwane.
+ * 
+ * @param spec Specyfikacja z wiersza poleceń (np. "raw:img.hex")
+ * @param target Struktura OutputTarget do wypełnienia
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int parse_output_target(const char* spec, OutputTarget* target) {
+    const char* colon = strchr(spec, ':');
+    if (!colon || colon == spec || colon[1] == '\0') {
+        fprintf(stderr, "Error: Invalid output target '%s'. Use FORMAT:PATH (formats: c, raw, asm, masm, bin, preview)\n", spec);
+        return 0;
+    }
+    
+    size_t name_length = (size_t)(colon - spec);
+    for (size_t i = 0; i < sizeof(output_format_names) / sizeof(output_format_names[0]); i++) {
+        if (strlen(output_format_names[i].name) == name_length && strncmp(spec, output_format_names[i].name, name_length) == 0) {
+            target->format = output_format_names[i].format;
+            strncpy(target->path, colon + 1, sizeof(target->path) - 1);
+            target->path[sizeof(target->path) - 1] = '\0';
+            return 1;
+        }
+    }
+    
+    fprintf(stderr, "Error: Unknown output format in '%s'. Use: c, raw, asm, masm, bin, preview\n", spec);
+    return 0;
+}
+
+/**
+ * @brief Parsuje zakres przeglądu w postaci FIRST:LAST:STEP
+ * 
+ * @param spec Specyfikacja z wiersza poleceń (np. "10:100:10")
+ * @param option Nazwa opcji używana w komunikacie błędu
+ * @param range Struktura SweepRange do wypełnienia
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int parse_sweep_range(const char* spec, const char* option, SweepRange* range) {
+    char tail;
+    if (sscanf(spec, "%d:%d:%d%c", &range->first, &range->last, &range->step, &tail) != 3 ||
+        range->first < 0 || range->last > 100 || range->first > range->last || range->step <= 0) {
+        fprintf(stderr, "Error: Invalid %s range '%s'. Use FIRST:LAST:STEP with 0 <= FIRST <= LAST <= 100 and STEP > 0\n", option, spec);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Parsuje rozmiar pamięci z opcjonalnym sufiksem K, M lub G
+ * 
+ * @param spec Specyfikacja z wiersza poleceń (np. "512M", "2G", "65536")
+ * @param size Wynikowy rozmiar w bajtach
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ */
+static int parse_memory_size(const char* spec, size_t* size) {
+    char* end;
+    unsigned long long value = strtoull(spec, &end, 10);
+    unsigned long long multiplier = 1;
+    
+    if (end == spec || *spec == '-') {
+        value = 0;
+    } else if (*end == 'K' || *end == 'k') {
+        multiplier = 1024ULL;
+        end++;
+    } else if (*end == 'M' || *end == 'm') {
+        multiplier = 1024ULL * 1024;
+        end++;
+    } else if (*end == 'G' || *end == 'g') {
+        multiplier = 1024ULL * 1024 * 1024;
+        end++;
+    }
+    
+    if (value == 0 || *end != '\0' || value > (unsigned long long)(size_t)-1 / multiplier) {
+        fprintf(stderr, "Error: Invalid --max-mem value '%s'. Use a positive number of bytes with optional K, M or G suffix\n", spec);
+        return 0;
+    }
+    *size = (size_t)(value * multiplier);
+    return 1;
+}
+
+/**
+ * @brief Parsuje rozmiar docelowy --resize w postaci SZERxWYS
+ * 
+ * @param spec Specyfikacja z wiersza poleceń (np. "128x64", "296x0")
+ * @param context Kontekst konwersji (resize_width i resize_height)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ * 
+ * @note Wymiar 0 jest liczony z proporcji obrazu (resize_target_size()),
+ *       ale nie oba naraz
+ */
+static int parse_resize_size(const char* spec, ConversionContext* context) {
+    char tail;
+    int width, height;
+    if (sscanf(spec, "%dx%d%c", &width, &height, &tail) != 2 || width < 0 || height < 0 ||
+        (width == 0 && height == 0) || width > RESIZE_MAX_DIMENSION || height > RESIZE_MAX_DIMENSION) {
+        fprintf(stderr, "Error: Invalid --resize size '%s'. Use WIDTHxHEIGHT (1-%d, one of them may be 0 to keep the aspect ratio)\n", spec, RESIZE_MAX_DIMENSION);
+        return 0;
+    }
+    context->resize_width = width;
+    context->resize_height = height;
+    return 1;
+}
+
+/**
+ * @brief Parsuje wycinek --crop w postaci X,Y,SZER,WYS[:NAZWA]
+ * 
+ * @param spec Specyfikacja z wiersza poleceń (np. "32,0,16,16:player")
+ * @param crop Wynikowy prostokąt
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu (komunikat wypisany)
+ * 
+ * @note NAZWA (litery, cyfry, podkreślenie) jest przyrostkiem plików
+ *       i tablicy, gdy wycinków jest kilka
+ */
+static int parse_crop_rect(const char* spec, CropRect* crop) {
+    int consumed = 0;
+    memset(crop, 0, sizeof(*crop));
+    int valid = sscanf(spec, "%d,%d,%d,%d%n", &crop->x, &crop->y, &crop->width, &crop->height, &consumed) == 4 &&
+                crop->x >= 0 && crop->y >= 0 && crop->width > 0 && crop->height > 0;
+    const char* name = spec + consumed;
+    if (valid && *name == ':') {
+        name++;
+        size_t length = strlen(name);
+        valid = length > 0 && length < CROP_NAME_LENGTH;
+        for (size_t i = 0; i < length && valid; i++) {
+            char c = name[i];
+            valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+        if (valid) {
+            strcpy(crop->name, name);
+        }
+    } else if (valid && *name != '\0') {
+        valid = 0;
+    }
+    if (!valid) {
+        fprintf(stderr, "Error: Invalid --crop region '%s'. Use X,Y,WIDTH,HEIGHT[:NAME] (NAME: letters, digits, '_', up to %d chars)\n", spec, CROP_NAME_LENGTH - 1);
+        return 0;
+    }
+    return 1;
+}
+
 /**
  * @brief Wyświetla pomoc programu z opisem wszystkich opcji
  * 
@@ -44,11 +211,24 @@ void print_usage(const char* program_name) {
     printf("Usage: %s [OPTIONS] INPUT_BMP [OUTPUT_C_FILE]\n", program_name);
     printf("\n");
     printf("Converts a BMP image to a C array containing packed pixel data.\n");
-    printf("Supports both 4bpp (4 bits per pixel) and 1bpp (1 bit per pixel) formats.\n");
+    printf("Supports 1, 2, 4 and 8 bits per pixel grayscale output.\n");
+    printf("Input may also be PNG or binary PGM/PPM (detected by file signature).\n");
+    printf("Use '-' as INPUT_BMP, OUTPUT_C_FILE or --out path for stdin/stdout\n");
+    printf("(with stdout output all messages go to stderr).\n");
     printf("\n");
     printf("Options:\n");
     printf("  -4, --4bpp          Use 4 bits per pixel (default)\n");
     printf("  -1, --1bpp          Use 1 bit per pixel (black/white)\n");
+    printf("  -2, --2bpp          Use 2 bits per pixel (4 gray levels)\n");
+    printf("  -8, --8bpp          Use 8 bits per pixel (256 gray levels)\n");
+    printf("  --color FORMAT      Color output for TFT displays instead of grayscale (24/32-bit BMP input)\n");
+    printf("                      FORMATS: rgb565 (= rgb565le), rgb565be (byte-swapped for SPI), rgb332, rgb444,\n");
+    printf("                      indexed (4bpp indices + 16-color palette computed from the image)\n");
+    printf("  --kmeans N          k-means refinement passes after median cut for --color indexed (default: 0)\n");
+    printf("  --layout CTRL       1bpp data in the display controller's memory order (replaces -h/-v/-l/-b)\n");
+    printf("                      CONTROLLERS: ssd1306, sh1106, st7565 (8-row pages, bit 0 = top), uc8151 (rows)\n");
+    printf("  --page-cmds BUS     Prefix every page with page/column address commands for direct DMA\n");
+    printf("                      BUS: i2c (0x80 per command / 0x40 data control bytes), spi (no control bytes)\n");
     printf("  -h, --horizontal    Scan horizontally (rows) (default)\n");
     printf("  -v, --vertical      Scan vertically (columns)\n");
     printf("  -l, --little-endian Little endian pixel order (default)\n");
@@ -60,20 +240,50 @@ void print_usage(const char* program_name) {
     printf("  -p, --progmem       Add PROGMEM keyword to C arrays\n");
     printf("  -n, --name NAME     Set array name (default: image_data)\n");
     printf("  --bmp               Generate BMP preview\n");
+    printf("  --out FMT:PATH      Write an output target (repeatable): c, raw, asm, masm, bin, preview\n");
     printf("  -i, --invert        Invert bits (swap 0 and 1)\n");
-    printf("  --palette VARIANT   Palette variant for 1bpp (bw, gray, green, portfolio, oled_yellow, custom)\n");
-    printf("  --palette4bpp VAR   Palette variant for 4bpp (bw, gray, green, portfolio, oled_yellow, custom)\n");
+    printf("  --palette VARIANT   Palette variant for 1bpp (bw, gray, green, portfolio, oled_yellow, custom, all)\n");
+    printf("  --palette4bpp VAR   Palette variant for 2/4/8bpp (bw, gray, green, portfolio, oled_yellow, custom, all)\n");
     printf("  -cf, --color_first_in_ramp (r,g,b)  First color in custom ramp (8-bit values)\n");
     printf("  -cl, --color_last_in_ramp (r,g,b)   Last color in custom ramp (8-bit values)\n");
     printf("\n");
-    printf("Dithering options (only for 1bpp):\n");
+    printf("Dithering options (only for 1bpp, 2bpp, 4bpp and --color, per channel):\n");
     printf("  -d, --dither METHOD Floyd-Steinberg dithering (default for 1bpp)\n");
-    printf("                      METHODS: floyd, o8x8, none\n");
+    printf("                      METHODS: floyd, blue, none,\n");
+    printf("                               o2x2, o4x4, o8x8, o16x16 (Bayer),\n");
+    printf("                               c4x4, c8x8 (cluster-dot)\n");
     printf("\n");
-    printf("Image adjustment options (only for 1bpp):\n");
+    printf("Image adjustment options (only for 1bpp, 2bpp and 4bpp):\n");
     printf("  -br, --brightness PERC Brightness 0-100%% (default: 50%%)\n");
     printf("  -ct, --contrast PERC   Contrast 0-100%% (default: 50%%)\n");
+    printf("  --sweep-br A:B:STEP    Convert once per brightness A..B (one output set per value)\n");
+    printf("  --sweep-ct A:B:STEP    Convert once per contrast A..B (combined with --sweep-br)\n");
+    printf("\n");
+    printf("Region options (grayscale output):\n");
+    printf("  --crop X,Y,W,H[:NAME] Convert only this region; BMP input reads just its rows (repeatable,\n");
+    printf("                      several crops write one output set each, suffixed with NAME or cropN)\n");
+    printf("  --dedup             Write a repeated crop's C/assembler array as an alias of the first crop\n");
+    printf("                      with identical data (its file must be linked into the same program)\n");
     printf("\n");
+    printf("Orientation options (grayscale output and --layout, applied while packing):\n");
+    printf("  --rotate DEG        Rotate the output clockwise: 0, 90, 180 or 270 (panel mounted sideways)\n");
+    printf("  --flip h|v          Mirror the output after rotation: h = left-right, v = top-bottom\n");
+    printf("\n");
+    printf("Resize options (grayscale output, resampled while the input is read):\n");
+    printf("  --resize WxH        Resample to the display size, e.g. 128x64 (0 = keep aspect ratio, e.g. 296x0)\n");
+    printf("  --resize-filter F   Resize filter: bilinear (default), box (area average), lanczos (Lanczos-3)\n");
+    printf("\n");
+    printf("Manifest options:\n");
+    printf("  --manifest          INPUT_FILE is an INI manifest listing assets with per-asset options;\n");
+    printf("                      all assets are converted in parallel into one OUTPUT_FILE with\n");
+    printf("                      an asset index enum and table (formats: c, asm, masm), or into\n");
+    printf("                      an aligned binary pack with an index table (format = bin)\n");
+    printf("  --no-dedup          Write full data for manifest assets with identical data (like dedup = off)\n");
+    printf("\n");
+    printf("  --max-mem SIZE      Memory budget (e.g. 512M, 2G); larger images are processed\n");
+    printf("                      in horizontal bands read directly from the file\n");
+    printf("  --stats             Print per-stage timing and peak memory as a table\n");
+    printf("  --stats-json        Print per-stage timing and peak memory as JSON\n");
     printf("  --help              Show this help message\n");
     printf("\n");
     printf("If OUTPUT_FILE is not specified, defaults to 'image_data.h'.\n");
@@ -82,13 +292,25 @@ void print_usage(const char* program_name) {
     printf("  %s image.bmp                    # 4bpp conversion\n", program_name);
     printf("  %s -1 image.bmp                 # 1bpp with Floyd-Steinberg\n", program_name);
     printf("  %s -1 -d o8x8 image.bmp         # 1bpp with ordered dithering\n", program_name);
+    printf("  %s -1 -d blue image.bmp         # 1bpp with blue-noise dithering\n", program_name);
     printf("  %s -1 -d none image.bmp         # 1bpp without dithering\n", program_name);
+    printf("  %s -2 -d floyd image.bmp        # 2bpp (4 grays) with Floyd-Steinberg\n", program_name);
+    printf("  %s -4 -d o4x4 image.bmp         # 4bpp (16 grays) with ordered dithering\n", program_name);
+    printf("  %s --color rgb565be -d floyd image.bmp # RGB565 for SPI TFT, dithered\n", program_name);
+    printf("  %s --color indexed --kmeans 4 image.bmp # 16-color palette + 4bpp indices\n", program_name);
+    printf("  %s -1 --layout ssd1306 --page-cmds i2c --out bin:oled.bin image.bmp\n", program_name);
+    printf("  %s -1 --resize 128x64 --resize-filter lanczos photo.png oled.h\n", program_name);
+    printf("  %s -1 --crop 0,0,16,16:idle --crop 16,0,16,16:run sheet.bmp sprites.h\n", program_name);
+    printf("  %s -1 --layout ssd1306 --rotate 90 portrait.bmp oled.h\n", program_name);
     printf("  %s -c -p image.bmp output.h\n", program_name);
     printf("  %s -r image.bmp data.hex\n", program_name);
     printf("  %s -a image.bmp data.inc\n", program_name);
     printf("  %s -aa image.bmp data.inc\n", program_name);
     printf("  %s -n my_image -p image.bmp\n", program_name);
     printf("  %s -n sprite_data -v -a image.bmp sprite.inc\n", program_name);
+    printf("  %s --out c:img.h --out bin:img.bin --out preview:img.bmp image.bmp\n", program_name);
+    printf("  %s --manifest assets.ini assets.h\n", program_name);
+    printf("  %s -1 -d floyd --sweep-br 0:100:10 --sweep-ct 0:100:10 --bmp image.bmp preview/\n", program_name);
 }
 
 /**
@@ -128,12 +350,53 @@ int parse_arguments(int argc, char* argv[], ConversionContext* context, char** i
     *output_file = "image_data.h"; // Zostanie zaktualizowane na podstawie formatu
     
     for (int i = 1; i < argc; i++) {
-        if (argv[i][0] == '-') {
+        if (argv[i][0] == '-' && !is_stdio_path(argv[i])) {
             // Obsługa opcji
             if (strcmp(argv[i], "-4") == 0 || strcmp(argv[i], "--4bpp") == 0) {
                 context->bits_per_pixel = BITS_PER_PIXEL_4BPP;
             } else if (strcmp(argv[i], "-1") == 0 || strcmp(argv[i], "--1bpp") == 0) {
                 context->bits_per_pixel = BITS_PER_PIXEL_1BPP;
+            } else if (strcmp(argv[i], "-2") == 0 || strcmp(argv[i], "--2bpp") == 0) {
+                context->bits_per_pixel = BITS_PER_PIXEL_2BPP;
+            } else if (strcmp(argv[i], "-8") == 0 || strcmp(argv[i], "--8bpp") == 0) {
+                context->bits_per_pixel = BITS_PER_PIXEL_8BPP;
+            } else if (strcmp(argv[i], "--color") == 0) {
+                if (i + 1 < argc) {
+                    int color_format = parse_color_format(argv[i + 1]);
+                    if (color_format < 0) {
+                        fprintf(stderr, "Error: Unknown color format '%s'. Use: rgb565, rgb565le, rgb565be, rgb332, rgb444, indexed\n", argv[i + 1]);
+                        return 0;
+                    }
+                    context->color_format = color_format;
+                    i++; // Pomiń następny argument, bo to format koloru
+                } else {
+                    fprintf(stderr, "Error: --color requires an argument (rgb565, rgb565le, rgb565be, rgb332, rgb444, indexed)\n");
+                    return 0;
+                }
+            } else if (strcmp(argv[i], "--layout") == 0) {
+                if (i + 1 < argc) {
+                    int display_layout = parse_display_layout(argv[i + 1]);
+                    if (display_layout < 0) {
+                        fprintf(stderr, "Error: Unknown display layout '%s'. Use: ssd1306, sh1106, st7565, uc8151\n", argv[i + 1]);
+                        return 0;
+                    }
+                    context->display_layout = display_layout;
+                    i++; // Pomiń następny argument, bo to układ sterownika
+                } else {
+                    fprintf(stderr, "Error: --layout requires an argument (ssd1306, sh1106, st7565, uc8151)\n");
+                    return 0;
+                }
+            } else if (strcmp(argv[i], "--page-cmds") == 0) {
+                if (i + 1 < argc && strcmp(argv[i + 1], "i2c") == 0) {
+                    context->page_commands = PAGE_COMMANDS_I2C;
+                    i++; // Pomiń następny argument, bo to rodzaj magistrali
+                } else if (i + 1 < argc && strcmp(argv[i + 1], "spi") == 0) {
+                    context->page_commands = PAGE_COMMANDS_SPI;
+                    i++;
+                } else {
+                    fprintf(stderr, "Error: --page-cmds requires an argument (i2c or spi)\n");
+                    return 0;
+                }
             } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--horizontal") == 0) {
                 context->scan_direction = 1;
             } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--vertical") == 0) {
@@ -158,50 +421,46 @@ int parse_arguments(int argc, char* argv[], ConversionContext* context, char** i
                     context->array_name[sizeof(context->array_name) - 1] = '\0';
                     i++; // Pomiń następny argument, bo to nazwa tablicy
                 } else {
-                    printf("Error: --name requires an argument\n");
+                    fprintf(stderr, "Error: --name requires an argument\n");
                     return 0;
                 }
             } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dither") == 0) {
                 if (i + 1 < argc) {
-                    if (strcmp(argv[i + 1], "floyd") == 0) {
-                        context->dithering_method = DITHERING_FLOYD;
-                    } else if (strcmp(argv[i + 1], "o8x8") == 0) {
-                        context->dithering_method = DITHERING_ORDERED;
-                    } else if (strcmp(argv[i + 1], "none") == 0) {
-                        context->dithering_method = DITHERING_NONE;
-                    } else {
-                        printf("Error: Invalid dithering method '%s'. Use: floyd, o8x8, or none\n", argv[i + 1]);
+                    int dithering_method = parse_dithering_method(argv[i + 1]);
+                    if (dithering_method < 0) {
+                        fprintf(stderr, "Error: Invalid dithering method '%s'. Use: floyd, o2x2, o4x4, o8x8, o16x16, c4x4, c8x8, blue, or none\n", argv[i + 1]);
                         return 0;
                     }
+                    context->dithering_method = dithering_method;
                     i++; // Pomiń następny argument, bo to metoda ditheringu
                 } else {
-                    printf("Error: -d/--dither requires an argument (floyd, o8x8, or none)\n");
+                    fprintf(stderr, "Error: -d/--dither requires an argument (floyd, o2x2, o4x4, o8x8, o16x16, c4x4, c8x8, blue, or none)\n");
                     return 0;
                 }
             } else if (strcmp(argv[i], "-br") == 0 || strcmp(argv[i], "--brightness") == 0) {
                 if (i + 1 < argc) {
                     int brightness = atoi(argv[i + 1]);
                     if (brightness < 0 || brightness > 100) {
-                        printf("Error: Brightness must be between 0 and 100\n");
+                        fprintf(stderr, "Error: Brightness must be between 0 and 100\n");
                         return 0;
                     }
                     context->brightness = brightness;
                     i++; // Pomiń następny argument, bo to wartość jasności
                 } else {
-                    printf("Error: -br/--brightness requires an argument (0-100)\n");
+                    fprintf(stderr, "Error: -br/--brightness requires an argument (0-100)\n");
                     return 0;
                 }
             } else if (strcmp(argv[i], "-ct") == 0 || strcmp(argv[i], "--contrast") == 0) {
                 if (i + 1 < argc) {
                     int contrast = atoi(argv[i + 1]);
                     if (contrast < 0 || contrast > 100) {
-                        printf("Error: Contrast must be between 0 and 100\n");
+                        fprintf(stderr, "Error: Contrast must be between 0 and 100\n");
                         return 0;
                     }
                     context->contrast = contrast;
                     i++; // Pomiń następny argument, bo to wartość kontrastu
                 } else {
-                    printf("Error: -ct/--contrast requires an argument (0-100)\n");
+                    fprintf(stderr, "Error: -ct/--contrast requires an argument (0-100)\n");
                     return 0;
                 }
         } else if (strcmp(argv[i], "--bmp") == 0) {
@@ -223,12 +482,14 @@ int parse_arguments(int argc, char* argv[], ConversionContext* context, char** i
                     context->palette_variant = 4; // PALETTE_OLED_YELLOW
                 } else if (strcmp(argv[i], "custom") == 0) {
                     context->palette_variant = 5; // PALETTE_CUSTOM
+                } else if (strcmp(argv[i], "all") == 0) {
+                    context->palette_variant = 6; // PALETTE_ALL
                 } else {
-                    printf("Error: Unknown palette variant '%s'. Use: bw, gray, green, portfolio, oled_yellow, custom\n", argv[i]);
+                    fprintf(stderr, "Error: Unknown palette variant '%s'. Use: bw, gray, green, portfolio, oled_yellow, custom, all\n", argv[i]);
                     return 0;
                 }
             } else {
-                printf("Error: --palette requires an argument (bw, gray, green, portfolio, oled_yellow)\n");
+                fprintf(stderr, "Error: --palette requires an argument (bw, gray, green, portfolio, oled_yellow)\n");
                 return 0;
             }
         } else if (strcmp(argv[i], "--palette4bpp") == 0) {
@@ -246,40 +507,168 @@ int parse_arguments(int argc, char* argv[], ConversionContext* context, char** i
                     context->palette_4bpp_variant = 4; // PALETTE_OLED_YELLOW
                 } else if (strcmp(argv[i], "custom") == 0) {
                     context->palette_4bpp_variant = 5; // PALETTE_CUSTOM
+                } else if (strcmp(argv[i], "all") == 0) {
+                    context->palette_4bpp_variant = 6; // PALETTE_ALL
                 } else {
-                    printf("Error: Unknown 4bpp palette variant '%s'. Use: bw, gray, green, portfolio, oled_yellow, custom\n", argv[i]);
+                    fprintf(stderr, "Error: Unknown 4bpp palette variant '%s'. Use: bw, gray, green, portfolio, oled_yellow, custom, all\n", argv[i]);
                     return 0;
                 }
             } else {
-                printf("Error: --palette4bpp requires an argument (bw, gray, green, portfolio, oled_yellow)\n");
+                fprintf(stderr, "Error: --palette4bpp requires an argument (bw, gray, green, portfolio, oled_yellow)\n");
                 return 0;
             }
         } else if (strcmp(argv[i], "-cf") == 0 || strcmp(argv[i], "--color_first_in_ramp") == 0) {
             if (i + 1 < argc) {
                 i++; // Pomiń następny argument, bo to kolor
                 if (sscanf(argv[i], "(%hhu,%hhu,%hhu)", &context->custom_color_first[2], &context->custom_color_first[1], &context->custom_color_first[0]) != 3) {
-                    printf("Error: Invalid color format '%s'. Use: (r,g,b) where r,g,b are 0-255\n", argv[i]);
+                    fprintf(stderr, "Error: Invalid color format '%s'. Use: (r,g,b) where r,g,b are 0-255\n", argv[i]);
                     return 0;
                 }
             } else {
-                printf("Error: -cf requires a color argument in format (r,g,b)\n");
+                fprintf(stderr, "Error: -cf requires a color argument in format (r,g,b)\n");
                 return 0;
             }
         } else if (strcmp(argv[i], "-cl") == 0 || strcmp(argv[i], "--color_last_in_ramp") == 0) {
             if (i + 1 < argc) {
                 i++; // Pomiń następny argument, bo to kolor
                 if (sscanf(argv[i], "(%hhu,%hhu,%hhu)", &context->custom_color_last[2], &context->custom_color_last[1], &context->custom_color_last[0]) != 3) {
-                    printf("Error: Invalid color format '%s'. Use: (r,g,b) where r,g,b are 0-255\n", argv[i]);
+                    fprintf(stderr, "Error: Invalid color format '%s'. Use: (r,g,b) where r,g,b are 0-255\n", argv[i]);
                     return 0;
                 }
             } else {
-                printf("Error: -cl requires a color argument in format (r,g,b)\n");
+                fprintf(stderr, "Error: -cl requires a color argument in format (r,g,b)\n");
                 return 0;
             }
+        } else if (strcmp(argv[i], "--out") == 0) {
+            if (i + 1 < argc) {
+                i++; // Pomiń następny argument, bo to cel wyjściowy
+                if (context->output_count >= MAX_OUTPUT_TARGETS) {
+                    fprintf(stderr, "Error: Too many --out targets (maximum %d)\n", MAX_OUTPUT_TARGETS);
+                    return 0;
+                }
+                if (!parse_output_target(argv[i], &context->outputs[context->output_count])) {
+                    return 0;
+                }
+                context->output_count++;
+            } else {
+                fprintf(stderr, "Error: --out requires an argument (FORMAT:PATH)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--sweep-br") == 0 || strcmp(argv[i], "--sweep-ct") == 0) {
+            if (i + 1 < argc) {
+                SweepRange* range = (argv[i][8] == 'b') ? &context->sweep_brightness : &context->sweep_contrast;
+                if (!parse_sweep_range(argv[i + 1], argv[i], range)) {
+                    return 0;
+                }
+                i++; // Pomiń następny argument, bo to zakres przeglądu
+            } else {
+                fprintf(stderr, "Error: %s requires an argument (FIRST:LAST:STEP)\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--crop") == 0) {
+            if (i + 1 < argc) {
+                if (context->crop_count >= MAX_CROP_REGIONS) {
+                    fprintf(stderr, "Error: Too many --crop regions (max %d)\n", MAX_CROP_REGIONS);
+                    return 0;
+                }
+                if (!parse_crop_rect(argv[i + 1], &context->crops[context->crop_count])) {
+                    return 0;
+                }
+                context->crop_count++;
+                i++; // Pomiń następny argument, bo to wycinek
+            } else {
+                fprintf(stderr, "Error: --crop requires an argument (X,Y,WIDTH,HEIGHT[:NAME])\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--rotate") == 0) {
+            if (i + 1 < argc) {
+                const char* angle = argv[i + 1];
+                if (strcmp(angle, "0") != 0 && strcmp(angle, "90") != 0 && strcmp(angle, "180") != 0 && strcmp(angle, "270") != 0) {
+                    fprintf(stderr, "Error: Invalid --rotate angle '%s'. Use: 0, 90, 180, 270\n", angle);
+                    return 0;
+                }
+                context->rotation = atoi(angle);
+                i++; // Pomiń następny argument, bo to kąt obrotu
+            } else {
+                fprintf(stderr, "Error: --rotate requires an argument (0, 90, 180, 270)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--flip") == 0) {
+            if (i + 1 < argc) {
+                if (strcmp(argv[i + 1], "h") == 0) {
+                    context->flip |= FLIP_HORIZONTAL;
+                } else if (strcmp(argv[i + 1], "v") == 0) {
+                    context->flip |= FLIP_VERTICAL;
+                } else {
+                    fprintf(stderr, "Error: Invalid --flip axis '%s'. Use: h, v\n", argv[i + 1]);
+                    return 0;
+                }
+                i++; // Pomiń następny argument, bo to oś odbicia
+            } else {
+                fprintf(stderr, "Error: --flip requires an argument (h, v)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--resize") == 0) {
+            if (i + 1 < argc) {
+                if (!parse_resize_size(argv[i + 1], context)) {
+                    return 0;
+                }
+                i++; // Pomiń następny argument, bo to rozmiar docelowy
+            } else {
+                fprintf(stderr, "Error: --resize requires an argument (WIDTHxHEIGHT)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--resize-filter") == 0) {
+            if (i + 1 < argc) {
+                int filter = parse_resize_filter(argv[i + 1]);
+                if (filter < 0) {
+                    fprintf(stderr, "Error: Unknown resize filter '%s'. Use: box, bilinear, lanczos\n", argv[i + 1]);
+                    return 0;
+                }
+                context->resize_filter = filter;
+                i++; // Pomiń następny argument, bo to nazwa filtra
+            } else {
+                fprintf(stderr, "Error: --resize-filter requires an argument (box, bilinear, lanczos)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--max-mem") == 0) {
+            if (i + 1 < argc) {
+                if (!parse_memory_size(argv[i + 1], &context->max_memory)) {
+                    return 0;
+                }
+                i++; // Pomiń następny argument, bo to rozmiar pamięci
+            } else {
+                fprintf(stderr, "Error: --max-mem requires an argument (SIZE)\n");
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--kmeans") == 0) {
+            if (i + 1 < argc) {
+                char* end;
+                long iterations = strtol(argv[i + 1], &end, 10);
+                if (*argv[i + 1] == '\0' || *end != '\0' || iterations < 0 || iterations > MAX_KMEANS_ITERATIONS) {
+                    fprintf(stderr, "Error: Invalid k-means pass count '%s'. Use: 0-%d\n", argv[i + 1], MAX_KMEANS_ITERATIONS);
+                    return 0;
+                }
+                context->kmeans_iterations = (int)iterations;
+                i++; // Pomiń następny argument, bo to liczba przebiegów k-means
+            } else {
+                fprintf(stderr, "Error: --kmeans requires an argument (0-%d)\n", MAX_KMEANS_ITERATIONS);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--manifest") == 0) {
+            context->manifest = 1;
+        } else if (strcmp(argv[i], "--dedup") == 0) {
+            context->dedup_crops = 1;
+        } else if (strcmp(argv[i], "--no-dedup") == 0) {
+            context->keep_duplicates = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            context->stats_output = STATS_OUTPUT_TABLE;
+        } else if (strcmp(argv[i], "--stats-json") == 0) {
+            context->stats_output = STATS_OUTPUT_JSON;
         } else if (strcmp(argv[i], "--help") == 0) {
                 return 0; // Pokaże pomoc
             } else {
-                printf("Error: Unknown option '%s'\n", argv[i]);
+                fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
                 return 0;
             }
         } else {
@@ -289,16 +678,117 @@ int parse_arguments(int argc, char* argv[], ConversionContext* context, char** i
             } else if (strcmp(*output_file, "image_data.h") == 0) {
                 *output_file = argv[i];
             } else {
-                printf("Error: Too many file arguments\n");
+                fprintf(stderr, "Error: Too many file arguments\n");
                 return 0;
             }
         }
     }
     
     if (*input_file == NULL) {
-        printf("Error: No input file specified\n");
+        fprintf(stderr, "Error: No input file specified\n");
+        return 0;
+    }
+    
+    if ((context->sweep_brightness.step || context->sweep_contrast.step) && context->color_format != COLOR_FORMAT_NONE) {
+        fprintf(stderr, "Error: --sweep-br/--sweep-ct cannot be combined with --color\n");
         return 0;
     }
     
+    if ((context->resize_width || context->resize_height) && context->color_format != COLOR_FORMAT_NONE) {
+        fprintf(stderr, "Error: --resize cannot be combined with --color\n");
+        return 0;
+    }
+    
+    if (context->crop_count > 0 && context->color_format != COLOR_FORMAT_NONE) {
+        fprintf(stderr, "Error: --crop cannot be combined with --color\n");
+        return 0;
+    }
+    
+    if ((context->rotation || context->flip) && context->color_format != COLOR_FORMAT_NONE) {
+        fprintf(stderr, "Error: --rotate/--flip cannot be combined with --color\n");
+        return 0;
+    }
+    
+    if (context->display_layout != DISPLAY_LAYOUT_NONE && (context->bits_per_pixel != BITS_PER_PIXEL_1BPP || context->color_format != COLOR_FORMAT_NONE)) {
+        fprintf(stderr, "Error: --layout requires 1bpp mode (-1)\n");
+        return 0;
+    }
+    
+    if (context->page_commands != PAGE_COMMANDS_NONE && !display_layout_has_pages(context->display_layout)) {
+        fprintf(stderr, "Error: --page-cmds requires a page layout (--layout ssd1306, sh1106 or st7565)\n");
+        return 0;
+    }
+    
+    if (context->color_format == COLOR_FORMAT_INDEXED && context->dithering_method != DITHERING_NONE) {
+        fprintf(stderr, "Error: Dithering is not supported with --color indexed\n");
+        return 0;
+    }
+    
+    if ((context->sweep_brightness.step || context->sweep_contrast.step) && !BPP_IS_DITHERED(context->bits_per_pixel)) {
+        fprintf(stderr, "Error: --sweep-br/--sweep-ct require 1bpp, 2bpp or 4bpp mode (-1, -2, -4)\n");
+        return 0;
+    }
+    
+    if (context->manifest && (context->output_count > 0 || context->generate_bmp || context->crop_count > 1 ||
+                              context->sweep_brightness.step || context->sweep_contrast.step)) {
+        fprintf(stderr, "Error: --manifest writes one combined output and cannot be combined with --out, --bmp, --sweep-br/--sweep-ct or several --crop\n");
+        return 0;
+    }
+    
+    if (context->output_count > 0 && strcmp(*output_file, "image_data.h") != 0) {
+        fprintf(stderr, "Error: OUTPUT_FILE cannot be combined with --out\n");
+        return 0;
+    }
+    
+    // "-" = stdout: tylko jeden cel i bez ścieżek wyprowadzanych z nazwy pliku
+    int stdout_targets = count_stdout_targets(context, *output_file);
+    if (stdout_targets > 1) {
+        fprintf(stderr, "Error: Only one output target can be written to stdout ('-')\n");
+        return 0;
+    }
+    if (stdout_targets > 0) {
+        const char* first_path = (context->output_count > 0) ? context->outputs[0].path : *output_file;
+        int palette = (context->bits_per_pixel == BITS_PER_PIXEL_1BPP) ? context->palette_variant : context->palette_4bpp_variant;
+        if (context->generate_bmp && is_stdio_path(first_path)) {
+            fprintf(stderr, "Error: --bmp cannot derive a preview path from stdout, use --out preview:PATH\n");
+            return 0;
+        }
+        if (context->sweep_brightness.step || context->sweep_contrast.step) {
+            fprintf(stderr, "Error: --sweep-br/--sweep-ct write one output per combination and cannot use stdout\n");
+            return 0;
+        }
+        if (palette == PALETTE_ALL && context->color_format == COLOR_FORMAT_NONE) {
+            for (int i = 0; i < context->output_count; i++) {
+                if (context->outputs[i].format == FORMAT_BMP_PREVIEW && is_stdio_path(context->outputs[i].path)) {
+                    fprintf(stderr, "Error: --palette all writes one preview per palette and cannot use stdout\n");
+                    return 0;
+                }
+            }
+        }
+    }
+    
     return 1;
 }
+
+/**
+ * @brief Liczy cele wyjściowe zapisywane na stdout ("-")
+ * 
+ * @details W trybie klasycznym sprawdzany jest plik wyjściowy, z opcją
+ * --out wszystkie podane cele. Dodatni wynik oznacza, że komunikaty
+ * programu trzeba przenieść na stderr (redirect_console_to_stderr()).
+ * 
+ * @param context Kontekst konwersji po parse_arguments()
+ * @param output_file Plik wyjściowy trybu klasycznego
+ * 
+ * @return Liczba celów ze ścieżką "-"
+ */
+int count_stdout_targets(ConversionContext* context, const char* output_file) {
+    if (context->output_count == 0) {
+        return is_stdio_path(output_file);
+    }
+    int count = 0;
+    for (int i = 0; i < context->output_count; i++) {
+        count += is_stdio_path(context->outputs[i].path);
+    }
+    return count;
+}
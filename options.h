@@ -18,5 +18,6 @@
 // Prototypy funkcji obsługi argumentów
 void print_usage(const char* program_name);
 int parse_arguments(int argc, char* argv[], ConversionContext* context, char** input_file, char** output_file);
+int count_stdout_targets(ConversionContext* context, const char* output_file);
 
 #endif
@@ -0,0 +1,416 @@
+/*****************************************************************************
+
+    plik  : png_reader.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : odczyt plików PNG wiersz po wierszu - dane IDAT są dekompresowane
+            strumieniowo (inflate.c), a każdy wiersz od razu odfiltrowywany
+            i konwertowany do skali szarości
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "png_reader.h"
+#include "inflate.h"
+#include "utils.h"
+#include "stats.h"
+
+static const uchar png_signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+// Stan dekodera przekazywany do funkcji odczytu i zapisu zlib_inflate_stream()
+typedef struct {
+    FILE* file;
+    PngInfo* info;
+    dword chunk_remaining;     // Bajty pozostałe w bieżącym chunku IDAT
+    int idat_end;              // 1 = za ostatnim IDAT
+    size_t row_size;           // Bajty wiersza bez bajtu filtra
+    int pixel_bytes;           // Odległość filtra: bajty pełnego piksela (co najmniej 1)
+    uchar* current_row;        // Bajt filtra + dane bieżącego wiersza
+    uchar* previous_row;       // Odfiltrowany poprzedni wiersz (zera przed pierwszym)
+    size_t row_filled;         // Bajty bieżącego wiersza już otrzymane
+    int y;                     // Numer bieżącego wiersza
+    uchar* gray_row;           // Wiersz w skali szarości przekazywany dalej
+    ImageRowCallback row_callback;
+    void* callback_arg;
+} PngDecoder;
+
+// Liczba próbek na piksel dla typów koloru 0..6
+static const int png_channels[7] = {1, 0, 3, 1, 2, 0, 4};
+
+static dword read_be32(const uchar* data) {
+    return ((dword)data[0] << 24) | ((dword)data[1] << 16) | ((dword)data[2] << 8) | data[3];
+}
+
+// Pomija bajty czytając je (bez fseek)
+static int skip_png_bytes(FILE* file, dword count) {
+    uchar scratch[256];
+    while (count > 0) {
+        size_t part = (count < sizeof(scratch)) ? count : sizeof(scratch);
+        if (fread(scratch, 1, part, file) != part) {
+            return 0;
+        }
+        count -= (dword)part;
+    }
+    return 1;
+}
+
+// Czyta nagłówek chunka: długość i typ
+static int read_chunk_header(FILE* file, dword* length, uchar type[4]) {
+    uchar header[8];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        return 0;
+    }
+    *length = read_be32(header);
+    memcpy(type, header + 4, 4);
+    return *length <= 0x7FFFFFFF;
+}
+
+/**
+ * @brief Odczytuje sygnaturę i nagłówek IHDR pliku PNG
+ *
+ * @details Sprawdza sygnaturę, wymiary i dopuszczalne połączenia typu
+ * koloru z głębią bitową. Plik zostaje ustawiony za chunkiem IHDR -
+ * paletę i dane obrazu czyta decode_png_rows().
+ *
+ * @param file Wskaźnik do otwartego pliku (pozycja na początku)
+ * @param info Informacje o obrazie (wyjściowe)
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy plik nie jest poprawnym PNG
+ *
+ * @example
+ * ```c
+ * PngInfo info;
+ * if (read_png_header(file, &info) && !info.interlace) {
+ *     decode_png_rows(file, &info, store_row, &frame);
+ * }
+ * ```
+ */
+int read_png_header(FILE* file, PngInfo* info) {
+    uchar signature[8];
+    uchar type[4];
+    uchar ihdr[13];
+    dword length;
+
+    if (fread(signature, 1, sizeof(signature), file) != sizeof(signature) || memcmp(signature, png_signature, sizeof(signature)) != 0) {
+        return 0;
+    }
+    if (!read_chunk_header(file, &length, type) || length != sizeof(ihdr) || memcmp(type, "IHDR", 4) != 0) {
+        return 0;
+    }
+    // Suma CRC chunka jest pomijana
+    if (fread(ihdr, 1, sizeof(ihdr), file) != sizeof(ihdr) || !skip_png_bytes(file, 4)) {
+        return 0;
+    }
+
+    dword width = read_be32(ihdr);
+    dword height = read_be32(ihdr + 4);
+    info->bit_depth = ihdr[8];
+    info->color_type = ihdr[9];
+    info->interlace = ihdr[12];
+    if (width == 0 || height == 0 || width > 0x7FFFFFFF || height > 0x7FFFFFFF) {
+        return 0;
+    }
+    info->width = (int)width;
+    info->height = (int)height;
+    memset(info->gray_palette, 0, sizeof(info->gray_palette));
+
+    // Kompresja i filtrowanie mają w PNG tylko metodę 0
+    if (ihdr[10] != 0 || ihdr[11] != 0 || info->interlace > 1) {
+        return 0;
+    }
+    switch (info->color_type) {
+        case PNG_COLOR_GRAY:
+            return info->bit_depth == 1 || info->bit_depth == 2 || info->bit_depth == 4 || info->bit_depth == 8 || info->bit_depth == 16;
+        case PNG_COLOR_PALETTE:
+            return info->bit_depth == 1 || info->bit_depth == 2 || info->bit_depth == 4 || info->bit_depth == 8;
+        case PNG_COLOR_RGB:
+        case PNG_COLOR_GRAY_ALPHA:
+        case PNG_COLOR_RGBA:
+            return info->bit_depth == 8 || info->bit_depth == 16;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Oblicza rozmiar wiersza PNG w bajtach (bez bajtu filtra)
+ *
+ * @param info Informacje z read_png_header()
+ *
+ * @return Rozmiar wiersza lub 0 przy przepełnieniu
+ */
+size_t calculate_png_row_size(PngInfo* info) {
+    size_t bits;
+    if (!size_multiply((size_t)info->width, (size_t)png_channels[info->color_type] * info->bit_depth, &bits)) {
+        return 0;
+    }
+    return (bits + 7) / 8;
+}
+
+/**
+ * @brief Oblicza pamięć zajmowaną przez decode_png_rows()
+ *
+ * @details Stała niezależnie od wysokości obrazu: dwa wiersze PNG z bajtem
+ * filtra, wiersz skali szarości i stan inflate. Używana przy wyznaczaniu
+ * wysokości pasma dla --max-mem.
+ *
+ * @param info Informacje z read_png_header()
+ *
+ * @return Rozmiar w bajtach
+ */
+size_t calculate_png_decoder_memory(PngInfo* info) {
+    return 2 * (calculate_png_row_size(info) + 1) + (size_t)info->width + zlib_inflate_memory();
+}
+
+/**
+ * @brief Zwraca nazwę typu koloru PNG do wyświetlenia
+ *
+ * @param color_type PNG_COLOR_*
+ *
+ * @return Nazwa typu koloru
+ */
+const char* png_color_type_name(int color_type) {
+    switch (color_type) {
+        case PNG_COLOR_GRAY:       return "grayscale";
+        case PNG_COLOR_RGB:        return "RGB";
+        case PNG_COLOR_PALETTE:    return "indexed";
+        case PNG_COLOR_GRAY_ALPHA: return "grayscale+alpha";
+        case PNG_COLOR_RGBA:       return "RGBA";
+        default:                   return "unknown";
+    }
+}
+
+// Predyktor Paetha (PNG, filtr 4)
+static int paeth_predictor(int left, int above, int upper_left) {
+    int estimate = left + above - upper_left;
+    int distance_left = estimate > left ? estimate - left : left - estimate;
+    int distance_above = estimate > above ? estimate - above : above - estimate;
+    int distance_upper_left = estimate > upper_left ? estimate - upper_left : upper_left - estimate;
+    if (distance_left <= distance_above && distance_left <= distance_upper_left) {
+        return left;
+    }
+    return (distance_above <= distance_upper_left) ? above : upper_left;
+}
+
+// Odwraca filtr wiersza w miejscu; prior to odfiltrowany poprzedni wiersz
+static int unfilter_png_row(uchar* row, const uchar* prior, size_t length, int filter, int pixel_bytes) {
+    size_t i;
+    switch (filter) {
+        case 0: // None
+            break;
+        case 1: // Sub
+            for (i = pixel_bytes; i < length; i++) {
+                row[i] = (uchar)(row[i] + row[i - pixel_bytes]);
+            }
+            break;
+        case 2: // Up
+            for (i = 0; i < length; i++) {
+                row[i] = (uchar)(row[i] + prior[i]);
+            }
+            break;
+        case 3: // Average
+            for (i = 0; i < (size_t)pixel_bytes && i < length; i++) {
+                row[i] = (uchar)(row[i] + (prior[i] >> 1));
+            }
+            for (; i < length; i++) {
+                row[i] = (uchar)(row[i] + ((row[i - pixel_bytes] + prior[i]) >> 1));
+            }
+            break;
+        case 4: // Paeth
+            for (i = 0; i < (size_t)pixel_bytes && i < length; i++) {
+                row[i] = (uchar)(row[i] + prior[i]);
+            }
+            for (; i < length; i++) {
+                row[i] = (uchar)(row[i] + paeth_predictor(row[i - pixel_bytes], prior[i], prior[i - pixel_bytes]));
+            }
+            break;
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+// Konwertuje odfiltrowany wiersz do skali szarości 0-255 (kanał alfa jest pomijany,
+// z próbek 16-bitowych brany jest starszy bajt)
+static void convert_png_row(const uchar* row, uchar* gray_row, PngInfo* info) {
+    int width = info->width;
+    int depth = info->bit_depth;
+
+    if (depth < 8) {
+        int mask = (1 << depth) - 1;
+        for (int x = 0; x < width; x++) {
+            size_t bit = (size_t)x * depth;
+            int value = (row[bit >> 3] >> (8 - depth - (int)(bit & 7))) & mask;
+            gray_row[x] = (info->color_type == PNG_COLOR_PALETTE) ? info->gray_palette[value] : (uchar)(value * 255 / mask);
+        }
+        return;
+    }
+
+    int sample_bytes = depth / 8;
+    int pixel_bytes = png_channels[info->color_type] * sample_bytes;
+    for (int x = 0; x < width; x++, row += pixel_bytes) {
+        switch (info->color_type) {
+            case PNG_COLOR_RGB:
+            case PNG_COLOR_RGBA:
+                gray_row[x] = (uchar)convert_rgb_to_grayscale(row[0], row[sample_bytes], row[2 * sample_bytes]);
+                break;
+            case PNG_COLOR_PALETTE:
+                gray_row[x] = info->gray_palette[row[0]];
+                break;
+            default:
+                gray_row[x] = row[0];
+                break;
+        }
+    }
+}
+
+// Źródło danych dla inflate: zawartość kolejnych chunków IDAT
+static int read_idat_data(void* arg, uchar* buffer, int size) {
+    PngDecoder* decoder = (PngDecoder*)arg;
+    while (decoder->chunk_remaining == 0) {
+        dword length;
+        uchar type[4];
+        // CRC poprzedniego chunka jest pomijane
+        if (decoder->idat_end || !skip_png_bytes(decoder->file, 4) || !read_chunk_header(decoder->file, &length, type) ||
+            memcmp(type, "IDAT", 4) != 0) {
+            decoder->idat_end = 1;
+            return 0;
+        }
+        decoder->chunk_remaining = length;
+    }
+
+    size_t part = ((dword)size < decoder->chunk_remaining) ? (size_t)size : decoder->chunk_remaining;
+    size_t read = fread(buffer, 1, part, decoder->file);
+    decoder->chunk_remaining -= (dword)read;
+    return (int)read;
+}
+
+// Odbiorca danych z inflate: składa wiersze, odfiltrowuje je i przekazuje dalej
+static int receive_png_scanlines(void* arg, const uchar* data, int size) {
+    PngDecoder* decoder = (PngDecoder*)arg;
+    size_t line_size = decoder->row_size + 1;
+
+    while (size > 0) {
+        if (decoder->y >= decoder->info->height) {
+            return 1; // Nadmiarowe dane za ostatnim wierszem są ignorowane
+        }
+        size_t part = line_size - decoder->row_filled;
+        if ((size_t)size < part) {
+            part = (size_t)size;
+        }
+        memcpy(decoder->current_row + decoder->row_filled, data, part);
+        decoder->row_filled += part;
+        data += part;
+        size -= (int)part;
+        if (decoder->row_filled < line_size) {
+            break;
+        }
+
+        uchar* row = decoder->current_row + 1;
+        if (!unfilter_png_row(row, decoder->previous_row + 1, decoder->row_size, decoder->current_row[0], decoder->pixel_bytes)) {
+            return 0;
+        }
+        convert_png_row(row, decoder->gray_row, decoder->info);
+        if (!decoder->row_callback(decoder->callback_arg, decoder->y, decoder->gray_row)) {
+            return 0;
+        }
+
+        uchar* swap = decoder->previous_row;
+        decoder->previous_row = decoder->current_row;
+        decoder->current_row = swap;
+        decoder->row_filled = 0;
+        decoder->y++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Dekoduje dane obrazu PNG i przekazuje kolejne wiersze w skali szarości
+ *
+ * @details Czyta chunki za IHDR: paleta PLTE jest od razu zamieniana na
+ * tablicę szarości, pozostałe chunki przed IDAT są pomijane. Dane
+ * wszystkich kolejnych chunków IDAT tworzą jeden strumień zlib,
+ * dekompresowany strumieniowo. Każdy złożony wiersz jest odfiltrowywany
+ * (None, Sub, Up, Average, Paeth) względem poprzedniego i konwertowany do
+ * skali szarości - w pamięci są tylko dwa wiersze PNG i okno inflate,
+ * więc dekoder zasila przetwarzanie pasmami tak samo jak odczyt BMP.
+ *
+ * @param file Plik ustawiony za chunkiem IHDR (po read_png_header())
+ * @param info Informacje z read_png_header() (uzupełniana paleta)
+ * @param row_callback Odbiorca wierszy (od góry obrazu)
+ * @param callback_arg Argument przekazywany do row_callback
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy dane są uszkodzone lub urwane,
+ *         brak pamięci lub row_callback przerwał dekodowanie
+ *
+ * @note Obrazy z przeplotem Adam7 nie są obsługiwane (info->interlace)
+ * @note Sumy CRC chunków i Adler-32 strumienia nie są sprawdzane
+ */
+int decode_png_rows(FILE* file, PngInfo* info, ImageRowCallback row_callback, void* callback_arg) {
+    if (info->interlace) {
+        return 0;
+    }
+
+    // Chunki przed danymi obrazu - potrzebna jest tylko paleta
+    dword length;
+    uchar type[4];
+    int has_palette = 0;
+    for (;;) {
+        if (!read_chunk_header(file, &length, type) || memcmp(type, "IEND", 4) == 0) {
+            return 0;
+        }
+        if (memcmp(type, "IDAT", 4) == 0) {
+            break;
+        }
+        if (memcmp(type, "PLTE", 4) == 0 && length % 3 == 0 && length <= 3 * 256) {
+            uchar palette[3 * 256];
+            if (fread(palette, 1, length, file) != length) {
+                return 0;
+            }
+            for (dword i = 0; i < length / 3; i++) {
+                info->gray_palette[i] = (uchar)convert_rgb_to_grayscale(palette[3 * i], palette[3 * i + 1], palette[3 * i + 2]);
+            }
+            has_palette = 1;
+            length = 0;
+        }
+        if (!skip_png_bytes(file, length + 4)) {
+            return 0;
+        }
+    }
+    if (info->color_type == PNG_COLOR_PALETTE && !has_palette) {
+        return 0;
+    }
+
+    PngDecoder decoder;
+    decoder.file = file;
+    decoder.info = info;
+    decoder.chunk_remaining = length;
+    decoder.idat_end = 0;
+    decoder.row_size = calculate_png_row_size(info);
+    decoder.pixel_bytes = (png_channels[info->color_type] * info->bit_depth + 7) / 8;
+    decoder.row_filled = 0;
+    decoder.y = 0;
+    decoder.row_callback = row_callback;
+    decoder.callback_arg = callback_arg;
+    if (decoder.row_size == 0 || decoder.row_size > (size_t)-1 / 2 - 1) {
+        return 0;
+    }
+    decoder.current_row = (uchar*)stats_malloc(decoder.row_size + 1);
+    decoder.previous_row = (uchar*)stats_malloc(decoder.row_size + 1);
+    decoder.gray_row = (uchar*)stats_malloc((size_t)info->width);
+    int result = decoder.current_row && decoder.previous_row && decoder.gray_row;
+    if (result) {
+        memset(decoder.previous_row, 0, decoder.row_size + 1);
+        result = zlib_inflate_stream(read_idat_data, &decoder, receive_png_scanlines, &decoder) &&
+                 decoder.y == info->height;
+    }
+
+    stats_free(decoder.current_row);
+    stats_free(decoder.previous_row);
+    stats_free(decoder.gray_row);
+    return result;
+}
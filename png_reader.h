@@ -0,0 +1,44 @@
+/*****************************************************************************
+
+    plik  : png_reader.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla odczytu plików PNG wiersz po wierszu
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef PNG_READER_H
+#define PNG_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "defs.h"
+
+// Typy koloru PNG (pole color_type nagłówka IHDR)
+#define PNG_COLOR_GRAY       0  // Skala szarości, 1/2/4/8/16 bitów
+#define PNG_COLOR_RGB        2  // RGB, 8/16 bitów na kanał
+#define PNG_COLOR_PALETTE    3  // Paleta PLTE, 1/2/4/8 bitów
+#define PNG_COLOR_GRAY_ALPHA 4  // Skala szarości z kanałem alfa, 8/16 bitów
+#define PNG_COLOR_RGBA       6  // RGB z kanałem alfa, 8/16 bitów
+
+// Informacje z nagłówka IHDR i palety PLTE
+typedef struct {
+    int width;                 // Szerokość obrazu w pikselach
+    int height;                // Wysokość obrazu w pikselach
+    int bit_depth;             // Bity na próbkę (1, 2, 4, 8 lub 16)
+    int color_type;            // PNG_COLOR_*
+    int interlace;             // 0 = brak, 1 = Adam7 (nieobsługiwany)
+    uchar gray_palette[256];   // Skala szarości wpisów palety (wypełniana przez decode_png_rows())
+} PngInfo;
+
+// Prototypy funkcji
+int read_png_header(FILE* file, PngInfo* info);
+size_t calculate_png_row_size(PngInfo* info);
+size_t calculate_png_decoder_memory(PngInfo* info);
+const char* png_color_type_name(int color_type);
+int decode_png_rows(FILE* file, PngInfo* info, ImageRowCallback row_callback, void* callback_arg);
+
+#endif
@@ -0,0 +1,172 @@
+/*****************************************************************************
+
+    plik  : pnm_reader.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : odczyt binarnych plików PGM (P5) i PPM (P6) wiersz po wierszu
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <limits.h>
+#include "pnm_reader.h"
+#include "utils.h"
+#include "stats.h"
+
+// Czyta liczbę nagłówka PNM, pomijając białe znaki i komentarze '#'.
+// Znak kończący liczbę jest zwracany w terminator.
+static int read_pnm_number(FILE* file, int* value, int* terminator) {
+    int c = fgetc(file);
+    for (;;) {
+        if (c == '#') {
+            while (c != '\n' && c != '\r' && c != EOF) {
+                c = fgetc(file);
+            }
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+            c = fgetc(file);
+        } else {
+            break;
+        }
+    }
+    if (c < '0' || c > '9') {
+        return 0;
+    }
+
+    int number = 0;
+    while (c >= '0' && c <= '9') {
+        if (number > (INT_MAX - 9) / 10) {
+            return 0;
+        }
+        number = number * 10 + (c - '0');
+        c = fgetc(file);
+    }
+    *value = number;
+    *terminator = c;
+    return 1;
+}
+
+/**
+ * @brief Odczytuje nagłówek binarnego pliku PGM lub PPM
+ *
+ * @details Nagłówek to sygnatura "P5" lub "P6", szerokość, wysokość
+ * i maxval rozdzielone białymi znakami (dopuszczalne komentarze '#').
+ * Dane pikseli zaczynają się po jednym białym znaku za maxval - po
+ * powrocie z funkcji plik jest ustawiony na początku danych.
+ *
+ * @param file Wskaźnik do otwartego pliku (pozycja na początku)
+ * @param info Informacje o obrazie (wyjściowe)
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy nagłówek jest niepoprawny
+ *
+ * @example
+ * ```c
+ * PnmInfo info;
+ * if (read_pnm_header(file, &info)) {
+ *     printf("%dx%d, %s\n", info.width, info.height, info.channels == 1 ? "PGM" : "PPM");
+ * }
+ * ```
+ */
+int read_pnm_header(FILE* file, PnmInfo* info) {
+    uchar magic[2];
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6')) {
+        return 0;
+    }
+    info->channels = (magic[1] == '5') ? 1 : 3;
+
+    int terminator;
+    if (!read_pnm_number(file, &info->width, &terminator) ||
+        !read_pnm_number(file, &info->height, &terminator) ||
+        !read_pnm_number(file, &info->maxval, &terminator)) {
+        return 0;
+    }
+    // Po maxval dokładnie jeden biały znak, dalej już dane binarne
+    if (terminator != ' ' && terminator != '\t' && terminator != '\n' && terminator != '\r') {
+        return 0;
+    }
+    return info->width > 0 && info->height > 0 && info->maxval > 0 && info->maxval <= 65535;
+}
+
+/**
+ * @brief Oblicza rozmiar wiersza danych PGM/PPM w bajtach
+ *
+ * @param info Informacje z read_pnm_header()
+ *
+ * @return Rozmiar wiersza lub 0 przy przepełnieniu
+ */
+size_t calculate_pnm_row_size(PnmInfo* info) {
+    size_t row_size;
+    size_t sample_size = (info->maxval > 255) ? 2 : 1;
+    if (!size_multiply((size_t)info->width, (size_t)info->channels * sample_size, &row_size)) {
+        return 0;
+    }
+    return row_size;
+}
+
+/**
+ * @brief Dekoduje dane PGM/PPM i przekazuje kolejne wiersze w skali szarości
+ *
+ * @details Czyta plik wiersz po wierszu (pamięć: jeden wiersz pliku i jeden
+ * wiersz skali szarości). PGM z maxval 255 jest już skalą szarości - wiersz
+ * pliku trafia do row_callback bez żadnej konwersji. Pozostałe warianty są
+ * skalowane do 0-255 (próbki 16-bitowe są big-endian), a PPM przechodzi
+ * przez convert_rgb_to_grayscale() jak piksele BMP.
+ *
+ * @param file Plik ustawiony na początku danych (po read_pnm_header())
+ * @param info Informacje z read_pnm_header()
+ * @param row_callback Odbiorca wierszy (od góry obrazu)
+ * @param callback_arg Argument przekazywany do row_callback
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy dane są urwane, brak pamięci lub
+ *         row_callback przerwał dekodowanie
+ */
+int decode_pnm_rows(FILE* file, PnmInfo* info, ImageRowCallback row_callback, void* callback_arg) {
+    size_t row_size = calculate_pnm_row_size(info);
+    if (row_size == 0) {
+        return 0;
+    }
+    int is_plain_gray = (info->channels == 1 && info->maxval == 255);
+    uchar* file_row = (uchar*)stats_malloc(row_size);
+    uchar* gray_row = is_plain_gray ? NULL : (uchar*)stats_malloc((size_t)info->width);
+    if (!file_row || (!is_plain_gray && !gray_row)) {
+        stats_free(file_row);
+        stats_free(gray_row);
+        return 0;
+    }
+
+    int sample_size = (info->maxval > 255) ? 2 : 1;
+    int maxval = info->maxval;
+    int result = 1;
+    for (int y = 0; y < info->height && result; y++) {
+        if (fread(file_row, 1, row_size, file) != row_size) {
+            result = 0;
+            break;
+        }
+        if (is_plain_gray) {
+            result = row_callback(callback_arg, y, file_row);
+            continue;
+        }
+
+        // Przeskalowanie próbek do 0-255 z zaokrągleniem, wartości ponad maxval obcięte
+        const uchar* src = file_row;
+        for (int x = 0; x < info->width; x++) {
+            int rgb[3];
+            for (int c = 0; c < info->channels; c++) {
+                int sample = (sample_size == 2) ? (src[0] << 8) | src[1] : src[0];
+                src += sample_size;
+                if (sample > maxval) {
+                    sample = maxval;
+                }
+                rgb[c] = (maxval == 255) ? sample : (sample * 255 + maxval / 2) / maxval;
+            }
+            gray_row[x] = (info->channels == 1) ? (uchar)rgb[0] : (uchar)convert_rgb_to_grayscale((uchar)rgb[0], (uchar)rgb[1], (uchar)rgb[2]);
+        }
+        result = row_callback(callback_arg, y, gray_row);
+    }
+
+    stats_free(file_row);
+    stats_free(gray_row);
+    return result;
+}
@@ -0,0 +1,33 @@
+/*****************************************************************************
+
+    plik  : pnm_reader.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla odczytu binarnych plików PGM (P5) i PPM (P6)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef PNM_READER_H
+#define PNM_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "defs.h"
+
+// Informacje z nagłówka pliku PGM/PPM
+typedef struct {
+    int width;                 // Szerokość obrazu w pikselach
+    int height;                // Wysokość obrazu w pikselach
+    int maxval;                // Maksymalna wartość próbki (1-65535, powyżej 255 dwa bajty)
+    int channels;              // 1 = PGM (skala szarości), 3 = PPM (RGB)
+} PnmInfo;
+
+// Prototypy funkcji
+int read_pnm_header(FILE* file, PnmInfo* info);
+size_t calculate_pnm_row_size(PnmInfo* info);
+int decode_pnm_rows(FILE* file, PnmInfo* info, ImageRowCallback row_callback, void* callback_arg);
+
+#endif
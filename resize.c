@@ -0,0 +1,464 @@
+/*****************************************************************************
+
+    plik  : resize.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : strumieniowe, separowalne skalowanie skali szarości (--resize):
+            filtry box, bilinear i Lanczos-3 na wagach stałoprzecinkowych
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "resize.h"
+#include "stats.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESIZE_USE_SSE2 1
+#endif
+
+// Szerokość wektora wag i wierszy pierścienia (8 wartości int16 w rejestrze SSE2)
+#define RESIZE_VECTOR 8
+
+#define RESIZE_ROUND_UP(n) (((n) + RESIZE_VECTOR - 1) / RESIZE_VECTOR * RESIZE_VECTOR)
+
+#define LANCZOS_LOBES 3
+
+// Nazwy filtrów --resize-filter
+typedef struct {
+    int filter;
+    const char* name;
+} ResizeFilterInfo;
+
+static const ResizeFilterInfo resize_filters[] = {
+    {RESIZE_FILTER_BOX,      "box"},
+    {RESIZE_FILTER_BILINEAR, "bilinear"},
+    {RESIZE_FILTER_LANCZOS,  "lanczos"}
+};
+
+#define RESIZE_FILTER_COUNT ((int)(sizeof(resize_filters) / sizeof(resize_filters[0])))
+
+/**
+ * @brief Zwraca filtr skalowania o podanej nazwie
+ *
+ * @param name Nazwa z wiersza poleceń (box, bilinear, lanczos)
+ *
+ * @return RESIZE_FILTER_* lub -1 dla nieznanej nazwy
+ */
+int parse_resize_filter(const char* name) {
+    for (int i = 0; i < RESIZE_FILTER_COUNT; i++) {
+        if (strcmp(name, resize_filters[i].name) == 0) {
+            return resize_filters[i].filter;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Zwraca nazwę filtra skalowania
+ *
+ * @param filter RESIZE_FILTER_*
+ *
+ * @return Nazwa filtra lub "unknown"
+ */
+const char* resize_filter_name(int filter) {
+    for (int i = 0; i < RESIZE_FILTER_COUNT; i++) {
+        if (resize_filters[i].filter == filter) {
+            return resize_filters[i].name;
+        }
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Uzupełnia wymiar celu podany jako 0 z zachowaniem proporcji źródła
+ *
+ * @param src_width Szerokość źródła
+ * @param src_height Wysokość źródła
+ * @param dst_width Szerokość celu (0 = z proporcji, aktualizowana)
+ * @param dst_height Wysokość celu (0 = z proporcji, aktualizowana)
+ *
+ * @note Najwyżej jeden wymiar celu może być zerowy (sprawdza parse_arguments())
+ */
+void resize_target_size(int src_width, int src_height, int* dst_width, int* dst_height) {
+    if (*dst_width == 0) {
+        double width = (double)src_width * *dst_height / src_height + 0.5;
+        *dst_width = (width < 1.0) ? 1 : (width > INT_MAX - 8) ? INT_MAX - 8 : (int)width;
+    } else if (*dst_height == 0) {
+        double height = (double)src_height * *dst_width / src_width + 0.5;
+        *dst_height = (height < 1.0) ? 1 : (height > INT_MAX - 8) ? INT_MAX - 8 : (int)height;
+    }
+}
+
+// ============================================================================
+// Wagi filtrów
+// ============================================================================
+
+// Promień filtra w pikselach źródła przy skali 1:1
+static double filter_support(int filter) {
+    switch (filter) {
+        case RESIZE_FILTER_BOX:     return 0.5;
+        case RESIZE_FILTER_LANCZOS: return LANCZOS_LOBES;
+        default:                    return 1.0;
+    }
+}
+
+static double sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= 3.14159265358979323846;
+    return sin(x) / x;
+}
+
+/**
+ * @brief Waga piksela źródła o indeksie j dla próbki o środku center
+ *
+ * @details Box liczy pokrycie piksela [j, j+1) przez okno próbki, więc przy
+ * zmniejszaniu o całkowitą krotność daje dokładnie średnią bloku. Bilinear
+ * (trójkąt) i Lanczos-3 są próbkowane w środku piksela j + 0.5; przy
+ * zmniejszaniu są rozciągane o skalę (stretch), co działa jak filtr
+ * antyaliasingowy.
+ */
+static double filter_weight(int filter, int j, double center, double support, double stretch) {
+    if (filter == RESIZE_FILTER_BOX) {
+        double left = (center - support > j) ? center - support : j;
+        double right = (center + support < j + 1) ? center + support : j + 1;
+        return (right > left) ? right - left : 0.0;
+    }
+
+    double x = (j + 0.5 - center) / stretch;
+    if (x < 0) {
+        x = -x;
+    }
+    if (filter == RESIZE_FILTER_LANCZOS) {
+        return (x < LANCZOS_LOBES) ? sinc(x) * sinc(x / LANCZOS_LOBES) : 0.0;
+    }
+    return (x < 1.0) ? 1.0 - x : 0.0;
+}
+
+// Rozciągnięcie filtra i promień w pikselach źródła dla danej skali
+static void filter_extent(int src, int dst, int filter, double* stretch, double* support) {
+    double scale = (double)src / dst;
+    *stretch = (scale > 1.0) ? scale : 1.0;
+    *support = filter_support(filter) * *stretch;
+}
+
+// Liczba wag na próbkę (wspólna dla całej osi, najwyżej rozmiar źródła)
+static int axis_taps(int src, int dst, int filter) {
+    double stretch, support;
+    filter_extent(src, dst, filter, &stretch, &support);
+    double taps = ceil(2.0 * support) + 1.0;
+    return (taps > src) ? src : (int)taps;
+}
+
+static size_t axis_memory(int src, int dst, int filter) {
+    int taps_stride = RESIZE_ROUND_UP(axis_taps(src, dst, filter));
+    return (size_t)dst * (sizeof(int) + (size_t)taps_stride * sizeof(short));
+}
+
+/**
+ * @brief Wylicza wagi stałoprzecinkowe jednej osi
+ *
+ * @details Okno próbki jest przycinane do obrazu, a wagi normalizowane do
+ * sumy 1 << RESIZE_WEIGHT_BITS (reszta zaokrągleń trafia do największej
+ * wagi), więc obraz jednolity pozostaje jednolity także przy brzegach.
+ * Okno o stałej długości taps jest przesuwane tak, by nie wychodziło poza
+ * źródło - nadmiarowe wagi są zerowe.
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy brak pamięci
+ */
+static int build_axis(ResizeAxis* axis, int src, int dst, int filter) {
+    double stretch, support;
+    filter_extent(src, dst, filter, &stretch, &support);
+    double scale = (double)src / dst;
+
+    axis->taps = axis_taps(src, dst, filter);
+    axis->taps_stride = RESIZE_ROUND_UP(axis->taps);
+    axis->start = (int*)stats_malloc((size_t)dst * sizeof(int));
+    axis->weights = (short*)stats_malloc((size_t)dst * axis->taps_stride * sizeof(short));
+    double* weights = (double*)stats_malloc((size_t)axis->taps * sizeof(double));
+    if (!axis->start || !axis->weights || !weights) {
+        stats_free(weights);
+        return 0;
+    }
+    memset(axis->weights, 0, (size_t)dst * axis->taps_stride * sizeof(short));
+
+    for (int i = 0; i < dst; i++) {
+        double center = (i + 0.5) * scale;
+        int first = (int)floor(center - support);
+        if (first < 0) {
+            first = 0;
+        }
+        int start = (first > src - axis->taps) ? src - axis->taps : first;
+
+        double sum = 0.0;
+        for (int k = 0; k < axis->taps; k++) {
+            weights[k] = filter_weight(filter, start + k, center, support, stretch);
+            sum += weights[k];
+        }
+
+        short* fixed = axis->weights + (size_t)i * axis->taps_stride;
+        if (sum <= 0.0) {
+            // Okno bez wkładu (tylko teoretycznie przy Lanczosie na brzegu) - najbliższy piksel
+            int nearest = (int)center - start;
+            fixed[(nearest < 0) ? 0 : (nearest >= axis->taps) ? axis->taps - 1 : nearest] = 1 << RESIZE_WEIGHT_BITS;
+        } else {
+            int total = 0;
+            int largest = 0;
+            for (int k = 0; k < axis->taps; k++) {
+                fixed[k] = (short)floor(weights[k] / sum * (1 << RESIZE_WEIGHT_BITS) + 0.5);
+                total += fixed[k];
+                if (fixed[k] > fixed[largest]) {
+                    largest = k;
+                }
+            }
+            fixed[largest] += (short)((1 << RESIZE_WEIGHT_BITS) - total);
+        }
+        axis->start[i] = start;
+    }
+    stats_free(weights);
+    return 1;
+}
+
+static void free_axis(ResizeAxis* axis) {
+    stats_free(axis->start);
+    stats_free(axis->weights);
+    axis->start = NULL;
+    axis->weights = NULL;
+}
+
+// ============================================================================
+// Przebiegi skalowania
+// ============================================================================
+
+/**
+ * @brief Przebieg poziomy: wiersz źródła 0-255 → wiersz pośredni (wartość * 64)
+ *
+ * @details Wersja SSE2 mnoży 8 pikseli źródła przez 8 wag jednym
+ * _mm_madd_epi16 i sumuje cztery częściowe sumy 32-bitowe. Wiersz źródła
+ * ma zapas 8 bajtów, a wagi są dopełnione zerami do taps_stride, więc
+ * wektory nie wymagają obsługi końcówki.
+ */
+static void resample_row_horizontal(const ResizeAxis* axis, const uchar* src, short* dst, int dst_width) {
+    const int shift = RESIZE_WEIGHT_BITS - RESIZE_INTERMEDIATE_BITS;
+    const int round = 1 << (shift - 1);
+
+    for (int x = 0; x < dst_width; x++) {
+        const uchar* s = src + axis->start[x];
+        const short* w = axis->weights + (size_t)x * axis->taps_stride;
+        int sum;
+#ifdef RESIZE_USE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        for (int k = 0; k < axis->taps_stride; k += RESIZE_VECTOR) {
+            __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s + k)), zero);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(pixels, _mm_loadu_si128((const __m128i*)(w + k))));
+        }
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = _mm_cvtsi128_si32(acc);
+#else
+        sum = 0;
+        for (int k = 0; k < axis->taps; k++) {
+            sum += s[k] * w[k];
+        }
+#endif
+        // Ujemne płaty Lanczosa mogą wyjść poza 0-255 - zakres int16 wystarcza z zapasem
+        sum = (sum + round) >> shift;
+        dst[x] = (short)(sum < -32768 ? -32768 : sum > 32767 ? 32767 : sum);
+    }
+}
+
+/**
+ * @brief Przebieg pionowy: taps wierszy pośrednich → wiersz celu 0-255
+ *
+ * @details Wersja SSE2 przeplata dwa kolejne wiersze (unpack) i mnoży je
+ * przez parę wag jednym _mm_madd_epi16 - 8 pikseli na iterację, z
+ * nasyceniem do 0-255 przez _mm_packus_epi16.
+ */
+static void resample_rows_vertical(short* const* rows, const short* weights, int taps, uchar* dst, int dst_width) {
+    const int shift = RESIZE_WEIGHT_BITS + RESIZE_INTERMEDIATE_BITS;
+    const int round = 1 << (shift - 1);
+    int x = 0;
+
+#ifdef RESIZE_USE_SSE2
+    const __m128i rounding = _mm_set1_epi32(round);
+    for (; x + RESIZE_VECTOR <= dst_width; x += RESIZE_VECTOR) {
+        __m128i acc_lo = rounding;
+        __m128i acc_hi = rounding;
+        for (int k = 0; k < taps; k += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(rows[k] + x));
+            __m128i b;
+            unsigned int pair = (unsigned short)weights[k];
+            if (k + 1 < taps) {
+                b = _mm_loadu_si128((const __m128i*)(rows[k + 1] + x));
+                pair |= (unsigned int)(unsigned short)weights[k + 1] << 16;
+            } else {
+                b = _mm_setzero_si128();
+            }
+            __m128i w = _mm_set1_epi32((int)pair);
+            acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w));
+            acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w));
+        }
+        __m128i result = _mm_packs_epi32(_mm_srai_epi32(acc_lo, shift), _mm_srai_epi32(acc_hi, shift));
+        _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(result, result));
+    }
+#endif
+
+    for (; x < dst_width; x++) {
+        int sum = round;
+        for (int k = 0; k < taps; k++) {
+            sum += rows[k][x] * weights[k];
+        }
+        sum >>= shift;
+        dst[x] = (uchar)(sum < 0 ? 0 : sum > 255 ? 255 : sum);
+    }
+}
+
+// ============================================================================
+// Skalowanie strumieniowe
+// ============================================================================
+
+/**
+ * @brief Zwraca pamięć zajmowaną przez skalowanie
+ *
+ * @details Stała niezależnie od wysokości źródła: wagi obu osi, pierścień
+ * vertical.taps wierszy pośrednich (int16) i bufory jednego wiersza
+ * źródła i celu. Używane do planowania budżetu --max-mem.
+ *
+ * @return Rozmiar w bajtach
+ */
+size_t calculate_resampler_memory(int src_width, int src_height, int dst_width, int dst_height, int filter) {
+    size_t ring_stride = RESIZE_ROUND_UP((size_t)dst_width);
+    return axis_memory(src_width, dst_width, filter) + axis_memory(src_height, dst_height, filter) +
+           (size_t)axis_taps(src_height, dst_height, filter) * (ring_stride * sizeof(short) + sizeof(short*)) +
+           (size_t)src_width + RESIZE_VECTOR + ring_stride;
+}
+
+/**
+ * @brief Przygotowuje skalowanie strumieniowe
+ *
+ * @details Filtr jest separowalny: każdy wiersz źródła jest od razu
+ * skalowany w poziomie do pierścienia ostatnich vertical.taps wierszy,
+ * a wiersz celu powstaje z pierścienia, gdy tylko dotrze ostatni wiersz
+ * jego okna. Obraz źródłowy nigdy nie jest trzymany w całości - wiersze
+ * celu trafiają do odbiorcy (klatka lub pasma --max-mem) w kolejności
+ * od góry.
+ *
+ * @param resampler Skalowanie do zainicjalizowania
+ * @param src_width Szerokość źródła
+ * @param src_height Wysokość źródła
+ * @param dst_width Szerokość celu
+ * @param dst_height Wysokość celu
+ * @param filter RESIZE_FILTER_*
+ * @param output Odbiorca wierszy celu (0-255)
+ * @param output_arg Argument odbiorcy
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy brak pamięci (komunikat wypisany)
+ *
+ * @example
+ * ```c
+ * Resampler resampler;
+ * resampler_init(&resampler, 1024, 512, 128, 64, RESIZE_FILTER_LANCZOS, store_frame_row, &sink);
+ * decode_png_rows(file, &info, resampler_push_row, &resampler);
+ * resampler_free(&resampler);
+ * ```
+ */
+int resampler_init(Resampler* resampler, int src_width, int src_height, int dst_width, int dst_height, int filter,
+                   ImageRowCallback output, void* output_arg) {
+    memset(resampler, 0, sizeof(*resampler));
+    resampler->src_width = src_width;
+    resampler->src_height = src_height;
+    resampler->dst_width = dst_width;
+    resampler->dst_height = dst_height;
+    resampler->ring_stride = RESIZE_ROUND_UP(dst_width);
+    resampler->output = output;
+    resampler->output_arg = output_arg;
+
+    int built = build_axis(&resampler->horizontal, src_width, dst_width, filter) &&
+                build_axis(&resampler->vertical, src_height, dst_height, filter);
+    if (built) {
+        resampler->ring = (short*)stats_malloc((size_t)resampler->vertical.taps * resampler->ring_stride * sizeof(short));
+        resampler->ring_rows = (short**)stats_malloc((size_t)resampler->vertical.taps * sizeof(short*));
+        resampler->source_row = (uchar*)stats_malloc((size_t)src_width + RESIZE_VECTOR);
+        resampler->output_row = (uchar*)stats_malloc((size_t)resampler->ring_stride);
+    }
+    if (!built || !resampler->ring || !resampler->ring_rows || !resampler->source_row || !resampler->output_row) {
+        printf("Error: Cannot allocate memory for resize buffers\n");
+        resampler_free(resampler);
+        return 0;
+    }
+
+    // Zapas za wierszem źródła i kolumny pierścienia za dst_width są czytane przez pełne wektory
+    memset(resampler->source_row + src_width, 0, RESIZE_VECTOR);
+    memset(resampler->ring, 0, (size_t)resampler->vertical.taps * resampler->ring_stride * sizeof(short));
+    return 1;
+}
+
+/**
+ * @brief Przyjmuje kolejny wiersz źródła (ImageRowCallback)
+ *
+ * @details Wiersz musi przyjść w kolejności od góry. Po przebiegu poziomym
+ * wysyła do odbiorcy wszystkie wiersze celu, których okno kończy się na
+ * tym wierszu - okno ma stałą długość, więc leży w całości w pierścieniu.
+ *
+ * @param arg Skalowanie (Resampler*)
+ * @param y Numer wiersza źródła (od góry)
+ * @param gray_row Wiersz źródła 0-255
+ *
+ * @return 1 aby kontynuować, 0 gdy odbiorca przerwał przetwarzanie
+ */
+int resampler_push_row(void* arg, int y, const uchar* gray_row) {
+    Resampler* resampler = (Resampler*)arg;
+    const ResizeAxis* vertical = &resampler->vertical;
+    (void)y;
+
+    if (resampler->rows_received >= resampler->src_height) {
+        return 0;
+    }
+    memcpy(resampler->source_row, gray_row, resampler->src_width);
+    short* ring_row = resampler->ring + (size_t)(resampler->rows_received % vertical->taps) * resampler->ring_stride;
+    resample_row_horizontal(&resampler->horizontal, resampler->source_row, ring_row, resampler->dst_width);
+    resampler->rows_received++;
+
+    while (resampler->rows_emitted < resampler->dst_height &&
+           vertical->start[resampler->rows_emitted] + vertical->taps <= resampler->rows_received) {
+        int out_y = resampler->rows_emitted;
+        short** rows = resampler->ring_rows;
+        for (int k = 0; k < vertical->taps; k++) {
+            rows[k] = resampler->ring + (size_t)((vertical->start[out_y] + k) % vertical->taps) * resampler->ring_stride;
+        }
+        resample_rows_vertical(rows, vertical->weights + (size_t)out_y * vertical->taps_stride, vertical->taps,
+                               resampler->output_row, resampler->dst_width);
+        if (!resampler->output(resampler->output_arg, out_y, resampler->output_row)) {
+            return 0;
+        }
+        resampler->rows_emitted++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Zwalnia bufory skalowania
+ *
+ * @param resampler Skalowanie
+ */
+void resampler_free(Resampler* resampler) {
+    free_axis(&resampler->horizontal);
+    free_axis(&resampler->vertical);
+    stats_free(resampler->ring);
+    stats_free(resampler->ring_rows);
+    stats_free(resampler->source_row);
+    stats_free(resampler->output_row);
+    resampler->ring = NULL;
+    resampler->ring_rows = NULL;
+    resampler->source_row = NULL;
+    resampler->output_row = NULL;
+}
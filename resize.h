@@ -0,0 +1,67 @@
+/*****************************************************************************
+
+    plik  : resize.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy strumieniowego skalowania skali szarości (--resize)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef RESIZE_H
+#define RESIZE_H
+
+#include <stddef.h>
+#include "defs.h"
+
+// Górna granica wymiaru docelowego --resize
+#define RESIZE_MAX_DIMENSION 65535
+
+// Precyzja wag stałoprzecinkowych (suma wag próbki = 1 << RESIZE_WEIGHT_BITS)
+#define RESIZE_WEIGHT_BITS 14
+
+// Dodatkowe bity ułamkowe wierszy po przebiegu poziomym (wartość 0-255 * 64)
+#define RESIZE_INTERMEDIATE_BITS 6
+
+// Wagi jednej osi: dla próbki wyjściowej i źródło zaczyna się od start[i],
+// wagi leżą w weights[i * taps_stride .. + taps - 1] (reszta zerowa)
+typedef struct {
+    int taps;                  // Liczba wag na próbkę wyjściową
+    int taps_stride;           // taps zaokrąglone do 8 (pełne wektory SIMD)
+    int* start;                // Pierwszy indeks źródła każdej próbki wyjściowej
+    short* weights;            // Wagi stałoprzecinkowe
+} ResizeAxis;
+
+// Skalowanie strumieniowe: wiersze źródła wchodzą od góry, wiersze celu
+// wychodzą do odbiorcy, gdy tylko są gotowe
+typedef struct {
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+    ResizeAxis horizontal;
+    ResizeAxis vertical;
+    int ring_stride;           // Odstęp wierszy pierścienia (dst_width zaokrąglone do 8)
+    short* ring;               // Ostatnie vertical.taps wierszy po przebiegu poziomym
+    short** ring_rows;         // Wiersze pierścienia w kolejności okna bieżącego wiersza celu
+    uchar* source_row;         // Kopia wiersza źródła z zapasem na pełne wektory
+    uchar* output_row;         // Wiersz celu
+    int rows_received;         // Wiersze źródła przyjęte do tej pory
+    int rows_emitted;          // Wiersze celu przekazane odbiorcy
+    ImageRowCallback output;   // Odbiorca wierszy celu
+    void* output_arg;
+} Resampler;
+
+// Prototypy funkcji skalowania
+int parse_resize_filter(const char* name);
+const char* resize_filter_name(int filter);
+void resize_target_size(int src_width, int src_height, int* dst_width, int* dst_height);
+size_t calculate_resampler_memory(int src_width, int src_height, int dst_width, int dst_height, int filter);
+int resampler_init(Resampler* resampler, int src_width, int src_height, int dst_width, int dst_height, int filter,
+                   ImageRowCallback output, void* output_arg);
+int resampler_push_row(void* arg, int y, const uchar* gray_row);
+void resampler_free(Resampler* resampler);
+
+#endif
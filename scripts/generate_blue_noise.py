@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Generator tekstury progów blue noise (blue_noise.c) metodą void-and-cluster
+#
+# Copyright (c) 2026 PTODT <https://ptodt.org.pl>
+# Autor: Michal Kolodziejski (2:480/112.10)
+# Data: 2026.10.19
+# Licencja: MIT
+#
+# Użycie: python3 scripts/generate_blue_noise.py > blue_noise.c
+#
+# Czysty Python (bez numpy), deterministyczny - stałe ziarno generatora.
+# Tekstura jest kafelkowana (torus), więc filtr Gaussa zawija się na brzegach.
+
+import math
+import random
+
+SIZE = 64
+SIGMA = 1.5
+RADIUS = 6          # Promień okna filtra (wkład dalszych pikseli jest pomijalny)
+INITIAL_FILL = 0.1  # Udział jedynek we wzorcu początkowym
+SEED = 480112
+
+N = SIZE * SIZE
+KERNEL = [(dx, dy, math.exp(-(dx * dx + dy * dy) / (2 * SIGMA * SIGMA)))
+          for dy in range(-RADIUS, RADIUS + 1) for dx in range(-RADIUS, RADIUS + 1)]
+
+
+def splat(energy, index, sign):
+    x, y = index % SIZE, index // SIZE
+    for dx, dy, weight in KERNEL:
+        energy[((y + dy) % SIZE) * SIZE + (x + dx) % SIZE] += sign * weight
+
+
+def tightest_cluster(pattern, energy):
+    return max((i for i in range(N) if pattern[i]), key=lambda i: energy[i])
+
+
+def largest_void(pattern, energy):
+    return min((i for i in range(N) if not pattern[i]), key=lambda i: energy[i])
+
+
+def main():
+    rng = random.Random(SEED)
+    pattern = [0] * N
+    energy = [0.0] * N
+    for index in rng.sample(range(N), int(N * INITIAL_FILL)):
+        pattern[index] = 1
+        splat(energy, index, 1)
+
+    # Wzorzec początkowy: przenoszenie najciaśniejszego skupiska do największej pustki
+    while True:
+        cluster = tightest_cluster(pattern, energy)
+        pattern[cluster] = 0
+        splat(energy, cluster, -1)
+        void = largest_void(pattern, energy)
+        if void == cluster:
+            pattern[cluster] = 1
+            splat(energy, cluster, 1)
+            break
+        pattern[void] = 1
+        splat(energy, void, 1)
+
+    ones = sum(pattern)
+    rank = [0] * N
+
+    # Faza 1: kolejne skupiska usuwane z kopii wzorca dostają malejące rangi
+    work, work_energy = pattern[:], energy[:]
+    for r in range(ones - 1, -1, -1):
+        cluster = tightest_cluster(work, work_energy)
+        work[cluster] = 0
+        splat(work_energy, cluster, -1)
+        rank[cluster] = r
+
+    # Faza 2 i 3: kolejne pustki wypełniane aż do pełnej tekstury
+    for r in range(ones, N):
+        void = largest_void(pattern, energy)
+        pattern[void] = 1
+        splat(energy, void, 1)
+        rank[void] = r
+
+    # Ranga 0..N-1 → próg 0..254 (piksel 255 jest zawsze biały, 0 zawsze czarny)
+    thresholds = [r * 255 // N for r in rank]
+
+    print("""/*****************************************************************************
+
+    plik  : blue_noise.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : tekstura progów blue noise %dx%d dla ditheringu -d blue
+            (wygenerowana przez scripts/generate_blue_noise.py - nie edytować)
+
+    licencja : MIT
+*****************************************************************************/
+
+#include "blue_noise.h"
+
+// Void-and-cluster, filtr Gaussa sigma %.1f na torusie; próg = ranga * 255 / %d (0-254)
+const uchar blue_noise_texture[BLUE_NOISE_SIZE][BLUE_NOISE_SIZE] = {""" % (SIZE, SIZE, SIGMA, N))
+    for y in range(SIZE):
+        row = thresholds[y * SIZE:(y + 1) * SIZE]
+        print("    {" + ", ".join("%3d" % v for v in row) + "}" + ("," if y < SIZE - 1 else ""))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -40,12 +40,8 @@ if not exist %OUTPUT_DIR% mkdir %OUTPUT_DIR%
 @ECHO.
 
 REM Generuj wszystkie kombinacje jasności i kontrastu (0-100% co 10%)
-for /L %%b in (0,10,100) do (
-  for /L %%c in (0,10,100) do (
-    echo Generating br%%b_ct%%c...
-    bmp_to_xbpp.exe -1 -d floyd -br %%b -ct %%c --bmp img\sample-image.bmp %OUTPUT_DIR%\br%%b_ct%%c > nul 2>&1
-  )
-)
+REM Obraz jest wczytywany raz, a kombinacje są liczone równolegle (--sweep-br/--sweep-ct)
+bmp_to_xbpp.exe -1 -d floyd --sweep-br 0:100:10 --sweep-ct 0:100:10 --bmp img\sample-image.bmp %OUTPUT_DIR%\ | findstr /b /c:"- br"
 
 @ECHO.
 @ECHO - DONE... FINISHED RESULTS ARE IN [%OUTPUT_DIR%\] FOLDER
@@ -39,12 +39,8 @@ echo "- GENERATING BMP FILES WITH BRIGHTNESS/CONTRAST COMBINATIONS"
 echo ""
 
 # Generuj wszystkie kombinacje jasności i kontrastu (0-100% co 10%)
-for br in 0 10 20 30 40 50 60 70 80 90 100; do
-  for ct in 0 10 20 30 40 50 60 70 80 90 100; do
-    echo "Generating br${br}_ct${ct}..."
-    ./bmp_to_xbpp -1 -d floyd -br $br -ct $ct --bmp img/sample-image.bmp "$OUTPUT_DIR/br${br}_ct${ct}" > /dev/null 2>&1
-  done
-done
+# Obraz jest wczytywany raz, a kombinacje są liczone równolegle (--sweep-br/--sweep-ct)
+./bmp_to_xbpp -1 -d floyd --sweep-br 0:100:10 --sweep-ct 0:100:10 --bmp img/sample-image.bmp "$OUTPUT_DIR/" | grep "^- br"
 
 echo ""
 echo "- DONE... FINISHED RESULTS ARE IN [$OUTPUT_DIR/] FOLDER"
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# Generator matryc ordered ditheringu (dither_matrices.c): Bayer i cluster-dot
+#
+# Copyright (c) 2026 PTODT <https://ptodt.org.pl>
+# Autor: Michal Kolodziejski (2:480/112.10)
+# Data: 2026.10.19
+# Licencja: MIT
+#
+# Użycie: python3 scripts/generate_dither_matrices.py > dither_matrices.c
+#
+# Wywoływany przez Makefile przy zmianie skryptu. Każda matryca jest
+# przeliczana z rang 0..N-1 na progi środków przedziałów (2r+1)*255/(2N),
+# dzięki czemu jasność wyjścia odpowiada jasności wejścia w całym zakresie 0-255.
+
+import math
+
+BAYER_SIZES = [2, 4, 8, 16]
+CLUSTER_SIZES = [4, 8]
+
+
+def bayer_rank(x, y, size):
+    # Przeplot bitów (x ^ y) i y w odwróconej kolejności - klasyczna rekurencja Bayera
+    bits = size.bit_length() - 1
+    rank = 0
+    for b in range(bits):
+        shift = 2 * (bits - 1 - b)
+        rank |= (((x ^ y) >> b) & 1) << (shift + 1)
+        rank |= ((y >> b) & 1) << shift
+    return rank
+
+
+def cluster_ranks(size):
+    # Pojedyncza kropka rosnąca od środka komórki; remisy rozstrzyga kąt (spirala)
+    center = (size - 1) / 2.0
+    cells = []
+    for y in range(size):
+        for x in range(size):
+            dx, dy = x - center, y - center
+            angle = math.atan2(dy, dx) % (2 * math.pi)
+            cells.append((round(dx * dx + dy * dy, 6), round(angle, 6), y, x))
+    ranks = {}
+    for rank, (_, _, y, x) in enumerate(sorted(cells)):
+        ranks[(x, y)] = rank
+    return [[ranks[(x, y)] for x in range(size)] for y in range(size)]
+
+
+def thresholds(ranks, size):
+    count = size * size
+    return [[(2 * r + 1) * 255 // (2 * count) for r in row] for row in ranks]
+
+
+def emit(name, size, rows, comment):
+    print("")
+    print("// %s" % comment)
+    print("static const uchar %s[%d * %d] = {" % (name, size, size))
+    for y, row in enumerate(rows):
+        print("    " + ", ".join("%3d" % v for v in row) + ("," if y < size - 1 else ""))
+    print("};")
+
+
+def main():
+    print("""/*****************************************************************************
+
+    plik  : dither_matrices.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : matryce progów ordered ditheringu (Bayer, cluster-dot)
+            (wygenerowane przez scripts/generate_dither_matrices.py - nie edytować)
+
+    licencja : MIT
+*****************************************************************************/
+
+#include "dither_matrices.h\"""")
+
+    table = []
+    for size in BAYER_SIZES:
+        ranks = [[bayer_rank(x, y, size) for x in range(size)] for y in range(size)]
+        name = "bayer_%dx%d" % (size, size)
+        emit(name, size, thresholds(ranks, size), "Bayer %dx%d (rozproszone progi)" % (size, size))
+        table.append(("DITHERING_ORDERED_%dX%d" % (size, size) if size != 8 else "DITHERING_ORDERED", size, name))
+    for size in CLUSTER_SIZES:
+        name = "cluster_%dx%d" % (size, size)
+        emit(name, size, thresholds(cluster_ranks(size), size), "Cluster-dot %dx%d (kropka rosnąca od środka)" % (size, size))
+        table.append(("DITHERING_CLUSTER_%dX%d" % (size, size), size, name))
+
+    print("")
+    print("const DitherMatrix dither_matrices[] = {")
+    for method, size, name in table:
+        print("    {%s, %d, %s}," % (method, size, name))
+    print("};")
+    print("")
+    print("const int dither_matrix_count = (int)(sizeof(dither_matrices) / sizeof(dither_matrices[0]));")
+
+
+if __name__ == "__main__":
+    main()
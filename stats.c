@@ -0,0 +1,326 @@
+/*****************************************************************************
+
+    plik  : stats.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : implementacja statystyk czasu etapów konwersji i pamięci
+
+    licencja : MIT
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats.h"
+#include "timing.h"
+#include "threads.h"
+
+// Nagłówek alokacji - wyrównany do 16 bajtów, przechowuje rozmiar bloku
+#define STATS_ALLOC_HEADER 16
+
+static size_t stats_current_bytes = 0;
+static size_t stats_max_bytes = 0;
+static ThreadMutex stats_memory_lock = THREAD_MUTEX_INITIALIZER;
+
+static const char* stats_stage_names[STATS_STAGE_COUNT] = {
+    "header_read",
+    "pixel_read",
+    "grayscale",
+    "brightness_contrast",
+    "dithering",
+    "packing",
+    "inversion",
+    "output_write",
+    "preview_write"
+};
+
+// ============================================================================
+// Pomiar etapów
+// ============================================================================
+
+/**
+ * @brief Zeruje statystyki konwersji
+ *
+ * @param stats Wskaźnik do struktury ConversionStats
+ */
+void stats_reset(ConversionStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+/**
+ * @brief Rozpoczyna pomiar etapu
+ *
+ * @return Znacznik czasu przekazywany do stats_stage_end()
+ */
+double stats_stage_begin(void) {
+    return timing_now_ns();
+}
+
+/**
+ * @brief Kończy pomiar etapu i dolicza jego czas do statystyk
+ *
+ * @details Czas jest sumowany, więc etap wywoływany kilka razy (np. zapis
+ * wielu plików) raportuje łączny czas wszystkich wywołań.
+ *
+ * @param stats Wskaźnik do statystyk (NULL = pomiar wyłączony)
+ * @param stage Identyfikator etapu (STATS_STAGE_*)
+ * @param start_ns Znacznik zwrócony przez stats_stage_begin()
+ *
+ * @example
+ * ```c
+ * double t = stats_stage_begin();
+ * pack_pixels_1bpp(gray, packed, width, height, 1, 1);
+ * stats_stage_end(&stats, STATS_STAGE_PACKING, t);
+ * ```
+ */
+void stats_stage_end(ConversionStats* stats, int stage, double start_ns) {
+    if (!stats || stage < 0 || stage >= STATS_STAGE_COUNT) {
+        return;
+    }
+    stats->stage_ms[stage] += timing_elapsed_ms(start_ns);
+}
+
+/**
+ * @brief Zwraca nazwę etapu używaną w tabeli i JSON
+ *
+ * @param stage Identyfikator etapu (STATS_STAGE_*)
+ *
+ * @return Nazwa etapu lub "unknown"
+ */
+const char* stats_stage_name(int stage) {
+    if (stage < 0 || stage >= STATS_STAGE_COUNT) {
+        return "unknown";
+    }
+    return stats_stage_names[stage];
+}
+
+/**
+ * @brief Wypisuje statystyki pojedynczej konwersji
+ *
+ * @details W formacie tabeli wypisuje czas każdego etapu w milisekundach
+ * i jego udział w całkowitym czasie. W formacie JSON wypisuje obiekt
+ * z polami stages, total_ms i peak_bytes.
+ *
+ * @param file Plik wyjściowy (zwykle stdout)
+ * @param stats Wskaźnik do statystyk
+ * @param output_format STATS_OUTPUT_TABLE lub STATS_OUTPUT_JSON
+ */
+void stats_print(FILE* file, ConversionStats* stats, int output_format) {
+    if (output_format == STATS_OUTPUT_JSON) {
+        fprintf(file, "{\"stages\": {");
+        for (int i = 0; i < STATS_STAGE_COUNT; i++) {
+            fprintf(file, "%s\"%s\": %.3f", i ? ", " : "", stats_stage_names[i], stats->stage_ms[i]);
+        }
+        fprintf(file, "}, \"total_ms\": %.3f, \"peak_bytes\": %lu}\n", stats->total_ms, (unsigned long)stats->peak_bytes);
+        return;
+    }
+
+    fprintf(file, "- statystyki konwersji:\n");
+    fprintf(file, "  %-20s %12s %8s\n", "etap", "czas [ms]", "udział");
+    for (int i = 0; i < STATS_STAGE_COUNT; i++) {
+        double share = (stats->total_ms > 0) ? stats->stage_ms[i] * 100.0 / stats->total_ms : 0.0;
+        fprintf(file, "  %-20s %12.3f %7.1f%%\n", stats_stage_names[i], stats->stage_ms[i], share);
+    }
+    fprintf(file, "  %-20s %12.3f\n", "total", stats->total_ms);
+    fprintf(file, "  %-20s %12lu bytes\n", "peak memory", (unsigned long)stats->peak_bytes);
+}
+
+// ============================================================================
+// Śledzenie pamięci
+// ============================================================================
+
+/**
+ * @brief Alokuje pamięć z rejestracją w liczniku szczytowego zużycia
+ *
+ * @details Działa jak malloc(), ale zapamiętuje rozmiar bloku w nagłówku
+ * poprzedzającym zwracany wskaźnik, dzięki czemu stats_free() może
+ * pomniejszyć licznik bieżącego zużycia. Bloki muszą być zwalniane
+ * przez stats_free().
+ *
+ * @param size Rozmiar bloku w bajtach
+ *
+ * @return Wskaźnik do zaalokowanej pamięci lub NULL
+ *
+ * @note Liczniki są globalne i chronione muteksem - funkcję można wywoływać z wielu wątków
+ */
+void* stats_malloc(size_t size) {
+    if (size > (size_t)-1 - STATS_ALLOC_HEADER) {
+        return NULL;
+    }
+    uchar* block = (uchar*)malloc(size + STATS_ALLOC_HEADER);
+    if (!block) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    thread_mutex_lock(&stats_memory_lock);
+    stats_current_bytes += size;
+    if (stats_current_bytes > stats_max_bytes) {
+        stats_max_bytes = stats_current_bytes;
+    }
+    thread_mutex_unlock(&stats_memory_lock);
+    return block + STATS_ALLOC_HEADER;
+}
+
+/**
+ * @brief Zwalnia pamięć zaalokowaną przez stats_malloc()
+ *
+ * @param ptr Wskaźnik zwrócony przez stats_malloc() (NULL jest ignorowany)
+ */
+void stats_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    uchar* block = (uchar*)ptr - STATS_ALLOC_HEADER;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    thread_mutex_lock(&stats_memory_lock);
+    stats_current_bytes -= size;
+    thread_mutex_unlock(&stats_memory_lock);
+    free(block);
+}
+
+/**
+ * @brief Zwraca szczytową ilość pamięci zaalokowanej przez stats_malloc()
+ *
+ * @return Liczba bajtów od ostatniego stats_reset_peak()
+ */
+size_t stats_peak_bytes(void) {
+    return stats_max_bytes;
+}
+
+/**
+ * @brief Ustawia licznik szczytowy na bieżące zużycie pamięci
+ */
+void stats_reset_peak(void) {
+    stats_max_bytes = stats_current_bytes;
+}
+
+// ============================================================================
+// Agregacja statystyk (tryb wsadowy)
+// ============================================================================
+
+static int compare_double(const void* a, const void* b) {
+    double da = *(const double*)a;
+    double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Percentyl metodą najbliższej rangi na posortowanej tablicy
+static double percentile(const double* sorted, int count, double p) {
+    int rank = (int)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+/**
+ * @brief Inicjalizuje pusty agregat statystyk
+ *
+ * @param aggregate Wskaźnik do struktury StatsAggregate
+ */
+void stats_aggregate_init(StatsAggregate* aggregate) {
+    memset(aggregate, 0, sizeof(*aggregate));
+}
+
+/**
+ * @brief Dodaje statystyki jednej konwersji do agregatu
+ *
+ * @param aggregate Wskaźnik do agregatu
+ * @param stats Statystyki pojedynczego pliku
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu alokacji
+ */
+int stats_aggregate_add(StatsAggregate* aggregate, ConversionStats* stats) {
+    if (aggregate->count == aggregate->capacity) {
+        int new_capacity = aggregate->capacity ? aggregate->capacity * 2 : 16;
+        ConversionStats* samples = (ConversionStats*)realloc(aggregate->samples, new_capacity * sizeof(ConversionStats));
+        if (!samples) {
+            return 0;
+        }
+        aggregate->samples = samples;
+        aggregate->capacity = new_capacity;
+    }
+    aggregate->samples[aggregate->count++] = *stats;
+    return 1;
+}
+
+/**
+ * @brief Wypisuje sumy i percentyle czasów etapów dla wszystkich plików
+ *
+ * @details Dla każdego etapu (oraz czasu całkowitego) wypisuje sumę,
+ * średnią, percentyle p50/p90/p99 i maksimum. Szczytowa pamięć jest
+ * raportowana jako maksimum po wszystkich plikach, a gdy pliki były
+ * konwertowane równolegle - jako szczyt całego przebiegu (peak_bytes agregatu).
+ *
+ * @param file Plik wyjściowy (zwykle stdout)
+ * @param aggregate Wskaźnik do agregatu
+ * @param output_format STATS_OUTPUT_TABLE lub STATS_OUTPUT_JSON
+ */
+void stats_aggregate_print(FILE* file, StatsAggregate* aggregate, int output_format) {
+    int count = aggregate->count;
+    if (count == 0) {
+        return;
+    }
+
+    double* values = (double*)malloc(count * sizeof(double));
+    if (!values) {
+        return;
+    }
+
+    size_t peak = aggregate->peak_bytes;
+    for (int i = 0; i < count && !aggregate->peak_bytes; i++) {
+        if (aggregate->samples[i].peak_bytes > peak) {
+            peak = aggregate->samples[i].peak_bytes;
+        }
+    }
+
+    if (output_format == STATS_OUTPUT_JSON) {
+        fprintf(file, "{\"files\": %d, \"stages\": {", count);
+    } else {
+        fprintf(file, "- statystyki zbiorcze (%d plików):\n", count);
+        fprintf(file, "  %-20s %12s %10s %10s %10s %10s %10s\n", "etap [ms]", "suma", "średnia", "p50", "p90", "p99", "max");
+    }
+
+    // Ostatnia iteracja (stage == STATS_STAGE_COUNT) dotyczy czasu całkowitego
+    for (int stage = 0; stage <= STATS_STAGE_COUNT; stage++) {
+        double total = 0.0;
+        for (int i = 0; i < count; i++) {
+            values[i] = (stage < STATS_STAGE_COUNT) ? aggregate->samples[i].stage_ms[stage] : aggregate->samples[i].total_ms;
+            total += values[i];
+        }
+        qsort(values, count, sizeof(double), compare_double);
+
+        const char* name = (stage < STATS_STAGE_COUNT) ? stats_stage_names[stage] : "total";
+        if (output_format == STATS_OUTPUT_JSON) {
+            fprintf(file, "%s\"%s\": {\"sum\": %.3f, \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+                    stage ? ", " : "", name, total, total / count,
+                    percentile(values, count, 50), percentile(values, count, 90),
+                    percentile(values, count, 99), values[count - 1]);
+        } else {
+            fprintf(file, "  %-20s %12.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, total, total / count,
+                    percentile(values, count, 50), percentile(values, count, 90),
+                    percentile(values, count, 99), values[count - 1]);
+        }
+    }
+
+    if (output_format == STATS_OUTPUT_JSON) {
+        fprintf(file, "}, \"peak_bytes\": %lu}\n", (unsigned long)peak);
+    } else {
+        fprintf(file, "  %-20s %12lu bytes\n", aggregate->peak_bytes ? "peak memory (all)" : "peak memory (max)",
+                (unsigned long)peak);
+    }
+
+    free(values);
+}
+
+/**
+ * @brief Zwalnia pamięć agregatu
+ *
+ * @param aggregate Wskaźnik do agregatu
+ */
+void stats_aggregate_free(StatsAggregate* aggregate) {
+    free(aggregate->samples);
+    stats_aggregate_init(aggregate);
+}
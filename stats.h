@@ -0,0 +1,71 @@
+/*****************************************************************************
+
+    plik  : stats.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla statystyk czasu etapów konwersji i pamięci
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "defs.h"
+
+// Etapy konwersji mierzone przez --stats
+#define STATS_STAGE_HEADER_READ   0  // Odczyt i walidacja nagłówka
+#define STATS_STAGE_PIXEL_READ    1  // Odczyt danych pikseli
+#define STATS_STAGE_GRAYSCALE     2  // Konwersja do skali szarości
+#define STATS_STAGE_BRIGHTNESS    3  // Regulacja jasności i kontrastu
+#define STATS_STAGE_DITHERING     4  // Dithering i kwantyzacja
+#define STATS_STAGE_PACKING       5  // Pakowanie pikseli
+#define STATS_STAGE_INVERSION     6  // Inwersja bitów
+#define STATS_STAGE_OUTPUT_WRITE  7  // Zapis pliku wyjściowego
+#define STATS_STAGE_PREVIEW_WRITE 8  // Zapis podglądu BMP
+#define STATS_STAGE_COUNT         9
+
+// Format wypisywania statystyk
+#define STATS_OUTPUT_NONE  0  // Statystyki wyłączone (domyślnie)
+#define STATS_OUTPUT_TABLE 1  // Tabela tekstowa
+#define STATS_OUTPUT_JSON  2  // JSON
+
+// Statystyki pojedynczej konwersji
+typedef struct {
+    double stage_ms[STATS_STAGE_COUNT];  // Czas ścienny etapów w milisekundach
+    double total_ms;                     // Całkowity czas konwersji
+    size_t peak_bytes;                   // Szczytowa ilość zaalokowanej pamięci
+} ConversionStats;
+
+// Agregat statystyk wielu konwersji (tryb wsadowy)
+typedef struct {
+    int count;                           // Liczba zebranych konwersji
+    int capacity;                        // Pojemność tablicy samples
+    ConversionStats* samples;            // Statystyki poszczególnych plików
+    size_t peak_bytes;                   // Szczyt pamięci całego przebiegu (0: maksimum po plikach)
+} StatsAggregate;
+
+// Prototypy funkcji pomiaru etapów
+void stats_reset(ConversionStats* stats);
+double stats_stage_begin(void);
+void stats_stage_end(ConversionStats* stats, int stage, double start_ns);
+const char* stats_stage_name(int stage);
+void stats_print(FILE* file, ConversionStats* stats, int output_format);
+
+// Prototypy funkcji śledzenia pamięci
+void* stats_malloc(size_t size);
+void stats_free(void* ptr);
+size_t stats_peak_bytes(void);
+void stats_reset_peak(void);
+
+// Prototypy funkcji agregacji (tryb wsadowy)
+void stats_aggregate_init(StatsAggregate* aggregate);
+int stats_aggregate_add(StatsAggregate* aggregate, ConversionStats* stats);
+void stats_aggregate_print(FILE* file, StatsAggregate* aggregate, int output_format);
+void stats_aggregate_free(StatsAggregate* aggregate);
+
+#endif
@@ -0,0 +1,143 @@
+/*****************************************************************************
+
+    plik  : stream_io.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : pliki wejścia i wyjścia z obsługą "-" (stdin/stdout) do pracy
+            w potokach i regułach systemów budowania bez plików tymczasowych
+
+    licencja : MIT
+*****************************************************************************/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+#include "stream_io.h"
+
+// Strumień danych wyjściowych na pierwotnym stdout (po redirect_console_to_stderr())
+static FILE* stdout_data = NULL;
+
+/**
+ * @brief Sprawdza czy ścieżka oznacza stdin/stdout
+ *
+ * @param path Ścieżka pliku
+ *
+ * @return 1 dla "-", 0 w przeciwnym razie
+ */
+int is_stdio_path(const char* path) {
+    return strcmp(path, STDIO_PATH) == 0;
+}
+
+/**
+ * @brief Otwiera plik wejściowy lub stdin dla ścieżki "-"
+ *
+ * @details stdin jest przełączany w tryb binarny (Windows). Czytniki
+ * formatów nie przewijają wejścia, więc obraz może przyjść z potoku.
+ *
+ * @param path Ścieżka pliku lub "-"
+ *
+ * @return Strumień do odczytu lub NULL
+ */
+FILE* open_input_stream(const char* path) {
+    if (is_stdio_path(path)) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        return stdin;
+    }
+    return fopen(path, "rb");
+}
+
+/**
+ * @brief Zamyka plik wejściowy (stdin pozostaje otwarty)
+ *
+ * @param file Strumień z open_input_stream()
+ */
+void close_input_stream(FILE* file) {
+    if (file && file != stdin) {
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Przenosi komunikaty konsoli na stderr, zachowując stdout dla danych
+ *
+ * @details Gdy dane wyjściowe idą na stdout, komunikaty programu (printf)
+ * nie mogą się z nimi mieszać. Zamiast zmieniać każde wywołanie printf,
+ * deskryptor stdout jest duplikowany na strumień danych, a sam stdout
+ * kierowany na stderr - wszystkie komunikaty trafiają na stderr.
+ *
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ *
+ * @note Wywoływana raz, przed pierwszym komunikatem
+ *
+ * @example
+ * ```c
+ * if (is_stdio_path(output_path)) {
+ *     redirect_console_to_stderr();
+ * }
+ * printf("- converting...\n");  // trafia na stderr
+ * ```
+ */
+int redirect_console_to_stderr(void) {
+    fflush(stdout);
+#ifdef _WIN32
+    int data_fd = _dup(_fileno(stdout));
+    if (data_fd < 0 || _dup2(_fileno(stderr), _fileno(stdout)) != 0) {
+        return 0;
+    }
+    _setmode(data_fd, _O_BINARY);
+    stdout_data = _fdopen(data_fd, "wb");
+#else
+    int data_fd = dup(fileno(stdout));
+    if (data_fd < 0 || dup2(fileno(stderr), fileno(stdout)) < 0) {
+        return 0;
+    }
+    stdout_data = fdopen(data_fd, "wb");
+#endif
+    return stdout_data != NULL;
+}
+
+/**
+ * @brief Otwiera plik wyjściowy lub strumień stdout dla ścieżki "-"
+ *
+ * @details Dla "-" zwraca strumień danych z redirect_console_to_stderr()
+ * (lub stdout, gdy komunikaty nie zostały przeniesione). Zapisywacze
+ * piszą do niego tak jak do pliku, więc dane płyną na bieżąco.
+ *
+ * @param path Ścieżka pliku lub "-"
+ * @param mode Tryb fopen() ("w" lub "wb")
+ *
+ * @return Strumień do zapisu lub NULL
+ */
+FILE* open_output_stream(const char* path, const char* mode) {
+    if (is_stdio_path(path)) {
+        return stdout_data ? stdout_data : stdout;
+    }
+    return fopen(path, mode);
+}
+
+/**
+ * @brief Zamyka plik wyjściowy; strumień stdout jest tylko opróżniany
+ *
+ * @param file Strumień z open_output_stream()
+ *
+ * @return 1 w przypadku sukcesu, 0 gdy zapis się nie powiódł
+ */
+int close_output_stream(FILE* file) {
+    if (file == stdout || file == stdout_data) {
+        return fflush(file) == 0 && !ferror(file);
+    }
+    return fclose(file) == 0;
+}
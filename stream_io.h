@@ -0,0 +1,30 @@
+/*****************************************************************************
+
+    plik  : stream_io.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla plików wejścia i wyjścia z obsługą "-"
+            (stdin/stdout) do pracy w potokach
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef STREAM_IO_H
+#define STREAM_IO_H
+
+#include <stdio.h>
+
+// Ścieżka oznaczająca stdin (wejście) lub stdout (wyjście)
+#define STDIO_PATH "-"
+
+// Prototypy funkcji
+int is_stdio_path(const char* path);
+FILE* open_input_stream(const char* path);
+void close_input_stream(FILE* file);
+int redirect_console_to_stderr(void);
+FILE* open_output_stream(const char* path, const char* mode);
+int close_output_stream(FILE* file);
+
+#endif
@@ -0,0 +1,107 @@
+/*****************************************************************************
+
+    plik  : tests/test_bmp_palette.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : testy regresji odczytu palety BMP (read_bmp_gray_lut) dla
+            uszkodzonych nagłówków - biClrUsed poza zakresem i paleta
+            nachodząca na dane obrazu
+
+    licencja : MIT
+*****************************************************************************/
+
+#define _CRT_SECURE_NO_DEPRECATE
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+#include "../bmp_defs.h"
+#include "../bmp_indexed.h"
+
+static int failures = 0;
+
+#define CHECK(condition, name) \
+    do { \
+        if (condition) { \
+            printf("ok   %s\n", name); \
+        } else { \
+            printf("FAIL %s\n", name); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief Buduje plik BMP 8bpp z zadanym biClrUsed i liczbą wpisów palety w pliku
+ *
+ * @param colors_used Pole biClrUsed nagłówka
+ * @param palette_entries Wpisy palety zapisane przed danymi obrazu (data_offset)
+ * @param header Nagłówek pliku (wyjściowy)
+ * @param info Nagłówek informacyjny (wyjściowy)
+ *
+ * @return Plik tymczasowy ustawiony na początku lub NULL
+ */
+static FILE* make_bmp(dword colors_used, int palette_entries, BMPHeader* header, BMPInfoHeader* info) {
+    FILE* file = tmpfile();
+    if (!file) {
+        return NULL;
+    }
+    memset(header, 0, sizeof(*header));
+    memset(info, 0, sizeof(*info));
+    memcpy(header->signature, BMP_SIGNATURE_1, 2);
+    header->data_offset = BMP_HEADER_SIZE + BMP_INFO_HEADER_SIZE + palette_entries * (dword)sizeof(BMPColorEntry);
+    header->file_size = header->data_offset + 4;
+    info->header_size = BMP_INFO_HEADER_SIZE;
+    info->width = 4;
+    info->height = 1;
+    info->planes = 1;
+    info->bits_per_pixel = 8;
+    info->colors_used = colors_used;
+
+    fwrite(header, BMP_HEADER_SIZE, 1, file);
+    fwrite(info, BMP_INFO_HEADER_SIZE, 1, file);
+    for (int i = 0; i < palette_entries; i++) {
+        BMPColorEntry entry = {(uchar)i, (uchar)i, (uchar)i, 0};
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+    // Dane obrazu i zapas, który przy błędnym rozmiarze palety zostałby wczytany jako paleta
+    for (int i = 0; i < 4096; i++) {
+        fputc(0xAA, file);
+    }
+    rewind(file);
+    return file;
+}
+
+// Odczyt palety od początku pliku, tak jak po read_bmp_headers()
+static int read_lut(dword colors_used, int palette_entries, uchar* lut) {
+    BMPHeader header;
+    BMPInfoHeader info;
+    FILE* file = make_bmp(colors_used, palette_entries, &header, &info);
+    if (!file) {
+        return -1;
+    }
+    unsigned long long position = 0;
+    int result = read_bmp_gray_lut(file, &header, &info, BITS_PER_PIXEL_8BPP, lut, &position);
+    fclose(file);
+    return result;
+}
+
+int main(void) {
+    uchar lut[BMP_MAX_PALETTE_COLORS];
+
+    // biClrUsed >= 2^31 nie może stać się ujemną liczbą kolorów - przycięcie do 2^bpp
+    CHECK(read_lut(0x80000000u, 256, lut) == 1 && lut[255] == 255, "biClrUsed 0x80000000 clamps to 256 colors");
+    CHECK(read_lut(0xFFFFFFFFu, 256, lut) == 1 && lut[1] == 1, "biClrUsed 0xFFFFFFFF clamps to 256 colors");
+
+    // Jawna paleta dłuższa niż miejsce przed danymi obrazu - uszkodzony nagłówek
+    CHECK(read_lut(0x80000000u, 2, lut) == 0, "oversized biClrUsed past data_offset is rejected");
+    CHECK(read_lut(16, 2, lut) == 0, "biClrUsed 16 with 2 palette entries is rejected");
+
+    // biClrUsed = 0: domyślna paleta 2^bpp przycięta do miejsca przed danymi
+    CHECK(read_lut(0, 2, lut) == 1 && lut[1] == 1 && lut[2] == 0, "implicit palette is limited to data_offset");
+    CHECK(read_lut(2, 2, lut) == 1 && lut[0] == 0 && lut[1] == 1, "valid 2-color palette");
+
+    printf("%s\n", failures ? "FAILED" : "all tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/*****************************************************************************
+
+    plik  : threads.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : implementacja przenośnej obsługi wątków (pthreads / Win32)
+
+    licencja : MIT
+*****************************************************************************/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "threads.h"
+
+// Wspólny stan puli - kolejne indeksy zadań są pobierane pod blokadą
+typedef struct {
+    ParallelTask task;
+    void* arg;
+    int task_count;
+    int next_index;
+    ThreadMutex lock;
+} ParallelQueue;
+
+/**
+ * @brief Blokuje muteks
+ *
+ * @param mutex Muteks zainicjalizowany wartością THREAD_MUTEX_INITIALIZER
+ */
+void thread_mutex_lock(ThreadMutex* mutex) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+/**
+ * @brief Odblokowuje muteks
+ *
+ * @param mutex Muteks zablokowany przez thread_mutex_lock()
+ */
+void thread_mutex_unlock(ThreadMutex* mutex) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+/**
+ * @brief Zwraca liczbę dostępnych procesorów logicznych
+ *
+ * @return Liczba procesorów (co najmniej 1)
+ */
+int threads_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Pętla wątku roboczego - wykonuje zadania do wyczerpania kolejki
+static void parallel_worker(ParallelQueue* queue) {
+    for (;;) {
+        thread_mutex_lock(&queue->lock);
+        int index = queue->next_index++;
+        thread_mutex_unlock(&queue->lock);
+
+        if (index >= queue->task_count) {
+            return;
+        }
+        queue->task(queue->arg, index);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI parallel_thread_main(LPVOID param) {
+    parallel_worker((ParallelQueue*)param);
+    return 0;
+}
+#else
+static void* parallel_thread_main(void* param) {
+    parallel_worker((ParallelQueue*)param);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Wykonuje task_count zadań na puli wątków
+ *
+ * @details Uruchamia min(task_count, max_threads) - 1 wątków pomocniczych,
+ * a wątek wywołujący pracuje razem z nimi. Zadania są przydzielane
+ * dynamicznie (kolejny wolny indeks), więc nierówne czasy zadań nie
+ * blokują puli. Funkcja wraca po zakończeniu wszystkich zadań. Jeżeli
+ * utworzenie wątku się nie powiedzie, pozostałe zadania wykonują już
+ * uruchomione wątki.
+ *
+ * @param task_count Liczba zadań
+ * @param task Funkcja zadania wywoływana jako task(arg, index)
+ * @param arg Argument przekazywany do każdego zadania
+ * @param max_threads Maksymalna liczba wątków (0 = liczba procesorów)
+ *
+ * @return Liczba wątków, które wykonywały zadania
+ *
+ * @note Zadania muszą same zapisywać swoje wyniki (np. w tablicy po indeksie)
+ *
+ * @example
+ * ```c
+ * static void write_one(void* arg, int index) {
+ *     Job* jobs = (Job*)arg;
+ *     jobs[index].result = write_job(&jobs[index]);
+ * }
+ *
+ * run_parallel(job_count, write_one, jobs, 0);
+ * ```
+ */
+int run_parallel(int task_count, ParallelTask task, void* arg, int max_threads) {
+    if (task_count <= 0) {
+        return 0;
+    }
+    if (max_threads <= 0) {
+        max_threads = threads_cpu_count();
+    }
+    if (max_threads > THREADS_MAX_WORKERS) {
+        max_threads = THREADS_MAX_WORKERS;
+    }
+    int thread_count = (task_count < max_threads) ? task_count : max_threads;
+
+    ParallelQueue queue = {task, arg, task_count, 0, THREAD_MUTEX_INITIALIZER};
+
+#ifdef _WIN32
+    HANDLE handles[THREADS_MAX_WORKERS];
+#else
+    pthread_t handles[THREADS_MAX_WORKERS];
+#endif
+    int started = 0;
+    for (int i = 1; i < thread_count; i++) {
+#ifdef _WIN32
+        handles[started] = CreateThread(NULL, 0, parallel_thread_main, &queue, 0, NULL);
+        if (!handles[started]) {
+            break;
+        }
+#else
+        if (pthread_create(&handles[started], NULL, parallel_thread_main, &queue) != 0) {
+            break;
+        }
+#endif
+        started++;
+    }
+
+    parallel_worker(&queue);
+
+    for (int i = 0; i < started; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+
+    return started + 1;
+}
@@ -0,0 +1,38 @@
+/*****************************************************************************
+
+    plik  : threads.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla przenośnej obsługi wątków (pthreads / Win32)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK ThreadMutex;
+#define THREAD_MUTEX_INITIALIZER SRWLOCK_INIT
+#else
+#include <pthread.h>
+typedef pthread_mutex_t ThreadMutex;
+#define THREAD_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#endif
+
+// Maksymalna liczba wątków roboczych uruchamianych przez run_parallel()
+#define THREADS_MAX_WORKERS 64
+
+// Zadanie wykonywane równolegle: task(arg, index) dla index = 0..count-1
+typedef void (*ParallelTask)(void* arg, int index);
+
+// Prototypy funkcji obsługi wątków
+int threads_cpu_count(void);
+int run_parallel(int task_count, ParallelTask task, void* arg, int max_threads);
+void thread_mutex_lock(ThreadMutex* mutex);
+void thread_mutex_unlock(ThreadMutex* mutex);
+
+#endif
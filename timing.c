@@ -0,0 +1,84 @@
+/*****************************************************************************
+
+    plik  : timing.c
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : implementacja pomiaru czasu (zegar monotoniczny)
+
+    licencja : MIT
+*****************************************************************************/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "timing.h"
+
+/**
+ * @brief Zwraca bieżący czas zegara monotonicznego w nanosekundach
+ * 
+ * @details Funkcja odczytuje zegar monotoniczny systemu (QueryPerformanceCounter
+ * na Windows, clock_gettime(CLOCK_MONOTONIC) na systemach POSIX). Wartość
+ * bezwzględna nie ma znaczenia - służy wyłącznie do liczenia różnic czasu.
+ * 
+ * @return Czas w nanosekundach od nieokreślonego punktu odniesienia
+ * 
+ * @note Zegar nie cofa się przy zmianie czasu systemowego
+ * 
+ * @example
+ * ```c
+ * double start = timing_now_ns();
+ * pack_pixels_1bpp(gray, packed, 256, 64, 1, 1);
+ * printf("%.0f ns\n", timing_now_ns() - start);
+ * ```
+ */
+double timing_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Zwraca czas w milisekundach, który upłynął od podanego momentu
+ * 
+ * @param start_ns Moment początkowy zwrócony przez timing_now_ns()
+ * 
+ * @return Czas w milisekundach
+ */
+double timing_elapsed_ms(double start_ns) {
+    return (timing_now_ns() - start_ns) / 1e6;
+}
+
+/**
+ * @brief Zwraca bieżący czas lokalny (bezpieczne dla wątków)
+ * 
+ * @details W przeciwieństwie do localtime() nie korzysta ze wspólnego
+ * statycznego bufora, więc może być wywoływana równolegle przez kilka
+ * zapisywaczy plików.
+ * 
+ * @param out Struktura wypełniana czasem lokalnym
+ */
+void timing_local_time(struct tm* out) {
+    time_t now = time(NULL);
+#ifdef _WIN32
+    localtime_s(out, &now);
+#else
+    localtime_r(&now, out);
+#endif
+}
@@ -0,0 +1,23 @@
+/*****************************************************************************
+
+    plik  : timing.h
+    autor : Michal Kolodziejski (2:480/112.10)
+    data  : 2026.10.19
+    copyright  : PTODT <https://ptodt.org.pl>
+
+    opis  : plik nagłówkowy dla pomiaru czasu (zegar monotoniczny)
+
+    licencja : MIT
+*****************************************************************************/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <time.h>
+
+// Prototypy funkcji pomiaru czasu
+double timing_now_ns(void);
+double timing_elapsed_ms(double start_ns);
+void timing_local_time(struct tm* out);
+
+#endif
@@ -16,6 +16,47 @@
 #include <time.h>
 #include "defs.h"
 #include "utils.h"
+#include "timing.h"
+#include "stream_io.h"
+#include "color.h"
+#include "blue_noise.h"
+#include "dither_matrices.h"
+
+// SSE2 jest dostępne na każdym procesorze x86-64 (i opcjonalnie na x86)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTILS_USE_SSE2 1
+#endif
+
+// Szerokość paska kolumn przy blokowym pakowaniu pionowym (jedna linia cache)
+#define PACK_STRIP_COLUMNS 64
+
+// Pusty pasek kolumn - zastępuje wiersze spoza pasma w kernelach kolumn
+static const uchar zero_strip[PACK_STRIP_COLUMNS];
+
+// Długość wektora progów wiersza w ditheringu progowym (wielokrotność boku każdej matrycy)
+#define THRESHOLD_ROW_LENGTH BLUE_NOISE_SIZE
+
+// Nazwy metod ditheringu: opcja -d i nazwa w nagłówku / na konsoli
+typedef struct {
+    int dithering_method;
+    const char* option_name;
+    const char* display_name;
+} DitheringMethodInfo;
+
+static const DitheringMethodInfo dithering_methods[] = {
+    {DITHERING_NONE,          "none",   "None"},
+    {DITHERING_FLOYD,         "floyd",  "Floyd-Steinberg"},
+    {DITHERING_ORDERED_2X2,   "o2x2",   "Ordered 2x2"},
+    {DITHERING_ORDERED_4X4,   "o4x4",   "Ordered 4x4"},
+    {DITHERING_ORDERED,       "o8x8",   "Ordered 8x8"},
+    {DITHERING_ORDERED_16X16, "o16x16", "Ordered 16x16"},
+    {DITHERING_CLUSTER_4X4,   "c4x4",   "Cluster-dot 4x4"},
+    {DITHERING_CLUSTER_8X8,   "c8x8",   "Cluster-dot 8x8"},
+    {DITHERING_BLUE_NOISE,    "blue",   "Blue noise 64x64"}
+};
+
+#define DITHERING_METHOD_COUNT ((int)(sizeof(dithering_methods) / sizeof(dithering_methods[0])))
 
 // ============================================================================
 // Funkcje konwersji do skali szarości
@@ -79,57 +120,43 @@ uchar scale_to_4bpp(int gray_value) {
  * 
  * @details Funkcja konwertuje cały obraz BMP z formatu RGB na skalę szarości 4bpp.
  * Przetwarza obraz piksel po piksel, konwertując każdy piksel RGB na wartość
- * w skali szarości, a następnie skalując do formatu 4bpp (0-15). Obsługuje
- * standardowy format BMP z odwróconym porządkiem wierszy (od dołu do góry).
+ * w skali szarości, a następnie skalując do formatu 4bpp (0-15). Orientację
+ * obrazu (BMP od dołu lub od góry) obsługuje widok wierszy - wiersze są
+ * czytane w kolejności pliku, bez kopiowania ani odwracania danych.
  * 
- * @param image_data Wskaźnik do danych obrazu BMP (format BGR)
- * @param grayscale_data Wskaźnik do bufora wyjściowego (format 4bpp)
- * @param width Szerokość obrazu w pikselach
- * @param height Wysokość obrazu w pikselach
- * @param bytes_per_row Liczba bajtów na wiersz w obrazie BMP (z padding)
+ * @param view Widok wierszy obrazu wejściowego (24 lub 32 bpp, format BGR/BGRA)
+ * @param grayscale_data Wskaźnik do bufora wyjściowego (format 4bpp, od góry do dołu)
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym (>= szerokość; dokładna
+ *        szerokość także dla nieparzystej - kernele pakujące zerują ostatni półbajt)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
  * 
- * @note Obraz jest odwracany w pionie (BMP → PIL format)
- * @note Zakłada format 24-bit RGB (3 bajty na piksel)
- * 
  * @example
  * ```c
- * uchar* bmp_data = malloc(file_size);
- * uchar* gray_data = malloc(width * height);
- * 
- * // Wczytaj dane BMP
- * fread(bmp_data, 1, file_size, file);
+ * ImageRowView view;
+ * make_bmp_row_view(&view, bmp_data, width, height, 24, top_down);
  * 
  * // Konwertuj na skalę szarości 4bpp
- * if (convert_to_grayscale_4bpp(bmp_data, gray_data, width, height, row_size)) {
+ * if (convert_to_grayscale_4bpp(&view, gray_data, width)) {
  *     // gray_data zawiera teraz dane w formacie 4bpp
  * }
  * ```
  */
-int convert_to_grayscale_4bpp(uchar* image_data, uchar* grayscale_data, int width, int height, int bytes_per_row) {
-    int bytes_per_pixel = 3; // Zakładamy 24-bit na razie
+int convert_to_grayscale_4bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride) {
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    if (bytes_per_pixel < 3) {
+        return 0;
+    }
     
-    // BMP przechowuje wiersze od dołu do góry, ale chcemy od góry do dołu jak PIL
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            // Odczytaj z dolnego wiersza najpierw (format BMP)
-            int src_y = height - 1 - y;
-            int src_offset = src_y * bytes_per_row + x * bytes_per_pixel;
-            
-            // Wyciągnij wartości RGB (BMP przechowuje jako BGR)
-            uchar r = image_data[src_offset + 2];
-            uchar g = image_data[src_offset + 1];
-            uchar b = image_data[src_offset + 0];
-            
-            // Konwertuj do skali szarości
-            int gray = convert_rgb_to_grayscale(r, g, b);
-            
-            // Skaluj do 4bpp
-            uchar gray_4bpp = scale_to_4bpp(gray);
-            
-            // Zapisz w buforze skali szarości (od góry do dołu jak PIL)
-            grayscale_data[y * width + x] = gray_4bpp;
+    // Wiersze w kolejności pliku - dla BMP od dołu od ostatniego wiersza obrazu
+    for (int i = 0; i < view->height; i++) {
+        int y = (view->stride < 0) ? view->height - 1 - i : i;
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        uchar* dst = grayscale_data + (size_t)y * grayscale_stride;
+        
+        for (int x = 0; x < view->width; x++, src += bytes_per_pixel) {
+            // BMP przechowuje piksele jako BGR(A)
+            dst[x] = scale_to_4bpp(convert_rgb_to_grayscale(src[2], src[1], src[0]));
         }
     }
     
@@ -159,40 +186,76 @@ int convert_to_grayscale_4bpp(uchar* image_data, uchar* grayscale_data, int widt
  * 
  * @example
  * ```c
- * HeaderContext ctx = {256, 64, 1, DITHERING_FLOYD, 60, 70, 1, 0};
+ * HeaderContext ctx = {256, 64, 1, DITHERING_FLOYD, 60, 70, 1, 0, 0};
  * FILE* file = fopen("output.h", "w");
  * write_file_header(file, &ctx);
  * // Generuje: // Generated by BMP to xbpp Array Converter 1.0.3 (2025-10-01 11:30:00)...
  * ```
  */
 void write_file_header(FILE* file, HeaderContext* ctx) {
+    write_generator_comment(file, ctx->is_assembler);
+    write_format_comment(file, ctx);
+}
+
+/**
+ * @brief Zapisuje komentarz z wersją programu i czasem generowania
+ * 
+ * @details Pierwsze dwa wiersze nagłówka write_file_header(). Zbiorcze
+ * wyjście manifestu (--manifest) zapisuje je raz na początku pliku.
+ * 
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * @param is_assembler 1 = prefiks ";", 0 = prefiks "//"
+ */
+void write_generator_comment(FILE* file, int is_assembler) {
     // Pobierz aktualną datę i czas generowania pliku
-    time_t now = time(0);
-    struct tm* tm_info = localtime(&now);
+    struct tm tm_info;
+    timing_local_time(&tm_info);
     char generation_time[16];
-    strftime(generation_time, sizeof(generation_time), "%Y%m%dT%H%M%S", tm_info);
+    strftime(generation_time, sizeof(generation_time), "%Y%m%dT%H%M%S", &tm_info);
     
-    const char* comment_prefix = ctx->is_assembler ? ";" : "//";
+    const char* comment_prefix = is_assembler ? ";" : "//";
     
     fprintf(file, "%s Generated by BMP to xbpp Array Converter %s (%s) (c) %s (https://ptodt.org.pl)\n", 
             comment_prefix, VERSION_STRING, BUILD_DATETIME, COPYRIGHT_STRING);
     fprintf(file, "%s Created on: %s\n", comment_prefix, generation_time);
+}
+
+/**
+ * @brief Zapisuje komentarz z wymiarami i formatem danych obrazu
+ * 
+ * @details Pozostała część nagłówka write_file_header(); w zbiorczym
+ * wyjściu manifestu poprzedza tablicę każdego zasobu.
+ * 
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * @param ctx Wskaźnik do struktury HeaderContext z parametrami nagłówka
+ */
+void write_format_comment(FILE* file, HeaderContext* ctx) {
+    const char* comment_prefix = ctx->is_assembler ? ";" : "//";
     
     if (ctx->width > 0 && ctx->height > 0) {
         fprintf(file, "%s Image size: %dx%d\n", comment_prefix, ctx->width, ctx->height);
     }
     
+    const char* dither_name = dithering_method_name(ctx->dithering_method);
+    if (ctx->color_format != COLOR_FORMAT_NONE) {
+        // Wyjście kolorowe: format pikseli zamiast głębi skali szarości
+        fprintf(file, "%s Format: %s (%dbpp, dithering: %s%s)\n", comment_prefix, color_format_name(ctx->color_format),
+                color_format_bits(ctx->color_format), dither_name, ctx->invert ? ", inverted" : "");
+        return;
+    }
+    
     fprintf(file, "%s Format: %dbpp", comment_prefix, ctx->bits_per_pixel);
     
-    if (ctx->bits_per_pixel == BITS_PER_PIXEL_1BPP) {
-        const char* dither_name = (ctx->dithering_method == DITHERING_FLOYD) ? "Floyd-Steinberg" :
-                                 (ctx->dithering_method == DITHERING_ORDERED) ? "Ordered 8x8" : "None";
+    // 4bpp bez ditheringu zachowuje dotychczasowy, krótki opis formatu
+    int show_dithering = BPP_IS_DITHERED(ctx->bits_per_pixel) &&
+                         (ctx->bits_per_pixel < BITS_PER_PIXEL_4BPP || ctx->dithering_method != DITHERING_NONE);
+    if (show_dithering) {
         fprintf(file, " (dithering: %s, brightness: %d%%, contrast: %d%%", dither_name, ctx->brightness, ctx->contrast);
         if (ctx->invert) {
             fprintf(file, ", inverted");
         }
         fprintf(file, ")");
-    } else if (ctx->bits_per_pixel == BITS_PER_PIXEL_4BPP) {
+    } else {
         if (ctx->brightness != 50 || ctx->contrast != 50) {
             fprintf(file, " (brightness: %d%%, contrast: %d%%", ctx->brightness, ctx->contrast);
             if (ctx->invert) {
@@ -214,22 +277,23 @@ void write_file_header(FILE* file, HeaderContext* ctx) {
  * a następnie dodaje nowe zgodnie z konwencją nazewnictwa dla każdego formatu.
  * 
  * @param output_file Nazwa pliku wyjściowego (modyfikowana w miejscu)
+ * @param size Rozmiar bufora output_file (rozszerzenie jest przycinane do bufora)
  * @param output_format Format wyjściowy (FORMAT_C_ARRAY, FORMAT_RAW_DATA, etc.)
  * 
  * @note Modyfikuje string w miejscu - nie alokuje nowej pamięci
- * @note Mapowanie: C_ARRAY→.h, RAW_DATA→.hex, ASSEMBLER→.inc, MASM_ARRAY→.inc
+ * @note Mapowanie: C_ARRAY→.h, RAW_DATA→.hex, ASSEMBLER→.inc, MASM_ARRAY→.inc, BINARY→.bin, BMP_PREVIEW→.bmp
  * 
  * @example
  * ```c
  * char filename[256] = "my_image";
- * set_default_extension(filename, FORMAT_C_ARRAY);
+ * set_default_extension(filename, sizeof(filename), FORMAT_C_ARRAY);
  * // filename = "my_image.h"
  * 
- * set_default_extension(filename, FORMAT_RAW_DATA);
+ * set_default_extension(filename, sizeof(filename), FORMAT_RAW_DATA);
  * // filename = "my_image.hex"
  * ```
  */
-void set_default_extension(char* output_file, int output_format) {
+void set_default_extension(char* output_file, size_t size, int output_format) {
     // Usuń istniejące rozszerzenie
     char* dot = strrchr(output_file, '.');
     if (dot) {
@@ -237,26 +301,601 @@ void set_default_extension(char* output_file, int output_format) {
     }
     
     // Dodaj odpowiednie rozszerzenie na podstawie formatu
+    const char* extension = "";
     switch (output_format) {
         case FORMAT_C_ARRAY:
-            strncat(output_file, ".h", 2);
+            extension = ".h";
             break;
         case FORMAT_RAW_DATA:
-            strncat(output_file, ".hex", 4);
+            extension = ".hex";
             break;
         case FORMAT_ASSEMBLER:
-            strncat(output_file, ".inc", 4);
-            break;
         case FORMAT_MASM_ARRAY:
-            strncat(output_file, ".inc", 4);
+            extension = ".inc";
+            break;
+        case FORMAT_BINARY:
+            extension = ".bin";
+            break;
+        case FORMAT_BMP_PREVIEW:
+            extension = ".bmp";
             break;
     }
+    size_t length = strlen(output_file);
+    if (length < size) {
+        snprintf(output_file + length, size - length, "%s", extension);
+    }
 }
 
 // ============================================================================
 // Funkcje konwersji obrazu
 // ============================================================================
 
+/**
+ * @brief Mnoży dwa rozmiary z kontrolą przepełnienia
+ * 
+ * @details Wszystkie rozmiary buforów obliczane z wymiarów obrazu przechodzą
+ * przez tę funkcję, aby bardzo duże obrazy (np. ściany LED powyżej 4 GB)
+ * nie powodowały cichego przepełnienia i alokacji zbyt małego bufora.
+ * 
+ * @param a Pierwszy czynnik
+ * @param b Drugi czynnik
+ * @param result Wynik mnożenia (ustawiany tylko w przypadku sukcesu)
+ * 
+ * @return 1 w przypadku sukcesu, 0 jeśli wynik nie mieści się w size_t
+ * 
+ * @example
+ * ```c
+ * size_t pixel_count;
+ * if (!size_multiply(width, height, &pixel_count)) {
+ *     printf("Error: Image too large\n");
+ * }
+ * ```
+ */
+int size_multiply(size_t a, size_t b, size_t* result) {
+    if (a != 0 && b > (size_t)-1 / a) {
+        return 0;
+    }
+    *result = a * b;
+    return 1;
+}
+
+/**
+ * @brief Oblicza rozmiar spakowanych danych dla danej głębi i kierunku skanowania
+ * 
+ * @details Każdy wiersz (skanowanie poziome) lub kolumna (skanowanie pionowe)
+ * zaczyna się od nowego bajtu, więc rozmiar jest zaokrąglany w górę osobno
+ * dla każdej linii, a nie dla całego obrazu.
+ * 
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param scan_direction Kierunek skanowania (1=poziomy, 0=pionowy)
+ * 
+ * @return Rozmiar danych w bajtach lub 0, jeśli rozmiar nie mieści się w size_t
+ * 
+ * @example
+ * ```c
+ * size_t size = calculate_packed_size(37, 23, BITS_PER_PIXEL_1BPP, 1);  // 5 * 23 = 115
+ * size_t size2 = calculate_packed_size(37, 23, BITS_PER_PIXEL_1BPP, 0); // 37 * 3 = 111
+ * ```
+ */
+size_t calculate_packed_size(int width, int height, int bits_per_pixel, int scan_direction) {
+    size_t pixels_per_byte = 8 / bits_per_pixel;
+    size_t line_bytes = scan_direction ? ((size_t)width + pixels_per_byte - 1) / pixels_per_byte
+                                       : ((size_t)height + pixels_per_byte - 1) / pixels_per_byte;
+    size_t size;
+    if (!size_multiply(line_bytes, scan_direction ? (size_t)height : (size_t)width, &size)) {
+        return 0;
+    }
+    return size;
+}
+
+// Linie wyjścia jednego wywołania kernela: bajt k linii l leży pod
+// data[l * line_stride + k * byte_stride], linia 0 to pierwszy wiersz
+// (kernele wierszy) albo pierwsza kolumna (kernele kolumn) pasma
+typedef struct {
+    uchar* data;               // Bajt 0 pierwszej linii
+    ptrdiff_t line_stride;     // Odstęp kolejnych linii (ujemny - linie od końca bufora)
+    ptrdiff_t byte_stride;     // Odstęp kolejnych bajtów linii
+    int msb_first;             // 1 = pierwszy piksel linii na najstarszych bitach bajtu
+    int reverse_pixels;        // 1 = piksele linii idą od końca wiersza / kolumny źródła
+    int first_pixel;           // Pozycja w linii piksela z pierwszego wiersza pasma (kernele kolumn)
+    int line_pixels;           // Długość linii w pikselach (kernele kolumn)
+} PackTarget;
+
+// Bajty linii [first_byte, end_byte) z pikselami pasma rows wierszy (kernele kolumn, reverse jak target->reverse_pixels)
+static void column_byte_range(const PackTarget* target, int reverse, int rows, int per_byte, int* first_byte, int* end_byte) {
+    int low = reverse ? target->first_pixel - rows + 1 : target->first_pixel;
+    *first_byte = low / per_byte;
+    *end_byte = (low + rows - 1) / per_byte + 1;
+}
+
+/**
+ * @brief Wyznacza wiersze pasma składające się na bajt kolumny
+ *
+ * @details Piksel r bajtu byte_index leży na pozycji byte_index * per_byte + r
+ * linii. Pozycje poza pasmem dostają NULL - przy obrocie i odbiciu granice
+ * pasm nie muszą wypadać na granicy bajtu, więc bajt może być złożony
+ * z dwóch kolejnych pasm. Kierunek reverse jest przekazywany osobno, żeby
+ * warianty kerneli mogły go podać jako stałą.
+ *
+ * @return 1 gdy część pikseli bajtu zapisało już wcześniejsze pasmo
+ *         (bajt jest wtedy dopisywany przez OR), 0 w przeciwnym razie
+ */
+static int column_byte_rows(const uchar* grayscale_data, int width, int rows, const PackTarget* target, int reverse, int byte_index, int per_byte, const uchar** row_data) {
+    int merge = 0;
+    for (int r = 0; r < per_byte; r++) {
+        int position = byte_index * per_byte + r;
+        int band_row = reverse ? target->first_pixel - position : position - target->first_pixel;
+        if (band_row >= 0 && band_row < rows) {
+            row_data[r] = grayscale_data + (size_t)band_row * width;
+        } else {
+            row_data[r] = NULL;
+            // Wiersze przed pasmem są już spakowane; pozycje za końcem linii to dopełnienie
+            merge |= (band_row < 0 && position < target->line_pixels);
+        }
+    }
+    return merge;
+}
+
+/**
+ * @brief Wyznacza pasek kolumn i bajt linii bloku kernela kolumn
+ *
+ * @details Domyślnie pasek kolumn jest przechodzony przez wszystkie bajty
+ * linii, zanim kernel przejdzie do następnego - zapisy każdej kolumny (-v)
+ * są wtedy ciągłe. Gdy kolejne linie leżą w sąsiednich bajtach (strony
+ * sterowników OLED), bajt linii jest liczony dla całej szerokości naraz,
+ * więc zarówno odczyt wierszy, jak i zapis strony są sekwencyjne.
+ */
+static void column_block(const PackTarget* target, int block, int strip_count, int first_byte, int end_byte, int* x0, int* byte_index) {
+    int byte_count = end_byte - first_byte;
+    if (target->line_stride == 1 || target->line_stride == -1) {
+        *byte_index = first_byte + block / strip_count;
+        *x0 = (block % strip_count) * PACK_STRIP_COLUMNS;
+    } else {
+        *x0 = (block / byte_count) * PACK_STRIP_COLUMNS;
+        *byte_index = first_byte + block % byte_count;
+    }
+}
+
+// Rozrzuca bajty paska kolumn x0..x0+strip-1 do bajtu byte_index kolejnych linii
+static void scatter_column_bytes(const uchar* band, int strip, const PackTarget* target, int x0, int byte_index, int merge) {
+    uchar* dst = target->data + (ptrdiff_t)x0 * target->line_stride + (ptrdiff_t)byte_index * target->byte_stride;
+    if (merge) {
+        for (int x = 0; x < strip; x++, dst += target->line_stride) {
+            *dst |= band[x];
+        }
+    } else {
+        for (int x = 0; x < strip; x++, dst += target->line_stride) {
+            *dst = band[x];
+        }
+    }
+}
+
+/**
+ * @brief Blokowe pakowanie kolumn 1bpp (transpozycja bitów 8xN)
+ *
+ * @details Zamiast przechodzić obraz kolumna po kolumnie (skok o width przy
+ * każdym pikselu), funkcja dzieli obraz na paski po PACK_STRIP_COLUMNS kolumn
+ * i przetwarza je pasmami po 8 wierszy. Każde pasmo czyta 8 krótkich,
+ * ciągłych fragmentów wierszy i składa z nich po jednym bajcie dla każdej
+ * kolumny paska, więc odczyt jest sekwencyjny, a zapisy trafiają do
+ * PACK_STRIP_COLUMNS ciągłych strumieni wyjściowych. Z SSE2 bajty 16 kolumn
+ * są liczone jednocześnie.
+ *
+ * @param grayscale_data Piksele 0/1 pasma (width * rows, od góry do dołu)
+ * @param width Szerokość obrazu w pikselach
+ * @param rows Liczba wierszy pasma
+ * @param target Położenie linii (kolumn źródła) w buforze wyjściowym
+ */
+static void pack_1bpp_vertical_blocked(const uchar* grayscale_data, int width, int rows, const PackTarget* target) {
+    int first_byte, end_byte;
+    column_byte_range(target, target->reverse_pixels, rows, 8, &first_byte, &end_byte);
+    int strip_count = (width + PACK_STRIP_COLUMNS - 1) / PACK_STRIP_COLUMNS;
+    int block_count = strip_count * (end_byte - first_byte);
+    uchar band[PACK_STRIP_COLUMNS];
+    const uchar* row_data[8];
+    const uchar* strip_rows[8];
+    uchar bits[8];
+    for (int r = 0; r < 8; r++) {
+        bits[r] = (uchar)(target->msb_first ? (0x80 >> r) : (1 << r));
+    }
+#ifdef UTILS_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bit_masks[8];
+    for (int r = 0; r < 8; r++) {
+        bit_masks[r] = _mm_set1_epi8((char)bits[r]);
+    }
+#endif
+
+    for (int block = 0; block < block_count; block++) {
+        int x0, yb;
+        column_block(target, block, strip_count, first_byte, end_byte, &x0, &yb);
+        int strip = (width - x0 < PACK_STRIP_COLUMNS) ? width - x0 : PACK_STRIP_COLUMNS;
+        int merge = column_byte_rows(grayscale_data, width, rows, target, target->reverse_pixels, yb, 8, row_data);
+        for (int r = 0; r < 8; r++) {
+            strip_rows[r] = row_data[r] ? row_data[r] + x0 : zero_strip;
+        }
+        // Strony wyświetlacza: bajty paska leżą obok siebie, więc trafiają
+        // od razu do wyjścia bez rozrzucania przez scatter_column_bytes()
+        uchar* out = band;
+        if (target->line_stride == 1 && !merge) {
+            out = target->data + x0 + (ptrdiff_t)yb * target->byte_stride;
+        }
+        int x = 0;
+
+#ifdef UTILS_USE_SSE2
+        for (; x + 16 <= strip; x += 16) {
+            __m128i acc = zero;
+            for (int r = 0; r < 8; r++) {
+                __m128i is_zero = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(strip_rows[r] + x)), zero);
+                acc = _mm_or_si128(acc, _mm_andnot_si128(is_zero, bit_masks[r]));
+            }
+            _mm_storeu_si128((__m128i*)(out + x), acc);
+        }
+#endif
+        for (; x < strip; x++) {
+            uchar byte_value = 0;
+            for (int r = 0; r < 8; r++) {
+                if (strip_rows[r][x]) {
+                    byte_value |= bits[r];
+                }
+            }
+            out[x] = byte_value;
+        }
+
+        if (out == band) {
+            scatter_column_bytes(band, strip, target, x0, yb, merge);
+        }
+    }
+}
+
+/**
+ * @brief Blokowe pakowanie kolumn 4bpp (transpozycja 2xN)
+ *
+ * @details Odpowiednik pack_1bpp_vertical_blocked() dla 4bpp: paski po
+ * PACK_STRIP_COLUMNS kolumn są przetwarzane pasmami po 2 wiersze, a każda
+ * para pikseli z tej samej kolumny daje jeden bajt. Z SSE2 bajty
+ * 16 kolumn są składane jednocześnie.
+ *
+ * @param grayscale_data Piksele 0-15 pasma (width * rows, od góry do dołu)
+ * @param width Szerokość obrazu w pikselach
+ * @param rows Liczba wierszy pasma
+ * @param target Położenie linii (kolumn źródła) w buforze wyjściowym
+ */
+static void pack_4bpp_vertical_blocked(const uchar* grayscale_data, int width, int rows, const PackTarget* target) {
+    int first_byte, end_byte;
+    column_byte_range(target, target->reverse_pixels, rows, 2, &first_byte, &end_byte);
+    int strip_count = (width + PACK_STRIP_COLUMNS - 1) / PACK_STRIP_COLUMNS;
+    int block_count = strip_count * (end_byte - first_byte);
+    uchar band[PACK_STRIP_COLUMNS];
+    const uchar* row_data[2];
+
+    for (int block = 0; block < block_count; block++) {
+        int x0, yb;
+        column_block(target, block, strip_count, first_byte, end_byte, &x0, &yb);
+        int strip = (width - x0 < PACK_STRIP_COLUMNS) ? width - x0 : PACK_STRIP_COLUMNS;
+        int merge = column_byte_rows(grayscale_data, width, rows, target, target->reverse_pixels, yb, 2, row_data);
+        const uchar* row1 = row_data[0] ? row_data[0] + x0 : NULL;
+        const uchar* row2 = row_data[1] ? row_data[1] + x0 : NULL;
+        int x = 0;
+
+#ifdef UTILS_USE_SSE2
+        const __m128i low_mask = _mm_set1_epi8(0x0F);
+        for (; x + 16 <= strip; x += 16) {
+            __m128i p1 = row1 ? _mm_and_si128(_mm_loadu_si128((const __m128i*)(row1 + x)), low_mask) : _mm_setzero_si128();
+            __m128i p2 = row2 ? _mm_and_si128(_mm_loadu_si128((const __m128i*)(row2 + x)), low_mask) : _mm_setzero_si128();
+            __m128i high = target->msb_first ? p1 : p2;
+            __m128i low = target->msb_first ? p2 : p1;
+            // Przesunięcie 16-bitowe jest bezpieczne - wartości mieszczą się w 4 bitach
+            __m128i packed = _mm_or_si128(_mm_slli_epi16(high, 4), low);
+            _mm_storeu_si128((__m128i*)(band + x), packed);
+        }
+#endif
+        for (; x < strip; x++) {
+            uchar pixel1 = row1 ? (uchar)(row1[x] & 0x0F) : 0;
+            uchar pixel2 = row2 ? (uchar)(row2[x] & 0x0F) : 0;
+            band[x] = target->msb_first ? (uchar)((pixel1 << 4) | pixel2) : (uchar)((pixel2 << 4) | pixel1);
+        }
+
+        scatter_column_bytes(band, strip, target, x0, yb, merge);
+    }
+}
+
+// ============================================================================
+// Generyczne pakowanie N bpp (1, 2, 4, 8)
+// ============================================================================
+
+// Przesunięcie piksela i bajtu: msb_first = 1 - pierwszy piksel na najstarszych bitach
+#define PACK_SHIFT(BPP, MSB_FIRST, i) ((MSB_FIRST) ? 8 - (BPP) - (i) * (BPP) : (i) * (BPP))
+
+/**
+ * @brief Generuje kernel pakowania wierszy dla głębi BPP
+ *
+ * @details Każdy wiersz pasma staje się linią wyjścia i zaczyna się od
+ * nowego bajtu, w bajcie mieści się 8/BPP pikseli. Przy MSB_FIRST = 1
+ * pierwszy piksel linii trafia na najstarsze bity bajtu, przy 0 na
+ * najmłodsze. Przy STEP = -1 wiersz jest czytany od prawej (odbicie
+ * lub obrót). BPP, MSB_FIRST i STEP są stałymi czasu kompilacji, więc
+ * przesunięcia i indeksy są stałe, pętla po pikselach bajtu jest w pełni
+ * rozwijana, a dla 8bpp bez odbicia kernel sprowadza się do kopiowania.
+ */
+#define DEFINE_PACK_ROWS(BPP, VARIANT, MSB_FIRST, STEP) \
+static void pack_##BPP##bpp_rows_##VARIANT(const uchar* grayscale_data, int width, int rows, const PackTarget* target) { \
+    enum { PER_BYTE = 8 / BPP, MASK = (1 << BPP) - 1 }; \
+    for (int y = 0; y < rows; y++) { \
+        const uchar* src = grayscale_data + (size_t)y * width + ((STEP) < 0 ? width - 1 : 0); \
+        uchar* dst = target->data + (ptrdiff_t)y * target->line_stride; \
+        if (BPP == 8 && (STEP) == 1 && target->byte_stride == 1) { \
+            memcpy(dst, src, (size_t)width); \
+            continue; \
+        } \
+        int x = 0; \
+        for (; x + PER_BYTE <= width; x += PER_BYTE, src += PER_BYTE * (STEP), dst += target->byte_stride) { \
+            uchar byte_value = 0; \
+            for (int i = 0; i < PER_BYTE; i++) { \
+                byte_value |= (uchar)((src[i * (STEP)] & MASK) << PACK_SHIFT(BPP, MSB_FIRST, i)); \
+            } \
+            *dst = byte_value; \
+        } \
+        if (x < width) { \
+            /* Niepełny ostatni bajt linii - brakujące piksele są zerami */ \
+            uchar byte_value = 0; \
+            for (int i = 0; i < width - x; i++) { \
+                byte_value |= (uchar)((src[i * (STEP)] & MASK) << PACK_SHIFT(BPP, MSB_FIRST, i)); \
+            } \
+            *dst = byte_value; \
+        } \
+    } \
+}
+
+/**
+ * @brief Generuje blokowy kernel pakowania kolumn dla głębi BPP
+ *
+ * @details Ten sam układ co pack_1bpp_vertical_blocked(): paski po
+ * PACK_STRIP_COLUMNS kolumn przetwarzane pasmami po 8/BPP wierszy. Każdy
+ * wiersz pasma jest czytany sekwencyjnie i dopisywany (OR) do bajtów
+ * kolumn paska, więc pętla po kolumnach jest wektoryzowana przez
+ * kompilator. Przy MSB_FIRST = 1 pierwszy piksel linii trafia na
+ * najstarsze bity, przy REVERSE = 1 piksele linii idą od dołu pasma.
+ */
+#define DEFINE_PACK_COLUMNS(BPP, VARIANT, MSB_FIRST, REVERSE) \
+static void pack_##BPP##bpp_columns_##VARIANT(const uchar* grayscale_data, int width, int rows, const PackTarget* target) { \
+    enum { PER_BYTE = 8 / BPP, MASK = (1 << BPP) - 1 }; \
+    int first_byte, end_byte; \
+    column_byte_range(target, REVERSE, rows, PER_BYTE, &first_byte, &end_byte); \
+    int strip_count = (width + PACK_STRIP_COLUMNS - 1) / PACK_STRIP_COLUMNS; \
+    int block_count = strip_count * (end_byte - first_byte); \
+    uchar band[PACK_STRIP_COLUMNS]; \
+    const uchar* row_data[PER_BYTE]; \
+    for (int block = 0; block < block_count; block++) { \
+        int x0, yb; \
+        column_block(target, block, strip_count, first_byte, end_byte, &x0, &yb); \
+        int strip = (width - x0 < PACK_STRIP_COLUMNS) ? width - x0 : PACK_STRIP_COLUMNS; \
+        int merge = column_byte_rows(grayscale_data, width, rows, target, REVERSE, yb, PER_BYTE, row_data); \
+        memset(band, 0, sizeof(band)); \
+        for (int r = 0; r < PER_BYTE; r++) { \
+            if (!row_data[r]) { \
+                continue; \
+            } \
+            const uchar* src = row_data[r] + x0; \
+            for (int x = 0; x < strip; x++) { \
+                band[x] |= (uchar)((src[x] & MASK) << PACK_SHIFT(BPP, MSB_FIRST, r)); \
+            } \
+        } \
+        scatter_column_bytes(band, strip, target, x0, yb, merge); \
+    } \
+}
+
+// Warianty kolejności bitów i kierunku czytania linii jednej głębi
+#define DEFINE_PACK_VARIANTS(KIND, BPP) \
+    DEFINE_PACK_##KIND(BPP, lsb, 0, PACK_FORWARD_##KIND) \
+    DEFINE_PACK_##KIND(BPP, msb, 1, PACK_FORWARD_##KIND) \
+    DEFINE_PACK_##KIND(BPP, lsb_reverse, 0, PACK_REVERSE_##KIND) \
+    DEFINE_PACK_##KIND(BPP, msb_reverse, 1, PACK_REVERSE_##KIND)
+#define PACK_FORWARD_ROWS 1
+#define PACK_REVERSE_ROWS -1
+#define PACK_FORWARD_COLUMNS 0
+#define PACK_REVERSE_COLUMNS 1
+
+DEFINE_PACK_VARIANTS(ROWS, 1)
+DEFINE_PACK_VARIANTS(ROWS, 2)
+DEFINE_PACK_VARIANTS(ROWS, 4)
+DEFINE_PACK_VARIANTS(ROWS, 8)
+// 1bpp i 4bpp mają własne kernele kolumn z SSE2 (powyżej)
+DEFINE_PACK_VARIANTS(COLUMNS, 2)
+DEFINE_PACK_VARIANTS(COLUMNS, 8)
+
+typedef void (*PackKernel)(const uchar* grayscale_data, int width, int rows, const PackTarget* target);
+
+// Kernele pakowania jednej głębi: warianty [msb_first][reverse_pixels], wybierane raz na pasmo
+typedef struct {
+    int bits_per_pixel;
+    PackKernel pack_rows[2][2];
+    PackKernel pack_columns[2][2];
+} PackKernels;
+
+#define PACK_KERNEL_VARIANTS(BPP, KIND) \
+    {{pack_##BPP##bpp_##KIND##_lsb, pack_##BPP##bpp_##KIND##_lsb_reverse}, {pack_##BPP##bpp_##KIND##_msb, pack_##BPP##bpp_##KIND##_msb_reverse}}
+#define PACK_KERNEL_SINGLE(kernel) {{kernel, kernel}, {kernel, kernel}}
+
+static const PackKernels pack_kernels[] = {
+    {BITS_PER_PIXEL_1BPP, PACK_KERNEL_VARIANTS(1, rows), PACK_KERNEL_SINGLE(pack_1bpp_vertical_blocked)},
+    {BITS_PER_PIXEL_2BPP, PACK_KERNEL_VARIANTS(2, rows), PACK_KERNEL_VARIANTS(2, columns)},
+    {BITS_PER_PIXEL_4BPP, PACK_KERNEL_VARIANTS(4, rows), PACK_KERNEL_SINGLE(pack_4bpp_vertical_blocked)},
+    {BITS_PER_PIXEL_8BPP, PACK_KERNEL_VARIANTS(8, rows), PACK_KERNEL_VARIANTS(8, columns)},
+};
+
+// Zwraca kernele dla głębi lub NULL dla nieobsługiwanej
+static const PackKernels* find_pack_kernels(int bits_per_pixel) {
+    for (size_t i = 0; i < sizeof(pack_kernels) / sizeof(pack_kernels[0]); i++) {
+        if (pack_kernels[i].bits_per_pixel == bits_per_pixel) {
+            return &pack_kernels[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sprawdza czy głębia kolorów jest obsługiwana przez silnik pakowania
+ *
+ * @param bits_per_pixel Głębia kolorów
+ *
+ * @return 1 dla 1, 2, 4 i 8 bpp, 0 w przeciwnym razie
+ */
+int is_supported_bpp(int bits_per_pixel) {
+    return find_pack_kernels(bits_per_pixel) != NULL;
+}
+
+/**
+ * @brief Sprowadza obrót i odbicie wyjścia do osi obrazu źródłowego
+ *
+ * @details Wyjście powstaje przez obrót źródła zgodnie z ruchem wskazówek
+ * zegara, a następnie odbicie obróconego obrazu. Każde z 8 położeń to
+ * co najwyżej zamiana osi (obrót o 90 lub 270 stopni) i odwrócenie
+ * kolejności kolumn i/lub wierszy źródła.
+ *
+ * @param rotation Obrót --rotate w stopniach (0, 90, 180, 270)
+ * @param flip Odbicie --flip (maska FLIP_*)
+ *
+ * @return Maska ORIENTATION_*
+ *
+ * @example
+ * ```c
+ * image_orientation(90, FLIP_NONE);        // ORIENTATION_TRANSPOSE | ORIENTATION_MIRROR_Y
+ * image_orientation(0, FLIP_HORIZONTAL);   // ORIENTATION_MIRROR_X
+ * ```
+ */
+int image_orientation(int rotation, int flip) {
+    int orientation = (rotation == 90)  ? ORIENTATION_TRANSPOSE | ORIENTATION_MIRROR_Y :
+                      (rotation == 180) ? ORIENTATION_MIRROR_X | ORIENTATION_MIRROR_Y :
+                      (rotation == 270) ? ORIENTATION_TRANSPOSE | ORIENTATION_MIRROR_X : ORIENTATION_IDENTITY;
+    int transposed = (orientation & ORIENTATION_TRANSPOSE) != 0;
+    // Po zamianie osi odbicie poziome wyjścia odwraca wiersze źródła, a pionowe kolumny
+    if (flip & FLIP_HORIZONTAL) {
+        orientation ^= transposed ? ORIENTATION_MIRROR_Y : ORIENTATION_MIRROR_X;
+    }
+    if (flip & FLIP_VERTICAL) {
+        orientation ^= transposed ? ORIENTATION_MIRROR_X : ORIENTATION_MIRROR_Y;
+    }
+    return orientation;
+}
+
+/**
+ * @brief Zwraca wymiary obrazu wyjściowego po obrocie
+ *
+ * @param orientation Maska ORIENTATION_*
+ * @param width Szerokość źródła
+ * @param height Wysokość źródła
+ * @param out_width Szerokość wyjścia (wyjściowy)
+ * @param out_height Wysokość wyjścia (wyjściowy)
+ */
+void oriented_size(int orientation, int width, int height, int* out_width, int* out_height) {
+    int transposed = (orientation & ORIENTATION_TRANSPOSE) != 0;
+    *out_width = transposed ? height : width;
+    *out_height = transposed ? width : height;
+}
+
+/**
+ * @brief Pakuje pasmo wierszy źródła do linii wyjścia o dowolnym położeniu
+ *
+ * @details Wspólny punkt wejścia wszystkich kerneli. Obrót i odbicie nie
+ * wymagają kopii klatki - są zamieniane na wybór kernela i odwzorowanie
+ * indeksów:
+ * - linie wyjścia (wiersze przy -h, kolumny przy -v) obróconego o 90/270
+ *   stopni obrazu to kolumny (-h) lub wiersze (-v) źródła, więc obrót
+ *   zamienia kernel wierszy z blokową transpozycją kernela kolumn;
+ * - odwrócona kolejność linii to ujemny odstęp linii w buforze;
+ * - odwrócona kolejność pikseli linii to odczyt wiersza od prawej
+ *   (kernel wierszy) albo wierszy pasma od dołu (kernel kolumn).
+ * Położenie bajtów w buforze opisują line_stride i byte_stride, dzięki
+ * czemu te same kernele pakują kolumny (-v) i strony sterowników OLED.
+ *
+ * @param grayscale_data Piksele pasma (width * band_height, od góry do dołu)
+ * @param width Szerokość źródła w pikselach
+ * @param height Wysokość całego źródła w pikselach
+ * @param band_y Pierwszy wiersz pasma w źródle
+ * @param band_height Liczba wierszy pasma
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * @param scan_direction Linie wyjścia: 1 = wiersze, 0 = kolumny obrazu wyjściowego
+ * @param pixel_order 1 = pierwszy piksel na najstarszych bitach, 0 = na najmłodszych
+ *                    (pionowe 1bpp: 1 = górny piksel w bicie 0)
+ * @param orientation Obrót i odbicie (image_orientation())
+ * @param line_data Bajt 0 linii 0 wyjścia
+ * @param line_stride Odstęp kolejnych linii wyjścia w bajtach
+ * @param byte_stride Odstęp kolejnych bajtów linii
+ *
+ * @return 1 w przypadku sukcesu, 0 dla nieobsługiwanej głębi
+ *
+ * @note Pasma muszą przychodzić kolejno od góry źródła - bajt dzielony
+ *       przez dwa pasma jest dopełniany (OR) przez drugie z nich
+ */
+int pack_band_lines(const uchar* grayscale_data, int width, int height, int band_y, int band_height, int bits_per_pixel, int scan_direction,
+                    int pixel_order, int orientation, uchar* line_data, ptrdiff_t line_stride, ptrdiff_t byte_stride) {
+    const PackKernels* kernels = find_pack_kernels(bits_per_pixel);
+    if (!kernels) {
+        return 0;
+    }
+    int transposed = (orientation & ORIENTATION_TRANSPOSE) != 0;
+    int mirror_x = (orientation & ORIENTATION_MIRROR_X) != 0;
+    int mirror_y = (orientation & ORIENTATION_MIRROR_Y) != 0;
+
+    PackTarget target;
+    target.byte_stride = byte_stride;
+    // Wyjątek pionowego 1bpp: pixel_order = 1 to górny piksel w bicie 0 (strony OLED)
+    target.msb_first = (bits_per_pixel == BITS_PER_PIXEL_1BPP && !scan_direction) ? !pixel_order : pixel_order;
+
+    if (scan_direction != transposed) {
+        // Linie wyjścia to wiersze źródła
+        int first_line = mirror_y ? height - 1 - band_y : band_y;
+        target.data = line_data + (ptrdiff_t)first_line * line_stride;
+        target.line_stride = mirror_y ? -line_stride : line_stride;
+        target.reverse_pixels = mirror_x;
+        target.first_pixel = 0;
+        target.line_pixels = width;
+        kernels->pack_rows[target.msb_first][target.reverse_pixels](grayscale_data, width, band_height, &target);
+    } else {
+        // Linie wyjścia to kolumny źródła, piksele linii to wiersze pasma
+        target.data = line_data + (mirror_x ? (ptrdiff_t)(width - 1) * line_stride : 0);
+        target.line_stride = mirror_x ? -line_stride : line_stride;
+        target.reverse_pixels = mirror_y;
+        target.first_pixel = mirror_y ? height - 1 - band_y : band_y;
+        target.line_pixels = height;
+        kernels->pack_columns[target.msb_first][target.reverse_pixels](grayscale_data, width, band_height, &target);
+    }
+    return 1;
+}
+
+/**
+ * @brief Pakuje piksele N bpp do bajtów z obsługą różnych kierunków skanowania
+ *
+ * @details Wybiera kernel wygenerowany dla danej głębi (DEFINE_PACK_ROWS /
+ * DEFINE_PACK_COLUMNS) lub ręcznie zoptymalizowany kernel kolumn dla 1bpp
+ * i 4bpp (pack_band_lines() dla całego obrazu bez obrotu).
+ *
+ * @param grayscale_data Piksele 0..BPP_LEVELS(bits_per_pixel)-1 (width * height, od góry do dołu)
+ * @param packed_data Bufor wyjściowy (calculate_packed_size() bajtów)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * @param scan_direction Kierunek skanowania (1=poziomy, 0=pionowy)
+ * @param pixel_order 1 = pierwszy piksel na najstarszych bitach, 0 = na najmłodszych
+ *
+ * @return 1 w przypadku sukcesu, 0 dla nieobsługiwanej głębi
+ *
+ * @note Wyjątek: pionowe 1bpp z pixel_order = 1 ma górny piksel w bicie 0
+ *       (układ stron sterowników OLED typu SSD1306)
+ *
+ * @example
+ * ```c
+ * uchar packed[64 * 16];  // 256x16 pikseli, 2bpp = 4 piksele na bajt
+ * pack_pixels(gray_levels, packed, 256, 16, BITS_PER_PIXEL_2BPP, 1, 1);
+ * ```
+ */
+int pack_pixels(uchar* grayscale_data, uchar* packed_data, int width, int height, int bits_per_pixel, int scan_direction, int pixel_order) {
+    return pack_pixels_band(grayscale_data, packed_data, width, height, 0, height, bits_per_pixel, scan_direction, pixel_order, ORIENTATION_IDENTITY);
+}
+
 /**
  * @brief Pakuje piksele 4bpp do bajtów z obsługą różnych kierunków skanowania
  * 
@@ -274,7 +913,7 @@ void set_default_extension(char* output_file, int output_format) {
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
  * 
  * @note Skanowanie poziome: wiersz po wierszu, 2 piksele na bajt
- * @note Skanowanie pionowe: kolumna po kolumnie, 2 piksele na bajt
+ * @note Skanowanie pionowe: kolumna po kolumnie, 2 piksele na bajt (pakowanie blokowe)
  * @note Little endian: piksel1 w górnych 4 bitach, piksel2 w dolnych
  * @note Big endian: piksel2 w górnych 4 bitach, piksel1 w dolnych
  * 
@@ -289,46 +928,30 @@ void set_default_extension(char* output_file, int output_format) {
  * ```
  */
 int pack_pixels_4bpp(uchar* grayscale_data, uchar* packed_data, int width, int height, int scan_direction, int pixel_order) {
-    int packed_index = 0;
-    
-    if (scan_direction) {
-        // Skanowanie poziome (wiersze)
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x += 2) {
-                uchar pixel1 = grayscale_data[y * width + x];
-                uchar pixel2 = (x + 1 < width) ? grayscale_data[y * width + x + 1] : 0;
-                
-                // Pakuj dwa 4-bitowe piksele w jeden bajt
-                if (pixel_order) {
-                    // Little endian: piksel1|piksel2
-                    packed_data[packed_index] = (pixel1 << 4) | pixel2;
-                } else {
-                    // Big endian: piksel2|piksel1
-                    packed_data[packed_index] = (pixel2 << 4) | pixel1;
-                }
-                packed_index++;
-            }
-        }
-    } else {
-        // Skanowanie pionowe (kolumny)
-        for (int x = 0; x < width; x++) {
-            for (int y = 0; y < height; y += 2) {
-                uchar pixel1 = grayscale_data[y * width + x];
-                uchar pixel2 = (y + 1 < height) ? grayscale_data[(y + 1) * width + x] : 0;
-                
-                // Pakuj dwa 4-bitowe piksele w jeden bajt
-                if (pixel_order) {
-                    // Little endian: piksel1|piksel2
-                    packed_data[packed_index] = (pixel1 << 4) | pixel2;
-                } else {
-                    // Big endian: piksel2|piksel1
-                    packed_data[packed_index] = (pixel2 << 4) | pixel1;
-                }
-                packed_index++;
-            }
-        }
+    return pack_pixels(grayscale_data, packed_data, width, height, BITS_PER_PIXEL_4BPP, scan_direction, pixel_order);
+}
+
+/**
+ * @brief Odwraca wartości pikseli w spakowanych danych
+ * 
+ * @details Dla każdej głębi N bpp odwrócenie piksela v to (2^N - 1) - v,
+ * czyli negacja jego bitów - wystarczy więc zanegować całe bajty. Dla 1bpp
+ * zamienia 0↔1, dla 4bpp v na 15-v. Operacja jest wykonywana w miejscu,
+ * przed zapisem pliku wyjściowego i podglądu BMP.
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych obrazu (modyfikowany)
+ * @param data_size Rozmiar danych w bajtach
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * 
+ * @return 1 w przypadku sukcesu, 0 dla nieobsługiwanej głębi
+ */
+int invert_packed_data(uchar* packed_data, size_t data_size, int bits_per_pixel) {
+    if (!is_supported_bpp(bits_per_pixel)) {
+        return 0;
+    }
+    for (size_t i = 0; i < data_size; i++) {
+        packed_data[i] = (uchar)~packed_data[i];
     }
-    
     return 1;
 }
 
@@ -336,9 +959,8 @@ int pack_pixels_4bpp(uchar* grayscale_data, uchar* packed_data, int width, int h
  * @brief Zapisuje spakowane dane do pliku w wybranym formacie
  * 
  * @details Implementuje wzorzec Strategy do zapisu danych w różnych formatach
- * wyjściowych (C array, raw data, assembler, MASM). Funkcja obsługuje inwersję
- * danych, generuje odpowiednie nagłówki i formatuje dane zgodnie z wybranym
- * standardem. Automatycznie wybiera odpowiedni format na podstawie parametru
+ * wyjściowych (C array, raw data, assembler, MASM). Funkcja generuje odpowiednie
+ * nagłówki i formatuje dane zgodnie z wybranym standardem. Automatycznie wybiera odpowiedni format na podstawie parametru
  * output_format.
  * 
  * @param packed_data Wskaźnik do spakowanych danych obrazu
@@ -349,15 +971,16 @@ int pack_pixels_4bpp(uchar* grayscale_data, uchar* packed_data, int width, int h
  * @param output_path Ścieżka do pliku wyjściowego
  * @param output_format Format wyjściowy (FORMAT_C_ARRAY, FORMAT_RAW_DATA, etc.)
  * @param use_progmem Czy używać atrybutu PROGMEM (tylko dla C array)
- * @param bits_per_pixel Głębia kolorów (1 lub 4 bpp)
- * @param dithering_method Metoda ditheringu (tylko dla 1bpp)
- * @param brightness Jasność 0-100% (tylko dla 1bpp)
- * @param contrast Kontrast 0-100% (tylko dla 1bpp)
- * @param invert Czy odwrócić bity danych (1=tak, 0=nie)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param invert Czy dane zostały odwrócone (1=tak, 0=nie) - tylko informacja w nagłówku
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
  * 
- * @note Modyfikuje dane w miejscu jeśli invert=1
+ * @note Nie modyfikuje danych - inwersję wykonuje wcześniej invert_packed_data()
  * @note Generuje spójne nagłówki dla wszystkich formatów
  * @note Obsługuje różne formaty komentarzy (// dla C, ; dla assemblera)
  * 
@@ -365,58 +988,114 @@ int pack_pixels_4bpp(uchar* grayscale_data, uchar* packed_data, int width, int h
  * ```c
  * uchar data[1024];
  * if (write_array(data, 1024, 64, 32, "my_image", "output.h", 
- *                 FORMAT_C_ARRAY, 1, 4, 0, 50, 50, 0)) {
+ *                 FORMAT_C_ARRAY, 1, 4, 0, 0, 50, 50, 0)) {
  *     // Plik został wygenerowany pomyślnie
  * }
  * ```
  */
-int write_array(uchar* packed_data, int data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert) {
-    FILE* file = fopen(output_path, "w");
+int write_array(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert, int external_linkage) {
+    // "-" = stdout: dane są zapisywane strumieniowo, bez pliku tymczasowego
+    FILE* file = open_output_stream(output_path, (output_format == FORMAT_BINARY) ? "wb" : "w");
     if (!file) {
         return 0;
     }
 
-    // Zastosuj inwersję do danych jeśli wymagane
-    if (invert) {
-        if (bits_per_pixel == BITS_PER_PIXEL_1BPP) {
-            // Dla 1bpp: odwróć bity
-            for (int i = 0; i < data_size; i++) {
-                packed_data[i] = ~packed_data[i];
-            }
-        } else if (bits_per_pixel == BITS_PER_PIXEL_4BPP) {
-            // Dla 4bpp: odwróć wartości pikseli (0-15 staje się 15-0)
-            for (int i = 0; i < data_size; i++) {
-                uchar byte = packed_data[i];
-                uchar low_nibble = 15 - (byte & 0x0F);
-                uchar high_nibble = 15 - ((byte >> 4) & 0x0F);
-                packed_data[i] = (high_nibble << 4) | low_nibble;
-            }
-        }
-    }
-
     int result = 0;
     switch (output_format) {
         case 0: // FORMAT_C_ARRAY
-            result = format_c_array_write(packed_data, data_size, width, height, array_name, file, use_progmem, bits_per_pixel, dithering_method, brightness, contrast, invert);
+            result = format_c_array_write(packed_data, data_size, width, height, array_name, file, use_progmem, bits_per_pixel, color_format, dithering_method, brightness, contrast, invert, external_linkage);
             break;
         case 1: // FORMAT_RAW_DATA
-            result = format_raw_data_write(packed_data, data_size, file, bits_per_pixel, dithering_method, brightness, contrast, invert);
+            result = format_raw_data_write(packed_data, data_size, file, bits_per_pixel, color_format, dithering_method, brightness, contrast, invert);
             break;
         case 2: // FORMAT_ASSEMBLER
-            result = format_assembler_write(packed_data, data_size, width, height, array_name, file, bits_per_pixel, dithering_method, brightness, contrast, invert);
+            result = format_assembler_write(packed_data, data_size, width, height, array_name, file, bits_per_pixel, color_format, dithering_method, brightness, contrast, invert);
             break;
         case 3: // FORMAT_MASM_ARRAY
-            result = format_masm_array_write(packed_data, data_size, width, height, array_name, file, bits_per_pixel, dithering_method, brightness, contrast, invert);
+            result = format_masm_array_write(packed_data, data_size, width, height, array_name, file, bits_per_pixel, color_format, dithering_method, brightness, contrast, invert);
+            break;
+        case 4: // FORMAT_BINARY
+            result = format_binary_write(packed_data, data_size, file);
             break;
         default:
             result = 0;
             break;
     }
     
-    fclose(file);
+    if (!close_output_stream(file)) {
+        result = 0;
+    }
     return result;
 }
 
+/**
+ * @brief Zapisuje plik wyjściowy, którego tablica jest aliasem tablicy o tych samych danych
+ * 
+ * @details Odpowiednik write_array() dla danych identycznych z tablicą
+ * zapisaną wcześniej w tym samym przebiegu (kolejny wycinek --crop):
+ * bajty nie są powtarzane, a nazwa tablicy wskazuje oryginał - w C
+ * deklaracją extern i #define, w assemblerze przypisaniem etykiety.
+ * Plik z oryginalną tablicą musi trafić do tego samego programu.
+ * 
+ * @param original_name Nazwa tablicy z danymi
+ * @param data_size Rozmiar danych w bajtach (deklaracja extern)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param array_name Nazwa aliasu
+ * @param output_path Ścieżka do pliku wyjściowego
+ * @param output_format Format z nazwaną tablicą (FORMAT_HAS_ARRAY_NAME())
+ * @param use_progmem Czy oryginał ma atrybut PROGMEM (tylko dla C array)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param invert Czy dane zostały odwrócone (1=tak, 0=nie) - tylko informacja w nagłówku
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu lub formatu bez nazwy tablicy
+ */
+int write_array_alias(const char* original_name, size_t data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert) {
+    if (!FORMAT_HAS_ARRAY_NAME(output_format)) {
+        return 0;
+    }
+    FILE* file = open_output_stream(output_path, "w");
+    if (!file) {
+        return 0;
+    }
+
+    int is_assembler = (output_format != FORMAT_C_ARRAY);
+    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, is_assembler, color_format};
+    write_file_header(file, &header_ctx);
+    if (is_assembler) {
+        fprintf(file, "; Same data as %s\n", original_name);
+        fprintf(file, "%s = %s\n", array_name, original_name);
+    } else {
+        fprintf(file, "// Same data as %s\n", original_name);
+        fprintf(file, "extern const unsigned char %s[%lu]%s;\n", original_name, (unsigned long)data_size, use_progmem ? " PROGMEM" : "");
+        fprintf(file, "#define %s %s\n", array_name, original_name);
+    }
+    return close_output_stream(file);
+}
+
+/**
+ * @brief Liczy skrót FNV-1a (64 bity) danych
+ * 
+ * @details Skrót tylko grupuje kandydatów na identyczne dane - zgodność
+ * potwierdza porównanie bajt po bajcie.
+ * 
+ * @param hash Skrót dotychczasowych danych (CONTENT_HASH_SEED na początku)
+ * @param data Dane
+ * @param size Rozmiar danych w bajtach
+ * 
+ * @return Skrót kontynuowany o data
+ */
+unsigned long long content_hash(unsigned long long hash, const uchar* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
 /**
  * @brief Zapisuje dane w formacie tablicy C z obsługą PROGMEM
  * 
@@ -432,10 +1111,11 @@ int write_array(uchar* packed_data, int data_size, int width, int height, const
  * @param array_name Nazwa tablicy w kodzie C
  * @param file Wskaźnik do otwartego pliku wyjściowego
  * @param use_progmem Czy dodać atrybut PROGMEM (1=tak, 0=nie)
- * @param bits_per_pixel Głębia kolorów (1 lub 4 bpp)
- * @param dithering_method Metoda ditheringu (tylko dla 1bpp)
- * @param brightness Jasność 0-100% (tylko dla 1bpp)
- * @param contrast Kontrast 0-100% (tylko dla 1bpp)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
  * @param invert Czy odwrócić bity danych (1=tak, 0=nie)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
@@ -447,16 +1127,36 @@ int write_array(uchar* packed_data, int data_size, int width, int height, const
  * @example
  * ```c
  * FILE* file = fopen("image.h", "w");
- * format_c_array_write(data, 1024, 64, 32, "my_image", file, 1, 4, 0, 50, 50, 0);
+ * format_c_array_write(data, 1024, 64, 32, "my_image", file, 1, 4, 0, 0, 50, 50, 0);
  * // Generuje: const unsigned char my_image[1024] PROGMEM = { 0x12, 0x34, ... };
  * ```
  */
-int format_c_array_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int use_progmem, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert) {
-    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 0};
+int format_c_array_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert, int external_linkage) {
+    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 0, color_format};
     write_file_header(file, &header_ctx);
-    fprintf(file, "const unsigned char %s[%d]%s = {\n", array_name, data_size, ((use_progmem) ? " PROGMEM" : ""));
+    return format_c_array_data(packed_data, data_size, array_name, file, use_progmem, external_linkage);
+}
+
+/**
+ * @brief Zapisuje deklarację tablicy C z danymi, bez nagłówka pliku
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych obrazu
+ * @param data_size Rozmiar danych w bajtach
+ * @param array_name Nazwa tablicy w kodzie C
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * @param use_progmem Czy dodać atrybut PROGMEM (1=tak, 0=nie)
+ * @param external_linkage Czy poprzedzić definicję deklaracją extern (tablica może być celem aliasu)
+ * 
+ * @return 1 w przypadku sukcesu
+ */
+int format_c_array_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file, int use_progmem, int external_linkage) {
+    if (external_linkage) {
+        // W C++ stała tablica ma wiązanie wewnętrzne - wcześniejsza deklaracja extern je zmienia
+        fprintf(file, "extern const unsigned char %s[%lu]%s;\n", array_name, (unsigned long)data_size, ((use_progmem) ? " PROGMEM" : ""));
+    }
+    fprintf(file, "const unsigned char %s[%lu]%s = {\n", array_name, (unsigned long)data_size, ((use_progmem) ? " PROGMEM" : ""));
     
-    for (int i = 0; i < data_size; i++) {
+    for (size_t i = 0; i < data_size; i++) {
         if (i % 16 == 0) {
             fprintf(file, "    ");
         }
@@ -487,10 +1187,11 @@ int format_c_array_write(uchar* packed_data, int data_size, int width, int heigh
  * @param packed_data Wskaźnik do spakowanych danych obrazu
  * @param data_size Rozmiar danych w bajtach
  * @param file Wskaźnik do otwartego pliku wyjściowego
- * @param bits_per_pixel Głębia kolorów (1 lub 4 bpp)
- * @param dithering_method Metoda ditheringu (tylko dla 1bpp)
- * @param brightness Jasność 0-100% (tylko dla 1bpp)
- * @param contrast Kontrast 0-100% (tylko dla 1bpp)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
  * @param invert Czy odwrócić bity danych (1=tak, 0=nie)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
@@ -502,15 +1203,15 @@ int format_c_array_write(uchar* packed_data, int data_size, int width, int heigh
  * @example
  * ```c
  * FILE* file = fopen("image.hex", "w");
- * format_raw_data_write(data, 1024, file, 4, 0, 50, 50, 0);
+ * format_raw_data_write(data, 1024, file, 4, 0, 0, 50, 50, 0);
  * // Generuje: 0x12, 0x34, 0x56, 0x78, ...
  * ```
  */
-int format_raw_data_write(uchar* packed_data, int data_size, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert) {
-    HeaderContext header_ctx = {0, 0, bits_per_pixel, dithering_method, brightness, contrast, invert, 0};
+int format_raw_data_write(uchar* packed_data, size_t data_size, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert) {
+    HeaderContext header_ctx = {0, 0, bits_per_pixel, dithering_method, brightness, contrast, invert, 0, color_format};
     write_file_header(file, &header_ctx);
     
-    for (int i = 0; i < data_size; i++) {
+    for (size_t i = 0; i < data_size; i++) {
         if (i % 16 == 0) {
             fprintf(file, "    ");
         }
@@ -542,10 +1243,11 @@ int format_raw_data_write(uchar* packed_data, int data_size, FILE* file, int bit
  * @param height Wysokość obrazu w pikselach
  * @param array_name Nazwa etykiety w kodzie assemblera
  * @param file Wskaźnik do otwartego pliku wyjściowego
- * @param bits_per_pixel Głębia kolorów (1 lub 4 bpp)
- * @param dithering_method Metoda ditheringu (tylko dla 1bpp)
- * @param brightness Jasność 0-100% (tylko dla 1bpp)
- * @param contrast Kontrast 0-100% (tylko dla 1bpp)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
  * @param invert Czy odwrócić bity danych (1=tak, 0=nie)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
@@ -557,16 +1259,30 @@ int format_raw_data_write(uchar* packed_data, int data_size, FILE* file, int bit
  * @example
  * ```c
  * FILE* file = fopen("image.inc", "w");
- * format_assembler_write(data, 1024, 64, 32, "my_image", file, 4, 0, 50, 50, 0);
+ * format_assembler_write(data, 1024, 64, 32, "my_image", file, 4, 0, 0, 50, 50, 0);
  * // Generuje: my_image:\n    .db $12, $34, $56, $78, ...
  * ```
  */
-int format_assembler_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert) {
-    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 1};
+int format_assembler_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert) {
+    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 1, color_format};
     write_file_header(file, &header_ctx);
-    fprintf(file, "%s:\n", array_name);
-    
-    for (int i = 0; i < data_size; i++) {
+    return format_assembler_data(packed_data, data_size, array_name, file);
+}
+
+/**
+ * @brief Zapisuje etykietę i dyrektywy .db z danymi, bez nagłówka pliku
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych obrazu
+ * @param data_size Rozmiar danych w bajtach
+ * @param array_name Nazwa etykiety w kodzie assemblera
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * 
+ * @return 1 w przypadku sukcesu
+ */
+int format_assembler_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file) {
+    fprintf(file, "%s:\n", array_name);
+    
+    for (size_t i = 0; i < data_size; i++) {
         if (i % 16 == 0) {
             fprintf(file, "    .db ");
         }
@@ -597,10 +1313,11 @@ int format_assembler_write(uchar* packed_data, int data_size, int width, int hei
  * @param height Wysokość obrazu w pikselach
  * @param array_name Nazwa tablicy w kodzie MASM
  * @param file Wskaźnik do otwartego pliku wyjściowego
- * @param bits_per_pixel Głębia kolorów (1 lub 4 bpp)
- * @param dithering_method Metoda ditheringu (tylko dla 1bpp)
- * @param brightness Jasność 0-100% (tylko dla 1bpp)
- * @param contrast Kontrast 0-100% (tylko dla 1bpp)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8 bpp)
+ * @param color_format Wyjście kolorowe (COLOR_FORMAT_*, 0 = skala szarości)
+ * @param dithering_method Metoda ditheringu (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param brightness Jasność 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
+ * @param contrast Kontrast 0-100% (tylko dla 1bpp, 2bpp i 4bpp)
  * @param invert Czy odwrócić bity danych (1=tak, 0=nie)
  * 
  * @return 1 w przypadku sukcesu, 0 w przypadku błędu
@@ -612,16 +1329,30 @@ int format_assembler_write(uchar* packed_data, int data_size, int width, int hei
  * @example
  * ```c
  * FILE* file = fopen("image.inc", "w");
- * format_masm_array_write(data, 1024, 64, 32, "my_image", file, 4, 0, 50, 50, 0);
+ * format_masm_array_write(data, 1024, 64, 32, "my_image", file, 4, 0, 0, 50, 50, 0);
  * // Generuje: .array my_image[1024].byte\n $12, $34, $56, $78, ...
  * ```
  */
-int format_masm_array_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert) {
-    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 1};
+int format_masm_array_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert) {
+    HeaderContext header_ctx = {width, height, bits_per_pixel, dithering_method, brightness, contrast, invert, 1, color_format};
     write_file_header(file, &header_ctx);
-    fprintf(file, ".array %s[%d].byte\n", array_name, data_size);
+    return format_masm_array_data(packed_data, data_size, array_name, file);
+}
+
+/**
+ * @brief Zapisuje makro .array z danymi, bez nagłówka pliku
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych obrazu
+ * @param data_size Rozmiar danych w bajtach
+ * @param array_name Nazwa tablicy w kodzie MASM
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * 
+ * @return 1 w przypadku sukcesu
+ */
+int format_masm_array_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file) {
+    fprintf(file, ".array %s[%lu].byte\n", array_name, (unsigned long)data_size);
     
-    for (int i = 0; i < data_size; i++) {
+    for (size_t i = 0; i < data_size; i++) {
         if (i % 16 == 0) {
             if (i == 0) {
                 fprintf(file, " "); // Tylko pierwsza linia ma wcięcie
@@ -643,8 +1374,120 @@ int format_masm_array_write(uchar* packed_data, int data_size, int width, int he
     return 1;
 }
 
+/**
+ * @brief Zapisuje dane jako surowe bajty binarne
+ * 
+ * @details Funkcja zapisuje spakowane dane bez nagłówka i bez formatowania
+ * tekstowego - plik zawiera dokładnie data_size bajtów. Format jest
+ * przeznaczony do bezpośredniego dołączania (np. .incbin, objcopy) lub
+ * ładowania z karty pamięci.
+ * 
+ * @param packed_data Wskaźnik do spakowanych danych obrazu
+ * @param data_size Rozmiar danych w bajtach
+ * @param file Wskaźnik do pliku otwartego w trybie binarnym
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu zapisu
+ * 
+ * @example
+ * ```c
+ * FILE* file = fopen("image.bin", "wb");
+ * format_binary_write(data, 1024, file);
+ * ```
+ */
+int format_binary_write(uchar* packed_data, size_t data_size, FILE* file) {
+    return fwrite(packed_data, 1, data_size, file) == data_size;
+}
+
+/**
+ * @brief Dopisuje paletę RGB za danymi obrazu (--color indexed)
+ * 
+ * @details Paleta jest zapisywana jako osobna tablica NAZWA_palette
+ * z trójkami R, G, B (po jednym kolorze w wierszu) w tym samym formacie
+ * co dane obrazu. Plik jest otwierany w trybie dopisywania, więc funkcję
+ * wywołuje się po write_array().
+ * 
+ * @param output_path Ścieżka do pliku wyjściowego lub "-" (stdout)
+ * @param output_format Format wyjściowy (bez FORMAT_BINARY)
+ * @param array_name Nazwa tablicy danych obrazu
+ * @param use_progmem Czy dodać atrybut PROGMEM (tylko dla C array)
+ * @param palette Kolory RGB (3 bajty na kolor)
+ * @param color_count Liczba kolorów palety
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Surowe bajty binarne nie mają miejsca na paletę - FORMAT_BINARY zwraca 0
+ * 
+ * @example
+ * ```c
+ * append_palette_array("image.h", FORMAT_C_ARRAY, "my_image", 0, palette, 16);
+ * // Generuje: const unsigned char my_image_palette[48] = { 0x12, 0x34, 0x56, // 0 ...
+ * ```
+ */
+int append_palette_array(const char* output_path, int output_format, const char* array_name, int use_progmem, const uchar* palette, int color_count) {
+    if (output_format == FORMAT_BINARY) {
+        return 0;
+    }
+    FILE* file = open_output_stream(output_path, "a");
+    if (!file) {
+        return 0;
+    }
+    format_palette_write(file, output_format, array_name, use_progmem, palette, color_count);
+    return close_output_stream(file);
+}
+
+/**
+ * @brief Zapisuje tablicę palety RGB NAZWA_palette do otwartego pliku
+ * 
+ * @param file Wskaźnik do otwartego pliku wyjściowego
+ * @param output_format Format wyjściowy (FORMAT_C_ARRAY, FORMAT_ASSEMBLER lub FORMAT_MASM_ARRAY)
+ * @param array_name Nazwa tablicy danych obrazu
+ * @param use_progmem Czy dodać atrybut PROGMEM (tylko dla C array)
+ * @param palette Kolory RGB (3 bajty na kolor)
+ * @param color_count Liczba kolorów palety
+ * 
+ * @return 1 w przypadku sukcesu
+ */
+int format_palette_write(FILE* file, int output_format, const char* array_name, int use_progmem, const uchar* palette, int color_count) {
+    int is_assembler = (output_format == FORMAT_ASSEMBLER || output_format == FORMAT_MASM_ARRAY);
+    const char* byte_prefix = is_assembler ? "$" : "0x";
+    fprintf(file, "\n%s Palette: %d colors, RGB888\n", is_assembler ? ";" : "//", color_count);
+    switch (output_format) {
+        case FORMAT_C_ARRAY:
+            fprintf(file, "const unsigned char %s_palette[%d]%s = {\n", array_name, color_count * 3, use_progmem ? " PROGMEM" : "");
+            break;
+        case FORMAT_ASSEMBLER:
+            fprintf(file, "%s_palette:\n", array_name);
+            break;
+        case FORMAT_MASM_ARRAY:
+            fprintf(file, ".array %s_palette[%d].byte\n", array_name, color_count * 3);
+            break;
+    }
+
+    for (int i = 0; i < color_count; i++) {
+        const uchar* color = palette + i * 3;
+        int last = (i == color_count - 1);
+        const char* indent = (output_format == FORMAT_ASSEMBLER) ? "    .db " :
+                             (output_format == FORMAT_MASM_ARRAY) ? (i == 0 ? " " : "") : "    ";
+        fprintf(file, "%s%s%02X, %s%02X, %s%02X", indent, byte_prefix, color[0], byte_prefix, color[1], byte_prefix, color[2]);
+        if (output_format == FORMAT_MASM_ARRAY) {
+            fprintf(file, "\n"); // Jak dane obrazu - wiersze .array bez komentarzy
+        } else if (is_assembler) {
+            fprintf(file, " ; %d\n", i);
+        } else {
+            fprintf(file, last ? "  // %d\n" : ", // %d\n", i);
+        }
+    }
+
+    if (output_format == FORMAT_C_ARRAY) {
+        fprintf(file, "};\n");
+    } else if (output_format == FORMAT_MASM_ARRAY) {
+        fprintf(file, ".enda\n");
+    }
+    return 1;
+}
+
 // ============================================================================
-// Funkcje dla 1bpp
+// Funkcje dla głębi z ditheringiem (skala 0-255, dithering, kwantyzacja)
 // ============================================================================
 
 uchar scale_to_1bpp(int gray_value) {
@@ -652,116 +1495,256 @@ uchar scale_to_1bpp(int gray_value) {
     return (gray_value > 127) ? 1 : 0;
 }
 
-int convert_to_grayscale_1bpp(uchar* image_data, uchar* grayscale_data, int width, int height, int bytes_per_row, int dithering_method, int brightness, int contrast) {
-    int bytes_per_pixel = 3; // Zakładamy 24-bit na razie
-    
-    // Najpierw konwertuj do skali szarości (0-255)
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            // Odczytaj z dolnego wiersza najpierw (format BMP)
-            int src_y = height - 1 - y;
-            int src_offset = src_y * bytes_per_row + x * bytes_per_pixel;
-            
-            // Wyciągnij wartości RGB (BMP przechowuje jako BGR)
-            uchar r = image_data[src_offset + 2];
-            uchar g = image_data[src_offset + 1];
-            uchar b = image_data[src_offset + 0];
-            
-            // Konwertuj do skali szarości
-            int gray = convert_rgb_to_grayscale(r, g, b);
-            
-            // Zapisz w buforze skali szarości (od góry do dołu jak PIL)
-            grayscale_data[y * width + x] = (uchar)gray;
-        }
+/**
+ * @brief Kwantyzuje wartość w skali szarości do poziomu głębi N bpp
+ * 
+ * @details Poziom to starsze N bitów wartości (gray >> (8 - N)), co dla
+ * 1bpp daje progowanie > 127, a dla 4bpp dzielenie przez 16. Poziomy
+ * zwracane przez dithering (k * 255 / (2^N - 1)) przechodzą dokładnie na k.
+ * 
+ * @param gray_value Wartość w skali szarości (0-255)
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * 
+ * @return Poziom 0..BPP_LEVELS(bits_per_pixel)-1
+ * 
+ * @example
+ * ```c
+ * uchar level = scale_to_bpp(170, BITS_PER_PIXEL_2BPP);  // 170 >> 6 = 2
+ * ```
+ */
+uchar scale_to_bpp(int gray_value, int bits_per_pixel) {
+    return (uchar)(gray_value >> (8 - bits_per_pixel));
+}
+
+/**
+ * @brief Konwertuje obraz do skali szarości w skali wymaganej przez głębię
+ * 
+ * @details Głębie z ditheringiem (1bpp, 2bpp, 4bpp) i 8bpp dostają pełną
+ * skalę 0-255 (BPP_GRAYSCALE_SHIFT() == 0); convert_to_grayscale_4bpp()
+ * obsługuje głębie kwantyzowane już przy konwersji.
+ * 
+ * @param view Widok wierszy obrazu wejściowego (24 lub 32 bpp, format BGR/BGRA)
+ * @param grayscale_data Wskaźnik do bufora wyjściowego
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym (>= szerokość)
+ * @param bits_per_pixel Głębia wyjściowa (1, 2, 4 lub 8)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int convert_to_grayscale_bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride, int bits_per_pixel) {
+    if (BPP_GRAYSCALE_SHIFT(bits_per_pixel) == 0) {
+        return convert_to_grayscale_8bpp(view, grayscale_data, grayscale_stride);
     }
-    
-    // Zastosuj regulację jasności i kontrastu
-    if (!adjust_brightness_contrast(grayscale_data, width, height, brightness, contrast)) {
+    return convert_to_grayscale_4bpp(view, grayscale_data, grayscale_stride);
+}
+
+/**
+ * @brief Konwertuje obraz BMP na skalę szarości 0-255 (8 bitów na piksel)
+ * 
+ * @details Pierwszy etap konwersji 1bpp: każdy piksel BGR jest zamieniany na
+ * wartość luminancji 0-255 bez kwantyzacji. Wynik ma układ od góry do dołu
+ * niezależnie od orientacji pliku (obsługuje ją widok wierszy). Jest wejściem
+ * regulacji jasności i kontrastu oraz ditheringu.
+ * 
+ * @param view Widok wierszy obrazu wejściowego (24 lub 32 bpp, format BGR/BGRA)
+ * @param grayscale_data Wskaźnik do bufora wyjściowego (grayscale_stride * wysokość bajtów)
+ * @param grayscale_stride Odstęp wierszy w buforze wyjściowym (>= szerokość)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int convert_to_grayscale_8bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride) {
+    int bytes_per_pixel = view->bits_per_pixel / 8;
+    if (bytes_per_pixel < 3) {
         return 0;
     }
     
-    // Zastosuj odpowiedni dithering
+    // Wiersze w kolejności pliku - dla BMP od dołu od ostatniego wiersza obrazu
+    for (int i = 0; i < view->height; i++) {
+        int y = (view->stride < 0) ? view->height - 1 - i : i;
+        const uchar* src = IMAGE_VIEW_ROW(view, y);
+        uchar* dst = grayscale_data + (size_t)y * grayscale_stride;
+        
+        for (int x = 0; x < view->width; x++, src += bytes_per_pixel) {
+            // BMP przechowuje piksele jako BGR(A)
+            dst[x] = (uchar)convert_rgb_to_grayscale(src[2], src[1], src[0]);
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief Stosuje wybraną metodę ditheringu do obrazu w skali szarości
+ * 
+ * @param grayscale_data Wskaźnik do danych obrazu w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param dithering_method Metoda ditheringu (DITHERING_*)
+ * @param levels Liczba poziomów wyjściowych (BPP_LEVELS(bpp), 2 dla 1bpp)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note DITHERING_NONE nie modyfikuje danych (kwantyzację wykonuje quantize_to_bpp())
+ */
+int apply_dithering(uchar* grayscale_data, int width, int height, int dithering_method, int levels) {
+    return apply_dithering_band(grayscale_data, width, height, height, 0, dithering_method, levels);
+}
+
+/**
+ * @brief Stosuje wybraną metodę ditheringu do pasma wierszy
+ * 
+ * @details Wersja apply_dithering() dla przetwarzania obrazu pasmami
+ * (--max-mem). Bufor zawiera rows_present wierszy, z których
+ * rows_to_process pierwszych jest ditherowanych; pozostały wiersz jest
+ * wierszem wyprzedzającym dla Floyd-Steinberg.
+ * 
+ * @param grayscale_data Wskaźnik do danych pasma w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param rows_present Liczba wierszy w buforze
+ * @param rows_to_process Liczba wierszy do ditheringu
+ * @param y_offset Numer pierwszego wiersza pasma w obrazie
+ * @param dithering_method Metoda ditheringu (DITHERING_*)
+ * @param levels Liczba poziomów wyjściowych (2 dla 1bpp, 4 dla 2bpp)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int apply_dithering_band(uchar* grayscale_data, int width, int rows_present, int rows_to_process, int y_offset, int dithering_method, int levels) {
     switch (dithering_method) {
         case DITHERING_FLOYD:
-            if (!apply_floyd_steinberg_dithering(grayscale_data, width, height)) {
-                return 0;
-            }
-            break;
+            return apply_floyd_steinberg_dithering_band(grayscale_data, width, rows_present, rows_to_process, levels);
         case DITHERING_ORDERED:
-            if (!apply_ordered_dithering(grayscale_data, width, height)) {
-                return 0;
-            }
-            break;
+        case DITHERING_ORDERED_2X2:
+        case DITHERING_ORDERED_4X4:
+        case DITHERING_ORDERED_16X16:
+        case DITHERING_CLUSTER_4X4:
+        case DITHERING_CLUSTER_8X8:
+            return apply_ordered_dithering_band(grayscale_data, width, rows_to_process, y_offset, dithering_method, levels);
+        case DITHERING_BLUE_NOISE:
+            return apply_blue_noise_dithering_band(grayscale_data, width, rows_to_process, y_offset, levels);
         case DITHERING_NONE:
         default:
             // Brak ditheringu - tylko progowanie
-            break;
+            return 1;
     }
-    
-    // Konwertuj do 1bpp (0 lub 1)
-    for (int i = 0; i < width * height; i++) {
-        grayscale_data[i] = scale_to_1bpp(grayscale_data[i]);
+}
+
+/**
+ * @brief Kwantyzuje obraz w skali szarości do poziomów głębi N bpp
+ * 
+ * @details Ostatni etap konwersji głębi z ditheringiem: każda wartość 0-255
+ * jest zamieniana na poziom scale_to_bpp() - dla 1bpp 0/1, dla 2bpp 0-3.
+ * 
+ * @param grayscale_data Wskaźnik do danych obrazu (0-255 → poziomy, w miejscu)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Wysokość obrazu w pikselach
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int quantize_to_bpp(uchar* grayscale_data, int width, int height, int bits_per_pixel) {
+    int shift = 8 - bits_per_pixel;
+    if (shift == 0) {
+        return 1;
+    }
+    size_t pixel_count = (size_t)width * height;
+    size_t i = 0;
+#ifdef UTILS_USE_SSE2
+    // Przesunięcie 16-bitowych słów i maska odcinająca bity sąsiedniego bajtu
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+    const __m128i level_mask = _mm_set1_epi8((char)(0xFF >> shift));
+    for (; i + 16 <= pixel_count; i += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(grayscale_data + i));
+        _mm_storeu_si128((__m128i*)(grayscale_data + i), _mm_and_si128(_mm_srl_epi16(pixels, shift_count), level_mask));
+    }
+#endif
+    for (; i < pixel_count; i++) {
+        grayscale_data[i] = (uchar)(grayscale_data[i] >> shift);
     }
-    
     return 1;
 }
 
-int pack_pixels_1bpp(uchar* grayscale_data, uchar* packed_data, int width, int height, int scan_direction, int pixel_order) {
-    int packed_index = 0;
+/**
+ * @brief Konwertuje obraz BMP na piksele 1bpp (0/1) z ditheringiem
+ * 
+ * @details Składa kolejne etapy konwersji 1bpp: skala szarości 0-255,
+ * regulacja jasności i kontrastu, dithering i progowanie. Program główny
+ * wywołuje te etapy osobno, aby móc mierzyć ich czas (--stats).
+ * 
+ * @param view Widok wierszy obrazu wejściowego (24 lub 32 bpp)
+ * @param grayscale_data Wskaźnik do bufora wyjściowego (wartości 0/1)
+ * @param dithering_method Metoda ditheringu
+ * @param brightness Jasność 0-100%
+ * @param contrast Kontrast 0-100%
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int convert_to_grayscale_1bpp(ImageRowView* view, uchar* grayscale_data, int dithering_method, int brightness, int contrast) {
+    int width = view->width;
+    int height = view->height;
     
-    if (scan_direction) {
-        // Skanowanie poziome (wiersze)
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x += 8) {
-                uchar byte_value = 0;
-                
-                for (int bit = 0; bit < 8; bit++) {
-                    int pixel_x = x + bit;
-                    if (pixel_x < width) {
-                        uchar pixel_value = grayscale_data[y * width + pixel_x];
-                        if (pixel_value) {
-                            if (pixel_order) {
-                                // Little endian: bit 7 = pierwszy piksel (lewy)
-                                byte_value |= (1 << (7 - bit));
-                            } else {
-                                // Big endian: bit 0 = pierwszy piksel (lewy)
-                                byte_value |= (1 << bit);
-                            }
-                        }
-                    }
-                }
-                
-                packed_data[packed_index++] = byte_value;
-            }
-        }
-    } else {
-        // Skanowanie pionowe (kolumny)
-        for (int x = 0; x < width; x++) {
-            for (int y = 0; y < height; y += 8) {
-                uchar byte_value = 0;
-                
-                for (int bit = 0; bit < 8; bit++) {
-                    int pixel_y = y + bit;
-                    if (pixel_y < height) {
-                        uchar pixel_value = grayscale_data[pixel_y * width + x];
-                        if (pixel_value) {
-                            if (pixel_order) {
-                                // Little endian: bit 0 = pierwszy piksel (góra)
-                                byte_value |= (1 << bit);
-                            } else {
-                                // Big endian: bit 7 = pierwszy piksel (góra)
-                                byte_value |= (1 << (7 - bit));
-                            }
-                        }
-                    }
-                }
-                
-                packed_data[packed_index++] = byte_value;
-            }
-        }
+    // Najpierw konwertuj do skali szarości (0-255)
+    if (!convert_to_grayscale_8bpp(view, grayscale_data, width)) {
+        return 0;
     }
     
-    return 1;
+    // Zastosuj regulację jasności i kontrastu
+    if (!adjust_brightness_contrast(grayscale_data, width, height, brightness, contrast)) {
+        return 0;
+    }
+    
+    // Zastosuj odpowiedni dithering
+    if (!apply_dithering(grayscale_data, width, height, dithering_method, BPP_LEVELS(BITS_PER_PIXEL_1BPP))) {
+        return 0;
+    }
+    
+    // Konwertuj do 1bpp (0 lub 1)
+    return quantize_to_bpp(grayscale_data, width, height, BITS_PER_PIXEL_1BPP);
+}
+
+/**
+ * @brief Pakuje piksele 1bpp (0/1) do bajtów
+ * 
+ * @details Odpowiednik pack_pixels_4bpp() dla 1bpp - 8 pikseli na bajt.
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Little endian: bit 7 = pierwszy (lewy) piksel; pionowo bit 0 = górny piksel
+ */
+int pack_pixels_1bpp(uchar* grayscale_data, uchar* packed_data, int width, int height, int scan_direction, int pixel_order) {
+    return pack_pixels(grayscale_data, packed_data, width, height, BITS_PER_PIXEL_1BPP, scan_direction, pixel_order);
+}
+
+/**
+ * @brief Pakuje pasmo wierszy obrazu do docelowego miejsca w buforze całego obrazu
+ * 
+ * @details Używana przy przetwarzaniu pasmami (--max-mem) i dla całej
+ * klatki (band_y = 0, band_height = height). Linie wyjścia (wiersze przy
+ * skanowaniu poziomym, kolumny przy pionowym) obrazu po obrocie leżą
+ * w buforze jedna za drugą - układ calculate_packed_size() dla wymiarów
+ * z oriented_size(). Pasma muszą przychodzić kolejno od góry źródła.
+ * 
+ * @param grayscale_data Piksele pasma (width * band_height, od góry do dołu)
+ * @param packed_data Bufor spakowanych danych całego obrazu
+ * @param width Szerokość źródła w pikselach
+ * @param height Wysokość całego źródła w pikselach
+ * @param band_y Numer pierwszego wiersza pasma w obrazie
+ * @param band_height Liczba wierszy pasma
+ * @param bits_per_pixel Głębia kolorów (1, 2, 4 lub 8)
+ * @param scan_direction Kierunek skanowania wyjścia (1=poziomy, 0=pionowy)
+ * @param pixel_order Kolejność pikseli w bajcie
+ * @param orientation Obrót i odbicie (image_orientation(), ORIENTATION_IDENTITY = bez zmian)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int pack_pixels_band(uchar* grayscale_data, uchar* packed_data, int width, int height, int band_y, int band_height, int bits_per_pixel, int scan_direction, int pixel_order, int orientation) {
+    if (!is_supported_bpp(bits_per_pixel)) {
+        return 0;
+    }
+    int out_width, out_height;
+    oriented_size(orientation, width, height, &out_width, &out_height);
+    size_t pixels_per_byte = 8 / bits_per_pixel;
+    size_t line_bytes = ((size_t)(scan_direction ? out_width : out_height) + pixels_per_byte - 1) / pixels_per_byte;
+    return pack_band_lines(grayscale_data, width, height, band_y, band_height, bits_per_pixel, scan_direction, pixel_order,
+                           orientation, packed_data, (ptrdiff_t)line_bytes, 1);
 }
 
 // ============================================================================
@@ -798,35 +1781,70 @@ int pack_pixels_1bpp(uchar* grayscale_data, uchar* packed_data, int width, int h
  * ```
  */
 int apply_floyd_steinberg_dithering(uchar* grayscale_data, int width, int height) {
+    return apply_floyd_steinberg_dithering_band(grayscale_data, width, height, height, 2);
+}
+
+/**
+ * @brief Floyd-Steinberg dla pasma wierszy z wierszem wyprzedzającym
+ * 
+ * @details Wersja apply_floyd_steinberg_dithering() dla przetwarzania
+ * pasmami. Kwantyzowane są tylko pierwsze rows_to_process wierszy, ale błąd
+ * ostatniego z nich trafia do kolejnego wiersza bufora (jeśli jest obecny).
+ * Ten wiersz, już z rozproszonym błędem, staje się pierwszym wierszem
+ * następnego pasma - wynik jest identyczny jak dla całego obrazu.
+ * 
+ * @param grayscale_data Wskaźnik do danych pasma w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param rows_present Liczba wierszy w buforze
+ * @param rows_to_process Liczba wierszy do kwantyzacji (<= rows_present)
+ * @param levels Liczba poziomów wyjściowych (2 = 0/255, 4 = 0/85/170/255)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Piksel jest zastępowany najbliższym poziomem - dla 2 poziomów to
+ *       próg 127, jak w klasycznej wersji 1bpp
+ */
+int apply_floyd_steinberg_dithering_band(uchar* grayscale_data, int width, int rows_present, int rows_to_process, int levels) {
     // Floyd-Steinberg dithering
     // Błędy są rozpraszane na piksele: prawo, lewo-dół, dół, prawo-dół
+    int height = rows_present;
+    if (levels < 2) {
+        return 0;
+    }
     
-    for (int y = 0; y < height; y++) {
+    // Najbliższy poziom dla każdej wartości 0-255
+    uchar nearest_level[256];
+    for (int value = 0; value < 256; value++) {
+        int level = (value * (levels - 1) + 127) / 255;
+        nearest_level[value] = (uchar)(level * 255 / (levels - 1));
+    }
+    
+    for (int y = 0; y < rows_to_process; y++) {
         for (int x = 0; x < width; x++) {
-            int old_pixel = grayscale_data[y * width + x];
-            int new_pixel = (old_pixel > 127) ? 255 : 0;
+            int old_pixel = grayscale_data[(size_t)y * width + x];
+            int new_pixel = nearest_level[old_pixel];
             int error = old_pixel - new_pixel;
             
-            grayscale_data[y * width + x] = (uchar)new_pixel;
+            grayscale_data[(size_t)y * width + x] = (uchar)new_pixel;
             
             // Rozprowadź błąd na sąsiednie piksele
             if (x + 1 < width) {
-                int new_value = grayscale_data[y * width + (x + 1)] + (error * 7 / 16);
-                grayscale_data[y * width + (x + 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
+                int new_value = grayscale_data[(size_t)y * width + (x + 1)] + (error * 7 / 16);
+                grayscale_data[(size_t)y * width + (x + 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
             }
             
             if (y + 1 < height) {
                 if (x > 0) {
-                    int new_value = grayscale_data[(y + 1) * width + (x - 1)] + (error * 3 / 16);
-                    grayscale_data[(y + 1) * width + (x - 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
+                    int new_value = grayscale_data[(size_t)(y + 1) * width + (x - 1)] + (error * 3 / 16);
+                    grayscale_data[(size_t)(y + 1) * width + (x - 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
                 }
                 
-                int new_value = grayscale_data[(y + 1) * width + x] + (error * 5 / 16);
-                grayscale_data[(y + 1) * width + x] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
+                int new_value = grayscale_data[(size_t)(y + 1) * width + x] + (error * 5 / 16);
+                grayscale_data[(size_t)(y + 1) * width + x] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
                 
                 if (x + 1 < width) {
-                    int new_value = grayscale_data[(y + 1) * width + (x + 1)] + (error * 1 / 16);
-                    grayscale_data[(y + 1) * width + (x + 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
+                    int new_value = grayscale_data[(size_t)(y + 1) * width + (x + 1)] + (error * 1 / 16);
+                    grayscale_data[(size_t)(y + 1) * width + (x + 1)] = (uchar)((new_value < 0) ? 0 : (new_value > 255) ? 255 : new_value);
                 }
             }
         }
@@ -835,32 +1853,203 @@ int apply_floyd_steinberg_dithering(uchar* grayscale_data, int width, int height
     return 1;
 }
 
+/**
+ * @brief Zamienia nazwę metody ditheringu z opcji -d na stałą DITHERING_*
+ * 
+ * @param name Nazwa metody (none, floyd, o2x2, o4x4, o8x8, o16x16, c4x4, c8x8, blue)
+ * 
+ * @return Stała DITHERING_* lub -1 dla nieznanej nazwy
+ */
+int parse_dithering_method(const char* name) {
+    for (int i = 0; i < DITHERING_METHOD_COUNT; i++) {
+        if (strcmp(dithering_methods[i].option_name, name) == 0) {
+            return dithering_methods[i].dithering_method;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Zwraca czytelną nazwę metody ditheringu (nagłówek pliku, konsola)
+ * 
+ * @param dithering_method Metoda ditheringu (DITHERING_*)
+ * 
+ * @return Nazwa metody; "None" dla nieznanej wartości
+ */
+const char* dithering_method_name(int dithering_method) {
+    for (int i = 0; i < DITHERING_METHOD_COUNT; i++) {
+        if (dithering_methods[i].dithering_method == dithering_method) {
+            return dithering_methods[i].display_name;
+        }
+    }
+    return "None";
+}
+
 int apply_ordered_dithering(uchar* grayscale_data, int width, int height) {
-    // Ordered 8x8 dithering - matryca Bayer 8x8
-    static const uchar bayer_matrix[8][8] = {
-        { 0, 32, 8, 40, 2, 34, 10, 42},
-        {48, 16, 56, 24, 50, 18, 58, 26},
-        {12, 44, 4, 36, 14, 46, 6, 38},
-        {60, 28, 52, 20, 62, 30, 54, 22},
-        { 3, 35, 11, 43, 1, 33, 9, 41},
-        {51, 19, 59, 27, 49, 17, 57, 25},
-        {15, 47, 7, 39, 13, 45, 5, 37},
-        {63, 31, 55, 23, 61, 29, 53, 21}
-    };
+    return apply_ordered_dithering_band(grayscale_data, width, height, 0, DITHERING_ORDERED, 2);
+}
+
+/**
+ * @brief Zwraca matrycę progów dla metody ordered ditheringu
+ * 
+ * @param dithering_method Metoda ditheringu (DITHERING_ORDERED*, DITHERING_CLUSTER_*)
+ * 
+ * @return Wskaźnik do matrycy lub NULL, jeśli metoda nie używa matrycy
+ */
+const DitherMatrix* find_dither_matrix(int dithering_method) {
+    for (int i = 0; i < dither_matrix_count; i++) {
+        if (dither_matrices[i].dithering_method == dithering_method) {
+            return &dither_matrices[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Ordered dithering (Bayer lub cluster-dot) dla pasma wierszy
+ * 
+ * @param grayscale_data Wskaźnik do danych pasma w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Liczba wierszy pasma
+ * @param y_offset Numer pierwszego wiersza pasma w obrazie (wybór wiersza matrycy)
+ * @param dithering_method Metoda ditheringu (DITHERING_ORDERED*, DITHERING_CLUSTER_*)
+ * @param levels Liczba poziomów wyjściowych (2 dla 1bpp, 4 dla 2bpp)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int apply_ordered_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int dithering_method, int levels) {
+    const DitherMatrix* matrix = find_dither_matrix(dithering_method);
+    if (!matrix) {
+        return 0;
+    }
+    return apply_threshold_dithering_band(grayscale_data, width, height, y_offset, levels,
+                                          matrix->thresholds, matrix->size);
+}
+
+/**
+ * @brief Dithering blue noise dla pasma wierszy zaczynającego się w wierszu y_offset
+ * 
+ * @details Działa jak ordered dithering, ale progi pochodzą z kafelkowanej
+ * tekstury blue noise 64x64 (blue_noise.c), więc wynik nie ma regularnego
+ * wzoru matrycy Bayera.
+ * 
+ * @param grayscale_data Wskaźnik do danych pasma w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Liczba wierszy pasma
+ * @param y_offset Numer pierwszego wiersza pasma w obrazie (wybór wiersza tekstury)
+ * @param levels Liczba poziomów wyjściowych (2 dla 1bpp, 4 dla 2bpp)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ */
+int apply_blue_noise_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int levels) {
+    return apply_threshold_dithering_band(grayscale_data, width, height, y_offset, levels,
+                                          &blue_noise_texture[0][0], BLUE_NOISE_SIZE);
+}
+
+/**
+ * @brief Dithering progowy z kafelkowaną matrycą progów size x size
+ * 
+ * @details Wspólne jądro ordered ditheringu i blue noise. Dla każdego wiersza
+ * wiersz matrycy jest powielany do wektora progów długości
+ * THRESHOLD_ROW_LENGTH, po czym wiersz obrazu jest porównywany z tym
+ * wektorem fragmentami - bez dzielenia modulo na piksel (SSE2: 16 pikseli
+ * jednym porównaniem). Każdy piksel jest przetwarzany niezależnie, więc
+ * wynik nie zależy od podziału na pasma.
+ * 
+ * @param grayscale_data Wskaźnik do danych pasma w skali szarości (0-255)
+ * @param width Szerokość obrazu w pikselach
+ * @param height Liczba wierszy pasma
+ * @param y_offset Numer pierwszego wiersza pasma w obrazie (wybór wiersza matrycy)
+ * @param levels Liczba poziomów wyjściowych (2 dla 1bpp, 4 dla 2bpp)
+ * @param thresholds Progi 0-254 zapisane wierszami
+ * @param size Bok matrycy (potęga dwójki, najwyżej THRESHOLD_ROW_LENGTH)
+ * 
+ * @return 1 w przypadku sukcesu, 0 w przypadku błędu
+ * 
+ * @note Dla więcej niż 2 poziomów wartość jest dzielona na przedział między
+ *       sąsiednimi poziomami, a położenie w przedziale (0-254) porównywane
+ *       z progiem. Progi mają zakres 0-254, więc biel (255) nigdy nie jest
+ *       przyciemniana, a czerń (0) rozjaśniana.
+ */
+int apply_threshold_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int levels, const uchar* thresholds, int size) {
+    if (levels < 2 || size <= 0 || size > THRESHOLD_ROW_LENGTH || (size & (size - 1)) != 0) {
+        return 0;
+    }
     
+    // Tablice poziomu dolnego, górnego i położenia w przedziale dla każdej wartości wejściowej
+    uchar level_low[256];
+    uchar level_high[256];
+    uchar fraction[256];
+    int steps = levels - 1;
+    for (int value = 0; value < 256; value++) {
+        int scaled = value * steps;
+        int level = scaled / 255;
+        level_low[value] = (uchar)(level * 255 / steps);
+        level_high[value] = (uchar)((level < steps ? level + 1 : level) * 255 / steps);
+        fraction[value] = (uchar)(scaled % 255);
+    }
+    
+    uchar row_thresholds[THRESHOLD_ROW_LENGTH];
     for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int threshold = bayer_matrix[y % 8][x % 8];
-            int pixel_value = grayscale_data[y * width + x];
-            
-            if (pixel_value > threshold) {
-                grayscale_data[y * width + x] = 255;
+        // Wektor progów wiersza - wiersz matrycy powielony do THRESHOLD_ROW_LENGTH
+        const uchar* matrix_row = thresholds + (size_t)((y + y_offset) & (size - 1)) * size;
+        for (int x = 0; x < THRESHOLD_ROW_LENGTH; x++) {
+            row_thresholds[x] = matrix_row[x & (size - 1)];
+        }
+        uchar* row = grayscale_data + (size_t)y * width;
+        
+        for (int x0 = 0; x0 < width; x0 += THRESHOLD_ROW_LENGTH) {
+            int count = (width - x0 < THRESHOLD_ROW_LENGTH) ? width - x0 : THRESHOLD_ROW_LENGTH;
+            uchar* chunk = row + x0;
+            int x = 0;
+            if (levels == 2) {
+#ifdef UTILS_USE_SSE2
+                // Porównanie bez znaku przez przesunięcie zakresu do liczb ze znakiem
+                const __m128i bias = _mm_set1_epi8((char)0x80);
+                for (; x + 16 <= count; x += 16) {
+                    __m128i pixels = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(chunk + x)), bias);
+                    __m128i limits = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(row_thresholds + x)), bias);
+                    _mm_storeu_si128((__m128i*)(chunk + x), _mm_cmpgt_epi8(pixels, limits));
+                }
+#endif
+                for (; x < count; x++) {
+                    chunk[x] = (chunk[x] > row_thresholds[x]) ? 255 : 0;
+                }
             } else {
-                grayscale_data[y * width + x] = 0;
+#ifdef UTILS_USE_SSE2
+                if (255 % steps == 0) {
+                    // Poziomy co 255/steps (2bpp, 4bpp): kwantyzacja arytmetyczna na 16 bitach
+                    const __m128i zero = _mm_setzero_si128();
+                    const __m128i steps_vector = _mm_set1_epi16((short)steps);
+                    const __m128i level_step = _mm_set1_epi16((short)(255 / steps));
+                    const __m128i full_scale = _mm_set1_epi16(255);
+                    const __m128i one = _mm_set1_epi16(1);
+                    for (; x + 16 <= count; x += 16) {
+                        __m128i pixels = _mm_loadu_si128((const __m128i*)(chunk + x));
+                        __m128i limits = _mm_loadu_si128((const __m128i*)(row_thresholds + x));
+                        __m128i halves[2];
+                        for (int half = 0; half < 2; half++) {
+                            __m128i value = half ? _mm_unpackhi_epi8(pixels, zero) : _mm_unpacklo_epi8(pixels, zero);
+                            __m128i limit = half ? _mm_unpackhi_epi8(limits, zero) : _mm_unpacklo_epi8(limits, zero);
+                            // scaled / 255 = (scaled + (scaled >> 8) + 1) >> 8 - dokładne dla scaled <= 255*255
+                            __m128i scaled = _mm_mullo_epi16(value, steps_vector);
+                            __m128i level = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(scaled, _mm_srli_epi16(scaled, 8)), one), 8);
+                            __m128i part = _mm_sub_epi16(scaled, _mm_mullo_epi16(level, full_scale));
+                            // Maska -1 tam, gdzie położenie w przedziale przekracza próg - podbicie poziomu
+                            level = _mm_sub_epi16(level, _mm_cmpgt_epi16(part, limit));
+                            halves[half] = _mm_mullo_epi16(level, level_step);
+                        }
+                        _mm_storeu_si128((__m128i*)(chunk + x), _mm_packus_epi16(halves[0], halves[1]));
+                    }
+                }
+#endif
+                for (; x < count; x++) {
+                    uchar value = chunk[x];
+                    chunk[x] = (fraction[value] > row_thresholds[x]) ? level_high[value] : level_low[value];
+                }
             }
         }
     }
-    
     return 1;
 }
 
@@ -873,23 +2062,30 @@ int adjust_brightness_contrast(uchar* grayscale_data, int width, int height, int
     // Kontrast: 0% = 0.0, 50% = 1.0, 100% = 2.0
     float contrast_factor = contrast / 50.0f;
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int pixel_index = y * width + x;
-            int original_value = grayscale_data[pixel_index];
-            
-            // Zastosuj kontrast (względem środka skali 127.5)
-            float adjusted_value = (original_value - 127.5f) * contrast_factor + 127.5f;
-            
-            // Zastosuj jasność
-            adjusted_value += brightness_factor;
-            
-            // Ogranicz do zakresu 0-255
-            if (adjusted_value < 0) adjusted_value = 0;
-            if (adjusted_value > 255) adjusted_value = 255;
-            
-            grayscale_data[pixel_index] = (uchar)adjusted_value;
-        }
+    // Ustawienia neutralne (50%/50%) nie zmieniają żadnej wartości
+    if (brightness == 50 && contrast == 50) {
+        return 1;
+    }
+    
+    // Wynik zależy tylko od wartości piksela - 256 obliczeń zamiast jednego na piksel
+    uchar adjusted[256];
+    for (int original_value = 0; original_value < 256; original_value++) {
+        // Zastosuj kontrast (względem środka skali 127.5)
+        float adjusted_value = (original_value - 127.5f) * contrast_factor + 127.5f;
+        
+        // Zastosuj jasność
+        adjusted_value += brightness_factor;
+        
+        // Ogranicz do zakresu 0-255
+        if (adjusted_value < 0) adjusted_value = 0;
+        if (adjusted_value > 255) adjusted_value = 255;
+        
+        adjusted[original_value] = (uchar)adjusted_value;
+    }
+    
+    size_t pixel_count = (size_t)width * height;
+    for (size_t i = 0; i < pixel_count; i++) {
+        grayscale_data[i] = adjusted[grayscale_data[i]];
     }
     
     return 1;
@@ -13,35 +13,74 @@
 #ifndef __UTILS_H__
 #define __UTILS_H__
 
+#include <stdio.h>
+#include <stddef.h>
 #include "defs.h"
 
 // Prototypy funkcji konwersji obrazu
+int size_multiply(size_t a, size_t b, size_t* result);
+size_t calculate_packed_size(int width, int height, int bits_per_pixel, int scan_direction);
+int is_supported_bpp(int bits_per_pixel);
+int pack_pixels(uchar* grayscale_data, uchar* packed_data, int width, int height, int bits_per_pixel, int scan_direction, int pixel_order);
 int pack_pixels_4bpp(uchar* grayscale_data, uchar* packed_data, int width, int height, int scan_direction, int pixel_order);
 int pack_pixels_1bpp(uchar* grayscale_data, uchar* packed_data, int width, int height, int scan_direction, int pixel_order);
+int pack_pixels_band(uchar* grayscale_data, uchar* packed_data, int width, int height, int band_y, int band_height, int bits_per_pixel, int scan_direction, int pixel_order, int orientation);
+int pack_band_lines(const uchar* grayscale_data, int width, int height, int band_y, int band_height, int bits_per_pixel, int scan_direction,
+                    int pixel_order, int orientation, uchar* line_data, ptrdiff_t line_stride, ptrdiff_t byte_stride);
+int image_orientation(int rotation, int flip);
+void oriented_size(int orientation, int width, int height, int* out_width, int* out_height);
 
 // Wzorzec Strategy dla formatów wyjściowych
-int write_array(uchar* packed_data, int data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert);
+int invert_packed_data(uchar* packed_data, size_t data_size, int bits_per_pixel);
+int write_array(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert, int external_linkage);
+int write_array_alias(const char* original_name, size_t data_size, int width, int height, const char* array_name, const char* output_path, int output_format, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert);
+
+// Skrót FNV-1a (64 bity) danych do wyszukiwania identycznych tablic
+#define CONTENT_HASH_SEED 14695981039346656037ULL
+unsigned long long content_hash(unsigned long long hash, const uchar* data, size_t size);
 
 // Funkcje pomocnicze
 void write_file_header(FILE* file, HeaderContext* ctx);
-void set_default_extension(char* output_file, int output_format);
+void write_generator_comment(FILE* file, int is_assembler);
+void write_format_comment(FILE* file, HeaderContext* ctx);
+void set_default_extension(char* output_file, size_t size, int output_format);
 
 // Indywidualne zapisywacze formatów (implementacje Strategy)
-int format_c_array_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int use_progmem, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert);
-int format_raw_data_write(uchar* packed_data, int data_size, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert);
-int format_assembler_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert);
-int format_masm_array_write(uchar* packed_data, int data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int dithering_method, int brightness, int contrast, int invert);
+int format_c_array_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int use_progmem, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert, int external_linkage);
+int format_raw_data_write(uchar* packed_data, size_t data_size, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert);
+int format_assembler_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert);
+int format_masm_array_write(uchar* packed_data, size_t data_size, int width, int height, const char* array_name, FILE* file, int bits_per_pixel, int color_format, int dithering_method, int brightness, int contrast, int invert);
+int format_binary_write(uchar* packed_data, size_t data_size, FILE* file);
+int append_palette_array(const char* output_path, int output_format, const char* array_name, int use_progmem, const uchar* palette, int color_count);
+int format_palette_write(FILE* file, int output_format, const char* array_name, int use_progmem, const uchar* palette, int color_count);
+
+// Same dane tablic bez nagłówka pliku (zbiorcze wyjście manifestu)
+int format_c_array_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file, int use_progmem, int external_linkage);
+int format_assembler_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file);
+int format_masm_array_data(uchar* packed_data, size_t data_size, const char* array_name, FILE* file);
 
 // Prototypy funkcji konwersji do skali szarości
-int convert_to_grayscale_4bpp(uchar* image_data, uchar* grayscale_data, int width, int height, int bytes_per_row);
-int convert_to_grayscale_1bpp(uchar* image_data, uchar* grayscale_data, int width, int height, int bytes_per_row, int dithering_method, int brightness, int contrast);
+int convert_to_grayscale_4bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride);
+int convert_to_grayscale_8bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride);
+int convert_to_grayscale_bpp(ImageRowView* view, uchar* grayscale_data, int grayscale_stride, int bits_per_pixel);
+int convert_to_grayscale_1bpp(ImageRowView* view, uchar* grayscale_data, int dithering_method, int brightness, int contrast);
 int convert_rgb_to_grayscale(uchar r, uchar g, uchar b);
 uchar scale_to_4bpp(int gray_value);
 uchar scale_to_1bpp(int gray_value);
+uchar scale_to_bpp(int gray_value, int bits_per_pixel);
 
 // Prototypy funkcji ditheringu
 int apply_floyd_steinberg_dithering(uchar* grayscale_data, int width, int height);
 int apply_ordered_dithering(uchar* grayscale_data, int width, int height);
+int apply_dithering(uchar* grayscale_data, int width, int height, int dithering_method, int levels);
+int apply_floyd_steinberg_dithering_band(uchar* grayscale_data, int width, int rows_present, int rows_to_process, int levels);
+int apply_ordered_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int dithering_method, int levels);
+int apply_blue_noise_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int levels);
+int apply_threshold_dithering_band(uchar* grayscale_data, int width, int height, int y_offset, int levels, const uchar* thresholds, int size);
+int parse_dithering_method(const char* name);
+const char* dithering_method_name(int dithering_method);
+int apply_dithering_band(uchar* grayscale_data, int width, int rows_present, int rows_to_process, int y_offset, int dithering_method, int levels);
+int quantize_to_bpp(uchar* grayscale_data, int width, int height, int bits_per_pixel);
 
 // Prototypy funkcji regulacji obrazu
 int adjust_brightness_contrast(uchar* grayscale_data, int width, int height, int brightness, int contrast);